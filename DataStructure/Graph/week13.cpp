@@ -10,55 +10,79 @@
 #include <iomanip>
 #include <cstdlib>
 #include <string>
+#include <vector>
+#include <algorithm>
 
 using namespace std;
 
-/**********************************************************************
- * Node
- * node class that have data, next pointer, and previous pointer.
- **********************************************************************/
-template < class T >
-class Node
-{
-private:
-    T data;                  
-    Node < T > * next;       
-    Node < T > * prev;
-    
-public:
-    Node();                   
-    Node* getNext();         
-    Node* getPrev();
-    T getData();             
-    void setData(T item);  
-    void setNext(Node* node); 
-    void setPrev(Node* node);
-};
-
 /***********************************************************************
- * List
- * class that can implement the doubly-linked list.
+ * OrderedList
+ * the sorted store of people. Items stay where they are once inserted;
+ * two trees of their positions keep them in order, one by rank and one
+ * by id. Each tree is a treap whose nodes count the nodes below them,
+ * so inserting, reading by rank, finding the rank of an item and
+ * looking up an id all take O(log n) expected time, however reads and
+ * inserts are interleaved.
  ************************************************************************/
 template < class T >
-class List
+class OrderedList
 {
 private:
-    int numItems;
-    Node < T > * firstNode;
-    Node < T > * lastNode;
+    // a node of either tree, for the item in the same position: the
+    // size of its subtree and its children, as positions too
+    struct Node
+    {
+        int size;
+        int left;
+        int right;
+    };
+    
+    std::vector < T > items;            // stay put once inserted
+    std::vector < Node > byRank;        // the tree in sorted order
+    std::vector < Node > byId;          // the tree ordered by id
+    int rootByRank;
+    int rootById;
+    
+    // a new item goes in front of the first one that is not smaller
+    struct RankOrder
+    {
+        RankOrder(const std::vector < T > &items) : items(items) {}
+        bool operator () (int fresh, int node) const
+        {
+            return !before(items[node], items[fresh]);
+        }
+        const std::vector < T > &items;
+    };
+    
+    // orders positions in items by the id number of the item there
+    struct IdOrder
+    {
+        IdOrder(const std::vector < T > &items) : items(items) {}
+        bool operator () (int fresh, int node) const
+        {
+            return items[fresh].getIdNum() < items[node].getIdNum();
+        }
+        const std::vector < T > &items;
+    };
+    
+    static bool before(const T &lSide, const T &rSide);
+    static unsigned priority(int node);
+    static int sizeOf(const std::vector < Node > &tree, int node)
+    {
+        return node == -1 ? 0 : tree[node].size;
+    }
+    template < class Order >
+    static void insert(std::vector < Node > &tree, int &root, int node,
+                       Order goesLeft);
     
 public:
-    List();
-    ~List();
-    List(const List &listToCopy);   
-    List& operator = (const List &rightSide);
-    void insert(T item, int pos);
-    void remove(int pos);
-    int lookup(T item) const;
-    T getData(int pos) const;
-    T idSearch(int idNum);
-    int empty(void) const;
-    int getNumItems(void) const;
+    OrderedList() : rootByRank(-1), rootById(-1) {}
+    void insert(const T &item);
+    int lookup(const T &item) const;
+    const T &getData(int pos) const;
+    T idSearch(int idNum) const;
+    int empty(void) const { return items.empty(); }
+    int getNumItems(void) const { return (int)items.size(); }
 };
 
 /**************************************************************
@@ -89,7 +113,8 @@ public:
     void setRight(BinaryTree* tree);
     void infix(void);              
     void prefix(void);         
-    void buildTree(int childId, int husId, int wifeId, List < T > &family);
+    void buildTree(int childId, int husId, int wifeId,
+                   OrderedList < T > &family);
     void postfix(void);            
     void level(void);              
 };
@@ -115,8 +140,8 @@ public:
     void setMonth(int aMonth) { month = aMonth; }
     void setYear(int aYear) { year = aYear; }
     
-    bool operator < (const Date& rSide);
-    bool operator > (const Date& rSide);
+    bool operator < (const Date& rSide) const;
+    bool operator > (const Date& rSide) const;
     
     void display(ostream& out) const;
 };
@@ -148,19 +173,19 @@ private:
     
 public:
     Person() { idNum = 0; secondYear = 0; }
-    string getFirstName() { return firstName; }
-    string getLastName() {return lastName; }
-    int getIdNum() { return idNum; }
-    Date getBirthDate() { return birthDate; }
-    int getSecondYear(){ return secondYear; }
+    string getFirstName() const { return firstName; }
+    string getLastName() const { return lastName; }
+    int getIdNum() const { return idNum; }
+    Date getBirthDate() const { return birthDate; }
+    int getSecondYear() const { return secondYear; }
     void setFirstName(string first) { firstName = first; }
     void setLastName(string last) { lastName = last; }
     void setIdNum(int id) { idNum = id; }
     void setBirthDate(Date birth) { birthDate = birth; }
     void setSecondYear(int year) { secondYear = year; }
     
-    bool operator < (const Person& rSide);
-    bool operator > (const Person& rSide);
+    bool operator < (const Person& rSide) const;
+    bool operator > (const Person& rSide) const;
     
     void display(ostream& out) const;
 };
@@ -179,7 +204,7 @@ ostream& operator << (ostream& out, const Person& rSide)
  * operator >
  * an overloaded operator > to compare birthdays of two persons
  ***********************************************************/
-bool Date::operator > (const Date& rSide)
+bool Date::operator > (const Date& rSide) const
 {
     if (year < rSide.year)
         return false;
@@ -203,7 +228,7 @@ bool Date::operator > (const Date& rSide)
  * operator <
  * an overloaded operator < to compare birthdays of two persons
  **********************************************************/
-bool Date::operator < (const Date& rSide)
+bool Date::operator < (const Date& rSide) const
 {
     if (year > rSide.year)
         return false;
@@ -251,7 +276,7 @@ void Date::display(ostream& out) const
  * an overloaded operator < to compare the name of two people and compare
  * last name first and then first name
  *********************************************************************/
-bool Person::operator < (const Person& rSide)
+bool Person::operator < (const Person& rSide) const
 {
     string lSideLast = lastName;
     string rSideLast = rSide.lastName;
@@ -289,7 +314,7 @@ bool Person::operator < (const Person& rSide)
  * an overloaded operator > to compare the name of two people and compare
  * last name first and then first name
  *********************************************************************/
-bool Person::operator > (const Person& rSide)
+bool Person::operator > (const Person& rSide) const
 {
     if (lastName < rSide.lastName)
         return false;
@@ -331,313 +356,171 @@ void Person::display(ostream& out) const
 }
 
 /**********************************************************************
- * default constructor of Node class
- * initialize data and next.
- ***********************************************************************/
-template < class T >
-Node < T > ::Node()
-{
-    next = NULL;
-    prev = NULL;
-}
-/**********************************************************************
- * getData
- * get data in a node
- ***********************************************************************/
-template < class T >
-T Node < T > ::getData()
-{
-    return data;
-}
-/**********************************************************************
- * getNext
- * get the next node
- ***********************************************************************/
-template < class T >
-Node < T > * Node < T > ::getNext()
-{
-    return next;
-}
-
-/**********************************************************************
- * getPrev
- * get the previous node
- ***********************************************************************/
-template < class T >
-Node < T > * Node < T > ::getPrev()
-{
-    return prev;
-}
-
-
-/**********************************************************************
- * setData
- * set data into a node
- ***********************************************************************/
-template < class T >
-void Node < T > ::setData(T item)
-{
-    data = item;
-}
-
-/**********************************************************************
- * setNext
- * set pointer in the next node
- ***********************************************************************/
-template < class T >
-void Node < T > ::setNext(Node < T > * node)
-{
-    next = node;
-}
-
-/**********************************************************************
- * setPrev
- * set pointer in the previous node
- ***********************************************************************/
-template < class T >
-void Node < T > ::setPrev(Node < T > * node)
-{
-    prev = node;
-}
-
-/**********************************************************************
- * default constructor of List class
- * initializes number of items and firstNode.
- ***********************************************************************/
-template < class T >
-List < T > ::List()
-{
-    numItems = 0;
-    firstNode = NULL;
-    lastNode = NULL;
-}
-
-/**********************************************************************
- * destructor
- * free memories in the list
- ***********************************************************************/
+ * before
+ * operator < on a Person is true for two equal people as well, which a
+ * search tree cannot live with. This is the strict version of it.
+ **********************************************************************/
 template < class T >
-List < T > ::~List()
+bool OrderedList < T > ::before(const T &lSide, const T &rSide)
 {
-    Node < T > * pCurr = firstNode;
-    Node < T > * pNext = NULL;
-    
-    for (int i = 0; i < numItems; i++)
-    {
-        pNext = pCurr->getNext();
-        delete pCurr;
-        pCurr = pNext;
-    }
+    return lSide < rSide && !(rSide < lSide);
 }
 
 /**********************************************************************
- * copy constructor
- * copy an template
- ***********************************************************************/
+ * priority
+ * the heap order of a node in both trees. A hash of its position does
+ * as well as a random number and gives the same trees on every run
+ **********************************************************************/
 template < class T >
-List < T > ::List(const List &listToCopy)  
+unsigned OrderedList < T > ::priority(int node)
 {
-    numItems = 0;
-    Node < T > * temp = listToCopy.firstNode;
-    
-    for (int i = 0; i < listToCopy.getNumItems(); i++)
-    {
-        insert(temp->getData(),i);
-        temp = temp->getNext();
-    }
+    unsigned hash = (unsigned)node * 2654435761u;
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3bu;
+    return hash ^ (hash >> 16);
 }
 
 /**********************************************************************
- * operator =
- * overloaded assignment operator
- ***********************************************************************/
+ * insert (into a tree)
+ * put node in as a leaf where the order says, counting it in every
+ * subtree on the way down, then rotate it up past any parent with a
+ * lower priority. Rotating keeps the counts right
+ **********************************************************************/
 template < class T >
-List < T > &List < T > ::operator = (const List &rightSide)
+template < class Order >
+void OrderedList < T > ::insert(std::vector < Node > &tree, int &root,
+                                int node, Order goesLeft)
 {
-    this->~List();
-    
-    numItems = 0;
-    Node < T > * temp = rightSide.firstNode;
-    
-    for (int i = 0; i < rightSide.getNumItems(); i++)
+    if (root == -1)
     {
-        insert(temp->getData(),i);
-        temp = temp->getNext();
+        root = node;
+        return;
     }
-}
-
-/**********************************************************************
- * insert
- * insert item at specified position
- ***********************************************************************/
-template < class T >
-void List < T > ::insert(T item, int pos)
-{
-    Node < T > * pCurr = firstNode;
-    Node < T > * pNew = new Node < T > ;
     
-    pNew->setData(item);
-    
-    if (pos == 0 || numItems == 0)
+    tree[root].size++;
+    int top = root;
+    if (goesLeft(node, root))
     {
-        firstNode = pNew;
-        pNew->setNext(pCurr);
-        if (numItems != 0)
-            pCurr->setPrev(pNew);
-        else
-            lastNode = pNew;
-    }
-    else if ((numItems - 1) < pos)
-    {
-        pCurr = lastNode;
-        lastNode = pNew;
-        pNew->setPrev(pCurr);
-        pCurr->setNext(pNew);
+        insert(tree, tree[top].left, node, goesLeft);
+        int child = tree[top].left;
+        if (priority(child) > priority(top))
+        {
+            tree[top].left = tree[child].right;
+            tree[child].right = top;
+            root = child;
+        }
     }
     else
     {
-        for (int i = 0; i < pos; i++)
+        insert(tree, tree[top].right, node, goesLeft);
+        int child = tree[top].right;
+        if (priority(child) > priority(top))
         {
-            pCurr = pCurr->getNext();
+            tree[top].right = tree[child].left;
+            tree[child].left = top;
+            root = child;
         }
-        
-        pCurr->getPrev()->setNext(pNew);//prev -> new
-        pNew->setNext(pCurr);// new -> next
-        pNew->setPrev(pCurr->getPrev());// prev <- new
-        pCurr->setPrev(pNew);// new <- next
     }
-    
-    numItems++;
+    if (root != top)
+    {
+        tree[root].size = tree[top].size;
+        tree[top].size = 1 + sizeOf(tree, tree[top].left) +
+                             sizeOf(tree, tree[top].right);
+    }
 }
 
 /**********************************************************************
- * remove
- * remove item at specified position
+ * insert
+ * add an item, in its sorted place and in its place by id. Equal items
+ * end up newest first
  ***********************************************************************/
 template < class T >
-void List < T > ::remove(int pos)
+void OrderedList < T > ::insert(const T &item)
 {
-    if (numItems == 0)
-        return;
-    
-    Node < T > * pCurr = firstNode;
-    
-    if (numItems == 1)
-    {
-        firstNode = NULL;
-        lastNode = NULL;
-    }
-    else if (pos == 0)
-    {
-        pCurr->getNext()->setPrev(NULL);
-        firstNode = pCurr->getNext();
-    }
-    else if ( (numItems - 1) <= pos)
-    {
-        pCurr = lastNode;
-        lastNode = pCurr->getPrev();
-        pCurr->getPrev()->setNext(NULL);
-    }
-    else
-    {
-        for (int i = 0; i < pos; i++)
-        {
-            pCurr = pCurr->getNext();
-        }
-        
-        pCurr->getPrev()->setNext(pCurr->getNext());
-        pCurr->getNext()->setPrev(pCurr->getPrev());
-    }
-    
-    delete pCurr;
-    
-    numItems--;
+    int node = (int)items.size();
+    items.push_back(item);
+    Node leaf = { 1, -1, -1 };
+    byRank.push_back(leaf);
+    byId.push_back(leaf);
+    insert(byRank, rootByRank, node, RankOrder(items));
+    insert(byId, rootById, node, IdOrder(items));
 }
 
 /**********************************************************************
  * lookup
- * returns position in linked list(zero relative)
+ * returns the rank of item in the sorted list (zero relative), or -1.
+ * The first node that is not before item is the only candidate; the
+ * nodes passed on the left of the way down to it are its rank
  ***********************************************************************/
 template < class T >
-int List < T > ::lookup(T item) const
+int OrderedList < T > ::lookup(const T &item) const
 {
-    Node < T > * pCurr = firstNode;
-    int pos = 0;
-    
-    while (pCurr != NULL && pCurr->getData() != item)
+    int rank = 0;
+    int found = -1;
+    int foundRank = 0;
+    for (int node = rootByRank; node != -1; )
     {
-        pCurr = pCurr->getNext();
-        pos++;
+        if (before(items[node], item))
+        {
+            rank += sizeOf(byRank, byRank[node].left) + 1;
+            node = byRank[node].right;
+        }
+        else
+        {
+            found = node;
+            foundRank = rank + sizeOf(byRank, byRank[node].left);
+            node = byRank[node].left;
+        }
     }
-    
-    if (pCurr == NULL)
-        pos = -1;
-    
-    return pos;
+    if (found == -1 || before(item, items[found]))
+        return -1;
+    return foundRank;
 }
 
 /**********************************************************************
  * getData
- * returns data located at the specified position
+ * returns data located at the specified rank
  ***********************************************************************/
 template < class T >
-T List < T > ::getData(int pos) const
+const T &OrderedList < T > ::getData(int pos) const
 {
-    Node < T > * pCurr = firstNode;
-    
-    for (int i = 0; i < pos && i < numItems; i++)
+    int node = rootByRank;
+    for (;;)
     {
-        pCurr = pCurr->getNext();
+        int numLeft = sizeOf(byRank, byRank[node].left);
+        if (pos == numLeft)
+            return items[node];
+        if (pos < numLeft)
+            node = byRank[node].left;
+        else
+        {
+            pos -= numLeft + 1;
+            node = byRank[node].right;
+        }
     }
-    
-    return pCurr->getData();
-}
-
-/**********************************************************************
- * empty
- * check if number of item in the list is empty.
- ***********************************************************************/
-template < class T >
-int List < T > ::empty(void) const
-{
-    if (numItems == 0)
-        return 1;
-    else
-        return 0;
-}
-
-/**********************************************************************
- * getNumItems
- * get number of item in the list
- ***********************************************************************/
-template < class T >
-int List < T > ::getNumItems(void) const
-{
-    return numItems;
 }
 
 /***********************************************************************
  * idSearch
- * find the person who have the same id number(parameter) in the list
- * and return person object.
+ * search the id tree for the person with the given id number.
+ * returns an empty object when there is no such person.
  **********************************************************************/
 template < class T >
-T List < T > ::idSearch(int idNum)
+T OrderedList < T > ::idSearch(int idNum) const
 {
-    int size = numItems;
-    
-    // search the person
-    for (int i = 0; i < size; i++)
+    for (int node = rootById; node != -1; )
     {
-        if (idNum == this->getData(i).getIdNum())
-        {
-            return this->getData(i);
-        }
+        const T &item = items[node];
+        if (item.getIdNum() == idNum)
+            return item;
+        if (item.getIdNum() > idNum)
+            node = byId[node].left;
+        else
+            node = byId[node].right;
     }
-    return this->getData(idNum);
+    return T();
 }
 
-
 /**********************************************************************
  * default constructor
  * initialize the data and pointers.
@@ -775,7 +658,7 @@ void BinaryTree < T > ::setRight(BinaryTree < T > * tree)
  **********************************************************************/
 template < class T >
 void BinaryTree < T > ::buildTree(int childId, int husId, int wifeId,
-                             List < T > &family)
+                             OrderedList < T > &family)
 {
     if (data.getIdNum() == childId)
     {
@@ -911,10 +794,10 @@ void BinaryTree < T > ::level()
 
 
 // non-member function prototype
-void parsePerson(ifstream &fin, List < Person > &family, string &next);
+void parsePerson(ifstream &fin, OrderedList < Person > &family, string &next);
 void parseName(ifstream &fin, string &next, Person &indi);
 void parseDate(ifstream &fin, string &next, Person &indi);
-void parseFamily(ifstream &fin, List < Person > &family,
+void parseFamily(ifstream &fin, OrderedList < Person > &family,
                  BinaryTree < Person > &familyTree, string &next);
 
 /**********************************************************************
@@ -945,7 +828,7 @@ int main(int argc, char* argv[])
     }
     
     string next;
-    List < Person > family;
+    OrderedList < Person > family;
     BinaryTree < Person > familyTree;
     
     fin >> next;
@@ -981,7 +864,7 @@ int main(int argc, char* argv[])
  * parse id and name and birthday form a file and insert the person
  * in a list
  ******************************************************************/
-void parsePerson(ifstream &fin, List < Person > &family, string &next)
+void parsePerson(ifstream &fin, OrderedList < Person > &family, string &next)
 {
     string id = next.substr(2);
     id.erase(id.find('@',1));
@@ -993,27 +876,7 @@ void parsePerson(ifstream &fin, List < Person > &family, string &next)
     parseName(fin, next, indi);
     parseDate(fin, next, indi);
     
-    int size = family.getNumItems();
-    
-    if (size != 0)
-    {
-
-        for (int i = 0; i < size; i++)
-        {
-            if (indi < family.getData(i))
-            {
-                family.insert(indi, i);
-                i = size;
-            }
-            else if (i == (size - 1))
-                family.insert(indi, i + 1);
-        }
-    }
-    else
-    {
-        family.insert(indi, 0);
-    }
-    
+    family.insert(indi);
     
     return;
 }
@@ -1177,7 +1040,7 @@ void parseDate(ifstream &fin, string &next, Person &indi)
  * find husband and wife and their child in the list using id and
  * build the family tree
  ******************************************************************/
-void parseFamily(ifstream &fin, List < Person > &family,
+void parseFamily(ifstream &fin, OrderedList < Person > &family,
                  BinaryTree < Person > &familyTree, string &next)
 {
     string id;
@@ -0,0 +1,407 @@
+/***********************************************************************
+* Header:
+*    Concurrent Hash
+* Author: Daniel Guzman
+* Summary:
+*    A hash set many threads can use at once. The items are split over
+*    a power of two number of shards by the top bits of their hash, and
+*    each shard is a FlatHash with its own reader-writer lock: finds
+*    share it, inserts and erases take it alone. Threads working on
+*    different shards never wait on each other, and each shard grows
+*    by itself, holding up only its own users. ConcurrentHashMap is
+*    the same over key-value pairs.
+*
+*    Needs C++14 for std::shared_timed_mutex.
+************************************************************************/
+
+#ifndef CONCURRENT_HASH_H
+#define CONCURRENT_HASH_H
+
+#include <cstddef>       // for SIZE_T
+#include <mutex>         // for UNIQUE_LOCK
+#include <new>           // for PLACEMENT NEW
+#include <shared_mutex>  // for SHARED_TIMED_MUTEX
+#include <utility>       // for PAIR
+#include <vector>
+#include "flatHash.h"
+#include "flatTable.h"
+
+/**************************************************
+ * CONCURRENT SHARDS
+ * The shards under ConcurrentHash and
+ * ConcurrentHashMap, each a table and its lock.
+ * Every shard starts a cache line of its own so
+ * two threads locking neighbouring shards do not
+ * fight over one line. The top bits of the hash
+ * pick the shard; the table uses the bottom ones
+ *************************************************/
+template <class Table>
+class ConcurrentShards
+{
+public:
+   struct Shard
+   {
+      mutable std::shared_timed_mutex lock;
+      Table table;
+   };
+
+   ConcurrentShards(int numShards) throw (const char *);
+   ~ConcurrentShards();
+
+   Shard & shardFor(size_t h) const { return shard(shardOf(h)); }
+   Shard & shard(int i) const
+   {
+      return *(Shard *)(shards + (size_t)i * shardSize);
+   }
+   int shardOf(size_t h) const
+   {
+      return shardBits ? (int)(h >> (sizeof(size_t) * 8 - shardBits)) : 0;
+   }
+
+   int  size() const;
+   void clear();
+   int  numShards() const { return shardMask + 1; }
+
+private:
+   // no copying: the locks cannot be copied
+   ConcurrentShards(const ConcurrentShards <Table> &);
+   ConcurrentShards <Table> & operator = (const ConcurrentShards <Table> &);
+
+   static const int CACHE_LINE = 64;
+
+   char * memory;        // what was allocated
+   char * shards;        // the first shard, aligned to a cache line
+   size_t shardSize;     // sizeof(Shard) rounded up to a cache line
+   int shardBits;
+   int shardMask;
+};
+
+/**************************************************
+ * CONCURRENT SHARDS CONSTRUCTOR
+ * numShards is rounded up to a power of two
+ *************************************************/
+template <class Table>
+ConcurrentShards<Table>::ConcurrentShards(int numShards) throw (const char *)
+{
+   shardBits = 0;
+   while ((1 << shardBits) < numShards)
+      shardBits++;
+   shardMask = (1 << shardBits) - 1;
+   shardSize = (sizeof(Shard) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+
+   try
+   {
+      memory = static_cast <char *> (::operator new(shardSize * (shardMask + 1) + CACHE_LINE));
+   }
+   catch (std::bad_alloc)
+   {
+      throw "ERROR: unable to allocate memory for the hash";
+   }
+   shards = memory + (CACHE_LINE - (size_t)memory % CACHE_LINE) % CACHE_LINE;
+
+   int built = 0;
+   try
+   {
+      for (; built <= shardMask; built++)
+         new (&shard(built)) Shard;
+   }
+   catch (...)
+   {
+      while (built-- > 0)
+         shard(built).~Shard();
+      ::operator delete(memory);
+      throw "ERROR: unable to allocate memory for the hash";
+   }
+}
+
+/**************************************************
+ * CONCURRENT SHARDS DESTRUCTOR
+ *************************************************/
+template <class Table>
+ConcurrentShards<Table>::~ConcurrentShards()
+{
+   for (int i = 0; i <= shardMask; i++)
+      shard(i).~Shard();
+   ::operator delete(memory);
+}
+
+/**************************************************
+ * CONCURRENT SHARDS SIZE and CLEAR
+ * One shard at a time, so with other threads busy
+ * the size is only ever a snapshot
+ *************************************************/
+template <class Table>
+int ConcurrentShards<Table>::size() const
+{
+   int num = 0;
+   for (int i = 0; i <= shardMask; i++)
+   {
+      std::shared_lock <std::shared_timed_mutex> hold(shard(i).lock);
+      num += shard(i).table.size();
+   }
+   return num;
+}
+
+template <class Table>
+void ConcurrentShards<Table>::clear()
+{
+   for (int i = 0; i <= shardMask; i++)
+   {
+      std::unique_lock <std::shared_timed_mutex> hold(shard(i).lock);
+      shard(i).table.clear();
+   }
+}
+
+/**************************************************
+ * CONCURRENT HASH
+ * Nothing hands out a reference to an item: it
+ * could move as soon as the lock goes
+ *************************************************/
+template <class T, class H = DefaultHasher <T> >
+class ConcurrentHash
+{
+public:
+   ConcurrentHash(int numShards = 64) throw (const char *) : shards(numShards) {}
+
+   // true if the item was not here before
+   bool insert(const T & item) throw (const char *);
+   bool erase(const T & item);
+   bool find(const T & item) const;
+
+   // insert the item, or if an equal one is already here call
+   // update(T & existing) on it under the shard's lock. update must
+   // not change anything == or the hasher look at
+   template <class Update>
+   bool insert_or_update(const T & item, Update update) throw (const char *);
+
+   // look up num items, setting found[i] for each. Items are grouped
+   // by shard first, so each shard is locked once per call, not once
+   // per item. Returns the number found
+   int findMany(const T * items, int num, bool * found) const;
+
+   int  size() const      { return shards.size();      }
+   bool empty() const     { return size() == 0;        }
+   void clear()           { shards.clear();            }
+   int  numShards() const { return shards.numShards(); }
+
+private:
+   typedef typename ConcurrentShards <FlatHash <T, H> > :: Shard Shard;
+
+   ConcurrentShards <FlatHash <T, H> > shards;
+   H hasher;
+};
+
+/**************************************************
+ * CONCURRENT HASH INSERT, ERASE and FIND
+ * Hash once, outside the lock, and hand the hash
+ * on to the shard
+ *************************************************/
+template <class T, class H>
+bool ConcurrentHash<T, H>::insert(const T & item) throw (const char *)
+{
+   size_t h = hasher(item);
+   Shard & s = shards.shardFor(h);
+   std::unique_lock <std::shared_timed_mutex> hold(s.lock);
+   bool inserted;
+   s.table.findOrInsert(item, h, inserted);
+   return inserted;
+}
+
+template <class T, class H>
+bool ConcurrentHash<T, H>::erase(const T & item)
+{
+   size_t h = hasher(item);
+   Shard & s = shards.shardFor(h);
+   std::unique_lock <std::shared_timed_mutex> hold(s.lock);
+   return s.table.erase(item, h);
+}
+
+template <class T, class H>
+bool ConcurrentHash<T, H>::find(const T & item) const
+{
+   size_t h = hasher(item);
+   Shard & s = shards.shardFor(h);
+   std::shared_lock <std::shared_timed_mutex> hold(s.lock);
+   return s.table.find(item, h);
+}
+
+/**************************************************
+ * CONCURRENT HASH INSERT OR UPDATE
+ *************************************************/
+template <class T, class H>
+template <class Update>
+bool ConcurrentHash<T, H>::insert_or_update(const T & item, Update update) throw (const char *)
+{
+   size_t h = hasher(item);
+   Shard & s = shards.shardFor(h);
+   std::unique_lock <std::shared_timed_mutex> hold(s.lock);
+   bool inserted;
+   T & existing = s.table.findOrInsert(item, h, inserted);
+   if (!inserted)
+      update(existing);
+   return inserted;
+}
+
+/**************************************************
+ * CONCURRENT HASH FIND MANY
+ * Counting sort the items by shard, then visit
+ * each shard that has any
+ *************************************************/
+template <class T, class H>
+int ConcurrentHash<T, H>::findMany(const T * items, int num, bool * found) const
+{
+   int numShards = shards.numShards();
+   std::vector <size_t> hashes(num);
+   std::vector <int> start(numShards + 1, 0);
+   for (int i = 0; i < num; i++)
+   {
+      hashes[i] = hasher(items[i]);
+      start[shards.shardOf(hashes[i]) + 1]++;
+   }
+   for (int i = 0; i < numShards; i++)
+      start[i + 1] += start[i];
+
+   std::vector <int> order(num);
+   std::vector <int> next(start.begin(), start.end() - 1);
+   for (int i = 0; i < num; i++)
+      order[next[shards.shardOf(hashes[i])]++] = i;
+
+   int numFound = 0;
+   for (int i = 0; i < numShards; i++)
+   {
+      if (start[i] == start[i + 1])
+         continue;
+      Shard & s = shards.shard(i);
+      std::shared_lock <std::shared_timed_mutex> hold(s.lock);
+      for (int j = start[i]; j < start[i + 1]; j++)
+      {
+         int k = order[j];
+         found[k] = s.table.find(items[k], hashes[k]);
+         numFound += found[k];
+      }
+   }
+   return numFound;
+}
+
+/**************************************************
+ * CONCURRENT HASH MAP
+ * The same shards, each a FlatTable of key-value
+ * pairs. Values go in and come out by copy under
+ * the shard's lock, for the same reason items do
+ *************************************************/
+template <class K, class V, class H = DefaultHasher <K> >
+class ConcurrentHashMap
+{
+public:
+   ConcurrentHashMap(int numShards = 64) throw (const char *) : shards(numShards) {}
+
+   // give key this value, inserting it if it is not here. True if
+   // it was inserted, false if an old value was replaced
+   bool insert_or_update(const K & key, const V & value) throw (const char *);
+
+   // call update(V & value) under the shard's lock, on the value for
+   // key if there is one, or on a new V() if not. True if inserted
+   template <class Update>
+   bool upsert(const K & key, Update update) throw (const char *);
+
+   // copy the value for key into value, if there is one
+   bool find(const K & key, V & value) const;
+   bool erase(const K & key);
+
+   int  size() const      { return shards.size();      }
+   bool empty() const     { return size() == 0;        }
+   void clear()           { shards.clear();            }
+   int  numShards() const { return shards.numShards(); }
+
+private:
+   typedef std::pair <K, V> Pair;
+   typedef FlatTable <Pair, K, KeyIsFirst, H> Table;
+   typedef typename ConcurrentShards <Table> :: Shard Shard;
+
+   // the slot for key in a locked shard, building a pair with
+   // value in it if there is none
+   static int claim(Shard & s, const K & key, size_t h, const V & value,
+                    bool & inserted) throw (const char *);
+
+   ConcurrentShards <Table> shards;
+   H hasher;
+};
+
+/**************************************************
+ * CONCURRENT HASH MAP CLAIM
+ *************************************************/
+template <class K, class V, class H>
+int ConcurrentHashMap<K, V, H>::claim(Shard & s, const K & key, size_t h, const V & value,
+                                      bool & inserted) throw (const char *)
+{
+   int i = s.table.claim(key, h, inserted);
+   if (inserted)
+   {
+      try
+      {
+         new (&s.table[i]) Pair(key, value);
+      }
+      catch (...)
+      {
+         s.table.unclaim(i);
+         throw "ERROR: unable to allocate memory for the hash";
+      }
+   }
+   return i;
+}
+
+/**************************************************
+ * CONCURRENT HASH MAP INSERT OR UPDATE and UPSERT
+ *************************************************/
+template <class K, class V, class H>
+bool ConcurrentHashMap<K, V, H>::insert_or_update(const K & key, const V & value) throw (const char *)
+{
+   size_t h = hasher(key);
+   Shard & s = shards.shardFor(h);
+   std::unique_lock <std::shared_timed_mutex> hold(s.lock);
+   bool inserted;
+   int i = claim(s, key, h, value, inserted);
+   if (!inserted)
+      s.table[i].second = value;
+   return inserted;
+}
+
+template <class K, class V, class H>
+template <class Update>
+bool ConcurrentHashMap<K, V, H>::upsert(const K & key, Update update) throw (const char *)
+{
+   size_t h = hasher(key);
+   Shard & s = shards.shardFor(h);
+   std::unique_lock <std::shared_timed_mutex> hold(s.lock);
+   bool inserted;
+   int i = claim(s, key, h, V(), inserted);
+   update(s.table[i].second);
+   return inserted;
+}
+
+/**************************************************
+ * CONCURRENT HASH MAP FIND and ERASE
+ *************************************************/
+template <class K, class V, class H>
+bool ConcurrentHashMap<K, V, H>::find(const K & key, V & value) const
+{
+   size_t h = hasher(key);
+   Shard & s = shards.shardFor(h);
+   std::shared_lock <std::shared_timed_mutex> hold(s.lock);
+   int i = s.table.find(key, h);
+   if (i < 0)
+      return false;
+   value = s.table[i].second;
+   return true;
+}
+
+template <class K, class V, class H>
+bool ConcurrentHashMap<K, V, H>::erase(const K & key)
+{
+   size_t h = hasher(key);
+   Shard & s = shards.shardFor(h);
+   std::unique_lock <std::shared_timed_mutex> hold(s.lock);
+   return s.table.erase(key, h);
+}
+
+#endif // CONCURRENT_HASH_H
@@ -0,0 +1,333 @@
+/***********************************************************************
+ * Program:
+ *    CONCURRENT HASH TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Runs ConcurrentHash through random inserts, erases and finds next
+ *    to a std::unordered_set, then has several threads count words
+ *    into one table with insert_or_update while others insert, erase
+ *    and look up keys of their own, and checks every count is exact.
+ *    ConcurrentHashMap gets the same: a run next to a std::map, then
+ *    threads counting with upsert and overwriting with
+ *    insert_or_update at once.
+ *    Build it with -fsanitize=thread ("make tsan") to have the races
+ *    checked too. Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT and ATOI
+#include <map>
+#include <random>          // for MT19937
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "concurrentHash.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * FUZZ
+ * One thread, so the table has to agree with the set after every step.
+ * Few shards and a small key range make shards grow and shrink often
+ ***********************************************************************/
+void fuzz(int numShards, int steps, unsigned seed)
+{
+   mt19937 random(seed);
+   ConcurrentHash <int> table(numShards);
+   unordered_set <int> expected;
+   CHECK(table.numShards() >= numShards);
+   CHECK(table.empty());
+
+   for (int step = 0; step < steps; step++)
+   {
+      int item = random() % 2000;
+      int choice = random() % 4;
+      if (choice < 2)
+      {
+         CHECK(table.insert(item) == expected.insert(item).second);
+      }
+      else if (choice == 2)
+      {
+         CHECK(table.erase(item) == (expected.erase(item) == 1));
+      }
+      else
+      {
+         CHECK(table.find(item) == (expected.count(item) == 1));
+      }
+      CHECK(table.size() == (int)expected.size());
+
+      // now and then, look every key up at once
+      if (step % 1000 == 0)
+      {
+         int items[2000];
+         bool found[2000];
+         for (int i = 0; i < 2000; i++)
+            items[i] = i;
+         CHECK(table.findMany(items, 2000, found) == (int)expected.size());
+         for (int i = 0; i < 2000; i++)
+            CHECK(found[i] == (expected.count(i) == 1));
+      }
+   }
+
+   table.clear();
+   CHECK(table.empty());
+   CHECK(!table.find(0));
+}
+
+/**********************************************************************
+ * WORD COUNT
+ * A word and how often it was seen. Only the word is compared and
+ * hashed, so insert_or_update may change the count
+ ***********************************************************************/
+struct WordCount
+{
+   string word;
+   long count;
+   bool operator == (const WordCount & rhs) const { return word == rhs.word; }
+};
+
+struct WordCountHasher
+{
+   size_t operator () (const WordCount & item) const
+   {
+      return hashBytes(item.word.data(), item.word.size());
+   }
+};
+
+/**********************************************************************
+ * COUNTING
+ * numCounters threads each count every one of NUM_WORDS words
+ * perThread / NUM_WORDS times, in an order of their own, while
+ * numChurners threads insert and erase words of their own and look up
+ * the counted ones. Every count must come out exactly right
+ ***********************************************************************/
+void counting(int numCounters, int numChurners, int perThread)
+{
+   const int NUM_WORDS = 1000;
+   ConcurrentHash <WordCount, WordCountHasher> table(16);
+   vector <thread> threads;
+
+   for (int t = 0; t < numCounters; t++)
+      threads.push_back(thread([&table, t, perThread]()
+      {
+         mt19937 random(t);
+         for (int i = 0; i < perThread; i++)
+         {
+            WordCount item = { "word" + to_string(random() % NUM_WORDS), 1 };
+            table.insert_or_update(item, [](WordCount & existing)
+            {
+               existing.count++;
+            });
+         }
+      }));
+
+   for (int t = 0; t < numChurners; t++)
+      threads.push_back(thread([&table, t, perThread]()
+      {
+         mt19937 random(100 + t);
+         for (int i = 0; i < perThread; i++)
+         {
+            WordCount mine = { "churn" + to_string(t) + "-" +
+                               to_string(random() % 50), 0 };
+            if (random() % 2)
+               table.insert(mine);
+            else
+               table.erase(mine);
+            WordCount counted = { "word" + to_string(random() % NUM_WORDS), 0 };
+            table.find(counted);
+         }
+         // leave nothing of this thread's behind
+         for (int i = 0; i < 50; i++)
+         {
+            WordCount mine = { "churn" + to_string(t) + "-" + to_string(i), 0 };
+            table.erase(mine);
+         }
+      }));
+
+   for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+
+   // the counts themselves, computed again on this thread
+   vector <long> expected(NUM_WORDS, 0);
+   for (int t = 0; t < numCounters; t++)
+   {
+      mt19937 random(t);
+      for (int i = 0; i < perThread; i++)
+         expected[random() % NUM_WORDS]++;
+   }
+
+   int numWords = 0;
+   for (int i = 0; i < NUM_WORDS; i++)
+   {
+      if (expected[i] == 0)
+         continue;
+      numWords++;
+      long count = -1;
+      WordCount probe = { "word" + to_string(i), 0 };
+      CHECK(!table.insert_or_update(probe, [&count](WordCount & existing)
+      {
+         count = existing.count;
+      }));
+      CHECK(count == expected[i]);
+   }
+   CHECK(table.size() == numWords);
+}
+
+/**********************************************************************
+ * MAP FUZZ
+ * The map on one thread, agreeing with a std::map after every step
+ ***********************************************************************/
+void mapFuzz(int numShards, int steps, unsigned seed)
+{
+   mt19937 random(seed);
+   ConcurrentHashMap <int, string> table(numShards);
+   map <int, string> expected;
+   CHECK(table.numShards() >= numShards);
+   CHECK(table.empty());
+
+   for (int step = 0; step < steps; step++)
+   {
+      int key = random() % 2000;
+      string value = to_string(step);
+      int choice = random() % 5;
+      string found;
+      if (choice < 2)
+      {
+         CHECK(table.insert_or_update(key, value) == (expected.count(key) == 0));
+         expected[key] = value;
+      }
+      else if (choice == 2)
+      {
+         CHECK(table.upsert(key, [](string & s) { s += "+"; }) ==
+               (expected.count(key) == 0));
+         expected[key] += "+";
+      }
+      else if (choice == 3)
+      {
+         CHECK(table.erase(key) == (expected.erase(key) == 1));
+      }
+      else if (expected.count(key))
+      {
+         CHECK(table.find(key, found));
+         CHECK(found == expected[key]);
+      }
+      else
+      {
+         found = "untouched";
+         CHECK(!table.find(key, found));
+         CHECK(found == "untouched");
+      }
+      CHECK(table.size() == (int)expected.size());
+   }
+
+   for (map <int, string> :: iterator it = expected.begin(); it != expected.end(); ++it)
+   {
+      string found;
+      CHECK(table.find(it->first, found));
+      CHECK(found == it->second);
+   }
+   table.clear();
+   CHECK(table.empty());
+   string found;
+   CHECK(!table.find(expected.begin()->first, found));
+}
+
+/**********************************************************************
+ * MAP COUNTING
+ * numCounters threads count NUM_WORDS words with upsert, as counting
+ * does, while numWriters threads keep overwriting keys of their own
+ * with insert_or_update, each ending on a value the test knows. Every
+ * count and every last value must come out exactly right
+ ***********************************************************************/
+void mapCounting(int numCounters, int numWriters, int perThread)
+{
+   const int NUM_WORDS = 1000;
+   ConcurrentHashMap <string, long> table(16);
+   vector <thread> threads;
+
+   for (int t = 0; t < numCounters; t++)
+      threads.push_back(thread([&table, t, perThread]()
+      {
+         mt19937 random(t);
+         for (int i = 0; i < perThread; i++)
+            table.upsert("word" + to_string(random() % NUM_WORDS),
+                         [](long & count) { count++; });
+      }));
+
+   for (int t = 0; t < numWriters; t++)
+      threads.push_back(thread([&table, t, perThread]()
+      {
+         mt19937 random(100 + t);
+         for (int i = 0; i < perThread; i++)
+         {
+            string mine = "mine" + to_string(t) + "-" + to_string(random() % 50);
+            table.insert_or_update(mine, (long)i);
+            long count;
+            table.find("word" + to_string(random() % NUM_WORDS), count);
+         }
+         for (int i = 0; i < 50; i++)
+            table.insert_or_update("mine" + to_string(t) + "-" + to_string(i),
+                                   (long)-i);
+      }));
+
+   for (size_t i = 0; i < threads.size(); i++)
+      threads[i].join();
+
+   vector <long> expected(NUM_WORDS, 0);
+   for (int t = 0; t < numCounters; t++)
+   {
+      mt19937 random(t);
+      for (int i = 0; i < perThread; i++)
+         expected[random() % NUM_WORDS]++;
+   }
+
+   int numWords = 0;
+   for (int i = 0; i < NUM_WORDS; i++)
+   {
+      long count = -1;
+      bool found = table.find("word" + to_string(i), count);
+      CHECK(found == (expected[i] != 0));
+      if (found)
+      {
+         numWords++;
+         CHECK(count == expected[i]);
+      }
+   }
+   for (int t = 0; t < numWriters; t++)
+      for (int i = 0; i < 50; i++)
+      {
+         long value = 1;
+         CHECK(table.find("mine" + to_string(t) + "-" + to_string(i), value));
+         CHECK(value == -i);
+      }
+   CHECK(table.size() == numWords + 50 * numWriters);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   // a smaller run is plenty under the thread sanitizer, which is slow
+   int perThread = argc > 1 ? atoi(argv[1]) : 200000;
+
+   fuzz(1, 20000, 1);
+   fuzz(4, 20000, 2);
+   fuzz(64, 20000, 3);
+   counting(8, 2, perThread);
+   counting(1, 7, perThread / 4);
+   mapFuzz(1, 20000, 4);
+   mapFuzz(64, 20000, 5);
+   mapCounting(6, 2, perThread);
+
+   cout << "ConcurrentHash tests passed\n";
+   return 0;
+}
@@ -0,0 +1,574 @@
+/***********************************************************************
+* Header:
+*    Filter
+* Author: Daniel Guzman
+* Summary:
+*    Approximate sets that answer "certainly not here" or "maybe here"
+*    from a few bytes per item, for putting in front of a hash table
+*    whose finds mostly miss:
+*       BloomFilter    each item sets eight bits of one 64-byte block,
+*                      so a lookup reads one cache line. Cannot erase
+*       CuckooFilter   each item leaves a small fingerprint in one of
+*                      two buckets of four. Can erase, and can fill up
+*    Both are sized from the number of items and the false positive
+*    rate wanted. Prefiltered puts either in front of a table.
+************************************************************************/
+
+#ifndef FILTER_H
+#define FILTER_H
+
+#include <cmath>         // for EXP, LOG and LGAMMA
+#include <cstddef>       // for SIZE_T
+#include <cstring>       // for MEMSET and MEMCPY
+#include <new>           // for BAD_ALLOC
+#include "hasher.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/**************************************************
+ * BLOOM FILTER
+ * A split block Bloom filter. The top half of the
+ * hash picks a block of eight 64-bit lanes, and
+ * the bottom half, multiplied out to 64 bits,
+ * gives eight 6-bit fields that pick one bit in
+ * each lane. The number of blocks is the fewest
+ * that give the rate asked for
+ *************************************************/
+template <class T, class H = DefaultHasher <T> >
+class BloomFilter
+{
+public:
+   BloomFilter(int numItems, double falsePositiveRate = 0.01) throw (const char *);
+   BloomFilter(const BloomFilter <T, H> & rhs) throw (const char *);
+   ~BloomFilter() { ::operator delete(allocated); }
+   BloomFilter <T, H> & operator = (const BloomFilter <T, H> & rhs) throw (const char *);
+
+   // always true: a Bloom filter never fills, it only gets less sure
+   bool insert(const T & item) { insertHash(hasher(item)); return true; }
+   bool contains(const T & item) const { return containsHash(hasher(item)); }
+   void clear() { memset(blocks, 0, numBlocks * BLOCK); numItems = 0; }
+
+   void insertHash(size_t h);
+   bool containsHash(size_t h) const;
+
+   int    size()   const { return numItems;                   }
+   size_t memory() const { return (size_t)numBlocks * BLOCK;  }
+
+   // expected for the number of items it was built for
+   double falsePositiveRate() const { return expectedRate; }
+
+private:
+   static const int BLOCK = 64;     // bytes, one cache line
+   static const int LANES = 8;
+
+   void allocate(size_t bytes) throw (const char *);
+   static double blockRate(double itemsPerBlock);
+
+   unsigned long long * block(size_t h) const
+   {
+      size_t i = (size_t)(((unsigned long long)(h >> 32) * numBlocks) >> 32);
+      return blocks + i * LANES;
+   }
+
+   char * allocated;
+   unsigned long long * blocks;     // aligned to a cache line
+   unsigned int numBlocks;
+   int numItems;
+   double expectedRate;
+   H hasher;
+};
+
+/**************************************************
+ * BLOOM FILTER BLOCK RATE
+ * The chance an item not in the filter passes,
+ * when the blocks hold itemsPerBlock on average.
+ * Items land in blocks Poisson-distributed, and a
+ * block holding i has each of its eight lane bits
+ * set with probability 1 - (63/64)^i
+ *************************************************/
+template <class T, class H>
+double BloomFilter<T, H>::blockRate(double itemsPerBlock)
+{
+   if (itemsPerBlock <= 0.0)
+      return 0.0;
+
+   double rate = 0.0;
+   int most = (int)(itemsPerBlock + 12.0 * sqrt(itemsPerBlock)) + 30;
+   for (int i = 1; i <= most; i++)
+   {
+      double poisson = exp(i * log(itemsPerBlock) - itemsPerBlock - lgamma(i + 1.0));
+      rate += poisson * pow(1.0 - pow(63.0 / 64.0, i), LANES);
+   }
+   return rate;
+}
+
+/**************************************************
+ * BLOOM FILTER CONSTRUCTOR
+ * Double the blocks until the rate is low enough,
+ * then search back down for the fewest that do
+ *************************************************/
+template <class T, class H>
+BloomFilter<T, H>::BloomFilter(int numItems, double falsePositiveRate) throw (const char *) :
+   allocated(NULL), blocks(NULL), numBlocks(1), numItems(0)
+{
+   if (!(falsePositiveRate > 0.0 && falsePositiveRate < 1.0))
+      throw "ERROR: the false positive rate must be between 0 and 1";
+
+   if (numItems > 0)
+   {
+      unsigned int low = 1;
+      unsigned int high = (numItems + 63) / 64;
+      while (blockRate((double)numItems / high) > falsePositiveRate)
+      {
+         if (high > 0x7fffffffU)
+            throw "ERROR: the false positive rate is too low";
+         low = high;
+         high *= 2;
+      }
+      while (low < high)
+      {
+         unsigned int middle = low + (high - low) / 2;
+         if (blockRate((double)numItems / middle) > falsePositiveRate)
+            low = middle + 1;
+         else
+            high = middle;
+      }
+      numBlocks = high;
+   }
+   expectedRate = blockRate((double)numItems / numBlocks);
+
+   allocate((size_t)numBlocks * BLOCK);
+   memset(blocks, 0, (size_t)numBlocks * BLOCK);
+}
+
+/**************************************************
+ * BLOOM FILTER COPY
+ *************************************************/
+template <class T, class H>
+BloomFilter<T, H>::BloomFilter(const BloomFilter <T, H> & rhs) throw (const char *) :
+   allocated(NULL), blocks(NULL), numBlocks(0), numItems(0)
+{
+   *this = rhs;
+}
+
+template <class T, class H>
+BloomFilter <T, H> & BloomFilter<T, H>::operator = (const BloomFilter <T, H> & rhs) throw (const char *)
+{
+   if (this == &rhs)
+      return *this;
+
+   if (numBlocks != rhs.numBlocks)
+   {
+      ::operator delete(allocated);
+      allocated = NULL;
+      allocate((size_t)rhs.numBlocks * BLOCK);
+      numBlocks = rhs.numBlocks;
+   }
+   memcpy(blocks, rhs.blocks, (size_t)numBlocks * BLOCK);
+   numItems = rhs.numItems;
+   expectedRate = rhs.expectedRate;
+   hasher = rhs.hasher;
+   return *this;
+}
+
+/**************************************************
+ * BLOOM FILTER ALLOCATE
+ * One cache line extra, to start on a boundary
+ *************************************************/
+template <class T, class H>
+void BloomFilter<T, H>::allocate(size_t bytes) throw (const char *)
+{
+   try
+   {
+      allocated = static_cast <char *> (::operator new(bytes + BLOCK));
+   }
+   catch (std::bad_alloc)
+   {
+      throw "ERROR: unable to allocate memory for the filter";
+   }
+   blocks = (unsigned long long *)(allocated + (BLOCK - (size_t)allocated % BLOCK) % BLOCK);
+}
+
+/**************************************************
+ * BLOOM FILTER INSERT and CONTAINS
+ * With AVX2 (-mavx2) the block is tested four lanes
+ * at a time; otherwise all eight lanes are tested
+ * without a branch, written out so that -O2 does
+ * not leave it a loop
+ *************************************************/
+template <class T, class H>
+void BloomFilter<T, H>::insertHash(size_t h)
+{
+   unsigned long long bits = (unsigned long long)(unsigned int)h * 0x9e3779b97f4a7c15ULL;
+   unsigned long long * lanes = block(h);
+   for (int i = 0; i < LANES; i++)
+      lanes[i] |= 1ULL << ((bits >> (16 + 6 * i)) & 63);
+   numItems++;
+}
+
+template <class T, class H>
+bool BloomFilter<T, H>::containsHash(size_t h) const
+{
+   unsigned long long bits = (unsigned long long)(unsigned int)h * 0x9e3779b97f4a7c15ULL;
+   const unsigned long long * lanes = block(h);
+#ifdef __AVX2__
+   const __m256i one = _mm256_set1_epi64x(1);
+   const __m256i sixtyThree = _mm256_set1_epi64x(63);
+   __m256i all = _mm256_set1_epi64x(bits);
+   __m256i low  = _mm256_and_si256(_mm256_srlv_epi64(all, _mm256_setr_epi64x(16, 22, 28, 34)), sixtyThree);
+   __m256i high = _mm256_and_si256(_mm256_srlv_epi64(all, _mm256_setr_epi64x(40, 46, 52, 58)), sixtyThree);
+   return _mm256_testc_si256(_mm256_load_si256((const __m256i *)lanes), _mm256_sllv_epi64(one, low)) &
+          _mm256_testc_si256(_mm256_load_si256((const __m256i *)(lanes + 4)), _mm256_sllv_epi64(one, high));
+#else
+   return ((~lanes[0] & (1ULL << ((bits >> 16) & 63))) |
+           (~lanes[1] & (1ULL << ((bits >> 22) & 63))) |
+           (~lanes[2] & (1ULL << ((bits >> 28) & 63))) |
+           (~lanes[3] & (1ULL << ((bits >> 34) & 63))) |
+           (~lanes[4] & (1ULL << ((bits >> 40) & 63))) |
+           (~lanes[5] & (1ULL << ((bits >> 46) & 63))) |
+           (~lanes[6] & (1ULL << ((bits >> 52) & 63))) |
+           (~lanes[7] & (1ULL << ((bits >> 58) & 63)))) == 0;
+#endif
+}
+
+/**************************************************
+ * CUCKOO FILTER
+ * Buckets of four fingerprints, enough of them to
+ * be 95% full at numItems. An item may be in
+ * bucket i or in g(f) - i, mod the number of
+ * buckets, where g hashes its fingerprint f, so
+ * either bucket leads to the other without the
+ * item. The fingerprint is as many
+ * bits of F as the rate needs, and 0 marks an
+ * empty slot. Inserting the same item twice stores
+ * it twice, and it takes two erases to go.
+ *************************************************/
+template <class T, class F = unsigned short, class H = DefaultHasher <T> >
+class CuckooFilter
+{
+public:
+   CuckooFilter(int numItems, double falsePositiveRate = 0.001) throw (const char *);
+   CuckooFilter(const CuckooFilter <T, F, H> & rhs) throw (const char *);
+   ~CuckooFilter() { delete [] table; }
+   CuckooFilter <T, F, H> & operator = (const CuckooFilter <T, F, H> & rhs) throw (const char *);
+
+   // false when the filter is too full to take the item. It is still
+   // remembered, kept aside, so nothing ever goes missing, but nothing
+   // more will fit until something is erased
+   bool insert(const T & item) { return insertHash(hasher(item)); }
+   bool contains(const T & item) const { return containsHash(hasher(item)); }
+   bool erase(const T & item) { return eraseHash(hasher(item)); }
+   void clear();
+
+   bool insertHash(size_t h);
+   bool containsHash(size_t h) const;
+   bool eraseHash(size_t h);
+
+   int    size()     const { return numItems;                   }
+   int    capacity() const { return numBuckets * SLOTS;         }
+   size_t memory()   const { return sizeof(F) * numBuckets * SLOTS; }
+
+   // at full load: two buckets of four, each slot matching 1 in 2^bits
+   double falsePositiveRate() const { return 2.0 * SLOTS / (1 << fingerprintBits); }
+
+private:
+   static const int SLOTS = 4;
+   static const int MAX_KICKS = 500;
+
+   // mixed again, so it owes nothing to the bits that chose the bucket
+   F fingerprint(size_t h) const
+   {
+      F f = (F)(hashMix(h) & fingerprintMask);
+      return f ? f : 1;
+   }
+   int firstBucket(size_t h) const
+   {
+      return (int)(((unsigned long long)(h >> 32) * numBuckets) >> 32);
+   }
+   int otherBucket(int bucket, F f) const
+   {
+      unsigned int g = (unsigned int)f * 0x5bd1e995U;
+      int other = (int)(((unsigned long long)g * numBuckets) >> 32) - bucket;
+      return other < 0 ? other + numBuckets : other;
+   }
+   bool has(int bucket, F f) const;
+   bool add(int bucket, F f);
+   bool remove(int bucket, F f);
+   bool place(int bucket, F f);
+
+   F * table;            // numBuckets * SLOTS fingerprints
+   int numBuckets;
+   int fingerprintBits;
+   F fingerprintMask;
+   int numItems;
+   F victim;             // the one left over when an insert failed
+   int victimBucket;
+   unsigned int random;  // picks which fingerprint to kick out
+   H hasher;
+};
+
+/**************************************************
+ * CUCKOO FILTER CONSTRUCTOR
+ * A false positive needs one of eight slots to
+ * match, so the rate is about 8 / 2^bits
+ *************************************************/
+template <class T, class F, class H>
+CuckooFilter<T, F, H>::CuckooFilter(int numItems, double falsePositiveRate) throw (const char *) :
+   table(NULL), numItems(0), victim(0), victimBucket(0), random(0x9e3779b9U)
+{
+   if (!(falsePositiveRate > 0.0 && falsePositiveRate < 1.0))
+      throw "ERROR: the false positive rate must be between 0 and 1";
+
+   fingerprintBits = 1;
+   while ((double)2.0 * SLOTS / (1 << fingerprintBits) > falsePositiveRate)
+      if (++fingerprintBits > (int)sizeof(F) * 8 || fingerprintBits > 30)
+         throw "ERROR: the fingerprint type is too small for that false positive rate";
+   fingerprintMask = (F)((1ULL << fingerprintBits) - 1);
+
+   numBuckets = (int)(numItems / (SLOTS * 0.95)) + 1;
+
+   try
+   {
+      table = new F[numBuckets * SLOTS];
+   }
+   catch (std::bad_alloc)
+   {
+      throw "ERROR: unable to allocate memory for the filter";
+   }
+   memset(table, 0, sizeof(F) * numBuckets * SLOTS);
+}
+
+/**************************************************
+ * CUCKOO FILTER COPY
+ *************************************************/
+template <class T, class F, class H>
+CuckooFilter<T, F, H>::CuckooFilter(const CuckooFilter <T, F, H> & rhs) throw (const char *) :
+   table(NULL), numBuckets(0)
+{
+   *this = rhs;
+}
+
+template <class T, class F, class H>
+CuckooFilter <T, F, H> & CuckooFilter<T, F, H>::operator = (const CuckooFilter <T, F, H> & rhs) throw (const char *)
+{
+   if (this == &rhs)
+      return *this;
+
+   if (numBuckets != rhs.numBuckets)
+   {
+      delete [] table;
+      table = NULL;
+      try
+      {
+         table = new F[rhs.numBuckets * SLOTS];
+      }
+      catch (std::bad_alloc)
+      {
+         throw "ERROR: unable to allocate memory for the filter";
+      }
+   }
+   memcpy(table, rhs.table, sizeof(F) * rhs.numBuckets * SLOTS);
+   numBuckets      = rhs.numBuckets;
+   fingerprintBits = rhs.fingerprintBits;
+   fingerprintMask = rhs.fingerprintMask;
+   numItems        = rhs.numItems;
+   victim          = rhs.victim;
+   victimBucket    = rhs.victimBucket;
+   random          = rhs.random;
+   hasher          = rhs.hasher;
+   return *this;
+}
+
+/**************************************************
+ * CUCKOO FILTER CLEAR
+ *************************************************/
+template <class T, class F, class H>
+void CuckooFilter<T, F, H>::clear()
+{
+   memset(table, 0, sizeof(F) * numBuckets * SLOTS);
+   numItems = 0;
+   victim = 0;
+}
+
+/**************************************************
+ * CUCKOO FILTER HAS, ADD and REMOVE
+ * On one bucket
+ *************************************************/
+template <class T, class F, class H>
+inline bool CuckooFilter<T, F, H>::has(int bucket, F f) const
+{
+   const F * slots = table + bucket * SLOTS;
+   return (slots[0] == f) | (slots[1] == f) | (slots[2] == f) | (slots[3] == f);
+}
+
+template <class T, class F, class H>
+bool CuckooFilter<T, F, H>::add(int bucket, F f)
+{
+   F * slots = table + bucket * SLOTS;
+   for (int i = 0; i < SLOTS; i++)
+      if (slots[i] == 0)
+      {
+         slots[i] = f;
+         return true;
+      }
+   return false;
+}
+
+template <class T, class F, class H>
+bool CuckooFilter<T, F, H>::remove(int bucket, F f)
+{
+   F * slots = table + bucket * SLOTS;
+   for (int i = 0; i < SLOTS; i++)
+      if (slots[i] == f)
+      {
+         slots[i] = 0;
+         return true;
+      }
+   return false;
+}
+
+/**************************************************
+ * CUCKOO FILTER INSERT
+ * The insert that leaves a fingerprint kept aside
+ * is the one that reports the filter full
+ *************************************************/
+template <class T, class F, class H>
+bool CuckooFilter<T, F, H>::insertHash(size_t h)
+{
+   if (victim)
+      return false;
+   numItems++;
+   return place(firstBucket(h), fingerprint(h));
+}
+
+/**************************************************
+ * CUCKOO FILTER PLACE
+ * If both buckets are full, kick a fingerprint
+ * out of one to its other bucket, and so on.
+ * After MAX_KICKS the one in hand is kept aside
+ * and place() returns false
+ *************************************************/
+template <class T, class F, class H>
+bool CuckooFilter<T, F, H>::place(int bucket, F f)
+{
+   int other = otherBucket(bucket, f);
+   if (add(bucket, f) || add(other, f))
+      return true;
+
+   bucket = (random & 1) ? bucket : other;
+   for (int kick = 0; kick < MAX_KICKS; kick++)
+   {
+      random ^= random << 13;
+      random ^= random >> 17;
+      random ^= random << 5;
+      F & slot = table[bucket * SLOTS + random % SLOTS];
+      F evicted = slot;
+      slot = f;
+      f = evicted;
+      bucket = otherBucket(bucket, f);
+      if (add(bucket, f))
+         return true;
+   }
+
+   victim = f;
+   victimBucket = bucket;
+   return false;
+}
+
+/**************************************************
+ * CUCKOO FILTER CONTAINS
+ *************************************************/
+template <class T, class F, class H>
+bool CuckooFilter<T, F, H>::containsHash(size_t h) const
+{
+   F f = fingerprint(h);
+   int bucket = firstBucket(h);
+   int other = otherBucket(bucket, f);
+   return has(bucket, f) | has(other, f) |
+          (victim == f && (victimBucket == bucket || victimBucket == other));
+}
+
+/**************************************************
+ * CUCKOO FILTER ERASE
+ * Only erase what was inserted: erasing anything
+ * else may take out another item's fingerprint.
+ * A freed slot makes room for the victim
+ *************************************************/
+template <class T, class F, class H>
+bool CuckooFilter<T, F, H>::eraseHash(size_t h)
+{
+   F f = fingerprint(h);
+   int bucket = firstBucket(h);
+   int other = otherBucket(bucket, f);
+
+   if (victim == f && (victimBucket == bucket || victimBucket == other))
+      victim = 0;
+   else if (!remove(bucket, f) && !remove(other, f))
+      return false;
+   numItems--;
+
+   if (victim)
+   {
+      F left = victim;
+      victim = 0;
+      place(victimBucket, left);
+   }
+   return true;
+}
+
+/**************************************************
+ * PREFILTERED
+ * A table with a filter in front of it: a find the
+ * filter rules out never reaches the table. Items
+ * must all go in through here, and the table must
+ * start empty. Only items new to the table go in
+ * the filter, so repeats do not fill it. If the
+ * filter ever fills, every find goes to the table
+ * from then on.
+ *************************************************/
+template <class T, class Filter, class Table>
+class Prefiltered
+{
+public:
+   Prefiltered(Table & table, int numItems, double falsePositiveRate) throw (const char *) :
+      table(table), filter(numItems, falsePositiveRate), trusted(true) {}
+
+   // true if the item was not here before. When the filter rules it
+   // out, it is new without asking the table
+   bool insert(const T & item)
+   {
+      if ((!trusted || filter.contains(item)) && table.find(item))
+         return false;
+      table.insert(item);
+      if (!filter.insert(item))
+         trusted = false;
+      return true;
+   }
+
+   bool find(const T & item)
+   {
+      if (trusted && !filter.contains(item))
+         return false;
+      return table.find(item);
+   }
+
+   // for filters and tables that can
+   bool erase(const T & item)
+   {
+      if (!table.erase(item))
+         return false;
+      filter.erase(item);
+      return true;
+   }
+
+   const Filter & getFilter() const { return filter; }
+   bool filtering() const { return trusted; }
+
+private:
+   Table & table;
+   Filter filter;
+   bool trusted;
+};
+
+#endif // FILTER_H
@@ -0,0 +1,246 @@
+/***********************************************************************
+ * Program:
+ *    FILTER TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks that BloomFilter and CuckooFilter never forget an item,
+ *    that their false positive rates are about what they promise, that
+ *    CuckooFilter erases like a multiset and reports itself full on the
+ *    insert that fills it, and that Prefiltered agrees with its table
+ *    and does not fill its filter with repeats. BloomFilter's
+ *    containsHash is also checked bit for bit against the layout it
+ *    documents. Built once as it is and once with -mavx2, for the
+ *    AVX2 containsHash. Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT
+#include <random>          // for MT19937_64
+#include <set>
+#include <string>
+#include <vector>
+#include "filter.h"
+#include "flatHash.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * RATES
+ * n items in, then n others looked for. None of the items may be
+ * missed, and the others may pass no more than about as often as the
+ * filter expects: 1.5 times, plus some slack for chance
+ ***********************************************************************/
+template <class Filter>
+void rates(Filter & filter, int n, unsigned seed)
+{
+   mt19937_64 random(seed);
+   vector <unsigned long long> items(n);
+   for (int i = 0; i < n; i++)
+   {
+      items[i] = random() | 1;           // the others are even
+      CHECK(filter.insert(items[i]));
+   }
+   for (int i = 0; i < n; i++)
+      CHECK(filter.contains(items[i]));
+
+   int numPassed = 0;
+   for (int i = 0; i < n; i++)
+      numPassed += filter.contains(random() & ~1ULL);
+   double expected = filter.falsePositiveRate();
+   CHECK(numPassed <= 1.5 * expected * n + 20);
+}
+
+void bloomRates()
+{
+   const double wanted[] = { 0.05, 0.01, 0.001 };
+   for (int i = 0; i < 3; i++)
+   {
+      BloomFilter <unsigned long long> filter(200000, wanted[i]);
+      CHECK(filter.falsePositiveRate() <= wanted[i]);
+      rates(filter, 200000, i);
+   }
+   BloomFilter <unsigned long long> tiny(1, 0.01);
+   rates(tiny, 1, 3);
+}
+
+void cuckooRates()
+{
+   CuckooFilter <unsigned long long, unsigned char> small(200000, 0.05);
+   CHECK(small.falsePositiveRate() <= 0.05);
+   rates(small, 200000, 4);
+   CuckooFilter <unsigned long long> large(200000, 0.001);
+   CHECK(large.falsePositiveRate() <= 0.001);
+   rates(large, 200000, 5);
+}
+
+/**********************************************************************
+ * BLOOM EXACT
+ * The blocks and lanes kept again here, as the filter's comments
+ * describe them, for a few sizes from a single block up. containsHash
+ * must agree exactly with them on hashes in and out of the filter,
+ * whichever way it tests the lanes
+ ***********************************************************************/
+void bloomExact()
+{
+   const int sizes[] = { 1, 50, 5000 };
+   for (int s = 0; s < 3; s++)
+   {
+      BloomFilter <unsigned long long> filter(sizes[s], 0.01);
+      unsigned long long numBlocks = filter.memory() / 64;
+      vector <unsigned long long> lanes(numBlocks * 8, 0);
+      mt19937_64 random(s);
+      for (int round = 0; round < 4 * sizes[s]; round++)
+      {
+         size_t h = random();
+         unsigned long long bits = (unsigned long long)(unsigned int)h * 0x9e3779b97f4a7c15ULL;
+         unsigned long long * block = &lanes[((h >> 32) * numBlocks >> 32) * 8];
+         bool expected = true;
+         for (int i = 0; i < 8; i++)
+            if (!(block[i] & 1ULL << ((bits >> (16 + 6 * i)) & 63)))
+               expected = false;
+         CHECK(filter.containsHash(h) == expected);
+
+         // put in every other one, so later ones can find them
+         if (round % 2)
+         {
+            filter.insertHash(h);
+            for (int i = 0; i < 8; i++)
+               block[i] |= 1ULL << ((bits >> (16 + 6 * i)) & 63);
+            CHECK(filter.containsHash(h));
+         }
+      }
+   }
+}
+
+/**********************************************************************
+ * CUCKOO FILL
+ * Insert until the filter says it is full. That insert and every one
+ * before it must still be found, every later one refused, and erasing
+ * some makes room again
+ ***********************************************************************/
+void cuckooFill()
+{
+   CuckooFilter <int> filter(1000, 0.001);
+   int n = 0;
+   while (filter.insert(n))
+      n++;
+   int last = n;                         // the one kept aside
+   CHECK(n >= filter.capacity() * 9 / 10);
+   CHECK(filter.size() == n + 1);
+   for (int i = 0; i <= last; i++)
+      CHECK(filter.contains(i));
+
+   CHECK(!filter.insert(last + 1));
+   CHECK(filter.size() == last + 1);
+
+   // the one kept aside goes back in once there is room for it
+   for (int i = 0; i < 100; i++)
+      CHECK(filter.erase(i));
+   CHECK(filter.insert(last + 1));
+   CHECK(filter.size() == last + 2 - 100);
+   for (int i = 100; i <= last + 1; i++)
+      CHECK(filter.contains(i));
+}
+
+/**********************************************************************
+ * CUCKOO ERASE
+ * Random inserts and erases next to a multiset, small enough that the
+ * filter is often full. Everything in the multiset must be found. The
+ * sizes must agree
+ ***********************************************************************/
+void cuckooErase()
+{
+   mt19937_64 random(6);
+   CuckooFilter <int> filter(200, 0.001);
+   multiset <int> expected;
+   for (int step = 0; step < 200000; step++)
+   {
+      int item = random() % 300;
+      if (random() % 2)
+      {
+         bool inserted = filter.insert(item);
+         // a refused insert left nothing behind, unless it was the one
+         // that filled the filter
+         if (inserted || filter.size() > (int)expected.size())
+            expected.insert(item);
+      }
+      else if (expected.count(item))
+      {
+         CHECK(filter.erase(item));
+         expected.erase(expected.find(item));
+      }
+      CHECK(filter.size() == (int)expected.size());
+      if (step % 1000 == 0)
+         for (multiset <int> :: iterator it = expected.begin(); it != expected.end(); ++it)
+            CHECK(filter.contains(*it));
+   }
+}
+
+/**********************************************************************
+ * PREFILTERED REPEATS
+ * The same few items over and over must not fill a cuckoo filter
+ * sized for them, and finds and erases must agree with the table
+ ***********************************************************************/
+void prefilteredRepeats()
+{
+   FlatHash <string> table;
+   Prefiltered <string, CuckooFilter <string>, FlatHash <string> > both(table, 100, 0.001);
+   for (int round = 0; round < 1000; round++)
+      for (int i = 0; i < 100; i++)
+         CHECK(both.insert("word" + to_string(i)) == (round == 0));
+   CHECK(both.filtering());
+   CHECK(both.getFilter().size() == 100);
+   CHECK(table.size() == 100);
+
+   for (int i = 0; i < 200; i++)
+      CHECK(both.find("word" + to_string(i)) == (i < 100));
+   for (int i = 0; i < 100; i += 2)
+      CHECK(both.erase("word" + to_string(i)));
+   CHECK(!both.erase("word0"));
+   for (int i = 0; i < 100; i++)
+      CHECK(both.find("word" + to_string(i)) == (i % 2 == 1));
+   CHECK(both.getFilter().size() == 50);
+}
+
+/**********************************************************************
+ * PREFILTERED FULL
+ * Once the filter fills, finds go to the table, so nothing goes
+ * missing however many items there are
+ ***********************************************************************/
+void prefilteredFull()
+{
+   FlatHash <int> table;
+   Prefiltered <int, CuckooFilter <int>, FlatHash <int> > both(table, 100, 0.001);
+   for (int i = 0; i < 10000; i++)
+      CHECK(both.insert(i));
+   CHECK(!both.filtering());
+   for (int i = 0; i < 20000; i++)
+      CHECK(both.find(i) == (i < 10000));
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   bloomRates();
+   bloomExact();
+   cuckooRates();
+   cuckooFill();
+   cuckooErase();
+   prefilteredRepeats();
+   prefilteredFull();
+#ifdef __AVX2__
+   cout << "Filter tests passed, with AVX2\n";
+#else
+   cout << "Filter tests passed\n";
+#endif
+   return 0;
+}
@@ -0,0 +1,136 @@
+/***********************************************************************
+* Header:
+*    Flat Hash
+* Author: Daniel Guzman
+* Summary:
+*    An open-addressing hash set in the style of Google's SwissTable.
+*    Items live directly in one array of slots, next to an array of one
+*    control byte per slot: EMPTY, or seven bits of the item's hash.
+*    A lookup loads the sixteen control bytes starting at the item's
+*    home slot and compares them all at once with SSE2, so most hits
+*    and misses touch one cache line of control bytes and at most one
+*    slot, instead of chasing a linked list. The table itself is a
+*    FlatTable, shared with HashMap.
+************************************************************************/
+
+#ifndef FLAT_HASH_H
+#define FLAT_HASH_H
+
+#include <cstddef>       // for SIZE_T
+#include <new>           // for PLACEMENT NEW
+#include "flatTable.h"
+
+/**************************************************
+ * FLAT HASH
+ * Each slot is an item, and the item is its own
+ * key
+ *************************************************/
+template <class T, class H = DefaultHasher <T> >
+class FlatHash
+{
+public:
+   FlatHash() throw (const char *) {}
+   FlatHash(int numItems) throw (const char *) : table(numItems) {}
+
+   void insert(const T & item) throw (const char *);
+   bool find(const T & item) const;
+   bool erase(const T & item);
+   void clear() { table.clear(); }
+
+   // the same, for callers that already know hashFunction()(item)
+   void insert(const T & item, size_t h) throw (const char *);
+   bool find(const T & item, size_t h) const;
+   bool erase(const T & item, size_t h);
+
+   // the item equal to this one, inserting a copy first if there is
+   // none. The reference lasts until the next insert or erase
+   T & findOrInsert(const T & item, size_t h, bool & inserted) throw (const char *);
+
+   const H & hashFunction() const { return table.hashFunction(); }
+
+   // start loading where a find for this hash will look first, so a
+   // batch of finds waits on memory once instead of once each
+   void prefetch(size_t h) const { table.prefetch(h); }
+
+   int  size()     const { return table.size();     }
+   int  capacity() const { return table.capacity(); }
+   bool empty()    const { return table.empty();    }
+
+   // a look at every slot; it rehashes every item, so not for a loop
+   HashStats stats() const { return table.stats(); }
+
+private:
+   FlatTable <T, T, KeyIsSlot, H> table;
+};
+
+/**************************************************
+ * FLAT HASH INSERT
+ * Duplicates are ignored
+ *************************************************/
+template <class T, class H>
+void FlatHash<T, H>::insert(const T & item) throw (const char *)
+{
+   insert(item, hashFunction()(item));
+}
+
+template <class T, class H>
+void FlatHash<T, H>::insert(const T & item, size_t h) throw (const char *)
+{
+   bool inserted;
+   findOrInsert(item, h, inserted);
+}
+
+/**************************************************
+ * FLAT HASH FIND OR INSERT
+ * One probe when the item is already here
+ *************************************************/
+template <class T, class H>
+T & FlatHash<T, H>::findOrInsert(const T & item, size_t h, bool & inserted) throw (const char *)
+{
+   int i = table.claim(item, h, inserted);
+   if (inserted)
+   {
+      try
+      {
+         new (&table[i]) T(item);
+      }
+      catch (...)
+      {
+         table.unclaim(i);
+         throw;
+      }
+   }
+   return table[i];
+}
+
+/**************************************************
+ * FLAT HASH FIND
+ *************************************************/
+template <class T, class H>
+bool FlatHash<T, H>::find(const T & item) const
+{
+   return table.find(item, hashFunction()(item)) >= 0;
+}
+
+template <class T, class H>
+bool FlatHash<T, H>::find(const T & item, size_t h) const
+{
+   return table.find(item, h) >= 0;
+}
+
+/**************************************************
+ * FLAT HASH ERASE
+ *************************************************/
+template <class T, class H>
+bool FlatHash<T, H>::erase(const T & item)
+{
+   return table.erase(item, hashFunction()(item));
+}
+
+template <class T, class H>
+bool FlatHash<T, H>::erase(const T & item, size_t h)
+{
+   return table.erase(item, h);
+}
+
+#endif // FLAT_HASH_H
@@ -0,0 +1,466 @@
+/***********************************************************************
+* Header:
+*    Flat Table
+* Author: Daniel Guzman
+* Summary:
+*    The open-addressing table under FlatHash and HashMap, in the style
+*    of Google's SwissTable. Slots live directly in one array, next to
+*    an array of one control byte per slot: EMPTY, or seven bits of the
+*    hash of the slot's key. A lookup loads the sixteen control bytes
+*    starting at the key's home slot and compares them all at once with
+*    SSE2, so most hits and misses touch one cache line of control bytes
+*    and at most one slot, instead of chasing a linked list.
+*
+*    A set keeps its items in the slots and a map its key-value pairs;
+*    KeyOf is how the table finds the key in a slot.
+************************************************************************/
+
+#ifndef FLAT_TABLE_H
+#define FLAT_TABLE_H
+
+#include <cstddef>       // for SIZE_T
+#include <cstring>       // for MEMSET
+#include <new>           // for PLACEMENT NEW
+#include <utility>       // for MOVE
+#include "hasher.h"
+#include "hashStats.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**************************************************
+ * KEY IS SLOT and KEY IS FIRST
+ * Where the key is: the whole slot, in a set, or
+ * the first of the pair, in a map
+ *************************************************/
+struct KeyIsSlot
+{
+   template <class T>
+   const T & operator () (const T & slot) const { return slot; }
+};
+
+struct KeyIsFirst
+{
+   template <class P>
+   const typename P::first_type & operator () (const P & slot) const { return slot.first; }
+};
+
+/**************************************************
+ * FLAT TABLE
+ * Capacity is always a power of two, at least one
+ * group, and the table doubles before it is more
+ * than 7/8 full. Probing is linear from the home
+ * slot, a group of sixteen at a time; the first
+ * sixteen control bytes are repeated past the end
+ * so a group can start at any slot. Erasing shifts
+ * later slots of the same run back a place, so no
+ * tombstones are ever left behind. Growing and
+ * erasing move slots, so an index into the table
+ * lasts only until the next claim or erase
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+class FlatTable
+{
+public:
+   FlatTable(int numItems = 0) throw (const char *);
+   FlatTable(const FlatTable & rhs) throw (const char *);
+   ~FlatTable();
+   FlatTable & operator = (const FlatTable & rhs) throw (const char *);
+
+   // the slot holding key, or -1
+   int find(const Key & key, size_t h) const;
+
+   // the slot holding key, or, setting inserted, an empty one marked
+   // full for the caller to build the slot in. If building it throws,
+   // the caller must unclaim() it before anything else
+   int claim(const Key & key, size_t h, bool & inserted) throw (const char *);
+   void unclaim(int i);
+
+   bool erase(const Key & key, size_t h);
+   void clear();
+
+   Slot &       operator [] (int i)       { return slots[i]; }
+   const Slot & operator [] (int i) const { return slots[i]; }
+
+   // the first full slot at or after i, or capacity()
+   int next(int i) const
+   {
+      while (i < numSlots && control[i] == EMPTY)
+         i++;
+      return i;
+   }
+
+   // start loading where a find for this hash will look first
+   void prefetch(size_t h) const
+   {
+      __builtin_prefetch(control + home(h));
+      __builtin_prefetch(slots + home(h));
+   }
+
+   const H & hashFunction() const { return hasher; }
+   int  size()     const { return numItems;      }
+   int  capacity() const { return numSlots;      }
+   bool empty()    const { return numItems == 0; }
+
+   // a look at every slot; it rehashes every key, so not for a loop
+   HashStats stats() const;
+
+private:
+   static const int GROUP = 16;
+   static const unsigned char EMPTY = 0x80;
+
+   void allocate(int slots) throw (const char *);
+   void release();
+   void grow() throw (const char *);
+   void setControl(int i, unsigned char c);
+   int  emptySlot(size_t h) const;
+   size_t hashOf(const Slot & slot) const { return hasher(keyOf(slot)); }
+
+   int home(size_t h)                const { return (int)(h >> 7) & (numSlots - 1); }
+   static unsigned char tag(size_t h)      { return (unsigned char)(h & 0x7f);      }
+   static int matchMask(const unsigned char * group, unsigned char c);
+
+   unsigned char * control;   // numSlots + GROUP bytes
+   Slot * slots;              // raw storage; only full slots hold anything
+   int numSlots;
+   int numItems;
+   H hasher;
+   KeyOf keyOf;
+#ifdef HASH_PROBE_STATS
+   ProbeCounter probeCounter;
+#endif
+};
+
+/**************************************************
+ * FLAT TABLE MATCH MASK
+ * Bit i is set when group[i] == c. With SSE2 that
+ * is one compare and one movemask
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+inline int FlatTable<Slot, Key, KeyOf, H>::matchMask(const unsigned char * group, unsigned char c)
+{
+#ifdef __SSE2__
+   __m128i bytes = _mm_loadu_si128((const __m128i *)group);
+   return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8((char)c)));
+#else
+   int mask = 0;
+   for (int i = 0; i < GROUP; i++)
+      mask |= (group[i] == c) << i;
+   return mask;
+#endif
+}
+
+/**************************************************
+ * FLAT TABLE CONSTRUCTORS
+ * Room for numItems slots before the first growth
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+FlatTable<Slot, Key, KeyOf, H>::FlatTable(int numItems) throw (const char *) :
+   control(NULL), slots(NULL), numSlots(0), numItems(0)
+{
+   int slots = GROUP;
+   while (slots - slots / 8 < numItems)
+      slots *= 2;
+   allocate(slots);
+}
+
+template <class Slot, class Key, class KeyOf, class H>
+FlatTable<Slot, Key, KeyOf, H>::FlatTable(const FlatTable & rhs) throw (const char *) :
+   control(NULL), slots(NULL), numSlots(0), numItems(0)
+{
+   *this = rhs;
+}
+
+/**************************************************
+ * FLAT TABLE DESTRUCTOR
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+FlatTable<Slot, Key, KeyOf, H>::~FlatTable()
+{
+   release();
+}
+
+/**************************************************
+ * FLAT TABLE ASSIGNMENT
+ * Same capacity, same layout: copy slot by slot
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+FlatTable <Slot, Key, KeyOf, H> &
+FlatTable<Slot, Key, KeyOf, H>::operator = (const FlatTable & rhs) throw (const char *)
+{
+   if (this == &rhs)
+      return *this;
+
+   release();
+   allocate(rhs.numSlots);
+   memcpy(control, rhs.control, numSlots + GROUP);
+   for (int i = 0; i < numSlots; i++)
+      if (control[i] != EMPTY)
+         new (slots + i) Slot(rhs.slots[i]);
+   numItems = rhs.numItems;
+   hasher = rhs.hasher;
+   return *this;
+}
+
+/**************************************************
+ * FLAT TABLE ALLOCATE and RELEASE
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+void FlatTable<Slot, Key, KeyOf, H>::allocate(int slots) throw (const char *)
+{
+   try
+   {
+      control = new unsigned char[slots + GROUP];
+      this->slots = static_cast <Slot *> (::operator new(sizeof(Slot) * slots));
+   }
+   catch (std::bad_alloc)
+   {
+      delete [] control;
+      control = NULL;
+      throw "ERROR: unable to allocate memory for the hash";
+   }
+   memset(control, EMPTY, slots + GROUP);
+   numSlots = slots;
+   numItems = 0;
+}
+
+template <class Slot, class Key, class KeyOf, class H>
+void FlatTable<Slot, Key, KeyOf, H>::release()
+{
+   if (control == NULL)
+      return;
+   for (int i = 0; i < numSlots; i++)
+      if (control[i] != EMPTY)
+         slots[i].~Slot();
+   delete [] control;
+   ::operator delete(slots);
+   control = NULL;
+   slots = NULL;
+}
+
+/**************************************************
+ * FLAT TABLE SET CONTROL
+ * Keep the copy of the first group in step
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+inline void FlatTable<Slot, Key, KeyOf, H>::setControl(int i, unsigned char c)
+{
+   control[i] = c;
+   if (i < GROUP)
+      control[numSlots + i] = c;
+}
+
+/**************************************************
+ * FLAT TABLE FIND
+ * Stops at the first group with an empty slot in
+ * it: a run of full slots from the home slot is
+ * never broken
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+int FlatTable<Slot, Key, KeyOf, H>::find(const Key & key, size_t h) const
+{
+   int mask = numSlots - 1;
+   unsigned char t = tag(h);
+   for (int pos = home(h), probed = 0; probed < numSlots; pos = (pos + GROUP) & mask, probed += GROUP)
+   {
+      const unsigned char * group = control + pos;
+      for (int match = matchMask(group, t); match; match &= match - 1)
+      {
+         int i = (pos + __builtin_ctz(match)) & mask;
+         if (keyOf(slots[i]) == key)
+         {
+            HASH_PROBE_RECORD(probeCounter, probed / GROUP + 1);
+            return i;
+         }
+      }
+      if (matchMask(group, EMPTY))
+      {
+         HASH_PROBE_RECORD(probeCounter, probed / GROUP + 1);
+         return -1;
+      }
+   }
+   HASH_PROBE_RECORD(probeCounter, numSlots / GROUP);
+   return -1;
+}
+
+/**************************************************
+ * FLAT TABLE EMPTY SLOT
+ * The first empty slot at or after the home slot.
+ * There always is one since the table is never full
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+int FlatTable<Slot, Key, KeyOf, H>::emptySlot(size_t h) const
+{
+   int mask = numSlots - 1;
+   for (int pos = home(h); ; pos = (pos + GROUP) & mask)
+   {
+      int empty = matchMask(control + pos, EMPTY);
+      if (empty)
+         return (pos + __builtin_ctz(empty)) & mask;
+   }
+}
+
+/**************************************************
+ * FLAT TABLE CLAIM and UNCLAIM
+ * One probe when the key is already here
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+int FlatTable<Slot, Key, KeyOf, H>::claim(const Key & key, size_t h, bool & inserted) throw (const char *)
+{
+   int i = find(key, h);
+   inserted = (i < 0);
+   if (inserted)
+   {
+      if (numItems + 1 > numSlots - numSlots / 8)
+         grow();
+      i = emptySlot(h);
+      setControl(i, tag(h));
+      numItems++;
+   }
+   return i;
+}
+
+template <class Slot, class Key, class KeyOf, class H>
+void FlatTable<Slot, Key, KeyOf, H>::unclaim(int i)
+{
+   setControl(i, EMPTY);
+   numItems--;
+}
+
+/**************************************************
+ * FLAT TABLE GROW
+ * Double the slots and move every one across
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+void FlatTable<Slot, Key, KeyOf, H>::grow() throw (const char *)
+{
+   unsigned char * oldControl = control;
+   Slot * oldSlots = slots;
+   int oldNumSlots = numSlots;
+   int oldNumItems = numItems;
+
+   control = NULL;
+   try
+   {
+      allocate(oldNumSlots * 2);
+   }
+   catch (const char *)
+   {
+      control = oldControl;
+      slots = oldSlots;
+      numSlots = oldNumSlots;
+      numItems = oldNumItems;
+      throw;
+   }
+
+   for (int i = 0; i < oldNumSlots; i++)
+      if (oldControl[i] != EMPTY)
+      {
+         size_t h = hashOf(oldSlots[i]);
+         int j = emptySlot(h);
+         new (slots + j) Slot(std::move(oldSlots[i]));
+         setControl(j, tag(h));
+         oldSlots[i].~Slot();
+      }
+   numItems = oldNumItems;
+   delete [] oldControl;
+   ::operator delete(oldSlots);
+}
+
+/**************************************************
+ * FLAT TABLE ERASE
+ * Empty the slot, then walk the rest of the run:
+ * any slot that would still be found from its
+ * home slot if it sat in the hole moves back into
+ * it, leaving a new hole further on
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+bool FlatTable<Slot, Key, KeyOf, H>::erase(const Key & key, size_t h)
+{
+   int hole = find(key, h);
+   if (hole < 0)
+      return false;
+
+   int mask = numSlots - 1;
+   slots[hole].~Slot();
+   for (int i = (hole + 1) & mask; control[i] != EMPTY; i = (i + 1) & mask)
+   {
+      // how far the hole and this slot are past the key's home slot
+      int start = home(hashOf(slots[i]));
+      if (((hole - start) & mask) < ((i - start) & mask))
+      {
+         new (slots + hole) Slot(std::move(slots[i]));
+         slots[i].~Slot();
+         setControl(hole, control[i]);
+         hole = i;
+      }
+   }
+   setControl(hole, EMPTY);
+   numItems--;
+   return true;
+}
+
+/**************************************************
+ * FLAT TABLE CLEAR
+ * Keep the capacity, drop the slots
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+void FlatTable<Slot, Key, KeyOf, H>::clear()
+{
+   for (int i = 0; i < numSlots; i++)
+      if (control[i] != EMPTY)
+         slots[i].~Slot();
+   memset(control, EMPTY, numSlots + GROUP);
+   numItems = 0;
+}
+
+/**************************************************
+ * FLAT TABLE STATS
+ * A slot d past its home slot is found in group
+ * d / GROUP + 1. A miss from any slot loads groups
+ * until one holds an empty slot, so walking
+ * backwards from an empty slot gives how far every
+ * slot is from the next one in a single pass
+ *************************************************/
+template <class Slot, class Key, class KeyOf, class H>
+HashStats FlatTable<Slot, Key, KeyOf, H>::stats() const
+{
+   HashStats stats;
+   stats.size = numItems;
+   stats.buckets = numSlots;
+   stats.loadFactor = (double)numItems / numSlots;
+
+   int mask = numSlots - 1;
+   long long found = 0;
+   for (int i = 0; i < numSlots; i++)
+      if (control[i] != EMPTY)
+      {
+         int distance = (i - home(hashOf(slots[i]))) & mask;
+         stats.add(distance);
+         found += distance / GROUP + 1;
+      }
+
+   int empty = 0;
+   while (control[empty] != EMPTY)
+      empty++;
+   long long missed = 0;
+   int distance = 0;
+   for (int n = 0, i = empty; n < numSlots; n++, i = (i - 1) & mask)
+   {
+      distance = (control[i] == EMPTY) ? 0 : distance + 1;
+      missed += distance / GROUP + 1;
+   }
+
+   double bytes = (double)numSlots * (sizeof(Slot) + 1) + GROUP;
+   if (numItems)
+   {
+      stats.successful = (double)found / numItems;
+      stats.bytesPerItem = bytes / numItems;
+      stats.overheadPerItem = stats.bytesPerItem - sizeof(Slot);
+   }
+   stats.unsuccessful = (double)missed / numSlots;
+   HASH_PROBE_REPORT(probeCounter, stats);
+   return stats;
+}
+
+#endif // FLAT_TABLE_H
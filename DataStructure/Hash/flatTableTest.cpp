@@ -0,0 +1,297 @@
+/***********************************************************************
+ * Program:
+ *    FLAT TABLE TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Runs FlatHash next to a std::unordered_set, and HashMap next to a
+ *    std::unordered_map, through random inserts, erases, finds and
+ *    updates, and checks they agree after every step. A poor hasher
+ *    that sends whole ranges of keys to one home slot keeps runs long
+ *    and wrapping past the end, where erasing has the most to shift.
+ *    The items count themselves, so every one built is destroyed.
+ *    HashMap's keys and its const walks must not be writable.
+ *    Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT
+#include <random>          // for MT19937
+#include <string>
+#include <type_traits>   // for IS_SAME and IS_ASSIGNABLE
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>       // for DECLVAL
+#include "flatHash.h"
+#include "hashMap.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * COUNTED
+ * A string that keeps count of how many are alive
+ ***********************************************************************/
+struct Counted
+{
+   static int numAlive;
+   string value;
+
+   Counted(const string & value = "") : value(value) { numAlive++; }
+   Counted(const Counted & rhs) : value(rhs.value)    { numAlive++; }
+   ~Counted()                                         { numAlive--; }
+   Counted & operator = (const Counted & rhs)
+   {
+      value = rhs.value;
+      return *this;
+   }
+   bool operator == (const Counted & rhs) const { return value == rhs.value; }
+};
+int Counted::numAlive = 0;
+
+/**********************************************************************
+ * GOOD HASHER and POOR HASHER
+ * The poor one gives a hundred keys at a time the same hash, so they
+ * share a home slot and a tag
+ ***********************************************************************/
+struct GoodHasher
+{
+   size_t operator () (const Counted & item) const
+   {
+      return hashBytes(item.value.data(), item.value.size());
+   }
+};
+
+struct PoorHasher
+{
+   size_t operator () (const Counted & item) const
+   {
+      return hashMix(atoi(item.value.c_str()) / 100);
+   }
+};
+
+Counted makeKey(int n) { return Counted(to_string(n)); }
+
+/**********************************************************************
+ * SAME SET
+ * Every item in the set is in the table and the sizes agree, so the
+ * table holds nothing else
+ ***********************************************************************/
+template <class H>
+void sameSet(const FlatHash <Counted, H> & table, const unordered_set <string> & expected)
+{
+   CHECK(table.size() == (int)expected.size());
+   CHECK(table.empty() == expected.empty());
+   for (unordered_set <string> :: const_iterator it = expected.begin(); it != expected.end(); ++it)
+      CHECK(table.find(Counted(*it)));
+}
+
+/**********************************************************************
+ * FUZZ SET
+ * A key range a few times the size the table settles at, so inserts
+ * and erases both hit and miss about as often
+ ***********************************************************************/
+template <class H>
+void fuzzSet(int range, int steps, unsigned seed)
+{
+   mt19937 random(seed);
+   {
+      FlatHash <Counted, H> table;
+      unordered_set <string> expected;
+      for (int step = 0; step < steps; step++)
+      {
+         Counted item = makeKey(random() % range);
+         int choice = random() % 8;
+         if (choice < 3)
+         {
+            bool inserted;
+            Counted & found = table.findOrInsert(item, table.hashFunction()(item), inserted);
+            CHECK(inserted == expected.insert(item.value).second);
+            CHECK(found == item);
+         }
+         else if (choice < 6)
+         {
+            CHECK(table.erase(item) == (expected.erase(item.value) == 1));
+         }
+         else
+         {
+            CHECK(table.find(item) == (expected.count(item.value) == 1));
+         }
+         CHECK(table.size() == (int)expected.size());
+
+         // now and then, everything, and a copy of everything
+         if (step % 1000 == 0)
+         {
+            sameSet(table, expected);
+            FlatHash <Counted, H> copy(table);
+            sameSet(copy, expected);
+            FlatHash <Counted, H> assigned;
+            assigned.insert(makeKey(-1));
+            assigned = table;
+            sameSet(assigned, expected);
+            CHECK(table.stats().size == (int)expected.size());
+         }
+      }
+      sameSet(table, expected);
+      table.clear();
+      expected.clear();
+      sameSet(table, expected);
+      CHECK(Counted::numAlive == 0);
+      table.insert(makeKey(1));
+   }
+   CHECK(Counted::numAlive == 0);
+}
+
+/**********************************************************************
+ * SAME MAP
+ * Walking the map visits every pair once with the right value
+ ***********************************************************************/
+template <class H>
+void sameMap(const HashMap <Counted, int, H> & map, const unordered_map <string, int> & expected)
+{
+   CHECK(map.size() == (int)expected.size());
+   CHECK(map.empty() == expected.empty());
+   int numVisited = 0;
+   for (typename HashMap <Counted, int, H> :: const_iterator it = map.begin(); it != map.end(); ++it)
+   {
+      unordered_map <string, int> :: const_iterator e = expected.find(it->first.value);
+      CHECK(e != expected.end());
+      CHECK(it->second == e->second);
+      numVisited++;
+   }
+   CHECK(numVisited == (int)expected.size());
+}
+
+/**********************************************************************
+ * FUZZ MAP
+ ***********************************************************************/
+template <class H>
+void fuzzMap(int range, int steps, unsigned seed)
+{
+   mt19937 random(seed);
+   {
+      HashMap <Counted, int, H> map;
+      unordered_map <string, int> expected;
+      for (int step = 0; step < steps; step++)
+      {
+         Counted key = makeKey(random() % range);
+         int value = random() % 1000;
+         int choice = random() % 10;
+         if (choice < 2)
+         {
+            // try_emplace builds nothing when the key is here
+            bool inserted = map.try_emplace(key, value).second;
+            CHECK(inserted == expected.insert(make_pair(key.value, value)).second);
+         }
+         else if (choice < 4)
+         {
+            map.upsert(key, [value](int & n) { n += value; });
+            expected[key.value] += value;
+         }
+         else if (choice < 5)
+         {
+            map[key] = value;
+            expected[key.value] = value;
+         }
+         else if (choice < 8)
+         {
+            CHECK(map.erase(key) == (expected.erase(key.value) == 1));
+         }
+         else
+         {
+            typename HashMap <Counted, int, H> :: iterator it = map.find(key);
+            unordered_map <string, int> :: iterator e = expected.find(key.value);
+            CHECK((it == map.end()) == (e == expected.end()));
+            if (e != expected.end())
+            {
+               CHECK(it->first == key);
+               CHECK(it->second == e->second);
+            }
+         }
+         CHECK(map.size() == (int)expected.size());
+
+         if (step % 1000 == 0)
+         {
+            sameMap(map, expected);
+            HashMap <Counted, int, H> copy(map);
+            sameMap(copy, expected);
+            HashMap <Counted, int, H> assigned;
+            assigned[makeKey(-1)] = 1;
+            assigned = map;
+            sameMap(assigned, expected);
+         }
+      }
+      sameMap(map, expected);
+      map.clear();
+      expected.clear();
+      sameMap(map, expected);
+      CHECK(Counted::numAlive == 0);
+      map[makeKey(1)] = 1;
+   }
+   CHECK(Counted::numAlive == 0);
+}
+
+/**********************************************************************
+ * MAP CONSTNESS
+ * No key can be written through any iterator, and a const map hands
+ * out only const pairs. The values stay writable through an iterator,
+ * which converts to a const_iterator at the same pair
+ ***********************************************************************/
+void mapConstness()
+{
+   typedef HashMap <string, int> Map;
+   static_assert(is_same <Map::value_type, pair <const string, int> >::value,
+                 "the key is const");
+   static_assert(!is_assignable <decltype((declval <Map::iterator> ()->first)),
+                                 string>::value, "no key written through an iterator");
+   static_assert(is_same <decltype(declval <const Map &> ().find("")),
+                          Map::const_iterator>::value, "a const find is const");
+   static_assert(is_same <decltype(*declval <const Map &> ().begin()),
+                          const Map::value_type &>::value, "a const walk is const");
+   static_assert(!is_assignable <decltype((declval <Map::const_iterator> ()->second)),
+                                 int>::value, "no value written through a const_iterator");
+
+   Map map;
+   for (int i = 0; i < 100; i++)
+      map[to_string(i)] = i;
+   for (Map::iterator it = map.begin(); it != map.end(); ++it)
+      it->second *= 2;
+
+   const Map & constMap = map;
+   int numVisited = 0;
+   for (Map::const_iterator it = constMap.cbegin(); it != constMap.cend(); it++)
+   {
+      CHECK(it->second == 2 * stoi(it->first));
+      numVisited++;
+   }
+   CHECK(numVisited == 100);
+
+   Map::iterator found = map.find("7");
+   Map::const_iterator constFound = found;
+   CHECK(constFound == constMap.find("7"));
+   CHECK((*constFound).second == 14);
+   CHECK(constMap.find("100") == constMap.end());
+   CHECK(map.find("100") == map.end());
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   fuzzSet <GoodHasher> (100, 50000, 1);
+   fuzzSet <GoodHasher> (5000, 200000, 2);
+   fuzzSet <PoorHasher> (3000, 100000, 3);
+   fuzzMap <GoodHasher> (100, 50000, 4);
+   fuzzMap <GoodHasher> (5000, 200000, 5);
+   fuzzMap <PoorHasher> (3000, 100000, 6);
+   mapConstness();
+
+   cout << "FlatTable tests passed\n";
+   return 0;
+}
@@ -6,11 +6,15 @@
 ************************************************************************/
 
 #include <iostream>
+#include <new>        // for PLACEMENT NEW
 using namespace std;
 
 #ifndef HASH_H
 #define HASH_H
+#include <string>
 #include "list.h"
+#include "hasher.h"
+#include "hashStats.h"
 
 template <class T>
 ostream & operator << (ostream & out, List <T> & rhs)
@@ -26,26 +30,88 @@ ostream & operator << (ostream & out, List <T> & rhs)
    return out;
 }
 
+/**************************************************
+ * HASH FUNCTION
+ * How Hash <T, H> turns an item into a bucket. With
+ * a hasher H the bucket count is a power of two and
+ * the hash is masked, all of it inline
+ *************************************************/
+template <class T, class H>
+class HashFunction  {
+protected:
+   int bucketOf(const T & item, int buckets) const {
+      return (int)(hasher(item) & (size_t)(buckets - 1));
+   }
+   static int bucketsFor(int cap) {
+      int buckets = 1;
+      while (buckets < cap)
+         buckets *= 2;
+      return buckets;
+   }
+   static int grownBuckets(int buckets) { return buckets * 2; }
+
+   H hasher;
+};
+
+/**************************************************
+ * HASH FUNCTION : VIRTUAL
+ * The original interface: a subclass overrides
+ * hash(), which gives a bucket in [0, capacity()).
+ * Any bucket count is fine, and it is kept as given
+ *************************************************/
 template <class T>
-class Hash  {
+class HashFunction <T, VirtualHash <T> >  {
+public:
+   virtual ~HashFunction() {}
+   virtual int hash(const T & value) const = 0;
+protected:
+   // hash() reads the bucket count from capacity(), so Hash sets
+   // that up before asking about any other size
+   int bucketOf(const T & item, int) const { return hash(item); }
+   static int bucketsFor(int cap) { return cap; }
+   static int grownBuckets(int buckets) { return buckets * 2 + 1; }
+};
+
+// work done per insert or find while growing: new buckets built,
+// then old buckets moved across
+#define BUILD_STEPS  16
+#define REHASH_STEPS 4
+
+/**************************************************
+ * HASH
+ * A table of buckets, each a linked List. Hash()
+ * grows on its own: once there are more than
+ * maxLoadFactor items per bucket the buckets are
+ * roughly doubled. Hash(cap) keeps exactly cap
+ * buckets unless setMaxLoadFactor() says otherwise.
+ *
+ * H is a hasher such as DefaultHasher <T>, in which
+ * case cap is rounded up to a power of two. Leave it
+ * out to subclass and override hash() instead.
+ *
+ * Growth never stops the world. First the bigger
+ * table is built a few buckets at a time, then the
+ * old buckets are moved into it a few at a time,
+ * with finds looking in both. Either way no one
+ * operation pays for the whole table
+ *************************************************/
+template <class T, class H = VirtualHash<T> >
+class Hash : public HashFunction<T, H>  {
 public:
    Hash() throw (const char *);
-   Hash(const Hash<T> & rhs) throw (const char *);
+   Hash(const Hash<T, H> & rhs) throw (const char *);
    Hash(int cap) throw (const char *);
    ~Hash();
-   Hash<T> & operator=(const Hash<T> &rhs) {
-      clear();
-      this->numBuckets = rhs.numBuckets;
-      this->hSize = rhs.hSize;
-      this->hashTable = new List<T>[numBuckets];
-      for (int i = 0; i < capacity(); i++)
-         this->hashTable[i] = rhs.hashTable[i];
-
+   Hash<T, H> & operator=(const Hash<T, H> &rhs) throw (const char *) {
+      if (this != &rhs) {
+         release();
+         HashFunction<T, H>::operator=(rhs);
+         copy(rhs);
+      }
       return *this;
    }
-   virtual int hash(const T & value) const = 0;
-   void insert(T item);
-   bool find(T item);
+   void insert(const T & item);
+   bool find(const T & item);
    void clear();
    int size()  
    {
@@ -61,79 +127,264 @@ public:
    }
    void  display()
    {
+      finishGrowth();
       cout << endl;
       for (int i = 0; i < capacity(); i++)
          cout << "Location: " << i << "::" << hashTable[i] << endl;
       cout << endl;
    }
 
+   // a look at every bucket, far cheaper to read than display().
+   // While growing, buckets not yet moved are counted as well
+   HashStats stats();
+
+   // snapshots need POSIX, so they are in hashSnapshot.h
+   template <class U, class G>
+   friend void snapshot(Hash<U, G> & hash, const std::string & fileName)
+      throw (const char *);
+   template <class U, class G>
+   friend void restore(Hash<U, G> & hash, const std::string & fileName)
+      throw (const char *);
+
+   // growth. A factor of 0 means never grow
+   float getMaxLoadFactor() const { return maxLoadFactor; }
+   void setMaxLoadFactor(float factor) { maxLoadFactor = factor; }
+   bool growing() const { return nextTable != NULL || oldTable != NULL; }
+
 private:
+   static List<T> * allocate(int buckets) throw (const char *);
+   static void freeBuckets(List<T> * table, int from, int to);
+   void copy(const Hash<T, H> & rhs) throw (const char *);
+   void release();
+   int  bucketIn(const T & item, int buckets);
+   void startGrowth() throw (const char *);
+   void growStep(int steps);
+   void finishGrowth() { while (growing()) growStep(numBuckets); }
+
    List<T> * hashTable;  
    int numBuckets;     
    int hSize;       
+
+   List<T> * nextTable;    // the bigger table while it is built, or NULL
+   int nextNumBuckets;
+   int numBuilt;           // buckets of nextTable constructed so far
+   List<T> * oldTable;     // the buckets being moved out of, or NULL
+   int oldNumBuckets;
+   int rehashIndex;        // old buckets before this are gone
+   float maxLoadFactor;
+#ifdef HASH_PROBE_STATS
+   ProbeCounter probeCounter;
+#endif
 };
 
 /**************************************************
- * HASH COPY CONSTRUCTOR
- * Copy constructor for the hash class
+ * HASH ALLOCATE
+ * Raw room for the buckets. Nothing is constructed,
+ * so even a huge table costs next to nothing until
+ * its buckets are built
  *************************************************/
-template <class T>
-Hash<T>::Hash(const Hash<T> & rhs) throw (const char *)  {
-   try   {
-      this->numBuckets = rhs.numBuckets;
-      this->hSize = rhs.hSize;
-      this->hashTable = new List<T>[numBuckets];
-
-      for (int i = 0; i < numBuckets; i++)
-         if(&rhs.hashTable[i] != NULL)
-            hashTable[i] = rhs.hashTable[i];
+template <class T, class H>
+List<T> * Hash<T, H>::allocate(int buckets) throw (const char *)  {
+   try {
+      return static_cast<List<T> *>(::operator new(sizeof(List<T>) * buckets));
    }
-   catch(...) {
+   catch(...){
       throw "ERROR: unable to allocate memory for the hash";
    }
 }
+
 /**************************************************
- * HASH DEFAULT CONSTRUCTOR
- * Default constructor for the hash class
+ * HASH FREE BUCKETS
+ * Destroy buckets [from, to) and free the table
  *************************************************/
-template <class T>
-Hash<T>::Hash() throw (const char *)   {
-   try {
-      numBuckets = 11;
-      hSize = 0;
-      hashTable = new List<T>[numBuckets];
+template <class T, class H>
+void Hash<T, H>::freeBuckets(List<T> * table, int from, int to)  {
+   if (table == NULL)
+      return;
+   for (int i = from; i < to; i++)
+      table[i].~List<T>();
+   ::operator delete(table);
+}
 
+/**************************************************
+ * HASH COPY
+ * Take on rhs's buckets, including any still
+ * waiting to be moved. A table still being built
+ * holds nothing yet, so it is started over later
+ *************************************************/
+template <class T, class H>
+void Hash<T, H>::copy(const Hash<T, H> & rhs) throw (const char *)  {
+   numBuckets = rhs.numBuckets;
+   hSize = rhs.hSize;
+   maxLoadFactor = rhs.maxLoadFactor;
+   nextTable = oldTable = NULL;
+   nextNumBuckets = numBuilt = 0;
+   oldNumBuckets = rehashIndex = 0;
+
+   hashTable = allocate(numBuckets);
+   for (int i = 0; i < numBuckets; i++)
+      new (hashTable + i) List<T>(rhs.hashTable[i]);
+
+   if (rhs.oldTable) {
+      oldTable = allocate(rhs.oldNumBuckets);
+      oldNumBuckets = rhs.oldNumBuckets;
+      rehashIndex = rhs.rehashIndex;
+      for (int i = rehashIndex; i < oldNumBuckets; i++)
+         new (oldTable + i) List<T>(rhs.oldTable[i]);
    }
-   catch(...){
-      throw "ERROR: unable to allocate memory for the hash";
-   }
+}
+
+/**************************************************
+ * HASH RELEASE
+ *************************************************/
+template <class T, class H>
+void Hash<T, H>::release()  {
+   freeBuckets(hashTable, 0, numBuckets);
+   freeBuckets(nextTable, 0, numBuilt);
+   freeBuckets(oldTable, rehashIndex, oldNumBuckets);
+   hashTable = nextTable = oldTable = NULL;
+   numBuckets = nextNumBuckets = numBuilt = 0;
+   oldNumBuckets = rehashIndex = 0;
+   hSize = 0;
+}
+
+/**************************************************
+ * HASH COPY CONSTRUCTOR
+ * Copy constructor for the hash class
+ *************************************************/
+template <class T, class H>
+Hash<T, H>::Hash(const Hash<T, H> & rhs) throw (const char *) :
+      HashFunction<T, H>(rhs)  {
+   copy(rhs);
+}
+/**************************************************
+ * HASH DEFAULT CONSTRUCTOR
+ * Default constructor for the hash class
+ *************************************************/
+template <class T, class H>
+Hash<T, H>::Hash() throw (const char *)   {
+   numBuckets = this->bucketsFor(11);
+   hSize = 0;
+   hashTable = allocate(numBuckets);
+   for (int i = 0; i < numBuckets; i++)
+      new (hashTable + i) List<T>;
+   nextTable = oldTable = NULL;
+   nextNumBuckets = numBuilt = 0;
+   oldNumBuckets = rehashIndex = 0;
+   maxLoadFactor = 1.0;
 }
 
 /**************************************************
  * HASH DECONSTRUCTOR
  * Deconstructor for the hash class
  *************************************************/
-template <class T>
-Hash<T>::~Hash()  {
-   for (int i = 0; i < numBuckets; i++)
-      hashTable[i].clear();
-   numBuckets = 0;
-   hSize = 0;
-   delete[] hashTable;
+template <class T, class H>
+Hash<T, H>::~Hash()  {
+   release();
 }
 /**************************************************
  * HASH NON-DEFAULT CONSTRUCTOR
  * Non-default constructor for the hash class
  *************************************************/
-template <class T>
-Hash<T>::Hash(int cap) throw (const char *)   {
-   try {
-      numBuckets = cap;
-      hSize = 0;
-      hashTable = new List<T>[numBuckets];
+template <class T, class H>
+Hash<T, H>::Hash(int cap) throw (const char *)   {
+   numBuckets = this->bucketsFor(cap);
+   hSize = 0;
+   hashTable = allocate(numBuckets);
+   for (int i = 0; i < numBuckets; i++)
+      new (hashTable + i) List<T>;
+   nextTable = oldTable = NULL;
+   nextNumBuckets = numBuilt = 0;
+   oldNumBuckets = rehashIndex = 0;
+   maxLoadFactor = 0.0;
+}
+
+/**************************************************
+ * HASH BUCKET IN
+ * hash() works from capacity(), so to find where an
+ * item sat in the old table, briefly pretend the
+ * table is still that size
+ *************************************************/
+template <class T, class H>
+int Hash<T, H>::bucketIn(const T & item, int buckets)  {
+   int current = numBuckets;
+   numBuckets = buckets;
+   int key = this->bucketOf(item, numBuckets);
+   numBuckets = current;
+   return key;
+}
+
+/**************************************************
+ * HASH START GROWTH
+ * Set aside room for about twice the buckets. Items
+ * keep going into the current table until it is
+ * built
+ *************************************************/
+template <class T, class H>
+void Hash<T, H>::startGrowth() throw (const char *)  {
+   nextNumBuckets = this->grownBuckets(numBuckets);
+   nextTable = allocate(nextNumBuckets);
+   numBuilt = 0;
+}
+
+/**************************************************
+ * HASH GROW STEP
+ * Build up to BUILD_STEPS * steps new buckets, or
+ * once they are all built, move up to
+ * REHASH_STEPS * steps old buckets across. The
+ * nodes are relinked, not copied, and an emptied
+ * bucket is destroyed on the spot so there is
+ * nothing left to walk when the old table is freed.
+ *
+ * With a step per operation, building the 2n new
+ * buckets takes n / 8 operations and moving the n
+ * old ones n / 4. At the default load factor of 1
+ * growth is over after 3n / 8 operations, well
+ * before the n more inserts that start the next
+ *************************************************/
+template <class T, class H>
+void Hash<T, H>::growStep(int steps)  {
+   if (nextTable) {
+      // in long long: finishGrowth() asks for numBuckets steps, and
+      // BUILD_STEPS times that overflows an int past 2^27 buckets
+      long long end = numBuilt + (long long)BUILD_STEPS * steps;
+      if (end > nextNumBuckets)
+         end = nextNumBuckets;
+      for (; numBuilt < end; numBuilt++)
+         new (nextTable + numBuilt) List<T>;
+      if (numBuilt < nextNumBuckets)
+         return;
+
+      oldTable = hashTable;
+      oldNumBuckets = numBuckets;
+      rehashIndex = 0;
+      hashTable = nextTable;
+      numBuckets = nextNumBuckets;
+      nextTable = NULL;
+      nextNumBuckets = numBuilt = 0;
+      return;
    }
-   catch(...){
-      throw "ERROR: unable to allocate memory for the hash";
+
+   long long moves = (long long)REHASH_STEPS * steps;
+   for (; moves > 0 && rehashIndex < oldNumBuckets; moves--, rehashIndex++)  {
+      List<T> & bucket = oldTable[rehashIndex];
+      while (!bucket.empty()) {
+         int key = this->bucketOf(bucket.front(), numBuckets);
+         if (key > -1 && key < numBuckets)
+            hashTable[key].spliceFront(bucket);
+         else  {
+            List<T> dropped;           // no bucket for it now
+            dropped.spliceFront(bucket);
+            hSize--;
+         }
+      }
+      bucket.~List<T>();
+   }
+
+   if (oldTable && rehashIndex == oldNumBuckets) {
+      freeBuckets(oldTable, 0, 0);
+      oldTable = NULL;
+      oldNumBuckets = rehashIndex = 0;
    }
 }
 
@@ -141,9 +392,14 @@ Hash<T>::Hash(int cap) throw (const char *)   {
  * HASH INSERT
  * Inserts values into the array
  *************************************************/
-template <class T>
-void Hash<T>::insert (T item) {
-   int key = hash(item);
+template <class T, class H>
+void Hash<T, H>::insert (const T & item) {
+   if (growing())
+      growStep(1);
+   else if (maxLoadFactor > 0.0 && hSize + 1 > maxLoadFactor * numBuckets)
+      startGrowth();
+
+   int key = this->bucketOf(item, numBuckets);
 
    if (key > -1 && key < numBuckets)
    {
@@ -154,37 +410,126 @@ void Hash<T>::insert (T item) {
 
 /**************************************************
  * HASH FIND
- * Finds an item in the array
+ * Finds an item in the array. While growing, an
+ * item may still be in its old bucket
  *************************************************/
- template <class T>
-bool Hash<T>::find(T item)
+ template <class T, class H>
+bool Hash<T, H>::find(const T & item)
 {
-   int key = hash(item);
+   if (growing())
+      growStep(1);
+
+   int key = this->bucketOf(item, numBuckets);
+   int probes = 0;
 
    if (key > -1 && key < numBuckets)
    {
       ListIterator <T> it;
       for (it = hashTable[key].begin(); it != hashTable[key].end(); ++it)
       {
+         probes++;
          if (*it == item)
+         {
+            HASH_PROBE_RECORD(probeCounter, probes);
             return true;
+         }
       }
    }
+
+   if (oldTable)
+   {
+      key = bucketIn(item, oldNumBuckets);
+      if (key >= rehashIndex && key < oldNumBuckets)
+      {
+         ListIterator <T> it;
+         for (it = oldTable[key].begin(); it != oldTable[key].end(); ++it)
+         {
+            probes++;
+            if (*it == item)
+            {
+               HASH_PROBE_RECORD(probeCounter, probes);
+               return true;
+            }
+         }
+      }
+   }
+   HASH_PROBE_RECORD(probeCounter, probes);
    return false;
 }// find end
 
 /**************************************************
  * HASH CLEAR
- * Clears the array
+ * Clears the array, and stops any growth
  *************************************************/
- template <class T>
- void Hash<T>::clear()  {
+ template <class T, class H>
+ void Hash<T, H>::clear()  {
     if (!empty()) {
       for (int i = 0; i < numBuckets; i++)  {
          	hashTable[i].clear();
       }
       hSize = 0;
    }
+   freeBuckets(nextTable, 0, numBuilt);
+   freeBuckets(oldTable, rehashIndex, oldNumBuckets);
+   nextTable = oldTable = NULL;
+   nextNumBuckets = numBuilt = 0;
+   oldNumBuckets = rehashIndex = 0;
+}
+
+/**************************************************
+ * HASH STATS
+ * The item at place j of a chain is found after
+ * j compares, and a miss compares the whole chain.
+ * Both assume finds land on buckets evenly, so a
+ * hash() that crowds a few buckets shows up in the
+ * longest chain and the histogram. An item still
+ * in the old table is looked for in its new bucket
+ * first, and that chain is added to its cost
+ *************************************************/
+template <class T, class H>
+HashStats Hash<T, H>::stats()  {
+   HashStats stats;
+   stats.size = hSize;
+   stats.buckets = numBuckets;
+   stats.loadFactor = (double)hSize / numBuckets;
+
+   long long found = 0;
+   long long chained = 0;
+   for (int i = 0; i < numBuckets; i++)  {
+      long long length = hashTable[i].size();
+      stats.add(length);
+      found += length * (length + 1) / 2;
+      chained += length;
+   }
+   stats.unsuccessful = (double)chained / numBuckets;
+
+   if (oldTable)  {
+      long long left = 0;
+      for (int i = rehashIndex; i < oldNumBuckets; i++)  {
+         long long place = 0;
+         ListIterator <T> it;
+         for (it = oldTable[i].begin(); it != oldTable[i].end(); ++it)  {
+            int key = this->bucketOf(*it, numBuckets);
+            found += ++place;
+            if (key > -1 && key < numBuckets)
+               found += hashTable[key].size();
+         }
+         stats.add(place);
+         left += place;
+      }
+      stats.unsuccessful += (double)left / oldNumBuckets;
+   }
+
+   // a node is the item and two links, a bucket is an empty List
+   double bytes = (double)hSize * sizeof(Node <T>) +
+      (double)(numBuckets + nextNumBuckets + oldNumBuckets) * sizeof(List <T>);
+   if (hSize)  {
+      stats.successful = (double)found / hSize;
+      stats.bytesPerItem = bytes / hSize;
+      stats.overheadPerItem = stats.bytesPerItem - sizeof(T);
+   }
+   HASH_PROBE_REPORT(probeCounter, stats);
+   return stats;
 }
 
 #endif
@@ -0,0 +1,647 @@
+/***********************************************************************
+ * Program:
+ *    HASH BENCH
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    The benchmarks behind the numbers quoted for the hash tables, so
+ *    they can be run again. Each one is a mode:
+ *       hashBench latency [n]     insert latency percentiles while
+ *                                 growing to n items, incremental
+ *                                 against stop-the-world growth
+ *       hashBench flat [n]        finds that hit and miss, FlatHash
+ *                                 against Hash, with n items
+ *       hashBench hasher [n]      finds, half of them hits, through a
+ *                                 virtual hash() against an inlined
+ *                                 hasher, with 4K and with n items
+ *       hashBench concurrent [n]  millions of operations a second on n
+ *                                 keys, ConcurrentHash against FlatHash
+ *                                 behind one mutex, at 1 to 32 threads
+ *       hashBench map [n]         counting n words drawn from a Zipf
+ *                                 vocabulary of 200K, std::map and
+ *                                 std::unordered_map against HashMap
+ *       hashBench snapshot [n]    saving and restoring a Hash of n
+ *                                 numbers and of n words, against
+ *                                 writing them as text and inserting
+ *                                 them again
+ *    Inputs are generated from fixed seeds, so runs are comparable.
+ *    Times depend on the machine; compare modes on one machine only.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for SORT
+#include <atomic>
+#include <chrono>          // for STEADY_CLOCK
+#include <cstdio>          // for REMOVE
+#include <cstdlib>         // for ATOI
+#include <cstring>         // for STRCMP
+#include <fstream>         // for IFSTREAM and OFSTREAM
+#include <iomanip>         // for SETW
+#include <map>
+#include <memory>          // for UNIQUE_PTR
+#include <mutex>           // for MUTEX and LOCK_GUARD
+#include <random>          // for MT19937_64
+#include <string>
+#include <thread>
+#include <unistd.h>        // for GETPID
+#include <unordered_map>
+#include <vector>
+#include "hash.h"
+#include "hashSnapshot.h"
+#include "flatHash.h"
+#include "concurrentHash.h"
+#include "hashMap.h"
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/**********************************************************************
+ * SECONDS SINCE and NANOSECONDS SINCE
+ ***********************************************************************/
+double secondsSince(Clock::time_point start)
+{
+   return chrono::duration <double> (Clock::now() - start).count();
+}
+
+float nanosecondsSince(Clock::time_point start)
+{
+   return chrono::duration <float, nano> (Clock::now() - start).count();
+}
+
+/**********************************************************************
+ * RANDOM KEYS
+ * n distinct random numbers, none of them negative
+ ***********************************************************************/
+template <class T>
+vector <T> randomKeys(int n, unsigned seed)
+{
+   mt19937_64 random(seed);
+   vector <T> keys;
+   while ((int)keys.size() < n)
+   {
+      while ((int)keys.size() < n)
+         keys.push_back((T)(random() >> (65 - 8 * sizeof(T))));
+      sort(keys.begin(), keys.end());
+      keys.erase(unique(keys.begin(), keys.end()), keys.end());
+   }
+   shuffle(keys.begin(), keys.end(), random);
+   return keys;
+}
+
+/**********************************************************************
+ * NANOSECONDS
+ * Pretty-print a time given in nanoseconds
+ ***********************************************************************/
+string nanoseconds(double ns)
+{
+   char buffer[32];
+   if (ns < 1000.0)
+      snprintf(buffer, sizeof(buffer), "%.0fns", ns);
+   else if (ns < 1000000.0)
+      snprintf(buffer, sizeof(buffer), "%.1fus", ns / 1000.0);
+   else if (ns < 1000000000.0)
+      snprintf(buffer, sizeof(buffer), "%.1fms", ns / 1000000.0);
+   else
+      snprintf(buffer, sizeof(buffer), "%.2fs", ns / 1000000000.0);
+   return buffer;
+}
+
+/**********************************************************************
+ * PERCENTILES
+ * p50 through the maximum of a set of latencies
+ ***********************************************************************/
+void percentiles(const char * name, vector <float> & latencies)
+{
+   sort(latencies.begin(), latencies.end());
+   const double points[] = { 0.50, 0.99, 0.999, 0.9999 };
+   cout << setw(16) << left << name << right;
+   for (int i = 0; i < 4; i++)
+      cout << setw(9)
+           << nanoseconds(latencies[(size_t)(points[i] * (latencies.size() - 1))]);
+   cout << setw(9) << nanoseconds(latencies.back()) << endl;
+}
+
+/**********************************************************************
+ * LATENCY
+ * Time every insert while a table grows from empty to n items. The
+ * incremental table is Hash as it is. The stop-the-world one is a
+ * fixed-size Hash rebuilt at the same load factor, the insert that
+ * crosses it paying for reinserting every item
+ ***********************************************************************/
+void latency(int n)
+{
+   typedef Hash <long long, DefaultHasher <long long> > Table;
+   vector <long long> keys = randomKeys <long long> (n, 1);
+   vector <float> incremental(n);
+   vector <float> stopTheWorld(n);
+
+   {
+      Table table;
+      for (int i = 0; i < n; i++)
+      {
+         Clock::time_point start = Clock::now();
+         table.insert(keys[i]);
+         incremental[i] = nanosecondsSince(start);
+      }
+   }
+   {
+      unique_ptr <Table> pTable(new Table(11));
+      for (int i = 0; i < n; i++)
+      {
+         Clock::time_point start = Clock::now();
+         if (pTable->size() + 1 > pTable->capacity())
+         {
+            unique_ptr <Table> pBigger(new Table(pTable->capacity() * 2));
+            for (int j = 0; j < i; j++)
+               pBigger->insert(keys[j]);
+            pTable.swap(pBigger);
+         }
+         pTable->insert(keys[i]);
+         stopTheWorld[i] = nanosecondsSince(start);
+      }
+   }
+
+   cout << "Insert latency growing to " << n << " items\n"
+        << setw(16) << "" << setw(9) << "p50" << setw(9) << "p99"
+        << setw(9) << "p99.9" << setw(9) << "p99.99" << setw(9) << "max" << endl;
+   percentiles("incremental", incremental);
+   percentiles("stop-the-world", stopTheWorld);
+}
+
+/**********************************************************************
+ * TIME FINDS
+ * Nanoseconds per find of every key, and how many were found, which
+ * also keeps the compiler from dropping the finds
+ ***********************************************************************/
+template <class Table, class T>
+double timeFinds(Table & table, const vector <T> & keys, int & numFound)
+{
+   numFound = 0;
+   Clock::time_point start = Clock::now();
+   for (size_t i = 0; i < keys.size(); i++)
+      numFound += table.find(keys[i]);
+   return secondsSince(start) * 1e9 / keys.size();
+}
+
+/**********************************************************************
+ * FLAT
+ * n random ints in a FlatHash and in a Hash that has grown to hold
+ * them, then each found in a different order, and as many absent keys
+ * looked for
+ ***********************************************************************/
+void flat(int n)
+{
+   vector <int> keys = randomKeys <int> (2 * n, 2);
+   vector <int> present(keys.begin(), keys.begin() + n);
+   vector <int> absent(keys.begin() + n, keys.end());
+   vector <int> order(present);
+   shuffle(order.begin(), order.end(), mt19937_64(3));
+
+   FlatHash <int> flatHash;
+   Hash <int, DefaultHasher <int> > hash;
+   for (int i = 0; i < n; i++)
+   {
+      flatHash.insert(present[i]);
+      hash.insert(present[i]);
+   }
+   int numFound = 0;
+   for (int i = 0; i < n; i++)
+      numFound += hash.find(present[i]);     // finish growing
+   HashStats flatStats = flatHash.stats();
+   HashStats hashStats = hash.stats();
+
+   cout << "Finds among " << n << " random ints\n"
+        << setw(16) << "" << setw(9) << "hit" << setw(9) << "miss"
+        << setw(12) << "bytes/item" << endl;
+   double hit = timeFinds(flatHash, order, numFound);
+   double miss = timeFinds(flatHash, absent, numFound);
+   cout << setw(16) << left << "FlatHash" << right << fixed << setprecision(1)
+        << setw(7) << hit << "ns" << setw(7) << miss << "ns"
+        << setw(12) << flatStats.bytesPerItem << endl;
+   hit = timeFinds(hash, order, numFound);
+   miss = timeFinds(hash, absent, numFound);
+   cout << setw(16) << left << "Hash" << right
+        << setw(7) << hit << "ns" << setw(7) << miss << "ns"
+        << setw(12) << hashStats.bytesPerItem << endl;
+   cout.unsetf(ios::fixed);
+}
+
+/**********************************************************************
+ * INT HASH and STRING HASH
+ * Hash <T> the way week12 subclasses it, with a virtual hash()
+ ***********************************************************************/
+class IntHash : public Hash <int>
+{
+public:
+   IntHash(int numBuckets) : Hash <int> (numBuckets) {}
+   int hash(const int & value) const { return value % capacity(); }
+};
+
+class StringHash : public Hash <string>
+{
+public:
+   StringHash(int numBuckets) : Hash <string> (numBuckets) {}
+   int hash(const string & value) const
+   {
+      unsigned int h = 0;
+      for (size_t i = 0; i < value.size(); i++)
+         h = h * 31 + (unsigned char)value[i];
+      return h % capacity();
+   }
+};
+
+/**********************************************************************
+ * STD HASHER
+ * std::hash as it is, the identity for integers
+ ***********************************************************************/
+template <class T>
+struct StdHasher
+{
+   size_t operator () (const T & value) const { return std::hash <T> () (value); }
+};
+
+/**********************************************************************
+ * FIND MIX
+ * About numFinds finds, half hits and half misses, from a table
+ * holding present. Prints milliseconds
+ ***********************************************************************/
+template <class Table, class T>
+void findMix(const char * name, Table & table, const vector <T> & present,
+             const vector <T> & absent, int numFinds)
+{
+   for (size_t i = 0; i < present.size(); i++)
+      table.insert(present[i]);
+   vector <T> keys;
+   for (int i = 0; keys.size() < 1000000 && keys.size() < 2 * present.size(); i++)
+   {
+      keys.push_back(present[i % present.size()]);
+      keys.push_back(absent[i % absent.size()]);
+   }
+   shuffle(keys.begin(), keys.end(), mt19937_64(4));
+
+   // whole passes over the keys, so exactly half are hits
+   int rounds = (numFinds + keys.size() - 1) / keys.size();
+   int numFound = 0;
+   Clock::time_point start = Clock::now();
+   for (int r = 0; r < rounds; r++)
+      for (size_t i = 0; i < keys.size(); i++)
+         numFound += table.find(keys[i]);
+   double ms = secondsSince(start) * 1000.0;
+   cout << setw(34) << left << name << right << setw(8) << (int)ms << "ms"
+        << (numFound == rounds * (int)keys.size() / 2 ? "" : "  (wrong count!)")
+        << endl;
+}
+
+/**********************************************************************
+ * HASHER
+ * 10M finds through each kind of table, at 4K items and at n
+ ***********************************************************************/
+void hasher(int n)
+{
+   const int FINDS = 10000000;
+   int sizes[2] = { 4096, n };
+   for (int s = 0; s < 2; s++)
+   {
+      int size = sizes[s];
+      vector <int> ints = randomKeys <int> (2 * size, 5);
+      vector <int> intsIn(ints.begin(), ints.begin() + size);
+      vector <int> intsOut(ints.begin() + size, ints.end());
+      vector <string> strings(2 * size);
+      for (int i = 0; i < 2 * size; i++)
+         strings[i] = "word" + to_string(ints[i]);
+      vector <string> stringsIn(strings.begin(), strings.begin() + size);
+      vector <string> stringsOut(strings.begin() + size, strings.end());
+
+      cout << "10M finds, half of them hits, among " << size << " items\n";
+      {
+         IntHash table(size);
+         findMix("Hash <int>, virtual %", table, intsIn, intsOut, FINDS);
+      }
+      {
+         Hash <int, DefaultHasher <int> > table(size);
+         findMix("Hash <int, DefaultHasher>", table, intsIn, intsOut, FINDS);
+      }
+      {
+         StringHash table(size);
+         findMix("Hash <string>, virtual *31 %", table, stringsIn, stringsOut, FINDS);
+      }
+      {
+         Hash <string, DefaultHasher <string> > table(size);
+         findMix("Hash <string, DefaultHasher>", table, stringsIn, stringsOut, FINDS);
+      }
+      {
+         FlatHash <int, StdHasher <int> > table;
+         findMix("FlatHash <int>, std::hash", table, intsIn, intsOut, FINDS);
+      }
+      {
+         FlatHash <int> table;
+         findMix("FlatHash <int>, DefaultHasher", table, intsIn, intsOut, FINDS);
+      }
+      {
+         FlatHash <string, StdHasher <string> > table;
+         findMix("FlatHash <string>, std::hash", table, stringsIn, stringsOut, FINDS);
+      }
+      {
+         FlatHash <string> table;
+         findMix("FlatHash <string>, DefaultHasher", table, stringsIn, stringsOut, FINDS);
+      }
+   }
+}
+
+/**********************************************************************
+ * LOCKED FLAT HASH
+ * The simple way to share a table: one lock around all of it
+ ***********************************************************************/
+class LockedFlatHash
+{
+public:
+   void insert(int item)
+   {
+      std::lock_guard <std::mutex> hold(lock);
+      table.insert(item);
+   }
+   bool erase(int item)
+   {
+      std::lock_guard <std::mutex> hold(lock);
+      return table.erase(item);
+   }
+   bool find(int item) const
+   {
+      std::lock_guard <std::mutex> hold(lock);
+      return table.find(item);
+   }
+private:
+   mutable std::mutex lock;
+   FlatHash <int> table;
+};
+
+/**********************************************************************
+ * THROUGHPUT
+ * Millions of operations a second with numThreads threads sharing
+ * numOps operations on the keys, readPercent of them finds and the
+ * rest split between inserts and erases
+ ***********************************************************************/
+template <class Table>
+double throughput(Table & table, const vector <int> & keys, int numOps,
+                  int numThreads, int readPercent)
+{
+   vector <thread> threads;
+   atomic <int> numFound(0);          // keeps the finds from being dropped
+   Clock::time_point start = Clock::now();
+   for (int t = 0; t < numThreads; t++)
+      threads.push_back(thread([&, t]()
+      {
+         mt19937 random(10 + t);
+         int found = 0;
+         for (int i = 0; i < numOps / numThreads; i++)
+         {
+            int key = keys[random() % keys.size()];
+            int choice = random() % 100;
+            if (choice < readPercent)
+               found += table.find(key);
+            else if (choice % 2)
+               table.insert(key);
+            else
+               table.erase(key);
+         }
+         numFound += found;
+      }));
+   for (int t = 0; t < numThreads; t++)
+      threads[t].join();
+   return numOps / secondsSince(start) / 1e6;
+}
+
+/**********************************************************************
+ * CONCURRENT
+ * 4M operations on n keys, half of them in the table to start with.
+ * On a machine with fewer cores than threads this shows the cost of
+ * the locks while time-slicing, not parallel scaling
+ ***********************************************************************/
+void concurrent(int n)
+{
+   const int OPS = 4000000;
+   const int threadCounts[] = { 1, 2, 4, 8, 16, 32 };
+   const int readPercents[] = { 95, 50, 5 };
+   const char * mixes[] = { "read 95%", "mixed", "write 95%" };
+   vector <int> keys = randomKeys <int> (n, 6);
+
+   cout << OPS / 1000000 << "M operations on " << n << " keys, Mops/s, "
+        << thread::hardware_concurrency() << " cores\n"
+        << setw(16) << "threads";
+   for (int t = 0; t < 6; t++)
+      cout << setw(7) << threadCounts[t];
+   cout << endl << fixed << setprecision(1);
+   for (int m = 0; m < 3; m++)
+   {
+      cout << setw(10) << left << mixes[m] << setw(6) << "mutex" << right;
+      for (int t = 0; t < 6; t++)
+      {
+         LockedFlatHash table;
+         for (int i = 0; i < n; i += 2)
+            table.insert(keys[i]);
+         cout << setw(7) << throughput(table, keys, OPS, threadCounts[t], readPercents[m]);
+         cout.flush();
+      }
+      cout << endl << setw(10) << "" << setw(6) << left << "shard" << right;
+      for (int t = 0; t < 6; t++)
+      {
+         ConcurrentHash <int> table(64);
+         for (int i = 0; i < n; i += 2)
+            table.insert(keys[i]);
+         cout << setw(7) << throughput(table, keys, OPS, threadCounts[t], readPercents[m]);
+         cout.flush();
+      }
+      cout << endl;
+   }
+   cout.unsetf(ios::fixed);
+}
+
+/**********************************************************************
+ * ZIPF WORDS
+ * n words from a vocabulary of numWords, the word of rank r drawn in
+ * proportion to 1 / r, as in English text
+ ***********************************************************************/
+vector <string> zipfWords(int n, int numWords, unsigned seed)
+{
+   mt19937_64 random(seed);
+   vector <string> vocabulary(numWords);
+   for (int i = 0; i < numWords; i++)
+   {
+      int length = 2 + random() % 10;
+      for (int j = 0; j < length; j++)
+         vocabulary[i] += (char)('a' + random() % 26);
+      vocabulary[i] += to_string(i);           // no two alike
+   }
+
+   vector <double> cumulative(numWords);
+   double total = 0.0;
+   for (int i = 0; i < numWords; i++)
+      cumulative[i] = total += 1.0 / (i + 1);
+
+   vector <string> words(n);
+   uniform_real_distribution <double> uniform(0.0, total);
+   for (int i = 0; i < n; i++)
+   {
+      int rank = lower_bound(cumulative.begin(), cumulative.end(), uniform(random))
+                 - cumulative.begin();
+      words[i] = vocabulary[rank < numWords ? rank : numWords - 1];
+   }
+   return words;
+}
+
+/**********************************************************************
+ * COUNT WORD
+ * One more of word, with each map's own idiom: week10 used operator[]
+ * on std::map and now uses upsert on HashMap
+ ***********************************************************************/
+template <class Map>
+void countWord(Map & counts, const string & word)
+{
+   counts[word]++;
+}
+
+void countWord(HashMap <string, int> & counts, const string & word)
+{
+   counts.upsert(word, [](int & n) { n++; });
+}
+
+/**********************************************************************
+ * COUNT WORDS
+ * Count every word and print the seconds taken, with the number of
+ * distinct words and the count of the first as a check
+ ***********************************************************************/
+template <class Map>
+void countWords(const char * name, const vector <string> & words)
+{
+   Clock::time_point start = Clock::now();
+   Map counts;
+   for (size_t i = 0; i < words.size(); i++)
+      countWord(counts, words[i]);
+   double seconds = secondsSince(start);
+   cout << setw(22) << left << name << right << fixed << setprecision(2)
+        << setw(8) << seconds << "s" << setw(10) << counts.size() << " words"
+        << setw(10) << counts[words[0]] << endl;
+   cout.unsetf(ios::fixed);
+}
+
+/**********************************************************************
+ * WORD COUNT
+ * Count n Zipf words, the same ones, with each kind of map
+ ***********************************************************************/
+void wordCount(int n)
+{
+   vector <string> words = zipfWords(n, 200000, 7);
+   cout << "Counting " << n << " words from a Zipf vocabulary of 200000\n";
+   countWords <std::map <string, int> > ("std::map", words);
+   countWords <unordered_map <string, int> > ("std::unordered_map", words);
+   countWords <HashMap <string, int> > ("HashMap, upsert", words);
+}
+
+/**********************************************************************
+ * TIME SNAPSHOT
+ * Seconds to save the Hash as a snapshot, synced to disk, and to
+ * restore it into an empty one; then to write the same items as text
+ * and insert them again from it. Reads come from the page cache
+ ***********************************************************************/
+template <class T>
+void timeSnapshot(const char * name, const vector <T> & items)
+{
+   string snapshotName = "/tmp/hashBench-" + to_string(getpid()) + ".snap";
+   string textName = "/tmp/hashBench-" + to_string(getpid()) + ".txt";
+   Hash <T, DefaultHasher <T> > hash;
+   for (size_t i = 0; i < items.size(); i++)
+      hash.insert(items[i]);
+
+   Clock::time_point start = Clock::now();
+   snapshot(hash, snapshotName);
+   double saveSeconds = secondsSince(start);
+   Hash <T, DefaultHasher <T> > restored;
+   start = Clock::now();
+   restore(restored, snapshotName);
+   double restoreSeconds = secondsSince(start);
+   if (restored.size() != hash.size())
+      throw "ERROR: the snapshot lost items";
+
+   start = Clock::now();
+   {
+      ofstream fout(textName.c_str());
+      for (size_t i = 0; i < items.size(); i++)
+         fout << items[i] << '\n';
+   }
+   double writeSeconds = secondsSince(start);
+   Hash <T, DefaultHasher <T> > reinserted;
+   start = Clock::now();
+   {
+      ifstream fin(textName.c_str());
+      T item;
+      while (fin >> item)
+         reinserted.insert(item);
+   }
+   double readSeconds = secondsSince(start);
+
+   ifstream snapshotFile(snapshotName.c_str(), ios::binary | ios::ate);
+   ifstream textFile(textName.c_str(), ios::binary | ios::ate);
+   cout << setw(10) << left << name << right << fixed << setprecision(2)
+        << setw(8) << saveSeconds << "s" << setw(8) << restoreSeconds << "s"
+        << setw(8) << snapshotFile.tellg() / 1e6 << "MB"
+        << setw(8) << writeSeconds << "s" << setw(8) << readSeconds << "s"
+        << setw(8) << textFile.tellg() / 1e6 << "MB" << endl;
+   cout.unsetf(ios::fixed);
+   remove(snapshotName.c_str());
+   remove(textName.c_str());
+}
+
+/**********************************************************************
+ * SNAPSHOTS
+ * n distinct numbers, and n distinct words: a few letters and then
+ * the word's number
+ ***********************************************************************/
+void snapshots(int n)
+{
+   mt19937_64 random(8);
+   vector <long long> numbers(n);
+   for (int i = 0; i < n; i++)
+      numbers[i] = (long long)(random() >> 2) * 4 + i % 4;
+   vector <string> words(n);
+   for (int i = 0; i < n; i++)
+   {
+      for (int j = 2 + random() % 10; j > 0; j--)
+         words[i] += (char)('a' + random() % 26);
+      words[i] += to_string(i);
+   }
+
+   cout << "A Hash of " << n << " numbers and of " << n << " words\n"
+        << setw(10) << "" << setw(9) << "save" << setw(9) << "restore"
+        << setw(10) << "snapshot" << setw(9) << "write" << setw(9) << "insert"
+        << setw(10) << "text" << endl;
+   timeSnapshot("numbers", numbers);
+   timeSnapshot("words", words);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   const char * mode = argc > 1 ? argv[1] : "";
+   int n = argc > 2 ? atoi(argv[2]) : 0;
+
+   if (strcmp(mode, "latency") == 0)
+      latency(n ? n : 10000000);
+   else if (strcmp(mode, "flat") == 0)
+      flat(n ? n : 1000000);
+   else if (strcmp(mode, "hasher") == 0)
+      hasher(n ? n : 1000000);
+   else if (strcmp(mode, "concurrent") == 0)
+      concurrent(n ? n : 1000000);
+   else if (strcmp(mode, "map") == 0)
+      wordCount(n ? n : 20000000);
+   else if (strcmp(mode, "snapshot") == 0)
+      snapshots(n ? n : 5000000);
+   else
+   {
+      cerr << "Usage: " << argv[0] << " latency|flat|hasher|concurrent|map|snapshot [n]\n";
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,216 @@
+/***********************************************************************
+* Header:
+*    Hash Map
+* Author: Daniel Guzman
+* Summary:
+*    A table of key-value pairs laid out like FlatHash, on the same
+*    FlatTable: one array of pairs, one control byte per pair (EMPTY or
+*    seven bits of the key's hash), probed sixteen control bytes at a
+*    time. Counting with it is one probe per key, where std::map takes
+*    O(log n) string compares:
+*
+*       HashMap <string, int> counts;
+*       counts.upsert(word, [](int & n) { n++; });
+************************************************************************/
+
+#ifndef HASH_MAP_H
+#define HASH_MAP_H
+
+#include <cstddef>       // for SIZE_T
+#include <new>           // for PLACEMENT NEW
+#include <utility>       // for PAIR and FORWARD
+#include "flatTable.h"
+
+/**************************************************
+ * HASH MAP
+ * Each slot is a pair, and its first is the key,
+ * const so no iterator can move a pair away from
+ * where its hash says it is. Growing and erasing
+ * move pairs, so any reference or iterator into
+ * the map lasts only until the next insert or
+ * erase
+ *************************************************/
+template <class K, class V, class H = DefaultHasher <K> >
+class HashMap
+{
+public:
+   typedef std::pair <const K, V> value_type;
+   class iterator;
+   class const_iterator;
+
+   HashMap() throw (const char *) {}
+   HashMap(int numItems) throw (const char *) : table(numItems) {}
+
+   // the value for key, inserting V() first if there is none
+   V & operator [] (const K & key) throw (const char *)
+   {
+      return try_emplace(key).first->second;
+   }
+
+   // insert key with V(args...) unless it is already here, in which
+   // case nothing is built. The bool says whether it was inserted
+   template <class ... Args>
+   std::pair <iterator, bool> try_emplace(const K & key, Args && ... args) throw (const char *);
+
+   // call update(V &) on the value for key, inserting V() first if
+   // there is none. One probe either way
+   template <class Update>
+   V & upsert(const K & key, Update update) throw (const char *);
+
+   iterator       find(const K & key);
+   const_iterator find(const K & key) const;
+   bool erase(const K & key) { return table.erase(key, table.hashFunction()(key)); }
+   void clear()              { table.clear(); }
+
+   int  size()     const { return table.size();     }
+   int  capacity() const { return table.capacity(); }
+   bool empty()    const { return table.empty();    }
+
+   iterator       begin()        { return iterator(this, table.next(0));             }
+   iterator       end()          { return iterator(this, table.capacity());          }
+   const_iterator begin()  const { return const_iterator(this, table.next(0));       }
+   const_iterator end()    const { return const_iterator(this, table.capacity());    }
+   const_iterator cbegin() const { return begin(); }
+   const_iterator cend()   const { return end();   }
+
+   // a look at every slot; it rehashes every key, so not for a loop
+   HashStats stats() const { return table.stats(); }
+
+private:
+   typedef FlatTable <value_type, K, KeyIsFirst, H> Table;
+   Table table;
+
+   // where key is, or capacity()
+   int slotOf(const K & key) const
+   {
+      int i = table.find(key, table.hashFunction()(key));
+      return i < 0 ? table.capacity() : i;
+   }
+};
+
+/**************************************************
+ * HASH MAP ITERATOR
+ * Visits the full slots in the order they lie in
+ *************************************************/
+template <class K, class V, class H>
+class HashMap <K, V, H> :: iterator
+{
+public:
+   iterator() : pMap(NULL), i(0) {}
+   iterator(HashMap <K, V, H> * pMap, int i) : pMap(pMap), i(i) {}
+
+   bool operator == (const iterator & rhs) const { return i == rhs.i; }
+   bool operator != (const iterator & rhs) const { return i != rhs.i; }
+
+   value_type & operator *  () const { return pMap->table[i];  }
+   value_type * operator -> () const { return &pMap->table[i]; }
+
+   iterator & operator ++ ()
+   {
+      i = pMap->table.next(i + 1);
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator tmp(*this);
+      ++(*this);
+      return tmp;
+   }
+
+private:
+   friend class const_iterator;
+   HashMap <K, V, H> * pMap;
+   int i;
+};
+
+/**************************************************
+ * HASH MAP CONST ITERATOR
+ * The same walk, handing out const pairs. An
+ * iterator converts to one
+ *************************************************/
+template <class K, class V, class H>
+class HashMap <K, V, H> :: const_iterator
+{
+public:
+   const_iterator() : pMap(NULL), i(0) {}
+   const_iterator(const HashMap <K, V, H> * pMap, int i) : pMap(pMap), i(i) {}
+   const_iterator(const iterator & it) : pMap(it.pMap), i(it.i) {}
+
+   bool operator == (const const_iterator & rhs) const { return i == rhs.i; }
+   bool operator != (const const_iterator & rhs) const { return i != rhs.i; }
+
+   const value_type & operator *  () const { return pMap->table[i];  }
+   const value_type * operator -> () const { return &pMap->table[i]; }
+
+   const_iterator & operator ++ ()
+   {
+      i = pMap->table.next(i + 1);
+      return *this;
+   }
+   const_iterator operator ++ (int postfix)
+   {
+      const_iterator tmp(*this);
+      ++(*this);
+      return tmp;
+   }
+
+private:
+   const HashMap <K, V, H> * pMap;
+   int i;
+};
+
+/**************************************************
+ * HASH MAP TRY EMPLACE
+ * Claim the slot first, and build the pair only if
+ * the key was not there
+ *************************************************/
+template <class K, class V, class H>
+template <class ... Args>
+std::pair <typename HashMap<K, V, H>::iterator, bool>
+HashMap<K, V, H>::try_emplace(const K & key, Args && ... args) throw (const char *)
+{
+   bool inserted;
+   int i = table.claim(key, table.hashFunction()(key), inserted);
+   if (inserted)
+   {
+      try
+      {
+         new (&table[i]) value_type(key, V(std::forward <Args> (args)...));
+      }
+      catch (...)
+      {
+         table.unclaim(i);
+         throw;
+      }
+   }
+   return std::pair <iterator, bool> (iterator(this, i), inserted);
+}
+
+/**************************************************
+ * HASH MAP UPSERT
+ *************************************************/
+template <class K, class V, class H>
+template <class Update>
+V & HashMap<K, V, H>::upsert(const K & key, Update update) throw (const char *)
+{
+   V & value = try_emplace(key).first->second;
+   update(value);
+   return value;
+}
+
+/**************************************************
+ * HASH MAP FIND
+ *************************************************/
+template <class K, class V, class H>
+typename HashMap<K, V, H>::iterator HashMap<K, V, H>::find(const K & key)
+{
+   return iterator(this, slotOf(key));
+}
+
+template <class K, class V, class H>
+typename HashMap<K, V, H>::const_iterator HashMap<K, V, H>::find(const K & key) const
+{
+   return const_iterator(this, slotOf(key));
+}
+
+#endif // HASH_MAP_H
@@ -0,0 +1,141 @@
+/***********************************************************************
+* Header:
+*    Hash Snapshot
+* Author: Daniel Guzman
+* Summary:
+*    Saving a Hash to a snapshot and loading it back, kept out of hash.h
+*    because snapshot.h needs POSIX. A snapshot keeps the buckets as
+*    they are, so restoring puts each item straight back in its bucket,
+*    only hashing it to check that it belongs there. Restore into the
+*    same kind of Hash that took the snapshot.
+************************************************************************/
+
+#ifndef HASH_SNAPSHOT_H
+#define HASH_SNAPSHOT_H
+
+#include "hash.h"
+#include "snapshot.h"
+
+/**************************************************
+ * HASH SNAPSHOT ITERATOR
+ * Every item, bucket by bucket
+ *************************************************/
+template <class T>
+class HashSnapshotIterator  {
+public:
+   HashSnapshotIterator(List<T> * table, int numBuckets) :
+      table(table), bucket(0), numBuckets(numBuckets)  { skipEmpty(); }
+   T & operator * () { return *it; }
+   HashSnapshotIterator & operator ++ ()  {
+      ++it;
+      if (!(it != table[bucket].end()))  {
+         bucket++;
+         skipEmpty();
+      }
+      return *this;
+   }
+private:
+   void skipEmpty()  {
+      while (bucket < numBuckets && table[bucket].empty())
+         bucket++;
+      if (bucket < numBuckets)
+         it = table[bucket].begin();
+   }
+   List<T> * table;
+   int bucket;
+   int numBuckets;
+   ListIterator<T> it;
+};
+
+/**************************************************
+ * SNAPSHOT
+ * The size of every bucket, padded to a multiple
+ * of eight bytes, then every item in bucket order
+ *************************************************/
+template <class T, class H>
+void snapshot(Hash<T, H> & hash, const std::string & fileName)
+   throw (const char *)  {
+   hash.finishGrowth();
+   SnapshotWriter out(fileName, SNAPSHOT_HASH,
+                      SnapshotElements<T>::KIND, SnapshotElements<T>::SIZE);
+   for (int i = 0; i < hash.numBuckets; i++)  {
+      unsigned int count = hash.hashTable[i].size();
+      out.write(&count, sizeof(count));
+   }
+   if (hash.numBuckets % 2)  {
+      unsigned int padding = 0;
+      out.write(&padding, sizeof(padding));
+   }
+   SnapshotElements<T>::write(out,
+      HashSnapshotIterator<T>(hash.hashTable, hash.numBuckets), hash.hSize);
+   out.finish(hash.hSize, hash.numBuckets);
+}
+
+/**************************************************
+ * RESTORE
+ * Everything is checked and the new buckets built
+ * before anything in the Hash is thrown away, so a
+ * bad snapshot or a failed allocation leaves it as
+ * it was
+ *************************************************/
+template <class T, class H>
+void restore(Hash<T, H> & hash, const std::string & fileName)
+   throw (const char *)  {
+   SnapshotReader in(fileName, SNAPSHOT_HASH,
+                     SnapshotElements<T>::KIND, SnapshotElements<T>::SIZE);
+   const SnapshotHeader & header = in.header();
+   unsigned long long buckets = header.extra;
+   unsigned long long countsSize = (buckets + buckets % 2) * sizeof(unsigned int);
+   if (buckets == 0 || buckets > INT_MAX || header.count > INT_MAX ||
+       countsSize > header.payloadSize)
+      throw "ERROR: the snapshot is corrupt";
+   if (hash.bucketsFor(buckets) != buckets)
+      throw "ERROR: the snapshot is of a different kind of hash";
+
+   const unsigned int * counts = (const unsigned int *)in.payload();
+   const char * items = in.payload() + countsSize;
+   size_t itemsSize = header.payloadSize - countsSize;
+   unsigned long long total = 0;
+   for (unsigned long long i = 0; i < buckets; i++)
+      total += counts[i];
+   if (total != header.count ||
+       SnapshotElements<T>::check(items, itemsSize, header.count) != itemsSize)
+      throw "ERROR: the snapshot is corrupt";
+
+   // built aside, checking each item is in the bucket this hash would
+   // put it in: a snapshot taken before the hash function changed
+   // would otherwise load without complaint and then find nothing
+   List<T> * table = Hash<T, H>::allocate(buckets);
+   for (unsigned long long i = 0; i < buckets; i++)
+      new (table + i) List<T>;
+   const char * error = NULL;
+   try  {
+      T item;
+      unsigned long long next = 0;
+      for (int i = 0; i < (int)buckets && error == NULL; i++)
+         for (unsigned int j = 0; j < counts[i] && error == NULL; j++)  {
+            SnapshotElements<T>::get(items, header.count, next++, item);
+            if (hash.bucketIn(item, buckets) != i)
+               error = "ERROR: the snapshot was taken with a different hash";
+            else
+               table[i].push_back(item);
+         }
+   }
+   catch (const char * thrown)  {
+      error = thrown;
+   }
+   catch (std::bad_alloc)  {
+      error = "ERROR: unable to allocate memory for the hash";
+   }
+   if (error != NULL)  {
+      Hash<T, H>::freeBuckets(table, 0, buckets);
+      throw error;
+   }
+
+   hash.release();
+   hash.numBuckets = buckets;
+   hash.hashTable = table;
+   hash.hSize = header.count;
+}
+
+#endif
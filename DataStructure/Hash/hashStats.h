@@ -0,0 +1,168 @@
+/***********************************************************************
+* Header:
+*    Hash Stats
+* Author: Daniel Guzman
+* Summary:
+*    What a hash table looks like inside, for tuning and for catching a
+*    bad hash function: how full it is, how long its chains (or probe
+*    runs) are, what a find costs, and how much memory each item takes.
+*    Hash and FlatHash both fill in a HashStats from stats().
+*
+*    Compiled with HASH_PROBE_STATS, each table also counts its lookups
+*    and, for one in HASH_PROBE_SAMPLE of them, how many probes the
+*    lookup took. Without it the counter is not there at all.
+************************************************************************/
+
+#ifndef HASH_STATS_H
+#define HASH_STATS_H
+
+#include <ostream>
+#ifdef HASH_PROBE_STATS
+#include <atomic>
+#endif
+
+// histogram bins; the last one also counts everything longer
+#define HASH_STATS_BINS 16
+
+/**************************************************
+ * HASH STATS
+ * A probe is one chain node compared in Hash, and
+ * one group of sixteen control bytes loaded in
+ * FlatHash. The histogram counts buckets by chain
+ * length in Hash, and items by how many slots past
+ * their home slot they sit in FlatHash
+ *************************************************/
+struct HashStats
+{
+   int size;
+   int buckets;                // or slots
+   double loadFactor;
+   long long histogram[HASH_STATS_BINS];
+   int longest;                // longest chain, or furthest from home
+   double successful;          // average probes to find an item there
+   double unsuccessful;        // average probes for one that is not
+   double bytesPerItem;        // the whole table over its items
+   double overheadPerItem;     // the same less the item itself
+
+   // from the probe counter, all 0 without HASH_PROBE_STATS
+   long long operations;       // lookups counted
+   long long sampled;          // lookups whose probes were counted
+   long long sampledProbes;
+   int sampledLongest;
+
+   HashStats() : size(0), buckets(0), loadFactor(0.0), longest(0),
+                 successful(0.0), unsuccessful(0.0), bytesPerItem(0.0),
+                 overheadPerItem(0.0), operations(0), sampled(0),
+                 sampledProbes(0), sampledLongest(0)
+   {
+      for (int i = 0; i < HASH_STATS_BINS; i++)
+         histogram[i] = 0;
+   }
+
+   // count one chain or run of this length
+   void add(int length, long long times = 1)
+   {
+      histogram[length < HASH_STATS_BINS ? length : HASH_STATS_BINS - 1] += times;
+      if (length > longest)
+         longest = length;
+   }
+};
+
+/**************************************************
+ * HASH STATS INSERTION
+ * A few lines a person can read; empty bins at the
+ * end of the histogram are left off
+ *************************************************/
+inline std::ostream & operator << (std::ostream & out, const HashStats & stats)
+{
+   std::streamsize precision = out.precision(3);
+   out << "\tSize:         " << stats.size << '\n'
+       << "\tBuckets:      " << stats.buckets << '\n'
+       << "\tLoad factor:  " << stats.loadFactor << '\n'
+       << "\tLongest:      " << stats.longest << '\n'
+       << "\tProbes:       " << stats.successful << " to find, "
+       << stats.unsuccessful << " to miss\n"
+       << "\tBytes/item:   " << stats.bytesPerItem << " ("
+       << stats.overheadPerItem << " overhead)\n";
+
+   int last = HASH_STATS_BINS - 1;
+   while (last > 0 && stats.histogram[last] == 0)
+      last--;
+   out << "\tHistogram:   ";
+   for (int i = 0; i <= last; i++)
+      out << ' ' << i << (i == HASH_STATS_BINS - 1 ? "+:" : ":")
+          << stats.histogram[i];
+   out << '\n';
+
+   if (stats.sampled)
+      out << "\tSampled:      " << stats.sampled << " of " << stats.operations
+          << " lookups, " << (double)stats.sampledProbes / stats.sampled
+          << " probes, at most " << stats.sampledLongest << '\n';
+   out.precision(precision);
+   return out;
+}
+
+#ifdef HASH_PROBE_STATS
+
+#ifndef HASH_PROBE_SAMPLE
+#define HASH_PROBE_SAMPLE 64
+#endif
+
+/**************************************************
+ * PROBE COUNTER
+ * Counts lookups, and the probes of every
+ * HASH_PROBE_SAMPLE-th one. Finds may run on many
+ * threads at once under a shared lock, so the counts
+ * are atomics, read and written without a locked
+ * add: two threads may now and then count as one,
+ * which a sample can live with
+ *************************************************/
+class ProbeCounter
+{
+public:
+   ProbeCounter() : operations(0), sampled(0), probes(0), longest(0) {}
+
+   void record(int numProbes) const
+   {
+      long long n = operations.load(std::memory_order_relaxed);
+      operations.store(n + 1, std::memory_order_relaxed);
+      if (n % HASH_PROBE_SAMPLE)
+         return;
+      sampled.store(sampled.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+      probes.store(probes.load(std::memory_order_relaxed) + numProbes,
+                   std::memory_order_relaxed);
+      if (numProbes > longest.load(std::memory_order_relaxed))
+         longest.store(numProbes, std::memory_order_relaxed);
+   }
+
+   void report(HashStats & stats) const
+   {
+      stats.operations = operations.load(std::memory_order_relaxed);
+      stats.sampled = sampled.load(std::memory_order_relaxed);
+      stats.sampledProbes = probes.load(std::memory_order_relaxed);
+      stats.sampledLongest = longest.load(std::memory_order_relaxed);
+   }
+
+private:
+   // no copying: each table counts its own lookups
+   ProbeCounter(const ProbeCounter &);
+   ProbeCounter & operator = (const ProbeCounter &);
+
+   mutable std::atomic <long long> operations;
+   mutable std::atomic <long long> sampled;
+   mutable std::atomic <long long> probes;
+   mutable std::atomic <int> longest;
+};
+
+#define HASH_PROBE_RECORD(counter, numProbes) (counter).record(numProbes)
+#define HASH_PROBE_REPORT(counter, stats)     (counter).report(stats)
+
+#else
+
+#define HASH_PROBE_RECORD(counter, numProbes)
+#define HASH_PROBE_REPORT(counter, stats)
+
+#endif // HASH_PROBE_STATS
+
+#endif // HASH_STATS_H
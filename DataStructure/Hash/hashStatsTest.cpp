@@ -0,0 +1,286 @@
+/***********************************************************************
+ * Program:
+ *    HASH STATS TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks what stats() says about Hash and FlatHash against tables
+ *    built so that every chain, and every slot's distance from home,
+ *    is known ahead: the histogram, the longest, the probes to find
+ *    and to miss, and the bytes per item. Then checks those averages
+ *    against the probes the tables themselves count, finding every
+ *    item once and missing once from every bucket or slot, which must
+ *    agree exactly. Must be built with -DHASH_PROBE_STATS
+ *    -DHASH_PROBE_SAMPLE=1 ("make test" does), so every lookup is
+ *    counted. Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cmath>           // for FABS
+#include <cstdlib>         // for EXIT
+#include <random>          // for MT19937_64
+#include <vector>
+#include "hash.h"
+#include "flatHash.h"
+using namespace std;
+
+#if !defined(HASH_PROBE_STATS) || HASH_PROBE_SAMPLE != 1
+#error "build with -DHASH_PROBE_STATS -DHASH_PROBE_SAMPLE=1"
+#endif
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * MOD HASH
+ * The week 12 way, so an item's bucket is plain to see
+ ***********************************************************************/
+class ModHash : public Hash <int>
+{
+public:
+   ModHash(int cap) throw (const char *) : Hash <int> (cap) {}
+   int hash(const int & value) const { return value % capacity(); }
+};
+
+/**********************************************************************
+ * IDENTITY HASHER
+ * The key is its own hash, so its home slot is key >> 7 and its tag
+ * the low seven bits
+ ***********************************************************************/
+struct IdentityHasher
+{
+   size_t operator () (unsigned long long key) const { return key; }
+};
+
+/**********************************************************************
+ * PROBES
+ * What the probe counter has seen so far, to take differences of
+ ***********************************************************************/
+struct Probes
+{
+   long long lookups;
+   long long probes;
+   Probes(const HashStats & stats) :
+      lookups(stats.sampled), probes(stats.sampledProbes) {}
+};
+
+/**********************************************************************
+ * SAME AVERAGE
+ * The probes counted between before and after average exactly what
+ * stats() worked out. Both divide whole numbers, so if the totals
+ * agree the doubles do too
+ ***********************************************************************/
+bool sameAverage(const Probes & before, const Probes & after, double expected)
+{
+   long long lookups = after.lookups - before.lookups;
+   return lookups > 0 &&
+      (double)(after.probes - before.probes) / lookups == expected;
+}
+
+/**********************************************************************
+ * HASH CHAINS
+ * Bucket b holds b % 5 items, and the last one 20, more than the
+ * histogram has bins for. The buckets never change, so every number
+ * is known
+ ***********************************************************************/
+void hashChains()
+{
+   const int BUCKETS = 50;
+   ModHash table(BUCKETS);
+   table.setMaxLoadFactor(0);
+   vector <int> lengths(BUCKETS);
+   long long expectedHistogram[HASH_STATS_BINS] = { 0 };
+   long long found = 0;
+   int n = 0;
+   for (int b = 0; b < BUCKETS; b++)
+   {
+      lengths[b] = (b == BUCKETS - 1) ? 20 : b % 5;
+      for (int j = 0; j < lengths[b]; j++)
+         table.insert(b + BUCKETS * j);
+      expectedHistogram[min(lengths[b], HASH_STATS_BINS - 1)]++;
+      found += lengths[b] * (lengths[b] + 1) / 2;
+      n += lengths[b];
+   }
+
+   HashStats stats = table.stats();
+   CHECK(stats.size == n);
+   CHECK(stats.buckets == BUCKETS);
+   CHECK(stats.loadFactor == (double)n / BUCKETS);
+   for (int i = 0; i < HASH_STATS_BINS; i++)
+      CHECK(stats.histogram[i] == expectedHistogram[i]);
+   CHECK(stats.longest == 20);
+   CHECK(stats.successful == (double)found / n);
+   CHECK(stats.unsuccessful == (double)n / BUCKETS);
+   double bytes = (double)n * sizeof(Node <int>) + (double)BUCKETS * sizeof(List <int>);
+   CHECK(stats.bytesPerItem == bytes / n);
+   CHECK(stats.overheadPerItem == bytes / n - sizeof(int));
+
+   // every item once, then one miss in every bucket
+   Probes start(stats);
+   for (int b = 0; b < BUCKETS; b++)
+      for (int j = 0; j < lengths[b]; j++)
+         CHECK(table.find(b + BUCKETS * j));
+   HashStats afterHits = table.stats();
+   CHECK(sameAverage(start, afterHits, stats.successful));
+   CHECK(afterHits.sampledLongest == 20);
+
+   for (int b = 0; b < BUCKETS; b++)
+      CHECK(!table.find(b + BUCKETS * 1000));
+   HashStats afterMisses = table.stats();
+   CHECK(sameAverage(afterHits, afterMisses, stats.unsuccessful));
+   CHECK(afterMisses.operations == afterMisses.sampled);
+   CHECK(afterMisses.operations - stats.operations == n + BUCKETS);
+}
+
+/**********************************************************************
+ * HASH GROWN
+ * A hasher, a table that has grown many times, and random misses.
+ * Hits must still agree exactly; random misses land on buckets
+ * unevenly, so they only come out about right
+ ***********************************************************************/
+void hashGrown()
+{
+   Hash <int, DefaultHasher <int> > table;
+   const int n = 100000;
+   for (int i = 0; i < n; i++)
+      table.insert(i * 3);
+   int settle = 0;
+   while (table.growing())
+      table.find(settle++ * 3 % n);
+
+   HashStats stats = table.stats();
+   long long buckets = 0;
+   long long items = 0;
+   for (int i = 0; i < HASH_STATS_BINS; i++)
+   {
+      buckets += stats.histogram[i];
+      items += stats.histogram[i] * i;
+   }
+   CHECK(buckets == stats.buckets);
+   CHECK(stats.histogram[HASH_STATS_BINS - 1] != 0 || items == n);
+   CHECK(stats.longest < HASH_STATS_BINS);
+
+   Probes start(stats);
+   for (int i = 0; i < n; i++)
+      CHECK(table.find(i * 3));
+   HashStats afterHits = table.stats();
+   CHECK(sameAverage(start, afterHits, stats.successful));
+
+   mt19937_64 random(50);
+   for (int i = 0; i < n; i++)
+      CHECK(!table.find((int)(random() % n) * 3 + 1));
+   HashStats afterMisses = table.stats();
+   double missed = (double)(afterMisses.sampledProbes - afterHits.sampledProbes) / n;
+   CHECK(fabs(missed - stats.unsuccessful) < 0.05 * stats.unsuccessful);
+}
+
+/**********************************************************************
+ * FLAT CLUSTER
+ * Forty keys with the same home slot fill slots 0 to 39 of 64, one
+ * each from 0 to 39 slots from home: the clustering a poor hash
+ * gives, and how far it pushes the probes out
+ ***********************************************************************/
+void flatCluster()
+{
+   FlatHash <unsigned long long, IdentityHasher> table;
+   for (unsigned long long key = 0; key < 40; key++)
+      table.insert(key);
+
+   HashStats stats = table.stats();
+   CHECK(stats.size == 40);
+   CHECK(stats.buckets == 64);
+   CHECK(table.capacity() == 64);
+   for (int i = 0; i < HASH_STATS_BINS - 1; i++)
+      CHECK(stats.histogram[i] == 1);
+   CHECK(stats.histogram[HASH_STATS_BINS - 1] == 40 - (HASH_STATS_BINS - 1));
+   CHECK(stats.longest == 39);
+
+   // distance d is found in group d / 16 + 1; a miss from slot i
+   // loads groups until it reaches slot 40, the first empty one
+   CHECK(stats.successful == (16 * 1 + 16 * 2 + 8 * 3) / 40.0);
+   long long missed = 0;
+   for (int i = 0; i < 64; i++)
+      missed += (i < 40 ? 40 - i : 0) / 16 + 1;
+   CHECK(stats.unsuccessful == missed / 64.0);
+   double bytes = 64.0 * (sizeof(unsigned long long) + 1) + 16;
+   CHECK(stats.bytesPerItem == bytes / 40);
+   CHECK(stats.overheadPerItem == bytes / 40 - sizeof(unsigned long long));
+
+   Probes start(stats);
+   for (unsigned long long key = 0; key < 40; key++)
+      CHECK(table.find(key));
+   HashStats afterHits = table.stats();
+   CHECK(sameAverage(start, afterHits, stats.successful));
+   CHECK(afterHits.sampledLongest == 3);
+
+   // a key with bit 40 set is never in the table, and its home is
+   // its bits from 7 up, mod 64
+   for (unsigned long long slot = 0; slot < 64; slot++)
+      CHECK(!table.find((1ULL << 40) | (slot << 7)));
+   HashStats afterMisses = table.stats();
+   CHECK(sameAverage(afterHits, afterMisses, stats.unsuccessful));
+   CHECK(afterMisses.operations - stats.operations == 40 + 64);
+}
+
+/**********************************************************************
+ * FLAT RANDOM
+ * Random keys, a full table's worth, with a miss from every slot.
+ * Both averages must agree exactly with the probes counted, and the
+ * histogram must account for every item. A copy counts its own
+ * lookups from nothing, so its longest is the hits' alone
+ ***********************************************************************/
+void flatRandom()
+{
+   FlatHash <unsigned long long, IdentityHasher> table;
+   mt19937_64 random(50);
+   vector <unsigned long long> keys;
+   while (table.size() < 100000)
+   {
+      unsigned long long key = random() >> 1;     // bit 63 clear
+      int size = table.size();
+      table.insert(key);
+      if (table.size() > size)
+         keys.push_back(key);
+   }
+
+   HashStats stats = table.stats();
+   long long items = 0;
+   for (int i = 0; i < HASH_STATS_BINS; i++)
+      items += stats.histogram[i];
+   CHECK(items == stats.size);
+   CHECK(stats.loadFactor > 0.3 && stats.loadFactor <= 0.875);
+   CHECK(stats.successful >= 1.0 && stats.unsuccessful >= 1.0);
+
+   FlatHash <unsigned long long, IdentityHasher> copy(table);
+   HashStats copied = copy.stats();
+   CHECK(copied.operations == 0);
+   for (int i = 0; i < keys.size(); i++)
+      CHECK(copy.find(keys[i]));
+   HashStats copyHits = copy.stats();
+   CHECK(sameAverage(Probes(copied), copyHits, stats.successful));
+   CHECK(copyHits.sampledLongest == stats.longest / 16 + 1);
+
+   HashStats afterHits = table.stats();
+
+   for (unsigned long long slot = 0; slot < (unsigned long long)stats.buckets; slot++)
+      CHECK(!table.find((1ULL << 63) | (slot << 7)));
+   HashStats afterMisses = table.stats();
+   CHECK(sameAverage(afterHits, afterMisses, stats.unsuccessful));
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   hashChains();
+   hashGrown();
+   flatCluster();
+   flatRandom();
+   cout << "Hash stats tests passed\n";
+   return 0;
+}
@@ -0,0 +1,136 @@
+/***********************************************************************
+ * Program:
+ *    HASH TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks that Hash's incremental growth finishes: through a long run
+ *    of inserts every growth ends within 3n / 8 operations of starting,
+ *    well before the next is due, so growing() is false most of the
+ *    time. Every item must be found while it grows, with a hasher and
+ *    with a virtual hash(), and finds alone must finish a growth too.
+ *    Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT
+#include "hash.h"
+#include "hasher.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * KEY
+ * Item number n
+ ***********************************************************************/
+int key(int n) { return n * 7919; }
+
+/**********************************************************************
+ * MOD HASH
+ * The week 12 way: subclass and override hash()
+ ***********************************************************************/
+class ModHash : public Hash <int>
+{
+public:
+   ModHash() throw (const char *) : Hash <int> () {}
+   int hash(const int & value) const
+   {
+      return (value & 0x7fffffff) % capacity();
+   }
+};
+
+/**********************************************************************
+ * LONG RUN
+ * Insert n items, one operation at a time, and time every growth
+ * from the insert that starts it to the one that sees it over. All
+ * of the items so far are looked for part way through every other
+ * growth
+ ***********************************************************************/
+template <class Table>
+void longRun(Table & table, int n)
+{
+   int numGrowths = 0;
+   int numGrowing = 0;
+   int start = 0;
+   int bucketsBefore = table.capacity();
+   bool wasGrowing = false;
+   for (int i = 0; i < n; i++)
+   {
+      table.insert(key(i));
+      bool growing = table.growing();
+      if (growing)
+         numGrowing++;
+      if (growing && !wasGrowing)
+      {
+         start = i;
+         bucketsBefore = table.capacity();
+         numGrowths++;
+      }
+      if (!growing && wasGrowing)
+      {
+         // the capacity changes once the bigger table is built
+         CHECK(table.capacity() > bucketsBefore);
+         CHECK(i - start <= 3 * bucketsBefore / 8 + 2);
+      }
+      // finds move growth along too, so only every other one is timed
+      if (growing && i - start == 100 && numGrowths % 2)
+         for (int j = 0; j <= i; j++)
+            CHECK(table.find(key(j)));
+      wasGrowing = growing;
+   }
+   CHECK(table.size() == n);
+   CHECK(numGrowths > 10);
+   CHECK(numGrowing < n / 2);
+
+   // whatever is left of the last one goes as they are all found
+   for (int i = 0; i < n; i++)
+      CHECK(table.find(key(i)));
+   CHECK(!table.growing());
+   CHECK(!table.find(key(n)));
+   CHECK(table.size() <= table.capacity());
+}
+
+/**********************************************************************
+ * FINDS FINISH
+ * Start a growth with one insert and let nothing but finds, hits and
+ * misses both, carry it through
+ ***********************************************************************/
+void findsFinish()
+{
+   Hash <int, DefaultHasher <int> > table;
+   int n = 0;
+   while (!table.growing())
+      table.insert(key(n++));
+   int buckets = table.capacity();
+   int numFinds = 0;
+   while (table.growing())
+   {
+      CHECK(table.find(key(numFinds % n)));
+      CHECK(!table.find(key(n + numFinds)));
+      numFinds += 2;
+      CHECK(numFinds <= 3 * buckets / 8 + 2);
+   }
+   CHECK(table.capacity() > buckets);
+   for (int i = 0; i < n; i++)
+      CHECK(table.find(key(i)));
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   Hash <int, DefaultHasher <int> > hashed;
+   longRun(hashed, 1000000);
+   ModHash modded;
+   longRun(modded, 300000);
+   findsFinish();
+   cout << "Hash tests passed\n";
+   return 0;
+}
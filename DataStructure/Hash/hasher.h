@@ -0,0 +1,160 @@
+/***********************************************************************
+* Header:
+*    Hasher
+* Author: Daniel Guzman
+* Summary:
+*    Hash functions small enough to inline, for tables that pick a
+*    bucket by masking with a power of two. Masking keeps only the low
+*    bits, so every hasher here makes sure the high bits of the value
+*    reach them:
+*       integers   SplitMix64's finalizer: two multiplies, three shifts
+*       float      the bit pattern, with -0.0 made the same as 0.0
+*       strings    eight bytes at a time through a 64x64->128 multiply
+*    Anything else goes through std::hash and the integer mix.
+************************************************************************/
+
+#ifndef HASHER_H
+#define HASHER_H
+
+#include <cstddef>       // for SIZE_T
+#include <cstring>       // for MEMCPY
+#include <functional>    // for STD::HASH
+#include <string>
+
+/**************************************************
+ * HASH MULTIPLY
+ * The full 128-bit product, its halves xored: each
+ * bit of either input reaches every bit above it
+ * in the low half and every bit below in the high
+ *************************************************/
+inline unsigned long long hashMultiply(unsigned long long a, unsigned long long b)
+{
+   unsigned __int128 r = (unsigned __int128)a * b;
+   return (unsigned long long)(r >> 64) ^ (unsigned long long)r;
+}
+
+/**************************************************
+ * HASH MIX
+ * SplitMix64's finalizer: every bit of x reaches
+ * every bit of the result. A single multiply only
+ * carries bits upwards, so keys whose low bits are
+ * all zero, such as doubles holding whole numbers,
+ * used to crowd into a few buckets
+ *************************************************/
+inline size_t hashMix(unsigned long long x)
+{
+   x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+   return (size_t)(x ^ (x >> 31));
+}
+
+/**************************************************
+ * HASH BYTES
+ * Sixteen bytes per multiply, each word xored with
+ * a constant so that zeros still mix. The last one
+ * to sixteen bytes are read as two words that may
+ * overlap, which beats copying a variable number.
+ * Each seed gives an unrelated function of the
+ * bytes; seed 0 is the one the tables use
+ *************************************************/
+inline size_t hashBytes(const char * p, size_t length,
+                        unsigned long long seed = 0)
+{
+   const unsigned long long K0 = 0xa0761d6478bd642fULL;
+   const unsigned long long K1 = 0xe7037ed1a0b428dbULL;
+   // the length gets a multiply of its own: xored straight into h it
+   // could cancel a difference in b, so "1000" and "10000" collided
+   unsigned long long h = hashMultiply(K0 ^ length, K1 ^ seed);
+   unsigned long long a = 0;
+   unsigned long long b = 0;
+
+   for (; length > 16; p += 16, length -= 16)
+   {
+      memcpy(&a, p, 8);
+      memcpy(&b, p + 8, 8);
+      h = hashMultiply(a ^ K0, b ^ h);
+   }
+
+   if (length >= 8)
+   {
+      memcpy(&a, p, 8);
+      memcpy(&b, p + length - 8, 8);
+   }
+   else if (length >= 4)
+   {
+      unsigned int first;
+      unsigned int last;
+      memcpy(&first, p, 4);
+      memcpy(&last, p + length - 4, 4);
+      a = first;
+      b = last;
+   }
+   else if (length > 0)
+      a = (unsigned long long)(unsigned char)p[0] << 16 |
+          (unsigned long long)(unsigned char)p[length / 2] << 8 |
+          (unsigned char)p[length - 1];
+
+   h = hashMultiply(a ^ K0, b ^ h ^ K1);
+   return (size_t)hashMultiply(h, K1);
+}
+
+/**************************************************
+ * DEFAULT HASHER
+ * std::hash is the identity for integers and
+ * pointers, so the integer mix is all they need
+ *************************************************/
+template <class T>
+struct DefaultHasher
+{
+   size_t operator () (const T & value) const
+   {
+      return hashMix(std::hash <T> () (value));
+   }
+};
+
+template <>
+struct DefaultHasher <float>
+{
+   size_t operator () (float value) const
+   {
+      unsigned int bits;
+      if (value == 0.0f)
+         value = 0.0f;
+      memcpy(&bits, &value, sizeof(bits));
+      return hashMix(bits);
+   }
+};
+
+template <>
+struct DefaultHasher <double>
+{
+   size_t operator () (double value) const
+   {
+      unsigned long long bits;
+      if (value == 0.0)
+         value = 0.0;
+      memcpy(&bits, &value, sizeof(bits));
+      return hashMix(bits);
+   }
+};
+
+template <>
+struct DefaultHasher <std::string>
+{
+   size_t operator () (const std::string & value) const
+   {
+      return hashBytes(value.data(), value.size());
+   }
+};
+
+/**************************************************
+ * VIRTUAL HASH
+ * Not a hasher: tells Hash <T> to call its own
+ * virtual hash(), as a subclass defines it
+ *************************************************/
+template <class T>
+struct VirtualHash
+{
+};
+
+#endif // HASHER_H
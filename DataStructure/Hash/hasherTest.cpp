@@ -0,0 +1,109 @@
+/***********************************************************************
+ * Program:
+ *    HASHER TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks the hashers in hasher.h: that strings differing only in
+ *    length and a byte or two, such as "1000" and "10000", do not
+ *    collide in all 64 bits, that none of a million numbered strings
+ *    do, and that the low bits a table masks off spread keys evenly.
+ *    Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "hasher.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+size_t hashOf(const string & s) { return hashBytes(s.data(), s.size()); }
+
+/**********************************************************************
+ * LENGTH PAIRS
+ * Once, the length was xored into the same word as the tail bytes, so
+ * one more character could cancel out the change it made
+ ***********************************************************************/
+void lengthPairs()
+{
+   CHECK(hashOf("w1220") != hashOf("w12220"));
+   CHECK(hashOf("1000") != hashOf("10000"));
+   CHECK(hashOf("") != hashOf(string(1, '\0')));
+   CHECK(hashOf(string(1, '\0')) != hashOf(string(2, '\0')));
+
+   // every length from 0 to 40 of the same byte, and of zeros
+   unordered_set <size_t> seen;
+   for (int length = 0; length <= 40; length++)
+   {
+      CHECK(seen.insert(hashOf(string(length, 'a'))).second);
+      CHECK(seen.insert(hashOf(string(length, '\0'))).second || length == 0);
+   }
+}
+
+/**********************************************************************
+ * NUMBERED STRINGS
+ * "0" to "999999" and "w0" to "w999999": no two share a full hash
+ ***********************************************************************/
+void numberedStrings()
+{
+   const char * prefixes[] = { "", "w", "word-" };
+   for (int p = 0; p < 3; p++)
+   {
+      unordered_set <size_t> seen;
+      for (int i = 0; i < 1000000; i++)
+         CHECK(seen.insert(hashOf(prefixes[p] + to_string(i))).second);
+   }
+}
+
+/**********************************************************************
+ * LOW BITS
+ * Masked to 2^16 buckets, a million keys should fill them about
+ * evenly. At random, about 15 keys land in each, and one with more
+ * than three times that would turn up once in a hundred billion runs
+ ***********************************************************************/
+template <class T>
+void lowBits(T (*make)(int))
+{
+   const int BUCKETS = 1 << 16;
+   const int NUM = 1000000;
+   vector <int> counts(BUCKETS);
+   DefaultHasher <T> hasher;
+   for (int i = 0; i < NUM; i++)
+      counts[hasher(make(i)) & (BUCKETS - 1)]++;
+   for (int i = 0; i < BUCKETS; i++)
+      CHECK(counts[i] <= 3 * NUM / BUCKETS);
+}
+
+int       makeInt(int i)    { return i * 1024; }
+long long makeLong(int i)  { return (long long)i << 32; }
+double    makeDouble(int i) { return i * 0.5; }
+string    makeString(int i) { return to_string(i); }
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   lengthPairs();
+   numberedStrings();
+   lowBits(makeInt);
+   lowBits(makeLong);
+   lowBits(makeDouble);
+   lowBits(makeString);
+
+   // -0.0 and 0.0 are equal, so they must hash the same
+   CHECK(DefaultHasher <double> () (-0.0) == DefaultHasher <double> () (0.0));
+   CHECK(DefaultHasher <float> () (-0.0f) == DefaultHasher <float> () (0.0f));
+
+   cout << "Hasher tests passed\n";
+   return 0;
+}
@@ -11,6 +11,7 @@
 
 #include <iostream>
 #include <string>
+#include "pool.h"
 
 using namespace std;
 
@@ -34,6 +35,14 @@ public:
       pPrev = 0;
    }
 
+   // nodes come from the slab pool rather than the general heap
+   static void * operator new(size_t size) {
+      return NodePool <sizeof(Node <T>)> :: allocate();
+   }
+   static void operator delete(void * p) {
+      NodePool <sizeof(Node <T>)> :: release(p);
+   }
+
    T data;
    Node<T> * pNext;
    Node<T> * pPrev;
@@ -117,12 +126,17 @@ public:
          throw "ERROR: unable to access data from an empty list";
    }
 
+   // hands the nodes back to the pool in batches
    void freeData(Node<T> *&pHead) {
 
-      if (pHead == NULL)
-         return;
-      freeData(pHead->pNext);
-      delete pHead;
+      typename NodePool <sizeof(Node <T>)> :: Chain chain;
+      for (Node<T> *p = pHead; p; ) {
+         Node<T> *pNext = p->pNext;
+         p->~Node();
+         chain.add(p);
+         p = pNext;
+      }
+      chain.release();
       pHead = pTail = NULL;
       length = 0;
    }
@@ -162,6 +176,29 @@ public:
          throw "ERROR: unable to allocate a new node for a list";
       }
    }
+
+   // moves the first node of rhs onto the end of this list. No node is
+   // allocated or freed, so rehashing a Hash costs no trips to the pool
+   void spliceFront(List<T> &rhs) {
+      Node<T> *pMove = rhs.pHead;
+      if (pMove == NULL)
+         return;
+      rhs.pHead = pMove->pNext;
+      if (rhs.pHead != NULL)
+         rhs.pHead->pPrev = NULL;
+      else
+         rhs.pTail = NULL;
+      rhs.length--;
+
+      pMove->pNext = NULL;
+      pMove->pPrev = pTail;
+      if (pTail != NULL)
+         pTail->pNext = pMove;
+      else
+         pHead = pMove;
+      pTail = pMove;
+      length++;
+   }
   
    List<T> &operator=(const List<T> &rhs) {
       clear();
@@ -0,0 +1,367 @@
+/***********************************************************************
+ * Module:
+ *    Perfect Hash
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Building, writing and mapping the perfect hash image. See
+ *    perfectHash.h
+ ************************************************************************/
+
+#include <algorithm>     // for MIN and SORT
+#include <cstdio>        // for FOPEN and FWRITE
+#include <cstring>       // for MEMCMP and MEMSET
+#include <fcntl.h>       // for OPEN
+#include <sys/mman.h>    // for MMAP
+#include <sys/stat.h>    // for FSTAT
+#include <unistd.h>      // for CLOSE
+#include "perfectHash.h"
+using namespace std;
+
+#define IMAGE_MAGIC   0x48534850   // "PHSH"
+#define IMAGE_VERSION 3            // 3: deep levels hash the word again
+
+/*****************************************
+ * PERFECT HASH :: HEADER
+ * The start of the file. Every section
+ * after it starts on an eight byte boundary
+ * or needs no more than four
+ ****************************************/
+struct PerfectHash::Header
+{
+   unsigned int magic;
+   unsigned int version;
+   unsigned int numWords;
+   unsigned int numLevels;
+   unsigned long long numBits;
+   unsigned long long poolSize;
+   unsigned long long levelStart[MAX_LEVELS + 1];
+};
+
+/*****************************************
+ * PERFECT HASH :: CONSTRUCTOR and DESTRUCTOR
+ ****************************************/
+PerfectHash::PerfectHash() : image(NULL), imageSize(0), numWords(0), numLevels(0),
+   levelStart(NULL), bits(NULL), ranks(NULL), offsets(NULL), pool(NULL)
+{
+}
+
+PerfectHash::~PerfectHash()
+{
+   close();
+}
+
+/*****************************************
+ * PERFECT HASH :: INDEX
+ * The number of the word, or -1 if it fell
+ * through every level and so is not one
+ ****************************************/
+long long PerfectHash::index(const char * word, int length, size_t h) const
+{
+   for (int level = 0; level < numLevels; level++)
+   {
+      unsigned long long size = levelStart[level + 1] - levelStart[level];
+      unsigned long long bit = levelStart[level] +
+                               levelBit(levelHash(word, length, h, level), level, size);
+      unsigned long long set = bits[bit >> 6];
+      if ((set >> (bit & 63)) & 1)
+      {
+         long long rank = ranks[bit / RANK_BLOCK];
+         for (unsigned long long w = bit / RANK_BLOCK * (RANK_BLOCK / 64); w < (bit >> 6); w++)
+            rank += __builtin_popcountll(bits[w]);
+         return rank + __builtin_popcountll(set & ((1ULL << (bit & 63)) - 1));
+      }
+   }
+   return -1;
+}
+
+/*****************************************
+ * PERFECT HASH :: FIND
+ * A word not in the list still gets a number
+ * most of the time, so check the word there
+ ****************************************/
+bool PerfectHash::find(const char * word, int length, size_t h) const
+{
+   long long i = index(word, length, h);
+   if (i < 0)
+      return false;
+   return offsets[i + 1] - offsets[i] == (unsigned int)length &&
+          memcmp(pool + offsets[i], word, length) == 0;
+}
+
+/*****************************************
+ * PERFECT HASH :: FIND MANY
+ ****************************************/
+void PerfectHash::findMany(const string * words, const size_t * hashes,
+                           int num, bool * found) const
+{
+   const int BATCH = 32;
+   long long numbers[BATCH];
+   for (int first = 0; first < num; first += BATCH)
+   {
+      int last = min(num, first + BATCH);
+      for (int i = first; i < last; i++)
+      {
+         unsigned long long size = levelStart[1] - levelStart[0];
+         __builtin_prefetch(bits + (levelBit(hashes[i], 0, size) >> 6));
+      }
+      for (int i = first; i < last; i++)
+      {
+         numbers[i - first] = index(words[i].data(), words[i].size(), hashes[i]);
+         if (numbers[i - first] >= 0)
+            __builtin_prefetch(offsets + numbers[i - first]);
+      }
+      for (int i = first; i < last; i++)
+         if (numbers[i - first] >= 0)
+            __builtin_prefetch(pool + offsets[numbers[i - first]]);
+      for (int i = first; i < last; i++)
+      {
+         long long n = numbers[i - first];
+         found[i] = n >= 0 &&
+                    offsets[n + 1] - offsets[n] == words[i].size() &&
+                    memcmp(pool + offsets[n], words[i].data(), words[i].size()) == 0;
+      }
+   }
+}
+
+/*****************************************
+ * PERFECT HASH :: BUILD
+ * Level by level until every word has a bit
+ * of its own, then number them by rank and
+ * lay out the pool in that order
+ ****************************************/
+void PerfectHash::build(const vector <string> & words,
+                        const string & fileName) throw (const char *)
+{
+   vector <size_t> hashes(words.size());
+   for (int i = 0; i < words.size(); i++)
+      hashes[i] = hashOf(words[i].data(), words[i].size());
+   build(words, hashes, fileName);
+}
+
+void PerfectHash::build(const vector <string> & words,
+                        const vector <size_t> & hashes,
+                        const string & fileName) throw (const char *)
+{
+   Header header;
+   memset(&header, 0, sizeof(header));
+   header.magic = IMAGE_MAGIC;
+   header.version = IMAGE_VERSION;
+   header.numWords = words.size();
+
+   vector <int> left(words.size());
+   for (int i = 0; i < words.size(); i++)
+      left[i] = i;
+
+   // the levels
+   vector <unsigned long long> allBits;
+   vector <unsigned long long> where;
+   while (!left.empty())
+   {
+      if (header.numLevels == MAX_LEVELS)
+      {
+         // forty levels of fresh hashes all but never fail to part
+         // two distinct words, so look for one that is there twice
+         vector <string> rest;
+         for (int i = 0; i < left.size(); i++)
+            rest.push_back(words[left[i]]);
+         sort(rest.begin(), rest.end());
+         if (adjacent_find(rest.begin(), rest.end()) != rest.end())
+            throw "ERROR: unable to build the perfect hash; the words are not distinct";
+         throw "ERROR: unable to build the perfect hash";
+      }
+
+      int level = header.numLevels;
+      unsigned long long size = (2 * (unsigned long long)left.size() + 63) / 64 * 64;
+      vector <unsigned long long> taken(size / 64);
+      vector <unsigned long long> collided(size / 64);
+      where.resize(left.size());
+      for (int i = 0; i < left.size(); i++)
+      {
+         const string & word = words[left[i]];
+         where[i] = levelBit(levelHash(word.data(), word.size(), hashes[left[i]], level),
+                             level, size);
+         unsigned long long mask = 1ULL << (where[i] & 63);
+         if (taken[where[i] >> 6] & mask)
+            collided[where[i] >> 6] |= mask;
+         taken[where[i] >> 6] |= mask;
+      }
+
+      vector <int> next;
+      for (int i = 0; i < left.size(); i++)
+         if (collided[where[i] >> 6] & (1ULL << (where[i] & 63)))
+            next.push_back(left[i]);
+      for (int w = 0; w < taken.size(); w++)
+         allBits.push_back(taken[w] & ~collided[w]);
+
+      header.levelStart[header.numLevels] = header.numBits;
+      header.numBits += size;
+      header.numLevels++;
+      left.swap(next);
+   }
+   header.levelStart[header.numLevels] = header.numBits;
+
+   // the ranks
+   vector <unsigned int> allRanks((header.numBits + RANK_BLOCK - 1) / RANK_BLOCK);
+   unsigned int count = 0;
+   for (int w = 0; w < allBits.size(); w++)
+   {
+      if (w % (RANK_BLOCK / 64) == 0)
+         allRanks[w / (RANK_BLOCK / 64)] = count;
+      count += __builtin_popcountll(allBits[w]);
+   }
+
+   // number the words with the same code that will look them up
+   PerfectHash view;
+   view.numLevels = header.numLevels;
+   view.levelStart = header.levelStart;
+   view.bits = allBits.empty() ? NULL : &allBits[0];
+   view.ranks = allRanks.empty() ? NULL : &allRanks[0];
+
+   vector <int> order(words.size(), -1);
+   for (int i = 0; i < words.size(); i++)
+   {
+      long long number = view.index(words[i].data(), words[i].size(), hashes[i]);
+      if (number < 0 || order[number] >= 0)
+         throw "ERROR: unable to build the perfect hash";
+      order[number] = i;
+   }
+
+   // the offsets and the pool
+   vector <unsigned int> allOffsets(words.size() + 1);
+   string allWords;
+   for (int i = 0; i < order.size(); i++)
+   {
+      allOffsets[i] = allWords.size();
+      allWords += words[order[i]];
+      if (allWords.size() > 0xffffffffULL)
+         throw "ERROR: too many words for one perfect hash";
+   }
+   allOffsets[order.size()] = allWords.size();
+   header.poolSize = allWords.size();
+
+   FILE * file = fopen(fileName.c_str(), "wb");
+   if (file == NULL)
+      throw "ERROR: unable to create the perfect hash file";
+   fwrite(&header, sizeof(header), 1, file);
+   if (!allBits.empty())
+   {
+      fwrite(&allBits[0], sizeof(unsigned long long), allBits.size(), file);
+      fwrite(&allRanks[0], sizeof(unsigned int), allRanks.size(), file);
+   }
+   fwrite(&allOffsets[0], sizeof(unsigned int), allOffsets.size(), file);
+   fwrite(allWords.data(), 1, allWords.size(), file);
+   bool failed = ferror(file);
+   if (fclose(file) != 0 || failed)
+      throw "ERROR: unable to write the perfect hash file";
+}
+
+/*****************************************
+ * PERFECT HASH :: VALID
+ * Does the image agree with itself, so no
+ * lookup can read outside it? The header
+ * must match the file's size, the levels
+ * must lie in order inside the bits, the
+ * ranks must count the bits, with a set bit
+ * for each word and no more, and the offsets
+ * must lie in order inside the pool
+ ****************************************/
+bool PerfectHash::valid(const void * image, unsigned long long size)
+{
+   const Header * header = (const Header *)image;
+   if (size < sizeof(Header) ||
+       header->magic != IMAGE_MAGIC ||
+       header->version != IMAGE_VERSION ||
+       header->numLevels > MAX_LEVELS ||
+       header->numBits % 64 != 0 ||
+       header->numBits / 8 > size ||
+       header->poolSize > size)
+      return false;
+   unsigned long long numBlocks = (header->numBits + RANK_BLOCK - 1) / RANK_BLOCK;
+   if (sizeof(Header) + header->numBits / 8 + numBlocks * 4 +
+       (header->numWords + 1ULL) * 4 + header->poolSize != size)
+      return false;
+
+   if (header->levelStart[0] != 0 ||
+       header->levelStart[header->numLevels] != header->numBits)
+      return false;
+   for (int level = 0; level < header->numLevels; level++)
+      if (header->levelStart[level] >= header->levelStart[level + 1])
+         return false;
+
+   const unsigned long long * bits = (const unsigned long long *)(header + 1);
+   const unsigned int * ranks = (const unsigned int *)(bits + header->numBits / 64);
+   unsigned long long count = 0;
+   for (unsigned long long w = 0; w < header->numBits / 64; w++)
+   {
+      if (w % (RANK_BLOCK / 64) == 0 && ranks[w / (RANK_BLOCK / 64)] != count)
+         return false;
+      count += __builtin_popcountll(bits[w]);
+   }
+   if (count != header->numWords)
+      return false;
+
+   const unsigned int * offsets = ranks + numBlocks;
+   if (offsets[0] != 0 || offsets[header->numWords] != header->poolSize)
+      return false;
+   for (unsigned int i = 0; i < header->numWords; i++)
+      if (offsets[i] > offsets[i + 1])
+         return false;
+   return true;
+}
+
+/*****************************************
+ * PERFECT HASH :: OPEN
+ * Map the file and point into it. All but
+ * the pool is read once to check it; the
+ * pool's pages are read as lookups touch
+ * them
+ ****************************************/
+void PerfectHash::open(const string & fileName) throw (const char *)
+{
+   close();
+
+   int fd = ::open(fileName.c_str(), O_RDONLY);
+   if (fd < 0)
+      throw "ERROR: unable to open the perfect hash file";
+   struct stat status;
+   if (fstat(fd, &status) != 0 || status.st_size < (off_t)sizeof(Header))
+   {
+      ::close(fd);
+      throw "ERROR: not a perfect hash file";
+   }
+   void * mapped = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+   ::close(fd);
+   if (mapped == MAP_FAILED)
+      throw "ERROR: unable to map the perfect hash file";
+
+   if (!valid(mapped, status.st_size))
+   {
+      munmap(mapped, status.st_size);
+      throw "ERROR: not a perfect hash file, or a damaged one";
+   }
+
+   const Header * header = (const Header *)mapped;
+   unsigned long long numBlocks = (header->numBits + RANK_BLOCK - 1) / RANK_BLOCK;
+   image = mapped;
+   imageSize = status.st_size;
+   numWords = header->numWords;
+   numLevels = header->numLevels;
+   levelStart = header->levelStart;
+   bits = (const unsigned long long *)(header + 1);
+   ranks = (const unsigned int *)(bits + header->numBits / 64);
+   offsets = ranks + numBlocks;
+   pool = (const char *)(offsets + numWords + 1);
+}
+
+/*****************************************
+ * PERFECT HASH :: CLOSE
+ ****************************************/
+void PerfectHash::close()
+{
+   if (image != NULL)
+      munmap(image, imageSize);
+   image = NULL;
+   imageSize = 0;
+   numWords = numLevels = 0;
+}
@@ -0,0 +1,123 @@
+/***********************************************************************
+ * Header:
+ *    Perfect Hash
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    A word list that never changes, turned once into a file that can
+ *    be mapped into memory and searched with nothing built at startup.
+ *    A minimal perfect hash (BBHash) numbers the words 0 to n - 1 with
+ *    no collisions, and word number i is stored at offsets[i] in one
+ *    pool of characters, so a lookup is one hash, a few bit tests, and
+ *    one compare.
+ *
+ *    The file, all in this machine's byte order:
+ *       Image header    magic, version, counts and the level starts
+ *       bits            the levels' bit arrays, 64 bits to a word
+ *       ranks           set bits before each block of 512
+ *       offsets         numWords + 1 of them into the pool
+ *       pool            the words, one after another
+ ************************************************************************/
+
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+
+#include <string>
+#include <vector>
+#include "hasher.h"
+
+/*************************************************************************
+ * PERFECT HASH
+ * Each level is a bit array twice the size of the words left. A word's
+ * hash picks one bit per level; where exactly one word picks a bit, the
+ * bit is set and that word stops there. The others go on to the next
+ * level. A word's number is the count of set bits before its own.
+ * Past the first few levels the word's bytes are hashed again with the
+ * level as the seed, so two words whose hashes collide in full are
+ * still told apart, as BBHash does
+ ************************************************************************/
+class PerfectHash
+{
+public:
+   PerfectHash();
+   ~PerfectHash();
+
+   // write the image of these words, which must be distinct
+   static void build(const std::vector <std::string> & words,
+                     const std::string & fileName) throw (const char *);
+
+   // the same, with the hash of each word that find() will be given in
+   // place of hashOf()
+   static void build(const std::vector <std::string> & words,
+                     const std::vector <size_t> & hashes,
+                     const std::string & fileName) throw (const char *);
+
+   // map an image written by build(), and check it is one
+   void open(const std::string & fileName) throw (const char *);
+   void close();
+   bool isOpen() const { return image != NULL; }
+
+   static size_t hashOf(const char * word, int length)
+   {
+      return hashBytes(word, length);
+   }
+   bool find(const char * word, int length) const
+   {
+      return find(word, length, hashOf(word, length));
+   }
+   bool find(const char * word, int length, size_t h) const;
+
+   // find num words with their hashes at once, waiting on each step's
+   // cache misses together: the bits, then the offsets, then the pool
+   void findMany(const std::string * words, const size_t * hashes,
+                 int num, bool * found) const;
+
+   int size() const { return numWords; }
+
+   // word number i, for 0 <= i < size()
+   std::string word(int i) const
+   {
+      return std::string(pool + offsets[i], offsets[i + 1] - offsets[i]);
+   }
+
+private:
+   // no copying: the mapping belongs to one object
+   PerfectHash(const PerfectHash &);
+   PerfectHash & operator = (const PerfectHash &);
+
+   static const int MAX_LEVELS = 48;
+   static const int REHASH_LEVEL = 8;     // the first to hash the bytes
+   static const int RANK_BLOCK = 512;     // bits
+
+   struct Header;
+   static bool valid(const void * image, unsigned long long size);
+
+   // what a word hashes to at a level. Few words, in the list or not,
+   // get as far as REHASH_LEVEL, so few lookups hash twice
+   static size_t levelHash(const char * word, int length, size_t h, int level)
+   {
+      return level < REHASH_LEVEL ? h : hashBytes(word, length, level);
+   }
+
+   // where word h lands in a level of size bits. The mix must not be
+   // linear in h: two hashes whose difference a multiply maps near zero
+   // would otherwise share a bit at every level
+   static unsigned long long levelBit(size_t h, int level, unsigned long long size)
+   {
+      unsigned long long mixed = hashMix(h + level * 0x9e3779b97f4a7c15ULL);
+      return size ? (unsigned long long)(((unsigned __int128)mixed * size) >> 64) : 0;
+   }
+   long long index(const char * word, int length, size_t h) const;
+
+   void * image;                          // the mapping, or NULL
+   size_t imageSize;
+   int numWords;
+   int numLevels;
+   const unsigned long long * levelStart; // numLevels + 1 bit offsets
+   const unsigned long long * bits;
+   const unsigned int * ranks;
+   const unsigned int * offsets;
+   const char * pool;
+};
+
+#endif // PERFECT_HASH_H
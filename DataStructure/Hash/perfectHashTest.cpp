@@ -0,0 +1,290 @@
+/***********************************************************************
+ * Program:
+ *    PERFECT HASH TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks that a perfect hash image numbers every word once and finds
+ *    nothing else, for word lists that once failed to build, for words
+ *    whose hashes all collide, and that repeated words are named as the
+ *    problem. Then damages images every way the header allows and byte
+ *    by byte: open() must refuse them or lookups must stay inside the
+ *    image, which the address sanitizer checks. Exits 1 on the first
+ *    failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for SORT
+#include <cstdio>          // for REMOVE
+#include <cstdlib>         // for EXIT
+#include <cstring>         // for STRSTR
+#include <fstream>         // for IFSTREAM and OFSTREAM
+#include <random>          // for MT19937
+#include <string>
+#include <unistd.h>        // for GETPID
+#include <vector>
+#include "perfectHash.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+// where the header's fields are in the file
+const int NUM_WORDS   = 8;
+const int NUM_LEVELS  = 12;
+const int NUM_BITS    = 16;
+const int POOL_SIZE   = 24;
+const int LEVEL_START = 32;
+const int MAX_LEVELS  = 48;
+const int HEADER_SIZE = LEVEL_START + (MAX_LEVELS + 1) * 8;
+
+string fileName = "/tmp/perfectHashTest-" + to_string(getpid()) + ".phf";
+
+/**********************************************************************
+ * READ IMAGE and WRITE IMAGE
+ ***********************************************************************/
+string readImage()
+{
+   ifstream fin(fileName.c_str(), ios::binary);
+   return string(istreambuf_iterator <char> (fin), istreambuf_iterator <char> ());
+}
+
+void writeImage(const string & image)
+{
+   ofstream fout(fileName.c_str(), ios::binary);
+   fout.write(image.data(), image.size());
+}
+
+template <class T>
+T field(const string & image, int at)
+{
+   T value;
+   memcpy(&value, image.data() + at, sizeof(T));
+   return value;
+}
+
+template <class T>
+string withField(string image, int at, T value)
+{
+   memcpy(&image[at], &value, sizeof(T));
+   return image;
+}
+
+/**********************************************************************
+ * NUMBERED
+ * Every word found and numbered once, and words not in the list, with
+ * the hash find() would give them, not found
+ ***********************************************************************/
+void numbered(const vector <string> & words, const vector <size_t> & hashes)
+{
+   PerfectHash image;
+   image.open(fileName);
+   CHECK(image.size() == (int)words.size());
+
+   vector <string> all;
+   for (int i = 0; i < image.size(); i++)
+      all.push_back(image.word(i));
+   sort(all.begin(), all.end());
+   vector <string> sorted(words);
+   sort(sorted.begin(), sorted.end());
+   CHECK(all == sorted);
+
+   for (int i = 0; i < words.size(); i++)
+   {
+      CHECK(image.find(words[i].data(), words[i].size(), hashes[i]));
+      string other = words[i] + "x";
+      CHECK(!image.find(other.data(), other.size(), hashes[i]));
+   }
+
+   bool found[100];
+   for (int first = 0; first < words.size(); first += 100)
+   {
+      int num = min((int)words.size() - first, 100);
+      image.findMany(&words[first], &hashes[first], num, found);
+      for (int i = 0; i < num; i++)
+         CHECK(found[i]);
+   }
+}
+
+void numbered(const vector <string> & words)
+{
+   vector <size_t> hashes;
+   for (int i = 0; i < words.size(); i++)
+      hashes.push_back(PerfectHash::hashOf(words[i].data(), words[i].size()));
+   PerfectHash::build(words, fileName);
+   numbered(words, hashes);
+}
+
+/**********************************************************************
+ * LISTS
+ * Ones that failed to build before, and none at all
+ ***********************************************************************/
+void lists()
+{
+   vector <string> words;
+   words.push_back("w1220");
+   words.push_back("w12220");
+   words.push_back("hello");
+   numbered(words);
+
+   words.clear();
+   for (int i = 0; i < 20000; i++)
+      words.push_back("w" + to_string(i));
+   numbered(words);
+
+   words.clear();
+   words.push_back("xylbfqkdono");
+   words.push_back("zhi");
+   numbered(words);
+
+   words.clear();
+   numbered(words);
+   PerfectHash image;
+   image.open(fileName);
+   CHECK(!image.find("a", 1));
+}
+
+/**********************************************************************
+ * COLLISIONS
+ * Every word given the same hash, so only the levels that hash the
+ * words again can tell them apart
+ ***********************************************************************/
+void collisions()
+{
+   vector <string> words;
+   for (int i = 0; i < 5000; i++)
+      words.push_back("c" + to_string(i));
+   vector <size_t> hashes(words.size(), 12345);
+   PerfectHash::build(words, hashes, fileName);
+   numbered(words, hashes);
+}
+
+/**********************************************************************
+ * REPEATS
+ * A word there twice can never be given a bit of its own, and the
+ * error says so
+ ***********************************************************************/
+void repeats()
+{
+   vector <string> words;
+   for (int i = 0; i < 1000; i++)
+      words.push_back("r" + to_string(i));
+   words.push_back("r500");
+   const char * error = NULL;
+   try
+   {
+      PerfectHash::build(words, fileName);
+   }
+   catch (const char * thrown)
+   {
+      error = thrown;
+   }
+   CHECK(error != NULL);
+   CHECK(strstr(error, "not distinct") != NULL);
+}
+
+/**********************************************************************
+ * REFUSED
+ * Can this damaged image not be opened?
+ ***********************************************************************/
+bool refused(const string & image)
+{
+   writeImage(image);
+   PerfectHash damaged;
+   try
+   {
+      damaged.open(fileName);
+   }
+   catch (const char * error)
+   {
+      return true;
+   }
+   return false;
+}
+
+/**********************************************************************
+ * DAMAGED
+ * Each field the header has set to something the rest disagrees with,
+ * a set bit cleared, an offset out of order, a rank off by one, and a
+ * file cut short must all be refused. Then any one byte changed: if
+ * the image still opens, every lookup must stay inside it
+ ***********************************************************************/
+void damaged()
+{
+   vector <string> words;
+   for (int i = 0; i < 3000; i++)
+      words.push_back("d" + to_string(i));
+   PerfectHash::build(words, fileName);
+   string image = readImage();
+   CHECK(!refused(image));
+
+   int numLevels = field <unsigned int> (image, NUM_LEVELS);
+   unsigned long long numBits = field <unsigned long long> (image, NUM_BITS);
+   unsigned long long numBlocks = (numBits + 511) / 512;
+   int bitsAt = HEADER_SIZE;
+   int ranksAt = bitsAt + numBits / 8;
+   int offsetsAt = ranksAt + numBlocks * 4;
+   CHECK(numLevels > 2);
+
+   CHECK(refused(withField <unsigned int> (image, NUM_WORDS, 2999)));
+   CHECK(refused(withField <unsigned int> (image, NUM_LEVELS, numLevels - 1)));
+   CHECK(refused(withField <unsigned int> (image, NUM_LEVELS, MAX_LEVELS + 1)));
+   CHECK(refused(withField <unsigned long long> (image, NUM_BITS, numBits + 64)));
+   CHECK(refused(withField <unsigned long long> (image, POOL_SIZE, 1ULL << 62)));
+   unsigned long long second = field <unsigned long long> (image, LEVEL_START + 8);
+   unsigned long long third = field <unsigned long long> (image, LEVEL_START + 16);
+   CHECK(refused(withField <unsigned long long> (image, LEVEL_START + 8, third)));
+   CHECK(refused(withField <unsigned long long> (image, LEVEL_START + 16, second)));
+   CHECK(refused(withField <unsigned long long> (image, LEVEL_START + 8, numBits * 2)));
+
+   // a set bit cleared, and the ranks and offsets
+   int at = bitsAt;
+   while (field <unsigned long long> (image, at) == 0)
+      at += 8;
+   unsigned long long set = field <unsigned long long> (image, at);
+   CHECK(refused(withField <unsigned long long> (image, at, set & (set - 1))));
+   CHECK(refused(withField <unsigned int> (image, ranksAt + 4,
+                                           field <unsigned int> (image, ranksAt + 4) + 1)));
+   CHECK(refused(withField <unsigned int> (image, offsetsAt + 400,
+                                           field <unsigned int> (image, offsetsAt + 408))));
+   CHECK(refused(withField <unsigned int> (image, offsetsAt, 1)));
+   CHECK(refused(image.substr(0, image.size() - 1)));
+   CHECK(refused(image.substr(0, HEADER_SIZE - 1)));
+
+   // one byte at a time, everywhere but the pool
+   mt19937 random(1);
+   for (int i = 0; i < offsetsAt + 3001 * 4; i += 1 + random() % 3)
+   {
+      string changed = image;
+      changed[i] ^= 1 << (random() % 8);
+      if (refused(changed))
+         continue;
+      PerfectHash opened;
+      opened.open(fileName);
+      for (int w = 0; w < opened.size(); w++)
+         opened.word(w);
+      for (int w = 0; w < 6000; w++)
+      {
+         string word = "d" + to_string(w);
+         opened.find(word.data(), word.size());
+      }
+   }
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   lists();
+   collisions();
+   repeats();
+   damaged();
+   remove(fileName.c_str());
+   cout << "PerfectHash tests passed\n";
+   return 0;
+}
@@ -0,0 +1,48 @@
+/***********************************************************************
+ * Program:
+ *    PHF
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Turns a dictionary into a perfect hash image that spell can map
+ *    instead of building a hash at startup. Usage:
+ *       phf <dictionary> <image.phf>
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include "perfectHash.h"
+#include "suggest.h"       // for LOADWORDS
+using namespace std;
+
+/**********************************************************************
+ * MAIN
+ * The words are lowercased and repeats dropped, as Dictionary does
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   if (argc != 3)
+   {
+      cerr << "Usage: " << argv[0] << " <dictionary> <image.phf>\n";
+      return 1;
+   }
+
+   try
+   {
+      vector <string> words;
+      loadWords(argv[1], words);
+      PerfectHash::build(words, argv[2]);
+
+      PerfectHash image;
+      image.open(argv[2]);
+      for (int i = 0; i < words.size(); i++)
+         if (!image.find(words[i].data(), words[i].size()))
+            throw "ERROR: the image is missing a word";
+      cout << words.size() << " words written to " << argv[2] << endl;
+   }
+   catch (const char * error)
+   {
+      cerr << error << endl;
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,186 @@
+/***********************************************************************
+ * Program:
+ *    SNAPSHOT TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks that a Hash comes back from a snapshot with the same items
+ *    in the same buckets, of ints and of strings, empty, and taken in
+ *    the middle of growing, and that a damaged, cut short, wrong type or
+ *    wrong hash snapshot is refused and leaves the Hash as it was. A
+ *    snapshot written to a name without a directory must land too.
+ *    Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdio>          // for REMOVE
+#include <cstdlib>         // for EXIT
+#include <fstream>         // for IFSTREAM and OFSTREAM
+#include <string>
+#include <unistd.h>        // for GETPID
+#include "hashSnapshot.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+string fileName = "/tmp/snapshotTest-" + to_string(getpid()) + ".snap";
+
+/**********************************************************************
+ * KEY
+ * Item number n, as an int or as a string
+ ***********************************************************************/
+template <class T> T key(int n);
+template <> int key <int> (int n) { return n * 7919; }
+template <> string key <string> (int n) { return "item" + to_string(n); }
+
+/**********************************************************************
+ * REFUSED
+ * Does restoring this file throw, and leave the Hash holding items
+ * 0 .. n - 1 and nothing else?
+ ***********************************************************************/
+template <class T, class H>
+bool refused(Hash <T, H> & hash, int n)
+{
+   bool threw = false;
+   try
+   {
+      restore(hash, fileName);
+   }
+   catch (const char * error)
+   {
+      threw = true;
+   }
+   if (hash.size() != n)
+      return false;
+   for (int i = 0; i < n + 100; i++)
+      if (hash.find(key <T> (i)) != (i < n))
+         return false;
+   return threw;
+}
+
+/**********************************************************************
+ * ROUND TRIP
+ * n items out and back in, into a Hash that held something else,
+ * with the buckets as they were. Then the same file damaged
+ ***********************************************************************/
+template <class T>
+void roundTrip(int n)
+{
+   Hash <T, DefaultHasher <T> > hash;
+   for (int i = 0; i < n; i++)
+      hash.insert(key <T> (i));
+   snapshot(hash, fileName);
+
+   Hash <T, DefaultHasher <T> > restored;
+   restored.insert(key <T> (n + 5));
+   restore(restored, fileName);
+   CHECK(restored.size() == n);
+   CHECK(restored.capacity() == hash.capacity());
+   for (int i = 0; i < n + 100; i++)
+      CHECK(restored.find(key <T> (i)) == (i < n));
+
+   // damaged every way the reader checks for
+   ifstream fin(fileName.c_str(), ios::binary);
+   string image((istreambuf_iterator <char> (fin)), istreambuf_iterator <char> ());
+   fin.close();
+   string changed[4] = { image, image, image.substr(0, image.size() - 1), image };
+   changed[0][image.size() - 1] ^= 1;             // a payload byte
+   changed[1][0] = 'X';                           // the magic
+   changed[3][12] ^= 1;                           // the container
+   for (int c = 0; c < 4; c++)
+   {
+      ofstream fout(fileName.c_str(), ios::binary);
+      fout.write(changed[c].data(), changed[c].size());
+      fout.close();
+      CHECK(refused(restored, n));
+   }
+}
+
+/**********************************************************************
+ * GROWING
+ * A snapshot taken while the Hash is part way through moving to a
+ * bigger table holds every item, and restores into a smaller one
+ ***********************************************************************/
+void growing()
+{
+   Hash <int, DefaultHasher <int> > hash;
+   int n = 0;
+   while (!hash.growing())
+      hash.insert(key <int> (n++));
+   snapshot(hash, fileName);
+   CHECK(!hash.growing());
+
+   Hash <int, DefaultHasher <int> > restored;
+   restore(restored, fileName);
+   CHECK(restored.size() == n);
+   for (int i = 0; i < n; i++)
+      CHECK(restored.find(key <int> (i)));
+}
+
+/**********************************************************************
+ * WRONG KIND
+ * Strings into an int Hash, and a Hash with another hash function
+ ***********************************************************************/
+struct OtherHasher
+{
+   size_t operator () (int value) const { return hashMix(value + 1); }
+};
+
+void wrongKind()
+{
+   Hash <string, DefaultHasher <string> > strings;
+   for (int i = 0; i < 1000; i++)
+      strings.insert(key <string> (i));
+   snapshot(strings, fileName);
+   Hash <int, DefaultHasher <int> > ints;
+   for (int i = 0; i < 10; i++)
+      ints.insert(key <int> (i));
+   CHECK(refused(ints, 10));
+
+   Hash <int, DefaultHasher <int> > hash;
+   for (int i = 0; i < 1000; i++)
+      hash.insert(key <int> (i));
+   snapshot(hash, fileName);
+   Hash <int, OtherHasher> other;
+   for (int i = 0; i < 10; i++)
+      other.insert(key <int> (i));
+   CHECK(refused(other, 10));
+}
+
+/**********************************************************************
+ * HERE
+ * A name with no directory in it is in the current one
+ ***********************************************************************/
+void here()
+{
+   string name = "snapshotTest-" + to_string(getpid()) + ".snap";
+   Hash <int, DefaultHasher <int> > hash;
+   hash.insert(1);
+   snapshot(hash, name);
+   Hash <int, DefaultHasher <int> > restored;
+   restore(restored, name);
+   CHECK(restored.size() == 1 && restored.find(1));
+   remove(name.c_str());
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   roundTrip <int> (0);
+   roundTrip <int> (100000);
+   roundTrip <string> (1);
+   roundTrip <string> (50000);
+   growing();
+   wrongKind();
+   here();
+   remove(fileName.c_str());
+   cout << "Snapshot tests passed\n";
+   return 0;
+}
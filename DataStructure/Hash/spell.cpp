@@ -0,0 +1,146 @@
+/***********************************************************************
+ * Program:
+ *    SPELL
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Spell checks any number of files at once, a thread per file, and
+ *    lists every misspelled word with where it is, and with -s up to k
+ *    suggestions for it, found with SymSpell or, with -b, a BK-tree.
+ *    The dictionary is a word list or an image made from one by phf;
+ *    -f puts a Bloom filter with that false positive rate in front of
+ *    it, and -v prints how its hash table is doing. Usage:
+ *       spell [-d dictionary] [-j threads] [-s k] [-b] [-f rate] [-v] <file> ...
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <chrono>          // for STEADY_CLOCK
+#include <cstdlib>         // for ATOI and ATOF
+#include <cstring>         // for STRCMP
+#include <thread>          // for HARDWARE_CONCURRENCY
+#include "spellCheck.h"
+#include "suggest.h"
+using namespace std;
+
+/**********************************************************************
+ * MAIN
+ * Reports go to stdout as file:line:column: word, in the order the
+ * files were given, followed by " -> " and the suggestions if asked
+ * for. Exits 1 if anything was misspelled or unreadable
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   string dictionaryFile = DICTIONARY_FILE;
+   int numThreads = thread::hardware_concurrency();
+   int numSuggestions = 0;
+   bool useBKTree = false;
+   double filterRate = 0.0;
+   bool verbose = false;
+   vector <string> fileNames;
+   for (int i = 1; i < argc; i++)
+   {
+      if (strcmp(argv[i], "-d") == 0 && i + 1 < argc)
+         dictionaryFile = argv[++i];
+      else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+         numThreads = atoi(argv[++i]);
+      else if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+         numSuggestions = atoi(argv[++i]);
+      else if (strcmp(argv[i], "-b") == 0)
+         useBKTree = true;
+      else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+         filterRate = atof(argv[++i]);
+      else if (strcmp(argv[i], "-v") == 0)
+         verbose = true;
+      else
+         fileNames.push_back(argv[i]);
+   }
+   if (fileNames.empty())
+   {
+      cerr << "Usage: " << argv[0]
+           << " [-d dictionary] [-j threads] [-s k] [-b] [-f rate] [-v] <file> ...\n";
+      return 1;
+   }
+   if (numThreads < 1)
+      numThreads = 1;
+
+   Dictionary dictionary;
+   SymSpell symSpell;
+   BKTree bkTree;
+   try
+   {
+      dictionary.load(dictionaryFile, filterRate);
+      if (numSuggestions > 0)
+      {
+         vector <string> words;
+         if (dictionary.image().isOpen())
+            for (int i = 0; i < dictionary.image().size(); i++)
+               words.push_back(dictionary.image().word(i));
+         else
+            loadWords(dictionaryFile, words);
+         if (useBKTree)
+            bkTree.build(words);
+         else
+            symSpell.build(words);
+      }
+   }
+   catch (const char * error)
+   {
+      cerr << error << ": " << dictionaryFile << endl;
+      return 1;
+   }
+   if (verbose && !dictionary.image().isOpen())
+      cerr << "Dictionary " << dictionaryFile << ":\n" << dictionary.stats();
+
+   chrono::steady_clock::time_point start = chrono::steady_clock::now();
+   vector <SpellReport> reports;
+   checkFiles(dictionary, fileNames, reports, numThreads);
+   chrono::duration <double> elapsed = chrono::steady_clock::now() - start;
+
+   // the same typo tends to come up again and again
+   HashMap <string, string> suggestionsFor;
+   vector <Suggestion> suggestions;
+
+   int numMisspelled = 0;
+   bool failed = false;
+   for (int i = 0; i < reports.size(); i++)
+   {
+      if (!reports[i].error.empty())
+      {
+         cerr << reports[i].error << ": " << reports[i].fileName << endl;
+         failed = true;
+      }
+      for (int j = 0; j < reports[i].misspelled.size(); j++)
+      {
+         const Misspelling & word = reports[i].misspelled[j];
+         cout << reports[i].fileName << ':' << word.line << ':'
+              << word.column << ": " << word.word;
+         if (numSuggestions > 0)
+         {
+            string lower = word.word;
+            for (int k = 0; k < lower.size(); k++)
+               if (lower[k] >= 'A' && lower[k] <= 'Z')
+                  lower[k] += 'a' - 'A';
+
+            pair <HashMap <string, string> ::iterator, bool> cached =
+               suggestionsFor.try_emplace(lower);
+            if (cached.second)
+            {
+               if (useBKTree)
+                  bkTree.suggest(lower, numSuggestions, suggestions);
+               else
+                  symSpell.suggest(lower, numSuggestions, suggestions);
+               for (int k = 0; k < suggestions.size(); k++)
+                  cached.first->second += (k ? ", " : "") + suggestions[k].word;
+            }
+            if (!cached.first->second.empty())
+               cout << " -> " << cached.first->second;
+         }
+         cout << '\n';
+      }
+      numMisspelled += reports[i].misspelled.size();
+   }
+
+   cerr << numMisspelled << " misspelled words in " << reports.size()
+        << " files, checked in " << elapsed.count() << " seconds\n";
+   return (failed || numMisspelled) ? 1 : 0;
+}
@@ -0,0 +1,548 @@
+/***********************************************************************
+ * Program:
+ *    SPELL BENCH
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    The benchmarks behind the numbers quoted for the spell checker, so
+ *    they can be run again. Each one is a mode:
+ *       spellBench check [mb]    checking mb megabytes of generated
+ *                                text against 500K words, a lookup at
+ *                                a time and batched, from the word
+ *                                list and from a perfect hash image,
+ *                                each alone and behind a Bloom filter
+ *       spellBench filter [n]    false positive rates and bytes a word
+ *                                of Bloom and cuckoo filters holding n
+ *                                words, and lookups that mostly miss,
+ *                                with and without one in front
+ *       spellBench phf [n]       building, opening and looking up a
+ *                                perfect hash image of n words, for
+ *                                words in it and words not
+ *       spellBench suggest [n]   suggestions a second from SymSpell,
+ *                                a BK-tree and a scan of every word,
+ *                                with n words, for 0 to 2 edits
+ *    The dictionary and the text are generated from fixed seeds into
+ *    temporary files, which are removed afterwards. Times depend on
+ *    the machine; compare modes on one machine only.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for LOWER_BOUND
+#include <chrono>          // for STEADY_CLOCK
+#include <cctype>          // for ISALPHA and TOLOWER
+#include <cstdio>          // for REMOVE
+#include <cstdlib>         // for ATOI
+#include <cstring>         // for STRCMP
+#include <fstream>         // for OFSTREAM
+#include <iomanip>         // for SETW
+#include <random>          // for MT19937_64
+#include <string>
+#include <unistd.h>        // for GETPID
+#include <vector>
+#include "spellCheck.h"
+#include "filter.h"
+#include "perfectHash.h"
+#include "suggest.h"
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/**********************************************************************
+ * SECONDS SINCE
+ ***********************************************************************/
+double secondsSince(Clock::time_point start)
+{
+   return chrono::duration <double> (Clock::now() - start).count();
+}
+
+/**********************************************************************
+ * TEMPORARY NAME
+ * A file name in /tmp that no other run will use
+ ***********************************************************************/
+string temporaryName(const char * suffix)
+{
+   return "/tmp/spellBench-" + to_string(getpid()) + suffix;
+}
+
+/**********************************************************************
+ * RANDOM WORDS
+ * n distinct lowercase words of 2 to 14 letters
+ ***********************************************************************/
+vector <string> randomWords(int n, unsigned seed)
+{
+   mt19937_64 random(seed);
+   vector <string> words;
+   while ((int)words.size() < n)
+   {
+      while ((int)words.size() < n)
+      {
+         string word(2 + random() % 13, ' ');
+         for (size_t i = 0; i < word.size(); i++)
+            word[i] = 'a' + random() % 26;
+         words.push_back(word);
+      }
+      sort(words.begin(), words.end());
+      words.erase(unique(words.begin(), words.end()), words.end());
+   }
+   shuffle(words.begin(), words.end(), random);
+   return words;
+}
+
+/**********************************************************************
+ * WRITE TEXT
+ * About mb megabytes of text drawn from the dictionary, the word of
+ * rank r in proportion to 1 / r, as in English. One word in twenty is
+ * misspelled, some start with a capital, and some have punctuation
+ * after them. Returns the words written
+ ***********************************************************************/
+long writeText(const string & fileName, const vector <string> & dictionary,
+               int mb, unsigned seed)
+{
+   mt19937_64 random(seed);
+   vector <double> cumulative(dictionary.size());
+   double total = 0.0;
+   for (size_t i = 0; i < dictionary.size(); i++)
+      cumulative[i] = total += 1.0 / (i + 1);
+   uniform_real_distribution <double> uniform(0.0, total);
+
+   ofstream fout(fileName.c_str());
+   long numBytes = 0;
+   long numWords = 0;
+   string line;
+   while (numBytes < (long)mb * 1000000)
+   {
+      size_t rank = lower_bound(cumulative.begin(), cumulative.end(), uniform(random))
+                    - cumulative.begin();
+      string word = dictionary[rank < dictionary.size() ? rank : dictionary.size() - 1];
+      if (random() % 20 == 0)
+         word[random() % word.size()] = 'a' + random() % 26;
+      if (random() % 10 == 0)
+         word[0] += 'A' - 'a';
+      line += word;
+      line += (random() % 12 == 0) ? ", " : " ";
+      numWords++;
+      if (line.size() > 70)
+      {
+         line += '\n';
+         fout << line;
+         numBytes += line.size();
+         line.clear();
+      }
+   }
+   fout << line << '\n';
+   return numWords;
+}
+
+/**********************************************************************
+ * READ WORDS
+ * The words of the text, lowercased, the way checkFile() sees them
+ ***********************************************************************/
+vector <string> readWords(const string & fileName)
+{
+   ifstream fin(fileName.c_str());
+   vector <string> words;
+   string token;
+   while (fin >> token)
+   {
+      string word;
+      for (size_t i = 0; i < token.size(); i++)
+         if (isalpha((unsigned char)token[i]))
+            word += tolower((unsigned char)token[i]);
+      if (!word.empty())
+         words.push_back(word);
+   }
+   return words;
+}
+
+/**********************************************************************
+ * LOOKUPS
+ * Seconds to look every word up, one at a time or batched, and how
+ * many were not found, which also keeps the lookups from being dropped
+ ***********************************************************************/
+double lookups(const Dictionary & dictionary, const vector <string> & words,
+               bool batched, long & numMissing)
+{
+   numMissing = 0;
+   Clock::time_point start = Clock::now();
+   if (!batched)
+   {
+      for (size_t i = 0; i < words.size(); i++)
+         numMissing += !dictionary.contains(words[i].data(), words[i].size());
+   }
+   else
+   {
+      bool found[Dictionary::MAX_BATCH];
+      for (size_t i = 0; i < words.size(); i += Dictionary::MAX_BATCH)
+      {
+         int num = min((size_t)Dictionary::MAX_BATCH, words.size() - i);
+         dictionary.containsMany(&words[i], num, found);
+         for (int j = 0; j < num; j++)
+            numMissing += !found[j];
+      }
+   }
+   return secondsSince(start);
+}
+
+/**********************************************************************
+ * CHECK FILE TIME
+ * Seconds for checkFile() on the whole text, and the misspellings
+ ***********************************************************************/
+double checkFileTime(const Dictionary & dictionary, const string & fileName,
+                     long & numMisspelled)
+{
+   vector <Misspelling> misspelled;
+   Clock::time_point start = Clock::now();
+   checkFile(dictionary, fileName, misspelled);
+   double seconds = secondsSince(start);
+   numMisspelled = misspelled.size();
+   return seconds;
+}
+
+/**********************************************************************
+ * REPORT
+ ***********************************************************************/
+void report(const char * name, double seconds, double mb, long count)
+{
+   cout << setw(32) << left << name << right << fixed << setprecision(2)
+        << setw(7) << seconds << "s" << setw(8) << setprecision(0)
+        << mb / seconds << " MB/s" << setw(10) << count << endl;
+   cout.unsetf(ios::fixed);
+}
+
+/**********************************************************************
+ * CHECK
+ * The same text against the same 500K words, held as a FlatHash and
+ * as a mapped perfect hash image, each with and without a 1% Bloom
+ * filter in front. Only the misspellings, one word in twenty, can be
+ * turned away by the filter
+ ***********************************************************************/
+void check(int mb)
+{
+   string listName = temporaryName("-dict.txt");
+   string imageName = temporaryName("-dict.phf");
+   string textName = temporaryName("-text.txt");
+
+   vector <string> words = randomWords(500000, 1);
+   {
+      ofstream fout(listName.c_str());
+      for (size_t i = 0; i < words.size(); i++)
+         fout << words[i] << '\n';
+   }
+   long numWords = writeText(textName, words, mb, 2);
+   PerfectHash::build(words, imageName);
+   vector <string> text = readWords(textName);
+
+   cout << "Checking " << mb << "MB, " << numWords << " words, against "
+        << words.size() << " words\n"
+        << setw(32) << "" << setw(8) << "time" << setw(13) << "rate"
+        << setw(10) << "missing" << endl;
+   const char * names[4] = { listName.c_str(), listName.c_str(),
+                             imageName.c_str(), imageName.c_str() };
+   const char * kinds[4] = { "FlatHash", "FlatHash+Bloom", "image", "image+Bloom" };
+   for (int k = 0; k < 4; k++)
+   {
+      Dictionary dictionary;
+      dictionary.load(names[k], (k % 2) ? 0.01 : 0.0);
+      long count;
+      double seconds = lookups(dictionary, text, false, count);
+      report((string(kinds[k]) + ", one at a time").c_str(), seconds, mb, count);
+      seconds = lookups(dictionary, text, true, count);
+      report((string(kinds[k]) + ", batched").c_str(), seconds, mb, count);
+      seconds = checkFileTime(dictionary, textName, count);
+      report((string(kinds[k]) + ", checkFile").c_str(), seconds, mb, count);
+   }
+
+   remove(listName.c_str());
+   remove(imageName.c_str());
+   remove(textName.c_str());
+}
+
+/**********************************************************************
+ * FILTER RATE
+ * How often words not in the filter pass, measured and expected, and
+ * what it costs in bytes a word
+ ***********************************************************************/
+template <class Filter>
+void filterRate(const char * name, Filter & filter, const vector <string> & words,
+                const vector <string> & others)
+{
+   for (size_t i = 0; i < words.size(); i++)
+      filter.insert(words[i]);
+   long numPassed = 0;
+   for (size_t i = 0; i < others.size(); i++)
+      numPassed += filter.contains(others[i]);
+   cout << setw(22) << left << name << right << fixed << setprecision(3)
+        << setw(9) << 100.0 * numPassed / others.size() << '%'
+        << setw(9) << 100.0 * filter.falsePositiveRate() << '%'
+        << setprecision(2) << setw(10) << (double)filter.memory() / words.size()
+        << endl;
+   cout.unsetf(ios::fixed);
+}
+
+/**********************************************************************
+ * FILTERED LOOKUPS
+ * Seconds to look up every query through a table with the filter in
+ * front, and how many were found
+ ***********************************************************************/
+template <class Filter>
+double filteredLookups(const vector <string> & words, const vector <string> & queries,
+                       long & numFound)
+{
+   FlatHash <string> table(words.size());
+   Prefiltered <string, Filter, FlatHash <string> > both(table, words.size(), 0.01);
+   for (size_t i = 0; i < words.size(); i++)
+      both.insert(words[i]);
+
+   numFound = 0;
+   Clock::time_point start = Clock::now();
+   for (size_t i = 0; i < queries.size(); i++)
+      numFound += both.find(queries[i]);
+   return secondsSince(start);
+}
+
+/**********************************************************************
+ * FILTER
+ * n words in each filter, and twice as many others looked for. Then
+ * ten million lookups, nine in ten for words not there, into a
+ * FlatHash alone and behind each filter at 1%
+ ***********************************************************************/
+void filter(int n)
+{
+   vector <string> all = randomWords(3 * n, 5);
+   vector <string> words(all.begin(), all.begin() + n);
+   vector <string> others(all.begin() + n, all.end());
+
+   cout << n << " words in, " << others.size() << " others looked for\n"
+        << setw(22) << "" << setw(10) << "passed" << setw(10) << "expected"
+        << setw(10) << "bytes" << endl;
+   const double rates[3] = { 0.05, 0.01, 0.001 };
+   const char * bloomNames[3] = { "Bloom 5%", "Bloom 1%", "Bloom 0.1%" };
+   for (int i = 0; i < 3; i++)
+   {
+      BloomFilter <string> bloom(n, rates[i]);
+      filterRate(bloomNames[i], bloom, words, others);
+   }
+   CuckooFilter <string, unsigned char> cuckoo8(n, 0.05);
+   filterRate("cuckoo 8-bit 5%", cuckoo8, words, others);
+   CuckooFilter <string, unsigned short> cuckoo16(n, 0.001);
+   filterRate("cuckoo 16-bit 0.1%", cuckoo16, words, others);
+
+   mt19937_64 random(6);
+   vector <string> queries(10000000);
+   for (size_t i = 0; i < queries.size(); i++)
+      queries[i] = (random() % 10) ? others[random() % others.size()]
+                                   : words[random() % words.size()];
+
+   cout << "\n" << queries.size() << " lookups, 90% misses\n";
+   FlatHash <string> table(words.size());
+   for (size_t i = 0; i < words.size(); i++)
+      table.insert(words[i]);
+   long numFound = 0;
+   Clock::time_point start = Clock::now();
+   for (size_t i = 0; i < queries.size(); i++)
+      numFound += table.find(queries[i]);
+   double seconds = secondsSince(start);
+   cout << setw(22) << left << "FlatHash" << right << fixed << setprecision(2)
+        << setw(8) << seconds << "s" << setw(10) << numFound << endl;
+   seconds = filteredLookups <BloomFilter <string> > (words, queries, numFound);
+   cout << setw(22) << left << "  + Bloom" << right
+        << setw(8) << seconds << "s" << setw(10) << numFound << endl;
+   seconds = filteredLookups <CuckooFilter <string> > (words, queries, numFound);
+   cout << setw(22) << left << "  + cuckoo" << right
+        << setw(8) << seconds << "s" << setw(10) << numFound << endl;
+   cout.unsetf(ios::fixed);
+}
+
+/**********************************************************************
+ * PHF
+ * Build an image of n words and open it, then look up a million words
+ * from it and a million that are not, one at a time and batched. The
+ * ones that are not reach the deeper levels most often
+ ***********************************************************************/
+void phf(int n)
+{
+   string imageName = temporaryName("-phf.phf");
+   vector <string> all = randomWords(n + 1000000, 7);
+   vector <string> words(all.begin(), all.begin() + n);
+   vector <string> others(all.begin() + n, all.end());
+
+   Clock::time_point start = Clock::now();
+   PerfectHash::build(words, imageName);
+   double buildSeconds = secondsSince(start);
+   PerfectHash image;
+   start = Clock::now();
+   image.open(imageName);
+   double openSeconds = secondsSince(start);
+   ifstream fin(imageName.c_str(), ios::binary | ios::ate);
+   long imageSize = fin.tellg();
+
+   cout << "A perfect hash image of " << n << " words: built in "
+        << buildSeconds << "s, opened in " << openSeconds * 1000 << "ms, "
+        << imageSize << " bytes\n"
+        << setw(22) << "" << setw(12) << "one at a time" << setw(12) << "batched"
+        << setw(10) << "found" << endl;
+
+   mt19937_64 random(8);
+   const char * kinds[2] = { "words in it", "words not in it" };
+   for (int k = 0; k < 2; k++)
+   {
+      const vector <string> & from = k ? others : words;
+      vector <string> queries(1000000);
+      vector <size_t> hashes(queries.size());
+      for (size_t i = 0; i < queries.size(); i++)
+      {
+         queries[i] = from[random() % from.size()];
+         hashes[i] = PerfectHash::hashOf(queries[i].data(), queries[i].size());
+      }
+
+      long numFound = 0;
+      start = Clock::now();
+      for (size_t i = 0; i < queries.size(); i++)
+         numFound += image.find(queries[i].data(), queries[i].size());
+      double seconds = secondsSince(start);
+
+      vector <char> found(queries.size());
+      start = Clock::now();
+      image.findMany(&queries[0], &hashes[0], queries.size(), (bool *)&found[0]);
+      double batchedSeconds = secondsSince(start);
+      long numBatched = 0;
+      for (size_t i = 0; i < found.size(); i++)
+         numBatched += found[i];
+      if (numBatched != numFound)
+         throw "ERROR: find() and findMany() disagree";
+
+      cout << setw(22) << left << kinds[k] << right << fixed << setprecision(1)
+           << setw(10) << seconds * 1e9 / queries.size() << "ns"
+           << setw(10) << batchedSeconds * 1e9 / queries.size() << "ns"
+           << setw(10) << numFound << endl;
+      cout.unsetf(ios::fixed);
+   }
+   remove(imageName.c_str());
+}
+
+/**********************************************************************
+ * SCAN
+ * Every word, with the same bounded distance the indexes use
+ ***********************************************************************/
+class Scan
+{
+public:
+   void build(const vector <string> & words) { this->words = words; }
+   void suggest(const string & word, int k, vector <Suggestion> & suggestions) const
+   {
+      suggestions.clear();
+      EditDistance distance(word);
+      for (size_t i = 0; i < words.size(); i++)
+      {
+         Suggestion suggestion;
+         suggestion.word = words[i];
+         suggestion.distance = distance.to(words[i], 2);
+         if (suggestion.distance <= 2)
+            suggestions.push_back(suggestion);
+      }
+      rankSuggestions(suggestions, k);
+   }
+private:
+   vector <string> words;
+};
+
+/**********************************************************************
+ * TIME SUGGESTER
+ * Build it, then ask for the best five for each query. Prints the
+ * build time, suggestions a second, and how many were found
+ ***********************************************************************/
+template <class Suggester>
+void timeSuggester(const char * name, const vector <string> & words,
+                   const vector <string> & queries)
+{
+   Suggester suggester;
+   Clock::time_point start = Clock::now();
+   suggester.build(words);
+   double buildSeconds = secondsSince(start);
+
+   vector <Suggestion> suggestions;
+   long numFound = 0;
+   start = Clock::now();
+   for (size_t i = 0; i < queries.size(); i++)
+   {
+      suggester.suggest(queries[i], 5, suggestions);
+      numFound += suggestions.size();
+   }
+   double seconds = secondsSince(start);
+   cout << setw(12) << left << name << right << fixed << setprecision(2)
+        << setw(8) << buildSeconds << "s" << setprecision(0)
+        << setw(12) << queries.size() / seconds << "/s" << setw(10) << numFound << endl;
+   cout.unsetf(ios::fixed);
+}
+
+/**********************************************************************
+ * SUGGEST
+ * Queries are dictionary words with 0 to 2 letters inserted, deleted
+ * or changed. The BK-tree and the scan get fewer of them: they are
+ * slow enough that the same count would take minutes
+ ***********************************************************************/
+void suggest(int n)
+{
+   vector <string> words = randomWords(n, 3);
+   sort(words.begin(), words.end());
+   mt19937_64 random(4);
+   vector <string> queries(5000);
+   for (size_t q = 0; q < queries.size(); q++)
+   {
+      string word = words[random() % words.size()];
+      for (int e = random() % 3; e > 0; e--)
+      {
+         int at = random() % word.size();
+         char letter = 'a' + random() % 26;
+         int kind = random() % 3;
+         if (kind == 0)
+            word.insert(word.begin() + at, letter);
+         else if (kind == 1 && word.size() > 1)
+            word.erase(at, 1);
+         else
+            word[at] = letter;
+      }
+      queries[q] = word;
+   }
+   vector <string> fewer(queries.begin(), queries.begin() + 500);
+
+   cout << "The best 5 suggestions among " << n << " words\n"
+        << setw(12) << "" << setw(9) << "build" << setw(14) << "queries"
+        << setw(10) << "found" << endl;
+   timeSuggester <SymSpell> ("SymSpell", words, queries);
+   timeSuggester <SymSpell> ("  (first 500)", words, fewer);
+   timeSuggester <BKTree> ("BK-tree", words, fewer);
+   timeSuggester <Scan> ("scan", words, fewer);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   const char * mode = argc > 1 ? argv[1] : "";
+   int n = argc > 2 ? atoi(argv[2]) : 0;
+
+   try
+   {
+      if (strcmp(mode, "check") == 0)
+         check(n ? n : 27);
+      else if (strcmp(mode, "filter") == 0)
+         filter(n ? n : 500000);
+      else if (strcmp(mode, "phf") == 0)
+         phf(n ? n : 500000);
+      else if (strcmp(mode, "suggest") == 0)
+         suggest(n ? n : 100000);
+      else
+      {
+         cerr << "Usage: " << argv[0] << " check|filter|phf|suggest [n]\n";
+         return 1;
+      }
+   }
+   catch (const char * error)
+   {
+      cerr << error << endl;
+      return 1;
+   }
+   return 0;
+}
@@ -3,22 +3,358 @@
  *    Week 12, Spell Check
  *    Brother Helfrich, CS 235
  * Author:
- *    <your name here>
+ *    Daniel Guzman
  * Summary:
- *    This program will implement the spellCheck() function
+ *    This program will implement the spellCheck() function. The
+ *    dictionary lives in a FlatHash and files are read a megabyte at a
+ *    time and cut into words by a table lookup per byte, so checking is
+ *    bound by the hash lookups rather than by iostreams.
  ************************************************************************/
 
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cstdio>        // for FOPEN and FREAD
+#include <cstring>       // for MEMMOVE
+#include <atomic>
+#include <thread>
 #include "spellCheck.h"
-#include "hash.h"
 using namespace std;
 
+/*****************************************
+ * LETTERS
+ * For each byte: the lowercase letter it
+ * is, or APOSTROPHE, or NOT_WORD. Bytes of
+ * UTF-8 sequences count as letters so an
+ * accented word stays in one piece
+ ****************************************/
+const unsigned char NOT_WORD   = 0;
+const unsigned char APOSTROPHE = '\'';
+
+struct Letters
+{
+   unsigned char lower[256];
+   Letters()
+   {
+      for (int c = 0; c < 256; c++)
+         lower[c] = (c >= 0x80) ? c : NOT_WORD;
+      for (int c = 'a'; c <= 'z'; c++)
+         lower[c] = lower[c - 'a' + 'A'] = c;
+      lower['\''] = APOSTROPHE;
+   }
+};
+static const Letters letters;
+
+/*****************************************
+ * DICTIONARY :: LOAD
+ * One word per line or per space, or an
+ * image written by PerfectHash::build()
+ ****************************************/
+void Dictionary::load(const string & fileName, double filterRate)
+   throw (const char *)
+{
+   filter.reset();
+   if (fileName.size() > 4 && fileName.compare(fileName.size() - 4, 4, ".phf") == 0)
+   {
+      mapped.open(fileName);
+      if (filterRate > 0.0)
+      {
+         filter.reset(new BloomFilter <string> (mapped.size(), filterRate));
+         for (int i = 0; i < mapped.size(); i++)
+            filter->insert(mapped.word(i));
+      }
+      return;
+   }
+
+   ifstream fin(fileName.c_str());
+   if (fin.fail())
+      throw "ERROR: unable to open the dictionary";
+
+   vector <string> list;
+   string word;
+   while (fin >> word)
+   {
+      for (int i = 0; i < word.size(); i++)
+         if (letters.lower[(unsigned char)word[i]] != NOT_WORD)
+            word[i] = letters.lower[(unsigned char)word[i]];
+      list.push_back(word);
+   }
+
+   words = FlatHash <string> (list.size());
+   for (int i = 0; i < list.size(); i++)
+      words.insert(list[i]);
+   if (filterRate > 0.0)
+   {
+      filter.reset(new BloomFilter <string> (words.size(), filterRate));
+      for (int i = 0; i < list.size(); i++)
+         filter->insert(list[i]);
+   }
+}
+
+/*****************************************
+ * DICTIONARY :: CONTAINS
+ ****************************************/
+bool Dictionary::contains(const char * word, int length) const
+{
+   string lower(word, length);
+   for (int i = 0; i < length; i++)
+      lower[i] = letters.lower[(unsigned char)word[i]];
+   if (filter && !filter->contains(lower))
+      return false;
+   if (mapped.isOpen())
+      return mapped.find(lower.data(), length);
+   return words.find(lower);
+}
+
+/*****************************************
+ * DICTIONARY :: CONTAINS MANY
+ * Hash and prefetch them all, then look.
+ * The filter, the table and the image all
+ * hash with hashBytes(), so each word is
+ * hashed once, and one the filter turns
+ * away is neither prefetched nor looked for
+ ****************************************/
+void Dictionary::containsMany(const string * lower, int num, bool * found) const
+{
+   size_t hashes[MAX_BATCH];
+   bool passed[MAX_BATCH];
+   for (int i = 0; i < num; i++)
+   {
+      hashes[i] = hashBytes(lower[i].data(), lower[i].size());
+      passed[i] = !filter || filter->containsHash(hashes[i]);
+   }
+
+   if (mapped.isOpen())
+   {
+      if (!filter)
+      {
+         mapped.findMany(lower, hashes, num, found);
+         return;
+      }
+
+      // the image wants the ones that got past in a row of their own
+      string kept[MAX_BATCH];
+      size_t keptHashes[MAX_BATCH];
+      bool keptFound[MAX_BATCH];
+      int numKept = 0;
+      for (int i = 0; i < num; i++)
+         if (passed[i])
+         {
+            kept[numKept] = lower[i];
+            keptHashes[numKept++] = hashes[i];
+         }
+      mapped.findMany(kept, keptHashes, numKept, keptFound);
+      for (int i = 0, k = 0; i < num; i++)
+         found[i] = passed[i] && keptFound[k++];
+      return;
+   }
+
+   for (int i = 0; i < num; i++)
+      if (passed[i])
+         words.prefetch(hashes[i]);
+   for (int i = 0; i < num; i++)
+      found[i] = passed[i] && words.find(lower[i], hashes[i]);
+}
+
+/*****************************************
+ * WORD BATCH
+ * Words waiting to be looked up, lowercased,
+ * with where they are in the buffer and the
+ * file. The buffer must not change until
+ * the batch is checked
+ ****************************************/
+struct WordBatch
+{
+   WordBatch() : num(0) {}
+
+   void add(const char * p, int length, int line, int column)
+   {
+      lower[num].resize(length);
+      for (int i = 0; i < length; i++)
+         lower[num][i] = letters.lower[(unsigned char)p[i]];
+      words[num] = p;
+      lengths[num] = length;
+      lines[num] = line;
+      columns[num] = column;
+      num++;
+   }
+
+   void check(const Dictionary & dictionary, vector <Misspelling> & misspelled)
+   {
+      bool found[Dictionary::MAX_BATCH];
+      dictionary.containsMany(lower, num, found);
+      for (int i = 0; i < num; i++)
+         if (!found[i])
+         {
+            Misspelling word;
+            word.word.assign(words[i], lengths[i]);
+            word.line = lines[i];
+            word.column = columns[i];
+            misspelled.push_back(word);
+         }
+      num = 0;
+   }
+
+   string lower[Dictionary::MAX_BATCH];
+   const char * words[Dictionary::MAX_BATCH];
+   int lengths[Dictionary::MAX_BATCH];
+   int lines[Dictionary::MAX_BATCH];
+   int columns[Dictionary::MAX_BATCH];
+   int num;
+};
+
+/*****************************************
+ * CHECK FILE
+ * Scan a chunk at a time. A word cut off at
+ * the end of a chunk is moved to the front of
+ * the buffer and finished with the next one; a
+ * word longer than the buffer doubles it
+ ****************************************/
+void checkFile(const Dictionary & dictionary, const string & fileName,
+               vector <Misspelling> & misspelled, int chunkSize) throw (const char *)
+{
+   if (chunkSize < 1)
+      throw "ERROR: the chunk size must be at least one byte";
+   FILE * file = fopen(fileName.c_str(), "rb");
+   if (file == NULL)
+      throw "ERROR: unable to open the file";
+
+   vector <char> buffer(chunkSize);
+   WordBatch batch;
+   int line = 1;
+   long long lineStart = 0;     // offset in the file of the current line
+   long long bufferStart = 0;   // offset in the file of buffer[0]
+   int kept = 0;                // bytes of a cut-off word at buffer[0]
+
+   for (;;)
+   {
+      if (kept == (int)buffer.size())
+         buffer.resize(buffer.size() * 2);
+      int numRead = fread(&buffer[kept], 1, buffer.size() - kept, file);
+      bool last = (numRead == 0);
+      const unsigned char * p = (const unsigned char *)&buffer[0];
+      int end = kept + numRead;
+      int cutOff = end;         // where the unfinished word starts
+
+      int i = 0;
+      while (i < end)
+      {
+         // between words
+         unsigned char c = letters.lower[p[i]];
+         if (c == NOT_WORD || c == APOSTROPHE)
+         {
+            if (p[i] == '\n')
+            {
+               line++;
+               lineStart = bufferStart + i + 1;
+            }
+            i++;
+            continue;
+         }
+
+         // a word, which may run off the end of the buffer
+         int start = i;
+         while (i < end && letters.lower[p[i]] != NOT_WORD)
+            i++;
+         if (i == end && !last)
+         {
+            cutOff = start;
+            break;
+         }
+
+         int length = i - start;
+         while (p[start + length - 1] == APOSTROPHE)
+            length--;
+         batch.add((const char *)p + start, length, line,
+                   (int)(bufferStart + start - lineStart) + 1);
+         if (batch.num == Dictionary::MAX_BATCH)
+            batch.check(dictionary, misspelled);
+      }
+
+      // the batch points into the buffer, so finish it first
+      batch.check(dictionary, misspelled);
+      kept = end - cutOff;
+      memmove(&buffer[0], &buffer[cutOff], kept);
+      bufferStart += cutOff;
+      if (last)
+         break;
+   }
+
+   bool failed = ferror(file);
+   fclose(file);
+   if (failed)
+      throw "ERROR: unable to read the file";
+}
+
+/*****************************************
+ * CHECK FILES
+ * Each worker takes the next file nobody
+ * has started until there are none left
+ ****************************************/
+void checkFiles(const Dictionary & dictionary,
+                const vector <string> & fileNames,
+                vector <SpellReport> & reports, int numThreads)
+{
+   reports.assign(fileNames.size(), SpellReport());
+   for (int i = 0; i < fileNames.size(); i++)
+      reports[i].fileName = fileNames[i];
+
+   atomic <int> next(0);
+   auto work = [&]()
+   {
+      for (int i = next++; i < (int)reports.size(); i = next++)
+      {
+         try
+         {
+            checkFile(dictionary, reports[i].fileName, reports[i].misspelled);
+         }
+         catch (const char * error)
+         {
+            reports[i].error = error;
+         }
+      }
+   };
+
+   if (numThreads > (int)fileNames.size())
+      numThreads = fileNames.size();
+   vector <thread> threads;
+   for (int i = 1; i < numThreads; i++)
+      threads.push_back(thread(work));
+   work();
+   for (int i = 0; i < threads.size(); i++)
+      threads[i].join();
+}
+
 /*****************************************
  * SPELL CHECK
  * Prompt the user for a file to spell-check
  ****************************************/
 void spellCheck()
 {
+   try
+   {
+      Dictionary dictionary;
+      dictionary.load(DICTIONARY_FILE);
+
+      string fileName;
+      cout << "What file do you want to check? ";
+      cin  >> fileName;
+
+      vector <Misspelling> misspelled;
+      checkFile(dictionary, fileName, misspelled);
+
+      if (misspelled.empty())
+         cout << "File contains no spelling errors\n";
+      else
+      {
+         cout << "Misspelled: ";
+         for (int i = 0; i < misspelled.size(); i++)
+            cout << (i ? ", " : "") << misspelled[i].word;
+         cout << endl;
+      }
+   }
+   catch (const char * error)
+   {
+      cout << error << endl;
+   }
 }
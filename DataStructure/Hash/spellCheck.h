@@ -11,6 +11,92 @@
 #ifndef SPELL_CHECK_H
 #define SPELL_CHECK_H
 
+#include <memory>
+#include <string>
+#include <vector>
+#include "filter.h"
+#include "flatHash.h"
+#include "perfectHash.h"
+
+#ifndef DICTIONARY_FILE
+#define DICTIONARY_FILE "/home/cs235e/week12/dictionary.txt"
+#endif
+
+/*************************************************************************
+ * DICTIONARY
+ * The words, lowercase, in a FlatHash, or mapped from a perfect hash
+ * image when the file name ends in .phf. Once loaded it is only read,
+ * so any number of threads can check against it at once. With a filter
+ * rate, a Bloom filter in front of the words turns most misspellings
+ * away before they reach the table
+ ************************************************************************/
+class Dictionary
+{
+public:
+   // filterRate is the false positive rate of the Bloom filter, 0 for none
+   void load(const std::string & fileName, double filterRate = 0.0)
+      throw (const char *);
+
+   // is word[0 .. length) a word, ignoring case?
+   bool contains(const char * word, int length) const;
+
+   // look up num words, already lowercase, at once. Much faster than
+   // one at a time: all the cache misses are waited on together
+   static const int MAX_BATCH = 32;
+   void containsMany(const std::string * lower, int num, bool * found) const;
+
+   int size() const { return mapped.isOpen() ? mapped.size() : words.size(); }
+
+   // not open unless a .phf was loaded
+   const PerfectHash & image() const { return mapped; }
+
+   // how the FlatHash is holding up; empty when an image was loaded
+   HashStats stats() const { return words.stats(); }
+
+   // NULL unless load() was given a filter rate
+   const BloomFilter <std::string> * getFilter() const { return filter.get(); }
+
+private:
+   FlatHash <std::string> words;
+   PerfectHash mapped;
+   std::unique_ptr <BloomFilter <std::string> > filter;
+};
+
+/*************************************************************************
+ * MISSPELLING
+ * A word as it appears in the file, and where: line and column count
+ * from 1, and the column is in bytes
+ ************************************************************************/
+struct Misspelling
+{
+   std::string word;
+   int line;
+   int column;
+};
+
+/*************************************************************************
+ * SPELL REPORT
+ * Everything wrong with one file, or why it could not be read
+ ************************************************************************/
+struct SpellReport
+{
+   std::string fileName;
+   std::vector <Misspelling> misspelled;
+   std::string error;
+};
+
+// a word is a run of letters, with apostrophes allowed inside it. The
+// file is read chunkSize bytes at a time
+void checkFile(const Dictionary & dictionary, const std::string & fileName,
+               std::vector <Misspelling> & misspelled,
+               int chunkSize = 1 << 20) throw (const char *);
+
+// check many files at once, each on a thread of its own, with up to
+// numThreads running at a time. reports comes back in fileNames' order
+void checkFiles(const Dictionary & dictionary,
+                const std::vector <std::string> & fileNames,
+                std::vector <SpellReport> & reports, int numThreads);
+
 void spellCheck();
 
 #endif // SPELL_CHECK_H
@@ -0,0 +1,310 @@
+/***********************************************************************
+ * Program:
+ *    SPELL CHECK TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks checkFile() against a plain scan of the whole file held in
+ *    memory: the same misspellings, each at the same line and column,
+ *    whatever the chunk size, so words cut at every chunk boundary are
+ *    put back together. Small files written by hand pin down the
+ *    rules themselves: apostrophes inside a word but not at its ends,
+ *    UTF-8 bytes as letters, case, and lines and columns counted in
+ *    bytes from 1. Random files of several megabytes, and a single
+ *    word longer than a chunk, check the files over 1MB.
+ *    Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdio>          // for REMOVE
+#include <cstdlib>         // for EXIT
+#include <fstream>
+#include <random>          // for MT19937
+#include <string>
+#include <vector>
+#include <unistd.h>        // for GETPID
+#include "spellCheck.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+string dictionaryName = "/tmp/spellCheckTest-" + to_string(getpid()) + ".dict";
+string textName = "/tmp/spellCheckTest-" + to_string(getpid()) + ".txt";
+
+// what the dictionary holds; "café" and "naïve" are UTF-8
+const char * WORDS[] = { "the", "cat", "sat", "on", "mat", "don't",
+                         "o'clock", "rock'n'roll", "café", "naïve", "a" };
+const int NUM_WORDS = sizeof(WORDS) / sizeof(WORDS[0]);
+
+/**********************************************************************
+ * WRITE
+ * Put text in a file, byte for byte
+ ***********************************************************************/
+void write(const string & fileName, const string & text)
+{
+   ofstream fout(fileName.c_str(), ios::binary);
+   fout.write(text.data(), text.size());
+   CHECK(fout.good());
+}
+
+/**********************************************************************
+ * IS LETTER and LOWER
+ * The rules of checkFile written out again: ASCII letters, and every
+ * byte of a UTF-8 sequence, lowercased only if ASCII
+ ***********************************************************************/
+bool isLetter(unsigned char c)
+{
+   return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c >= 0x80;
+}
+
+string lower(const string & word)
+{
+   string lowered(word);
+   for (int i = 0; i < lowered.size(); i++)
+      if (lowered[i] >= 'A' && lowered[i] <= 'Z')
+         lowered[i] += 'a' - 'A';
+   return lowered;
+}
+
+/**********************************************************************
+ * SCAN
+ * The misspellings in text, found all at once: a word starts at a
+ * letter, runs on through letters and apostrophes, and loses the
+ * apostrophes at its end
+ ***********************************************************************/
+vector <Misspelling> scan(const string & text, const Dictionary & dictionary)
+{
+   vector <Misspelling> misspelled;
+   int line = 1;
+   size_t lineStart = 0;
+   size_t i = 0;
+   while (i < text.size())
+   {
+      if (!isLetter(text[i]))
+      {
+         if (text[i] == '\n')
+         {
+            line++;
+            lineStart = i + 1;
+         }
+         i++;
+         continue;
+      }
+      size_t start = i;
+      while (i < text.size() && (isLetter(text[i]) || text[i] == '\''))
+         i++;
+      size_t end = i;
+      while (text[end - 1] == '\'')
+         end--;
+      string word = text.substr(start, end - start);
+      string lowered = lower(word);
+      if (!dictionary.contains(lowered.data(), lowered.size()))
+      {
+         Misspelling wrong = { word, line, (int)(start - lineStart) + 1 };
+         misspelled.push_back(wrong);
+      }
+   }
+   return misspelled;
+}
+
+/**********************************************************************
+ * SAME
+ * Two lists of misspellings match, word, line and column
+ ***********************************************************************/
+bool same(const vector <Misspelling> & a, const vector <Misspelling> & b)
+{
+   if (a.size() != b.size())
+      return false;
+   for (int i = 0; i < a.size(); i++)
+      if (a[i].word != b[i].word || a[i].line != b[i].line ||
+          a[i].column != b[i].column)
+         return false;
+   return true;
+}
+
+/**********************************************************************
+ * CHECK TEXT
+ * checkFile on text agrees with the scan at every chunk size given
+ ***********************************************************************/
+void checkText(const Dictionary & dictionary, const string & text,
+               const vector <int> & chunkSizes)
+{
+   write(textName, text);
+   vector <Misspelling> expected = scan(text, dictionary);
+   for (int i = 0; i < chunkSizes.size(); i++)
+   {
+      vector <Misspelling> misspelled;
+      checkFile(dictionary, textName, misspelled, chunkSizes[i]);
+      if (!same(misspelled, expected))
+         cerr << "chunk size " << chunkSizes[i] << ", "
+              << text.size() << " bytes\n";
+      CHECK(same(misspelled, expected));
+   }
+}
+
+/**********************************************************************
+ * BY HAND
+ * Small files with their misspellings worked out ahead, so the scan
+ * is checked as well, and read with every chunk size up to past their
+ * length, so each word is cut at each of its bytes in turn
+ ***********************************************************************/
+void byHand(const Dictionary & dictionary)
+{
+   vector <int> chunkSizes;
+   for (int size = 1; size <= 80; size++)
+      chunkSizes.push_back(size);
+
+   struct Case
+   {
+      const char * text;
+      int numWrong;
+      Misspelling wrong[4];
+   } cases[] =
+   {
+      { "the cat sat on the mat", 0 },
+      { "The CAT Sat", 0 },
+      { "the dgo sat", 1, { { "dgo", 1, 5 } } },
+      { "the cat\nsat on teh\nmat", 1, { { "teh", 2, 8 } } },
+      // apostrophes at the ends are not part of the word
+      { "'cat' cat'' don't 'the", 0 },
+      { "o'clock rock'n'roll don'", 1, { { "don", 1, 21 } } },
+      { "cats' ''' dont", 2, { { "cats", 1, 1 }, { "dont", 1, 11 } } },
+      // UTF-8 bytes are letters, and columns count bytes
+      { "café naïve", 0 },
+      { "Café cafe\ncafé ÇA", 2, { { "cafe", 1, 7 }, { "ÇA", 2, 7 } } },
+      // anything else separates words
+      { "cat,sat.on-the_mat1a", 0 },
+      { "\n\n\ncat\n  zzz", 1, { { "zzz", 5, 3 } } },
+      { "", 0 },
+      { "xyz", 1, { { "xyz", 1, 1 } } },
+   };
+   for (int c = 0; c < sizeof(cases) / sizeof(cases[0]); c++)
+   {
+      vector <Misspelling> expected(cases[c].wrong, cases[c].wrong + cases[c].numWrong);
+      CHECK(same(scan(cases[c].text, dictionary), expected));
+      checkText(dictionary, cases[c].text, chunkSizes);
+   }
+}
+
+/**********************************************************************
+ * RANDOM TEXT
+ * size bytes of words, right and wrong, some cased, some with
+ * apostrophes, between runs of spaces, punctuation and newlines
+ ***********************************************************************/
+string randomText(size_t size, mt19937 & random)
+{
+   const char * gaps[] = { " ", " ", " ", "\n", ", ", ". ", "\n\n", "  ", "'" };
+   string text;
+   while (text.size() < size)
+   {
+      string word = WORDS[random() % NUM_WORDS];
+      switch (random() % 8)
+      {
+         case 0:
+            word[0] = word[0] - 'a' + 'A';
+            break;
+         case 1:
+            word[random() % word.size()] = 'a' + random() % 26;
+            break;
+         case 2:
+            word += "''";
+            break;
+      }
+      text += word;
+      text += gaps[random() % (sizeof(gaps) / sizeof(gaps[0]))];
+   }
+   return text;
+}
+
+/**********************************************************************
+ * LARGE FILES
+ * Several megabytes, so the default chunk is filled and refilled,
+ * and one word longer than the default chunk, which must grow it
+ ***********************************************************************/
+void largeFiles(const Dictionary & dictionary)
+{
+   mt19937 random(45);
+   vector <int> chunkSizes;
+   chunkSizes.push_back(1 << 20);
+   chunkSizes.push_back(4096);
+   chunkSizes.push_back(1000003);
+   checkText(dictionary, randomText(3 * (1 << 20) + 12345, random), chunkSizes);
+
+   string text = randomText(1 << 20, random) + "\n  ";
+   int line = 1;
+   for (int i = 0; i < text.size(); i++)
+      line += text[i] == '\n';
+   text += string((1 << 20) + 100, 'q') + "' cat\nzz";
+   chunkSizes.push_back(100);
+   checkText(dictionary, text, chunkSizes);
+
+   // the long word is found whole, where it starts
+   vector <Misspelling> misspelled;
+   checkFile(dictionary, textName, misspelled);
+   CHECK(misspelled.size() >= 2);
+   const Misspelling & longWord = misspelled[misspelled.size() - 2];
+   CHECK(longWord.word == string((1 << 20) + 100, 'q'));
+   CHECK(longWord.line == line);
+   CHECK(longWord.column == 3);
+   CHECK(misspelled.back().word == "zz");
+   CHECK(misspelled.back().line == line + 1);
+}
+
+/**********************************************************************
+ * ERRORS
+ * A file that is not there, and a chunk size of nothing
+ ***********************************************************************/
+void errors(const Dictionary & dictionary)
+{
+   vector <Misspelling> misspelled;
+   bool thrown = false;
+   try
+   {
+      checkFile(dictionary, "/nonexistent/spellCheckTest", misspelled);
+   }
+   catch (const char * error)
+   {
+      thrown = true;
+   }
+   CHECK(thrown);
+
+   write(textName, "cat");
+   thrown = false;
+   try
+   {
+      checkFile(dictionary, textName, misspelled, 0);
+   }
+   catch (const char * error)
+   {
+      thrown = true;
+   }
+   CHECK(thrown);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   string words;
+   for (int i = 0; i < NUM_WORDS; i++)
+      words += string(WORDS[i]) + "\n";
+   write(dictionaryName, words);
+   Dictionary dictionary;
+   dictionary.load(dictionaryName);
+   CHECK(dictionary.size() == NUM_WORDS);
+
+   byHand(dictionary);
+   largeFiles(dictionary);
+   errors(dictionary);
+
+   remove(dictionaryName.c_str());
+   remove(textName.c_str());
+   cout << "Spell check tests passed\n";
+   return 0;
+}
@@ -0,0 +1,319 @@
+/***********************************************************************
+ * Module:
+ *    Suggest
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Edit distance, the SymSpell and BK-tree suggestion indexes, and
+ *    what they share. See suggest.h
+ ************************************************************************/
+
+#include <algorithm>     // for SORT, UNIQUE and PARTIAL_SORT
+#include <cstring>       // for MEMSET
+#include <fstream>
+#include "suggest.h"
+using namespace std;
+
+/*****************************************
+ * EDIT DISTANCE :: CONSTRUCTOR
+ ****************************************/
+EditDistance::EditDistance(const string & pattern) : pattern(pattern)
+{
+   memset(peq, 0, sizeof(peq));
+   if (pattern.size() <= 64)
+      for (int i = 0; i < pattern.size(); i++)
+         peq[(unsigned char)pattern[i]] |= 1ULL << i;
+}
+
+/*****************************************
+ * EDIT DISTANCE :: TO
+ * Pv and Mv hold whether each cell of the
+ * column is one more or one less than the
+ * cell above it; a word of arithmetic moves
+ * the whole column one letter of text on.
+ * The bottom cell is the distance so far,
+ * and since each letter left can lower it
+ * by at most one, we can stop early
+ ****************************************/
+int EditDistance::to(const string & text, int bound) const
+{
+   int m = pattern.size();
+   int n = text.size();
+   if (m > 64)
+      return table(text, bound);
+   if (m - n > bound || n - m > bound)
+      return bound + 1;
+   if (m == 0)
+      return n;
+
+   unsigned long long pv = ~0ULL;
+   unsigned long long mv = 0;
+   unsigned long long last = 1ULL << (m - 1);
+   int score = m;
+
+   for (int j = 0; j < n; j++)
+   {
+      unsigned long long eq = peq[(unsigned char)text[j]];
+      unsigned long long xv = eq | mv;
+      unsigned long long xh = (((eq & pv) + pv) ^ pv) | eq;
+      unsigned long long ph = mv | ~(xh | pv);
+      unsigned long long mh = pv & xh;
+
+      if (ph & last)
+         score++;
+      else if (mh & last)
+         score--;
+
+      // the top row is 0, 1, 2, ...: always one more
+      ph = (ph << 1) | 1;
+      mh <<= 1;
+      pv = mh | ~(xv | ph);
+      mv = ph & xv;
+
+      if (score - (n - j - 1) > bound)
+         return bound + 1;
+   }
+   return score <= bound ? score : bound + 1;
+}
+
+/*****************************************
+ * EDIT DISTANCE :: TABLE
+ * The textbook way, a row at a time, for
+ * patterns too long for one word of bits
+ ****************************************/
+int EditDistance::table(const string & text, int bound) const
+{
+   int m = pattern.size();
+   vector <int> row(m + 1);
+   for (int i = 0; i <= m; i++)
+      row[i] = i;
+
+   for (int j = 1; j <= text.size(); j++)
+   {
+      int diagonal = row[0];
+      row[0] = j;
+      for (int i = 1; i <= m; i++)
+      {
+         int above = row[i];
+         int change = diagonal + (pattern[i - 1] != text[j - 1]);
+         row[i] = min(change, min(row[i - 1], above) + 1);
+         diagonal = above;
+      }
+   }
+   return row[m] <= bound ? row[m] : bound + 1;
+}
+
+/*****************************************
+ * RANK SUGGESTIONS
+ ****************************************/
+static bool closer(const Suggestion & lhs, const Suggestion & rhs)
+{
+   if (lhs.distance != rhs.distance)
+      return lhs.distance < rhs.distance;
+   return lhs.word < rhs.word;
+}
+
+void rankSuggestions(vector <Suggestion> & suggestions, int k)
+{
+   if (k < suggestions.size())
+   {
+      partial_sort(suggestions.begin(), suggestions.begin() + k,
+                   suggestions.end(), closer);
+      suggestions.resize(k);
+   }
+   else
+      sort(suggestions.begin(), suggestions.end(), closer);
+}
+
+/*****************************************
+ * SYM SPELL :: DELETES
+ * The hashes of every string made by taking
+ * up to maxDistance letters out of the
+ * word's prefix, the prefix itself included
+ ****************************************/
+void SymSpell::deletes(const string & word, vector <size_t> & keys) const
+{
+   vector <string> all(1, word.substr(0, PREFIX));
+   int levelStart = 0;
+   for (int d = 0; d < maxDistance; d++)
+   {
+      int levelEnd = all.size();
+      for (int i = levelStart; i < levelEnd; i++)
+         for (int j = 0; j < all[i].size(); j++)
+            all.push_back(string(all[i]).erase(j, 1));
+      levelStart = levelEnd;
+   }
+
+   DefaultHasher <string> hasher;
+   keys.clear();
+   for (int i = 0; i < all.size(); i++)
+      keys.push_back(hasher(all[i]));
+   sort(keys.begin(), keys.end());
+   keys.erase(unique(keys.begin(), keys.end()), keys.end());
+}
+
+/*****************************************
+ * SYM SPELL :: BUILD
+ * Gather (key, word) for every word, sort
+ * them by key, and file each key's run
+ ****************************************/
+void SymSpell::build(const vector <string> & words)
+{
+   this->words = words;
+
+   vector <pair <size_t, int> > entries;
+   vector <size_t> keys;
+   for (int id = 0; id < words.size(); id++)
+   {
+      deletes(words[id], keys);
+      for (int i = 0; i < keys.size(); i++)
+         entries.push_back(pair <size_t, int> (keys[i], id));
+   }
+   sort(entries.begin(), entries.end());
+
+   postings.resize(entries.size());
+   index = HashMap <size_t, Run> (entries.size() / 4);
+   for (int i = 0; i < entries.size(); i++)
+   {
+      postings[i] = entries[i].second;
+      Run & run = index[entries[i].first];
+      if (run.count++ == 0)
+         run.first = i;
+   }
+}
+
+/*****************************************
+ * SYM SPELL :: SUGGEST
+ * Every word sharing a key with the query
+ * is a candidate; only those really within
+ * maxDistance are kept
+ ****************************************/
+void SymSpell::suggest(const string & word, int k,
+                       vector <Suggestion> & suggestions) const
+{
+   suggestions.clear();
+
+   vector <size_t> keys;
+   deletes(word, keys);
+   vector <int> candidates;
+   for (int i = 0; i < keys.size(); i++)
+   {
+      HashMap <size_t, Run> ::const_iterator it = index.find(keys[i]);
+      if (it != index.end())
+         candidates.insert(candidates.end(),
+                           postings.begin() + it->second.first,
+                           postings.begin() + it->second.first + it->second.count);
+   }
+   sort(candidates.begin(), candidates.end());
+   candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+   EditDistance distance(word);
+   for (int i = 0; i < candidates.size(); i++)
+   {
+      Suggestion suggestion;
+      suggestion.word = words[candidates[i]];
+      suggestion.distance = distance.to(suggestion.word, maxDistance);
+      if (suggestion.distance <= maxDistance)
+         suggestions.push_back(suggestion);
+   }
+   rankSuggestions(suggestions, k);
+}
+
+/*****************************************
+ * BK TREE :: BUILD
+ * Walk down from the root along the child
+ * at the new word's distance until there
+ * is no such child, and add it there
+ ****************************************/
+void BKTree::build(const vector <string> & words)
+{
+   nodes.clear();
+   nodes.reserve(words.size());
+   for (int w = 0; w < words.size(); w++)
+   {
+      Node node;
+      node.word = words[w];
+      node.distance = 0;
+      node.firstChild = node.nextSibling = -1;
+      if (nodes.empty())
+      {
+         nodes.push_back(node);
+         continue;
+      }
+
+      EditDistance distance(words[w]);
+      int parent = 0;
+      for (;;)
+      {
+         node.distance = distance.to(nodes[parent].word);
+         if (node.distance == 0)
+            break;                      // a repeat
+
+         int child = nodes[parent].firstChild;
+         while (child >= 0 && nodes[child].distance != node.distance)
+            child = nodes[child].nextSibling;
+         if (child < 0)
+         {
+            node.nextSibling = nodes[parent].firstChild;
+            nodes[parent].firstChild = nodes.size();
+            nodes.push_back(node);
+            break;
+         }
+         parent = child;
+      }
+   }
+}
+
+/*****************************************
+ * BK TREE :: SUGGEST
+ ****************************************/
+void BKTree::suggest(const string & word, int k,
+                     vector <Suggestion> & suggestions) const
+{
+   suggestions.clear();
+   if (nodes.empty())
+      return;
+
+   EditDistance distance(word);
+   vector <int> toVisit(1, 0);
+   while (!toVisit.empty())
+   {
+      const Node & node = nodes[toVisit.back()];
+      toVisit.pop_back();
+
+      int d = distance.to(node.word);
+      if (d <= maxDistance)
+      {
+         Suggestion suggestion;
+         suggestion.word = node.word;
+         suggestion.distance = d;
+         suggestions.push_back(suggestion);
+      }
+      for (int child = node.firstChild; child >= 0; child = nodes[child].nextSibling)
+         if (nodes[child].distance >= d - maxDistance &&
+             nodes[child].distance <= d + maxDistance)
+            toVisit.push_back(child);
+   }
+   rankSuggestions(suggestions, k);
+}
+
+/*****************************************
+ * LOAD WORDS
+ ****************************************/
+void loadWords(const string & fileName, vector <string> & words) throw (const char *)
+{
+   ifstream fin(fileName.c_str());
+   if (fin.fail())
+      throw "ERROR: unable to open the dictionary";
+
+   string word;
+   while (fin >> word)
+   {
+      for (int i = 0; i < word.size(); i++)
+         if (word[i] >= 'A' && word[i] <= 'Z')
+            word[i] += 'a' - 'A';
+      words.push_back(word);
+   }
+   sort(words.begin(), words.end());
+   words.erase(unique(words.begin(), words.end()), words.end());
+}
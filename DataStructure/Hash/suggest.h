@@ -0,0 +1,133 @@
+/***********************************************************************
+ * Header:
+ *    Suggest
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Spelling suggestions: the dictionary words closest to a misspelled
+ *    one by edit distance (insert, delete or change one letter). Two
+ *    indexes are built when the dictionary is loaded so a query never
+ *    compares against every word:
+ *       SymSpell   every word filed under the strings left by deleting
+ *                  up to two of its letters. A word within distance two
+ *                  of the query shares one of those with it
+ *       BKTree     words arranged by distance from each other, so the
+ *                  triangle inequality rules out whole subtrees
+ *    Both check their candidates with EditDistance, which computes the
+ *    distance a column of 64 cells at a time (Myers' bit-vector method).
+ ************************************************************************/
+
+#ifndef SUGGEST_H
+#define SUGGEST_H
+
+#include <string>
+#include <vector>
+#include "hashMap.h"
+
+/*************************************************************************
+ * EDIT DISTANCE
+ * Distances from one pattern to many words. Setting up takes a pass over
+ * the pattern; each word after that costs a few instructions per letter
+ * when the pattern has at most 64 letters, and a plain table otherwise
+ ************************************************************************/
+class EditDistance
+{
+public:
+   EditDistance(const std::string & pattern);
+
+   // the distance to text, or bound + 1 once it is sure to be more
+   int to(const std::string & text, int bound = 1 << 30) const;
+
+private:
+   int table(const std::string & text, int bound) const;
+
+   std::string pattern;
+   unsigned long long peq[256];   // bit i of peq[c] is set if pattern[i] == c
+};
+
+/*************************************************************************
+ * SUGGESTION
+ ************************************************************************/
+struct Suggestion
+{
+   std::string word;
+   int distance;
+};
+
+/*************************************************************************
+ * SYM SPELL
+ * Only the first PREFIX letters of a word are deleted from, which keeps
+ * the index to a few dozen keys per word; candidates are then checked
+ * against the whole word. Keys are 64-bit hashes of the deleted strings,
+ * and each maps to a run of word numbers in one array
+ ************************************************************************/
+class SymSpell
+{
+public:
+   SymSpell(int maxDistance = 2) : maxDistance(maxDistance) {}
+
+   // words must be lowercase and distinct
+   void build(const std::vector <std::string> & words);
+
+   // up to k words within maxDistance of word, closest first, ties in
+   // alphabetical order
+   void suggest(const std::string & word, int k,
+                std::vector <Suggestion> & suggestions) const;
+
+   int size() const { return words.size(); }
+
+private:
+   static const int PREFIX = 7;
+
+   struct Run
+   {
+      int first;
+      int count;
+   };
+
+   void deletes(const std::string & word, std::vector <size_t> & keys) const;
+
+   int maxDistance;
+   std::vector <std::string> words;
+   std::vector <int> postings;             // word numbers
+   HashMap <size_t, Run> index;            // key -> postings
+};
+
+/*************************************************************************
+ * BK TREE
+ * Each child is filed under its distance from its parent. Searching for
+ * words within d of the query, a node at distance n from it can only
+ * have such words under children filed between n - d and n + d
+ ************************************************************************/
+class BKTree
+{
+public:
+   BKTree(int maxDistance = 2) : maxDistance(maxDistance) {}
+
+   void build(const std::vector <std::string> & words);
+   void suggest(const std::string & word, int k,
+                std::vector <Suggestion> & suggestions) const;
+
+   int size() const { return nodes.size(); }
+
+private:
+   struct Node
+   {
+      std::string word;
+      int distance;       // from the parent
+      int firstChild;     // -1 if none
+      int nextSibling;    // -1 if none
+   };
+
+   int maxDistance;
+   std::vector <Node> nodes;
+};
+
+// keep the k best, closest first and then alphabetical
+void rankSuggestions(std::vector <Suggestion> & suggestions, int k);
+
+// the words of a dictionary file, lowercase and without repeats
+void loadWords(const std::string & fileName,
+               std::vector <std::string> & words) throw (const char *);
+
+#endif // SUGGEST_H
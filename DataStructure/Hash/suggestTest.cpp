@@ -0,0 +1,193 @@
+/***********************************************************************
+ * Program:
+ *    SUGGEST TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks EditDistance against the textbook table on random pairs,
+ *    both sides of the 64-letter limit, and that SymSpell and BKTree
+ *    suggest exactly what a scan of every word does, for queries a few
+ *    edits from a dictionary word and for random ones. The words use a
+ *    small alphabet so each has many neighbours. Exits 1 on the first
+ *    failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for MIN
+#include <cstdlib>         // for EXIT
+#include <random>          // for MT19937
+#include <string>
+#include <vector>
+#include "suggest.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * DISTANCE
+ * The whole table, no bound, no bits
+ ***********************************************************************/
+int distance(const string & a, const string & b)
+{
+   vector <vector <int> > d(a.size() + 1, vector <int> (b.size() + 1));
+   for (size_t i = 0; i <= a.size(); i++)
+      d[i][0] = i;
+   for (size_t j = 0; j <= b.size(); j++)
+      d[0][j] = j;
+   for (size_t i = 1; i <= a.size(); i++)
+      for (size_t j = 1; j <= b.size(); j++)
+         d[i][j] = min(d[i - 1][j - 1] + (a[i - 1] != b[j - 1]),
+                       min(d[i - 1][j], d[i][j - 1]) + 1);
+   return d[a.size()][b.size()];
+}
+
+string randomWord(mt19937 & random, int minLength, int maxLength, int letters)
+{
+   string word(minLength + random() % (maxLength - minLength + 1), ' ');
+   for (size_t i = 0; i < word.size(); i++)
+      word[i] = 'a' + random() % letters;
+   return word;
+}
+
+/**********************************************************************
+ * EDIT
+ * The word with up to numEdits letters inserted, deleted or changed
+ ***********************************************************************/
+string edit(mt19937 & random, string word, int numEdits)
+{
+   for (int e = 0; e < numEdits; e++)
+   {
+      int kind = random() % 3;
+      char letter = 'a' + random() % 6;
+      if (kind == 0 || word.empty())
+         word.insert(word.begin() + random() % (word.size() + 1), letter);
+      else if (kind == 1)
+         word.erase(random() % word.size(), 1);
+      else
+         word[random() % word.size()] = letter;
+   }
+   return word;
+}
+
+/**********************************************************************
+ * EDIT DISTANCES
+ * Unbounded, the exact distance. Bounded, the exact distance when it
+ * is within the bound, and bound + 1 when it is not
+ ***********************************************************************/
+void editDistances()
+{
+   mt19937 random(1);
+   for (int n = 0; n < 100000; n++)
+   {
+      string a = randomWord(random, 0, n % 10 ? 12 : 90, 4);
+      string b = (n % 2) ? edit(random, a, random() % 5)
+                         : randomWord(random, 0, n % 10 ? 12 : 90, 4);
+      int expected = distance(a, b);
+      EditDistance from(a);
+      CHECK(from.to(b) == expected);
+      int bound = random() % 5;
+      CHECK(from.to(b, bound) == min(expected, bound + 1));
+   }
+
+   // right at the limit of one word of bits
+   string a64(64, 'a');
+   string a65(65, 'a');
+   CHECK(EditDistance(a64).to(a65) == 1);
+   CHECK(EditDistance(a65).to(a64) == 1);
+   CHECK(EditDistance(a64).to("") == 64);
+   CHECK(EditDistance("").to(a64) == 64);
+}
+
+/**********************************************************************
+ * SCAN
+ * What every index has to agree with: every word, one at a time
+ ***********************************************************************/
+void scan(const vector <string> & words, const string & word, int k,
+          vector <Suggestion> & suggestions)
+{
+   suggestions.clear();
+   for (size_t i = 0; i < words.size(); i++)
+   {
+      Suggestion suggestion;
+      suggestion.word = words[i];
+      suggestion.distance = distance(word, words[i]);
+      if (suggestion.distance <= 2)
+         suggestions.push_back(suggestion);
+   }
+   rankSuggestions(suggestions, k);
+}
+
+bool same(const vector <Suggestion> & lhs, const vector <Suggestion> & rhs)
+{
+   if (lhs.size() != rhs.size())
+      return false;
+   for (size_t i = 0; i < lhs.size(); i++)
+      if (lhs[i].word != rhs[i].word || lhs[i].distance != rhs[i].distance)
+         return false;
+   return true;
+}
+
+/**********************************************************************
+ * INDEXES
+ * Words of 1 to 14 letters from six, some much longer, and queries
+ * made from them with up to three edits, past what may be suggested
+ ***********************************************************************/
+void indexes()
+{
+   mt19937 random(2);
+   vector <string> words;
+   for (int i = 0; i < 5000; i++)
+      words.push_back(randomWord(random, 1, 14, 6));
+   for (int i = 0; i < 20; i++)
+      words.push_back(randomWord(random, 60, 70, 6));
+   sort(words.begin(), words.end());
+   words.erase(unique(words.begin(), words.end()), words.end());
+
+   SymSpell symSpell;
+   symSpell.build(words);
+   BKTree bkTree;
+   bkTree.build(words);
+   CHECK(symSpell.size() == (int)words.size());
+   CHECK(bkTree.size() == (int)words.size());
+
+   vector <Suggestion> expected;
+   vector <Suggestion> suggestions;
+   int numWithSome = 0;
+   for (int q = 0; q < 2000; q++)
+   {
+      string word = (q % 4) ? edit(random, words[random() % words.size()], random() % 4)
+                            : randomWord(random, 1, 14, 6);
+      int k = (q % 2) ? 5 : 1000000;
+      scan(words, word, k, expected);
+      numWithSome += !expected.empty();
+
+      symSpell.suggest(word, k, suggestions);
+      CHECK(same(suggestions, expected));
+      bkTree.suggest(word, k, suggestions);
+      CHECK(same(suggestions, expected));
+   }
+   // the queries were not all too far from everything
+   CHECK(numWithSome > 1000);
+
+   // nothing in, nothing out
+   BKTree empty;
+   empty.build(vector <string> ());
+   empty.suggest("word", 5, suggestions);
+   CHECK(suggestions.empty());
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   editDistances();
+   indexes();
+   cout << "Suggest tests passed\n";
+   return 0;
+}
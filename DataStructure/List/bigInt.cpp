@@ -0,0 +1,357 @@
+/***********************************************************************
+ * Implementation:
+ *    BIG INT
+ * Summary:
+ *    Arithmetic on base 1,000,000,000 limbs along with fast-doubling
+ *    Fibonacci. See bigInt.h for the representation.
+ * Author
+ *    Daniel Guzman
+ **********************************************************************/
+
+#include <algorithm>   // for MIN and SWAP
+#include <thread>      // for THREAD
+#include "bigInt.h"
+using namespace std;
+
+typedef BigInt::Limb Limb;
+typedef unsigned long long Wide;
+
+// below this many limbs Karatsuba costs more than it saves
+const int KARATSUBA_CUTOFF = 40;
+
+// each formatting thread gets at least this many limbs
+const size_t FORMAT_LIMBS_PER_THREAD = 1 << 16;
+
+/************************************************
+ * TRIM
+ * Drop leading zero limbs so zero has no limbs
+ ***********************************************/
+static void trim(vector <Limb> & v)
+{
+    while (!v.empty() && v.back() == 0)
+        v.pop_back();
+}
+
+/************************************************
+ * ADD SHIFTED
+ * r += x * BASE^shift, growing r as needed
+ ***********************************************/
+static void addShifted(vector <Limb> & r, const vector <Limb> & x, size_t shift)
+{
+    if (r.size() < x.size() + shift + 1)
+        r.resize(x.size() + shift + 1, 0);
+
+    Limb carry = 0;
+    size_t i = 0;
+    for (; i < x.size(); i++)
+    {
+        Limb sum = r[i + shift] + x[i] + carry;
+        carry = (sum >= BigInt::BASE);
+        r[i + shift] = carry ? sum - BigInt::BASE : sum;
+    }
+    for (i += shift; carry; i++)
+    {
+        if (i == r.size())
+            r.push_back(0);
+        Limb sum = r[i] + carry;
+        carry = (sum >= BigInt::BASE);
+        r[i] = carry ? sum - BigInt::BASE : sum;
+    }
+    trim(r);
+}
+
+/************************************************
+ * SUBTRACT FROM
+ * r -= x where r >= x
+ ***********************************************/
+static void subtractFrom(vector <Limb> & r, const vector <Limb> & x)
+{
+    Limb borrow = 0;
+    size_t i = 0;
+    for (; i < x.size(); i++)
+    {
+        Limb sub = x[i] + borrow;
+        borrow = (r[i] < sub);
+        r[i] = borrow ? r[i] + BigInt::BASE - sub : r[i] - sub;
+    }
+    for (; borrow && i < r.size(); i++)
+    {
+        borrow = (r[i] == 0);
+        r[i] = borrow ? BigInt::BASE - 1 : r[i] - 1;
+    }
+    trim(r);
+}
+
+/************************************************
+ * MULTIPLY SCHOOLBOOK
+ * The O(n*m) method, one row of a at a time.
+ * Every partial sum fits easily in 64 bits
+ ***********************************************/
+static vector <Limb> multiplySchoolbook(const Limb * a, size_t na,
+                                        const Limb * b, size_t nb)
+{
+    vector <Limb> r(na + nb, 0);
+    for (size_t i = 0; i < na; i++)
+    {
+        Wide carry = 0;
+        Wide ai = a[i];
+        for (size_t j = 0; j < nb; j++)
+        {
+            Wide cur = r[i + j] + ai * b[j] + carry;
+            carry = cur / BigInt::BASE;
+            r[i + j] = (Limb)(cur - carry * BigInt::BASE);
+        }
+        r[i + nb] = (Limb)carry;
+    }
+    trim(r);
+    return r;
+}
+
+/************************************************
+ * MULTIPLY
+ * Karatsuba: with a = a1 B^m + a0 and likewise
+ * for b, three half-size products replace four:
+ *    a b = z2 B^2m + (z1 - z2 - z0) B^m + z0
+ * where z1 = (a0 + a1)(b0 + b1)
+ ***********************************************/
+static vector <Limb> multiply(const Limb * a, size_t na,
+                              const Limb * b, size_t nb)
+{
+    while (na > 0 && a[na - 1] == 0)
+        na--;
+    while (nb > 0 && b[nb - 1] == 0)
+        nb--;
+    if (na < nb)
+    {
+        swap(a, b);
+        swap(na, nb);
+    }
+    if (nb == 0)
+        return vector <Limb> ();
+    if (nb < (size_t)KARATSUBA_CUTOFF)
+        return multiplySchoolbook(a, na, b, nb);
+
+    // lopsided operands: cut a into pieces the size of b
+    if (nb <= na / 2)
+    {
+        vector <Limb> r;
+        for (size_t k = 0; k < na; k += nb)
+            addShifted(r, multiply(a + k, min(nb, na - k), b, nb), k);
+        return r;
+    }
+
+    size_t m = na / 2;
+    vector <Limb> z0 = multiply(a, m, b, m);
+    vector <Limb> z2 = multiply(a + m, na - m, b + m, nb - m);
+
+    vector <Limb> sumA(a, a + m);
+    vector <Limb> sumB(b, b + m);
+    trim(sumA);
+    trim(sumB);
+    addShifted(sumA, vector <Limb> (a + m, a + na), 0);
+    addShifted(sumB, vector <Limb> (b + m, b + nb), 0);
+    vector <Limb> z1 = multiply(sumA.data(), sumA.size(),
+                                sumB.data(), sumB.size());
+    subtractFrom(z1, z0);
+    subtractFrom(z1, z2);
+
+    vector <Limb> r(z0);
+    addShifted(r, z1, m);
+    addShifted(r, z2, 2 * m);
+    return r;
+}
+
+/************************************************
+ * BIG INT : NON-DEFAULT CONSTRUCTOR
+ ***********************************************/
+BigInt :: BigInt(unsigned long long value)
+{
+    for (; value; value /= BASE)
+        limbs.push_back((Limb)(value % BASE));
+}
+
+/************************************************
+ * BIG INT : ADD ONTO
+ ***********************************************/
+BigInt & BigInt :: operator += (const BigInt & rhs)
+{
+    addShifted(limbs, rhs.limbs, 0);
+    return *this;
+}
+
+/************************************************
+ * BIG INT : SUBTRACT FROM
+ ***********************************************/
+BigInt & BigInt :: operator -= (const BigInt & rhs) throw (const char *)
+{
+    if (*this < rhs)
+        throw "ERROR: BigInt cannot hold a negative number";
+    subtractFrom(limbs, rhs.limbs);
+    return *this;
+}
+
+/************************************************
+ * BIG INT : ADD, SUBTRACT, MULTIPLY
+ ***********************************************/
+BigInt BigInt :: operator + (const BigInt & rhs) const
+{
+    BigInt sum(*this);
+    return sum += rhs;
+}
+
+BigInt BigInt :: operator - (const BigInt & rhs) const throw (const char *)
+{
+    BigInt difference(*this);
+    return difference -= rhs;
+}
+
+BigInt BigInt :: operator * (const BigInt & rhs) const
+{
+    BigInt product;
+    product.limbs = multiply(limbs.data(), limbs.size(),
+                             rhs.limbs.data(), rhs.limbs.size());
+    return product;
+}
+
+/************************************************
+ * BIG INT : LESS THAN
+ ***********************************************/
+bool BigInt :: operator < (const BigInt & rhs) const
+{
+    if (limbs.size() != rhs.limbs.size())
+        return limbs.size() < rhs.limbs.size();
+    for (size_t i = limbs.size(); i-- > 0; )
+        if (limbs[i] != rhs.limbs[i])
+            return limbs[i] < rhs.limbs[i];
+    return false;
+}
+
+/************************************************
+ * BIG INT : NUM DIGITS
+ * Nine digits per limb, except for the top one
+ ***********************************************/
+int BigInt :: numDigits() const
+{
+    if (limbs.empty())
+        return 1;
+    int digits = DIGITS * (numLimbs() - 1);
+    for (Limb top = limbs.back(); top; top /= 10)
+        digits++;
+    return digits;
+}
+
+/************************************************
+ * FORMAT LIMBS
+ * Every limb below the top one is exactly nine
+ * digits, so limb i lands at a fixed place in the
+ * output and any range of limbs can be written
+ * independently of the others
+ ***********************************************/
+static void formatLimbs(const Limb * limbs, size_t first, size_t last,
+                        char * pEnd)
+{
+    for (size_t i = first; i < last; i++)
+    {
+        char * p = pEnd - BigInt::DIGITS * i;
+        Limb limb = limbs[i];
+        for (int digit = 0; digit < BigInt::DIGITS; digit++, limb /= 10)
+            *--p = (char)('0' + limb % 10);
+    }
+}
+
+/************************************************
+ * BIG INT : FORMAT
+ * The top limb has no leading zeros. The rest are
+ * split into contiguous ranges, one per thread,
+ * once there are enough of them to be worth it.
+ * Base 1e9 limbs are already decimal, so there is
+ * no base conversion to divide up
+ ***********************************************/
+size_t BigInt :: format(const Limb * limbs, size_t n, char * buffer)
+{
+    if (n == 0)
+    {
+        buffer[0] = '0';
+        return 1;
+    }
+
+    char top[DIGITS];
+    int length = 0;
+    for (Limb limb = limbs[n - 1]; limb; limb /= 10)
+        top[length++] = (char)('0' + limb % 10);
+    for (int i = 0; i < length; i++)
+        buffer[i] = top[length - 1 - i];
+
+    size_t total = length + DIGITS * (n - 1);
+    char * pEnd = buffer + total;
+
+    size_t numThreads = (n - 1) / FORMAT_LIMBS_PER_THREAD;
+    numThreads = min(numThreads, (size_t)thread::hardware_concurrency());
+    if (numThreads <= 1)
+    {
+        formatLimbs(limbs, 0, n - 1, pEnd);
+        return total;
+    }
+
+    vector <thread> threads;
+    size_t chunk = (n - 1 + numThreads - 1) / numThreads;
+    for (size_t first = 0; first < n - 1; first += chunk)
+        threads.push_back(thread(formatLimbs, limbs, first,
+                                 min(first + chunk, n - 1), pEnd));
+    for (size_t i = 0; i < threads.size(); i++)
+        threads[i].join();
+    return total;
+}
+
+/************************************************
+ * BIG INT : TO STRING
+ ***********************************************/
+string BigInt :: toString() const
+{
+    string text(numDigits(), '0');
+    format(limbs.data(), limbs.size(), &text[0]);
+    return text;
+}
+
+/************************************************
+ * INSERTION
+ ***********************************************/
+ostream & operator << (ostream & out, const BigInt & rhs)
+{
+    return out << rhs.toString();
+}
+
+/************************************************
+ * FIBONACCI NUMBER
+ * Fast doubling, walking the bits of n from the
+ * top with a = F(k) and b = F(k+1):
+ *    F(2k)   = F(k) (2 F(k+1) - F(k))
+ *    F(2k+1) = F(k)^2 + F(k+1)^2
+ * O(log n) multiplications of growing size
+ ***********************************************/
+BigInt fibonacciNumber(unsigned int n)
+{
+    BigInt a(0);
+    BigInt b(1);
+
+    int bit = 31;
+    while (bit >= 0 && !(n & (1u << bit)))
+        bit--;
+
+    for (; bit >= 0; bit--)
+    {
+        BigInt c = a * (b + b - a);
+        BigInt d = a * a + b * b;
+        if (n & (1u << bit))
+        {
+            a = d;
+            b = c + d;
+        }
+        else
+        {
+            a = c;
+            b = d;
+        }
+    }
+    return a;
+}
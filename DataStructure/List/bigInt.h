@@ -0,0 +1,72 @@
+/***********************************************************************
+ * Header:
+ *    BIG INT
+ * Summary:
+ *    An arbitrary-precision non-negative integer, big enough to hold
+ *    Fibonacci numbers with hundreds of thousands of digits. The value
+ *    is kept as base 1,000,000,000 limbs in a contiguous array, least
+ *    significant limb first, so every limb prints as exactly nine
+ *    decimal digits.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef big_int_h
+#define big_int_h
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*************************************************************************
+ * BIG INT
+ * Supports what the Fibonacci code needs: addition, subtraction of a
+ * smaller value, multiplication and decimal output. Multiplication is
+ * schoolbook for small operands and Karatsuba for large ones.
+ ************************************************************************/
+class BigInt
+{
+public:
+    typedef unsigned int Limb;
+    static const Limb BASE = 1000000000;   // one limb holds nine digits
+    static const int  DIGITS = 9;
+
+    // constructors
+    BigInt() {}
+    BigInt(unsigned long long value);
+
+    // arithmetic. Subtraction requires *this >= rhs
+    BigInt & operator += (const BigInt & rhs);
+    BigInt & operator -= (const BigInt & rhs) throw (const char *);
+    BigInt operator + (const BigInt & rhs) const;
+    BigInt operator - (const BigInt & rhs) const throw (const char *);
+    BigInt operator * (const BigInt & rhs) const;
+
+    // comparison
+    bool operator == (const BigInt & rhs) const { return limbs == rhs.limbs; }
+    bool operator != (const BigInt & rhs) const { return limbs != rhs.limbs; }
+    bool operator <  (const BigInt & rhs) const;
+
+    // the raw limbs, least significant first. Zero has no limbs
+    bool isZero()   const { return limbs.empty(); }
+    int  numLimbs() const { return (int)limbs.size(); }
+    const std::vector <Limb> & getLimbs() const { return limbs; }
+
+    // decimal representation
+    int numDigits() const;
+    std::string toString() const;
+    friend std::ostream & operator << (std::ostream & out, const BigInt & rhs);
+
+    // write the decimal digits of n raw limbs into buffer, which needs
+    // room for 9 * n characters, and return how many were written.
+    // Very long numbers are formatted by several threads at once
+    static size_t format(const Limb * limbs, size_t n, char * buffer);
+
+private:
+    std::vector <Limb> limbs;
+};
+
+// the nth Fibonacci number, F(1) = F(2) = 1, using fast doubling
+BigInt fibonacciNumber(unsigned int n);
+
+#endif // big_int_h
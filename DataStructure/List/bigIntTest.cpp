@@ -0,0 +1,224 @@
+/***********************************************************************
+ * Program:
+ *    BIG INT TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks BigInt products against a plain limb-by-limb product at
+ *    sizes either side of the Karatsuba cutoff and lopsided ones, with
+ *    random limbs and with every limb 999,999,999 so carries run the
+ *    whole length. Also addition and subtraction carrying and borrowing
+ *    across limbs, the decimal output, and fast-doubling F(n) against
+ *    adding up the sequence one term at a time. Exits 1 on the first
+ *    failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT
+#include <random>          // for MT19937
+#include <string>
+#include <vector>
+#include "bigInt.h"
+#include "fibonacci.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+typedef BigInt::Limb Limb;
+typedef unsigned long long Wide;
+
+/**********************************************************************
+ * FROM LIMBS
+ * The BigInt with these limbs, least significant first, built with
+ * nothing but multiplying by one limb and adding
+ ***********************************************************************/
+BigInt fromLimbs(const vector <Limb> & limbs)
+{
+   BigInt value(0);
+   for (int i = limbs.size() - 1; i >= 0; i--)
+      value = value * BigInt(BigInt::BASE) + BigInt(limbs[i]);
+   return value;
+}
+
+/**********************************************************************
+ * PRODUCT
+ * The product the slow way, to check the fast one against
+ ***********************************************************************/
+vector <Limb> product(const vector <Limb> & a, const vector <Limb> & b)
+{
+   vector <Wide> sums(a.size() + b.size() + 1, 0);
+   for (int i = 0; i < a.size(); i++)
+      for (int j = 0; j < b.size(); j++)
+      {
+         Wide cur = sums[i + j] + (Wide)a[i] * b[j];
+         sums[i + j] = cur % BigInt::BASE;
+         sums[i + j + 1] += cur / BigInt::BASE;
+      }
+   vector <Limb> limbs;
+   Wide carry = 0;
+   for (int i = 0; i < sums.size(); i++)
+   {
+      Wide cur = sums[i] + carry;
+      limbs.push_back((Limb)(cur % BigInt::BASE));
+      carry = cur / BigInt::BASE;
+   }
+   while (!limbs.empty() && limbs.back() == 0)
+      limbs.pop_back();
+   return limbs;
+}
+
+/**********************************************************************
+ * RANDOM LIMBS and NINES
+ * n random limbs, or n of the largest limb, with a non-zero top
+ ***********************************************************************/
+vector <Limb> randomLimbs(int n, mt19937 & random)
+{
+   vector <Limb> limbs(n);
+   for (int i = 0; i < n; i++)
+      limbs[i] = random() % BigInt::BASE;
+   if (n > 0 && limbs[n - 1] == 0)
+      limbs[n - 1] = 1;
+   return limbs;
+}
+
+vector <Limb> nines(int n)
+{
+   return vector <Limb> (n, BigInt::BASE - 1);
+}
+
+/**********************************************************************
+ * MULTIPLY
+ * Each side of the cutoff of 40 limbs, at twice it where Karatsuba
+ * recurses into both methods, and lopsided so the long side is cut
+ ***********************************************************************/
+void multiply()
+{
+   mt19937 random(30);
+   const int sizes[] = { 1, 2, 3, 39, 40, 41, 79, 80, 81, 161, 300 };
+   const int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+   for (int i = 0; i < numSizes; i++)
+      for (int j = 0; j < numSizes; j++)
+      {
+         vector <Limb> a = randomLimbs(sizes[i], random);
+         vector <Limb> b = randomLimbs(sizes[j], random);
+         BigInt x = fromLimbs(a);
+         BigInt y = fromLimbs(b);
+         CHECK(x.getLimbs() == a);
+         CHECK((x * y).getLimbs() == product(a, b));
+         CHECK((y * x).getLimbs() == product(a, b));
+         CHECK((fromLimbs(nines(sizes[i])) * fromLimbs(nines(sizes[j])))
+                  .getLimbs() == product(nines(sizes[i]), nines(sizes[j])));
+      }
+
+   // zero, and limbs of zero in the middle of a Karatsuba half
+   vector <Limb> holes = randomLimbs(100, random);
+   for (int i = 20; i < 70; i++)
+      holes[i] = 0;
+   BigInt x = fromLimbs(holes);
+   CHECK((x * BigInt(0)).isZero());
+   CHECK((BigInt(0) * x).isZero());
+   CHECK((x * x).getLimbs() == product(holes, holes));
+}
+
+/**********************************************************************
+ * POWER OF TEN
+ * 10^digits, by squaring
+ ***********************************************************************/
+BigInt powerOfTen(int digits)
+{
+   BigInt result(1);
+   BigInt square(10);
+   for (; digits; digits /= 2, square = square * square)
+      if (digits % 2)
+         result = result * square;
+   return result;
+}
+
+/**********************************************************************
+ * CARRIES
+ * 10^9k - 1 is k limbs of 999,999,999: adding one carries through all
+ * of them, taking one borrows back, and its square has a known shape
+ ***********************************************************************/
+void carries()
+{
+   const int ks[] = { 1, 2, 39, 40, 41, 100, 1000 };
+   for (int i = 0; i < sizeof(ks) / sizeof(ks[0]); i++)
+   {
+      int k = ks[i];
+      BigInt one(1);
+      BigInt power = powerOfTen(9 * k);
+      BigInt all = power - one;
+      CHECK(all.getLimbs() == nines(k));
+      CHECK(all + one == power);
+      CHECK(power.numLimbs() == k + 1);
+      CHECK(all < power);
+      CHECK(!(power < all));
+
+      // (10^d - 1)^2 = 10^2d - 2 10^d + 1: 9s, an 8, 0s and a 1
+      int d = 9 * k;
+      string square = (all * all).toString();
+      CHECK(square == string(d - 1, '9') + "8" + string(d - 1, '0') + "1");
+      CHECK(all.toString() == string(d, '9'));
+      CHECK(all.numDigits() == d);
+      CHECK(power.toString() == "1" + string(d, '0'));
+   }
+
+   // a limb that is small has its leading zeros written out below the top
+   BigInt x = BigInt(7) * BigInt(BigInt::BASE) + BigInt(42);
+   CHECK(x.toString() == "7000000042");
+   CHECK(BigInt(0).toString() == "0");
+   CHECK(BigInt(18446744073709551615ULL).toString() == "18446744073709551615");
+
+   bool threw = false;
+   try
+   {
+      BigInt(1) - BigInt(2);
+   }
+   catch (const char * error)
+   {
+      threw = true;
+   }
+   CHECK(threw);
+}
+
+/**********************************************************************
+ * FIBONACCI NUMBERS
+ * Fast doubling against the sequence added up term by term, and a few
+ * values known in full
+ ***********************************************************************/
+void fibonacciNumbers()
+{
+   CHECK(fibonacciNumber(0).isZero());
+   FibonacciSequence sequence;
+   for (unsigned int n = 1; n <= 3000; n++, sequence.next())
+      CHECK(fibonacciNumber(n).getLimbs() == sequence.value());
+
+   CHECK(fibonacciNumber(10).toString() == "55");
+   CHECK(fibonacciNumber(93).toString() == "12200160415121876738");
+   CHECK(fibonacciNumber(100).toString() == "354224848179261915075");
+
+   // F(1,000,000) has 208,988 digits, and F(a + b) = F(a) F(b + 1) +
+   // F(a - 1) F(b) ties it to smaller ones
+   BigInt big = fibonacciNumber(1000000);
+   CHECK(big.numDigits() == 208988);
+   CHECK(big.toString().size() == 208988);
+   CHECK(big == fibonacciNumber(600000) * fibonacciNumber(400001) +
+                fibonacciNumber(599999) * fibonacciNumber(400000));
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   multiply();
+   carries();
+   fibonacciNumbers();
+   cout << "BigInt tests passed\n";
+   return 0;
+}
@@ -11,6 +11,7 @@
 #include <iostream>
 #include "fibonacci.h"   // for fibonacci() prototype
 #include "list.h"        // for LIST
+#include "bigInt.h"      // for BIGINT and fibonacciNumber()
 using namespace std;
 
 
@@ -26,13 +27,93 @@ void fibonacci()
    cout << "How many Fibonacci numbers would you like to see? ";
    cin  >> number;
 
-   // your code to display the first <number> Fibonacci numbers
+   // display the first <number> Fibonacci numbers
+   {
+      FibonacciSequence sequence;
+      DecimalWriter writer(cout);
+      for (int i = 0; i < number; i++, sequence.next())
+      {
+         writer.put('\t');
+         writer.write(sequence.value());
+         writer.put('\n');
+      }
+   }
 
    // prompt for a single large Fibonacci
    cout << "Which Fibonacci number would you like to display? ";
    cin  >> number;
 
-   // your code to display the <number>th Fibonacci number
+   // display the <number>th Fibonacci number
+   if (number > 0)
+      cout << '\t' << fibonacciNumber(number) << endl;
 }
 
+/************************************************
+ * FIBONACCI SEQUENCE :: NEXT
+ * previous += current, then swap the buffers so
+ * current holds the sum. Since previous is never
+ * longer than current, this is one pass with a
+ * carry and, at most, one new limb
+ ***********************************************/
+void FibonacciSequence :: next()
+{
+   size_t n = current.size();
+   previous.resize(n, 0);
+
+   BigInt::Limb carry = 0;
+   for (size_t i = 0; i < n; i++)
+   {
+      BigInt::Limb sum = previous[i] + current[i] + carry;
+      carry = (sum >= BigInt::BASE);
+      previous[i] = carry ? sum - BigInt::BASE : sum;
+   }
+   if (carry)
+      previous.push_back(carry);
 
+   previous.swap(current);
+}
+
+/************************************************
+ * DECIMAL WRITER : CONSTRUCTOR and DESTRUCTOR
+ ***********************************************/
+DecimalWriter :: DecimalWriter(ostream & out, size_t capacity) :
+   out(out), buffer(new char[capacity]), capacity(capacity), used(0)
+{
+}
+
+DecimalWriter :: ~DecimalWriter()
+{
+   flush();
+   delete [] buffer;
+}
+
+/************************************************
+ * DECIMAL WRITER :: WRITE
+ * Format a number directly into the buffer. One
+ * too big for the buffer gets a buffer of its own
+ ***********************************************/
+void DecimalWriter :: write(const vector <BigInt::Limb> & limbs)
+{
+   size_t needed = BigInt::DIGITS * (limbs.size() + 1);
+   if (used + needed > capacity)
+      flush();
+
+   if (needed > capacity)
+   {
+      vector <char> text(needed);
+      out.write(&text[0], BigInt::format(limbs.data(), limbs.size(), &text[0]));
+      return;
+   }
+
+   used += BigInt::format(limbs.data(), limbs.size(), buffer + used);
+}
+
+/************************************************
+ * DECIMAL WRITER :: FLUSH
+ ***********************************************/
+void DecimalWriter :: flush()
+{
+   if (used)
+      out.write(buffer, used);
+   used = 0;
+}
@@ -11,8 +11,65 @@
 #ifndef FIBONACCI_H
 #define FIBONACCI_H
 
+#include <iostream>
+#include <vector>
+#include "bigInt.h"
+
 // the interactive fibonacci program
 void fibonacci();
 
+/*************************************************************************
+ * FIBONACCI SEQUENCE
+ * Generates F(1), F(2), F(3), ... one term at a time. Only two limb
+ * buffers are ever used: the next term is added in place on top of the
+ * older one and the two swap roles, so once the buffers have grown no
+ * term costs an allocation.
+ ************************************************************************/
+class FibonacciSequence
+{
+public:
+    FibonacciSequence() : current(1, 1) {}
+
+    // the current term, least significant limb first
+    const std::vector <BigInt::Limb> & value() const { return current; }
+
+    // advance to the following term
+    void next();
+
+private:
+    std::vector <BigInt::Limb> previous;
+    std::vector <BigInt::Limb> current;
+};
+
+/*************************************************************************
+ * DECIMAL WRITER
+ * Collects output in one large buffer and hands it to the stream in
+ * big blocks. Numbers are formatted straight into the buffer.
+ ************************************************************************/
+class DecimalWriter
+{
+public:
+    DecimalWriter(std::ostream & out, size_t capacity = 1 << 20);
+    ~DecimalWriter();
+
+    void put(char c)
+    {
+        if (used == capacity)
+            flush();
+        buffer[used++] = c;
+    }
+    void write(const std::vector <BigInt::Limb> & limbs);
+    void flush();
+
+private:
+    DecimalWriter(const DecimalWriter & rhs);
+    DecimalWriter & operator = (const DecimalWriter & rhs);
+
+    std::ostream & out;
+    char * buffer;
+    size_t capacity;
+    size_t used;
+};
+
 #endif // FIBONACCI_H
 
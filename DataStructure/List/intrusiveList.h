@@ -0,0 +1,207 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE LIST
+ * Summary:
+ *    A doubly linked list that links objects the caller already owns.
+ *    Each element carries its own ListHook, so linking and unlinking
+ *    never allocates or copies. An object can sit on several lists at
+ *    once by inheriting one hook per list, each with its own tag:
+ *
+ *       struct ByName {};
+ *       struct ByAge  {};
+ *       class Person : public ListHook <ByName>, public ListHook <ByAge>
+ *       IntrusiveList <Person, ByName> names;
+ *       IntrusiveList <Person, ByAge>  ages;
+ *
+ *    The list never owns its elements. An element unlinks itself when
+ *    it is destroyed, so size() counts by walking the list.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef intrusive_list_h
+#define intrusive_list_h
+
+#include <cassert>
+#include <cstddef>     // for NULL
+
+/*************************************************************************
+ * LIST HOOK
+ * The links an element embeds to join an IntrusiveList. An unlinked
+ * hook points at itself, which is also how the list's sentinel looks
+ * when the list is empty.
+ ************************************************************************/
+template <class Tag = void>
+class ListHook
+{
+public:
+    ListHook() : pNext(this), pPrev(this) {}
+
+    // copying an element does not copy its place on a list
+    ListHook(const ListHook & rhs) : pNext(this), pPrev(this) {}
+    ListHook & operator = (const ListHook & rhs) { return *this; }
+
+    ~ListHook() { unlink(); }
+
+    bool isLinked() const { return pNext != this; }
+
+    // take this element off whatever list it is on in O(1)
+    void unlink()
+    {
+        pPrev->pNext = pNext;
+        pNext->pPrev = pPrev;
+        pNext = pPrev = this;
+    }
+
+    // put this element directly in front of pPos
+    void linkBefore(ListHook * pPos)
+    {
+        assert(!isLinked());
+        pNext = pPos;
+        pPrev = pPos->pPrev;
+        pPrev->pNext = this;
+        pPos->pPrev = this;
+    }
+
+    ListHook * pNext;
+    ListHook * pPrev;
+};
+
+/*************************************************************************
+ * INTRUSIVE LIST
+ * T must inherit from ListHook <Tag>. The list is a ring threaded
+ * through a sentinel hook, so there are no NULL checks at the ends.
+ ************************************************************************/
+template <class T, class Tag = void>
+class IntrusiveList
+{
+public:
+    typedef ListHook <Tag> Hook;
+
+    IntrusiveList() {}
+    ~IntrusiveList() { clear(); }
+
+    // standard container interfaces
+    bool empty() const { return !head.isLinked(); }
+    int  size() const
+    {
+        int num = 0;
+        for (const Hook * p = head.pNext; p != &head; p = p->pNext)
+            num++;
+        return num;
+    }
+
+    // unlink every element, leaving the elements themselves alone
+    void clear()
+    {
+        while (!empty())
+            head.pNext->unlink();
+    }
+
+    // the ListIterator interfaces
+    class ListIterator;
+    ListIterator begin() { return ListIterator(head.pNext); }
+    ListIterator end()   { return ListIterator(&head);      }
+
+    // pushes and pops
+    void push_back(T & item)  { hook(item)->linkBefore(&head);       }
+    void push_front(T & item) { hook(item)->linkBefore(head.pNext);  }
+    void pop_back()  throw (const char *) { remove(back());  }
+    void pop_front() throw (const char *) { remove(front()); }
+
+    // the first and last element on the list
+    T & front() throw (const char *)
+    {
+        if (empty())
+            throw "ERROR: unable to access data from an empty List";
+        return *element(head.pNext);
+    }
+    T & back() throw (const char *)
+    {
+        if (empty())
+            throw "ERROR: unable to access data from an empty List";
+        return *element(head.pPrev);
+    }
+
+    // link item in front of it, leaving it on the new element
+    void insert(ListIterator & it, T & item)
+    {
+        hook(item)->linkBefore(it.p);
+        it = ListIterator(hook(item));
+    }
+
+    // unlink the element at it, leaving it on the one that followed
+    void erase(ListIterator & it) throw (const char *)
+    {
+        if (it == end())
+            throw "ERROR: unable to remove from an invalid location in a List";
+        Hook * pNext = it.p->pNext;
+        it.p->unlink();
+        it = ListIterator(pNext);
+    }
+
+    // unlink an element directly, no searching required
+    static void remove(T & item) { hook(item)->unlink(); }
+
+private:
+    // an intrusive list cannot be copied: the elements are not ours
+    IntrusiveList(const IntrusiveList & rhs);
+    IntrusiveList & operator = (const IntrusiveList & rhs);
+
+    static Hook * hook(T & item)       { return static_cast <Hook *> (&item); }
+    static T *    element(Hook * p)    { return static_cast <T *> (p);       }
+
+    Hook head;
+};
+
+/**************************************************
+ * IntrusiveList ListIterator
+ * An iterator through the list, walking the hooks
+ *************************************************/
+template <class T, class Tag>
+class IntrusiveList <T, Tag> :: ListIterator
+{
+    friend class IntrusiveList <T, Tag>;
+public:
+    ListIterator() : p(NULL) {}
+    ListIterator(Hook * p) : p(p) {}
+
+    // equals, not equals operator
+    bool operator == (const ListIterator & it) const { return it.p == p; }
+    bool operator != (const ListIterator & it) const { return it.p != p; }
+
+    // prefix increment and decrement
+    ListIterator & operator ++ ()
+    {
+        p = p->pNext;
+        return *this;
+    }
+    ListIterator & operator -- ()
+    {
+        p = p->pPrev;
+        return *this;
+    }
+
+    // postfix increment and decrement
+    ListIterator operator ++ (int postfix)
+    {
+        ListIterator tmp(*this);
+        p = p->pNext;
+        return tmp;
+    }
+    ListIterator operator -- (int postfix)
+    {
+        ListIterator tmp(*this);
+        p = p->pPrev;
+        return tmp;
+    }
+
+    // dereference operator
+    T & operator * () { return *static_cast <T *> (p); }
+    T * operator -> () { return static_cast <T *> (p); }
+
+private:
+    Hook * p;
+};
+
+#endif /* intrusive_list_h */
@@ -0,0 +1,256 @@
+/***********************************************************************
+ * Program:
+ *    INTRUSIVE LIST TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Links a fixed set of objects onto two IntrusiveLists at once, one
+ *    per tag, with random pushes, inserts, erases and removes, and
+ *    checks each list against a std::list of pointers after each step.
+ *    Also checks that an element unlinks itself when destroyed and that
+ *    a copy does not take its original's place. Exits 1 on the first
+ *    failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for FIND
+#include <cstdlib>         // for EXIT
+#include <list>
+#include <random>          // for MT19937
+#include <string>
+#include "intrusiveList.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+struct ByName {};
+struct ByAge  {};
+
+/**********************************************************************
+ * PERSON
+ * Something that can be on a list by name and a list by age at once
+ ***********************************************************************/
+struct Person : public ListHook <ByName>, public ListHook <ByAge>
+{
+   Person() : age(0) {}
+   Person(const string & name, int age) : name(name), age(age) {}
+   string name;
+   int age;
+};
+
+typedef IntrusiveList <Person, ByName> Names;
+typedef IntrusiveList <Person, ByAge>  Ages;
+
+/**********************************************************************
+ * SAME
+ * The list holds exactly the expected objects, in order, either way
+ ***********************************************************************/
+template <class Tag>
+void same(IntrusiveList <Person, Tag> & people, const list <Person *> & expected)
+{
+   CHECK(people.size() == expected.size());
+   CHECK(people.empty() == expected.empty());
+
+   list <Person *> :: const_iterator e = expected.begin();
+   typename IntrusiveList <Person, Tag> :: ListIterator it;
+   for (it = people.begin(); it != people.end(); ++it, ++e)
+      CHECK(&*it == *e);
+   CHECK(e == expected.end());
+
+   list <Person *> :: const_reverse_iterator r = expected.rbegin();
+   it = people.end();
+   for (; r != expected.rend(); ++r)
+      CHECK(&*--it == *r);
+   CHECK(it == people.begin());
+
+   if (!expected.empty())
+   {
+      CHECK(&people.front() == expected.front());
+      CHECK(&people.back() == expected.back());
+   }
+}
+
+/**********************************************************************
+ * STEP
+ * One random change to one of the lists, mirrored in its std::list
+ ***********************************************************************/
+template <class Tag>
+void step(IntrusiveList <Person, Tag> & people, list <Person *> & expected,
+          Person * everyone, int numPeople, mt19937 & random)
+{
+   typedef ListHook <Tag> Hook;
+   Person * p = everyone + random() % numPeople;
+   bool linked = static_cast <Hook *> (p)->isLinked();
+   int choice = random() % 6;
+
+   if (choice == 0 && !linked)
+   {
+      people.push_back(*p);
+      expected.push_back(p);
+   }
+   else if (choice == 1 && !linked)
+   {
+      people.push_front(*p);
+      expected.push_front(p);
+   }
+   else if (choice == 2 && !linked)
+   {
+      // insert in front of a random position, sometimes end()
+      int at = random() % (expected.size() + 1);
+      typename IntrusiveList <Person, Tag> :: ListIterator it = people.begin();
+      list <Person *> :: iterator e = expected.begin();
+      for (int i = 0; i < at; i++, ++it, ++e)
+         ;
+      people.insert(it, *p);
+      expected.insert(e, p);
+      CHECK(&*it == p);
+   }
+   else if (choice == 3 && !expected.empty())
+   {
+      int at = random() % expected.size();
+      typename IntrusiveList <Person, Tag> :: ListIterator it = people.begin();
+      list <Person *> :: iterator e = expected.begin();
+      for (int i = 0; i < at; i++, ++it, ++e)
+         ;
+      people.erase(it);
+      e = expected.erase(e);
+      CHECK((it == people.end()) == (e == expected.end()));
+      if (e != expected.end())
+         CHECK(&*it == *e);
+   }
+   else if (choice == 4 && linked)
+   {
+      // straight off the list, wherever it is
+      IntrusiveList <Person, Tag> :: remove(*p);
+      expected.remove(p);
+   }
+   else if (choice == 5 && !expected.empty())
+   {
+      if (random() % 2)
+      {
+         people.pop_front();
+         expected.pop_front();
+      }
+      else
+      {
+         people.pop_back();
+         expected.pop_back();
+      }
+   }
+   CHECK(static_cast <Hook *> (p)->isLinked() ==
+         (find(expected.begin(), expected.end(), p) != expected.end()));
+}
+
+/**********************************************************************
+ * FUZZ
+ * Both lists thread through the same objects. Changing one must never
+ * disturb the other
+ ***********************************************************************/
+void fuzz(int steps, unsigned seed)
+{
+   const int NUM = 40;
+   Person everyone[NUM];
+   for (int i = 0; i < NUM; i++)
+   {
+      everyone[i].name = string(1, 'a' + i % 26) + to_string(i);
+      everyone[i].age = i;
+   }
+
+   mt19937 random(seed);
+   Names names;
+   Ages ages;
+   list <Person *> expectedNames;
+   list <Person *> expectedAges;
+   for (int i = 0; i < steps; i++)
+   {
+      if (random() % 2)
+         step(names, expectedNames, everyone, NUM, random);
+      else
+         step(ages, expectedAges, everyone, NUM, random);
+      same(names, expectedNames);
+      same(ages, expectedAges);
+   }
+
+   names.clear();
+   expectedNames.clear();
+   same(names, expectedNames);
+   same(ages, expectedAges);
+   for (int i = 0; i < NUM; i++)
+      CHECK(!static_cast <ListHook <ByName> *> (everyone + i)->isLinked());
+}
+
+/**********************************************************************
+ * LIFETIMES
+ * An element destroyed while on a list leaves it, and a copy of an
+ * element is not on any list
+ ***********************************************************************/
+void lifetimes()
+{
+   Names names;
+   Ages ages;
+   Person first("first", 1);
+   Person last("last", 3);
+   names.push_back(first);
+   ages.push_back(first);
+   {
+      Person middle("middle", 2);
+      names.push_back(middle);
+      ages.push_front(middle);
+      names.push_back(last);
+      CHECK(names.size() == 3);
+      CHECK(ages.size() == 2);
+
+      Person copy(middle);
+      CHECK(copy.name == "middle");
+      CHECK(!static_cast <ListHook <ByName> *> (&copy)->isLinked());
+      CHECK(!static_cast <ListHook <ByAge> *> (&copy)->isLinked());
+      copy = first;
+      CHECK(!static_cast <ListHook <ByName> *> (&copy)->isLinked());
+      CHECK(names.size() == 3);
+   }
+   CHECK(names.size() == 2);
+   CHECK(ages.size() == 1);
+   CHECK(&names.front() == &first && &names.back() == &last);
+   CHECK(&ages.front() == &first);
+
+   // a list going away leaves its elements alone, and unlinked
+   {
+      Ages more;
+      more.push_back(last);
+      CHECK(static_cast <ListHook <ByAge> *> (&last)->isLinked());
+   }
+   CHECK(!static_cast <ListHook <ByAge> *> (&last)->isLinked());
+   CHECK(names.size() == 2);
+
+   // popping past the end throws, and leaves the list empty
+   bool thrown = false;
+   try
+   {
+      names.pop_back();
+      names.pop_back();
+      names.pop_back();
+   }
+   catch (const char * error)
+   {
+      thrown = true;
+   }
+   CHECK(thrown);
+   CHECK(names.empty());
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   fuzz(20000, 1);
+   fuzz(20000, 2);
+   lifetimes();
+   cout << "IntrusiveList tests passed\n";
+   return 0;
+}
@@ -56,8 +56,16 @@ public:
     // pushes and pops
     void push_back(const T &data);
     void push_front(const T &data) throw(const char *);
-    void pop_back(){erase(pTail);}
-    void pop_front(){erase(pHead);}
+    void pop_back()
+    {
+        ListIterator it(pTail);
+        erase(it);
+    }
+    void pop_front()
+    {
+        ListIterator it(pHead);
+        erase(it);
+    }
     
     // data reference to first node in the List
     T &front() throw(const char *)
@@ -76,13 +84,19 @@ public:
             throw "ERROR: unable to access data from an empty List";
     }
     
-    // cleans up all data in the List
+    // cleans up all data in the List, handing the nodes back to the
+    // pool in batches rather than deleting them one at a time
     void freeData(Node<T> *&pHead)
     {
-        if (pHead == NULL)
-            return;
-        freeData(pHead->pNext);
-        delete pHead;
+        typename NodePool <sizeof(Node <T>)> :: Chain chain;
+        for (Node<T> *p = pHead; p; )
+        {
+            Node<T> *pNext = p->pNext;
+            p->~Node();
+            chain.add(p);
+            p = pNext;
+        }
+        chain.release();
         pHead = pTail = NULL;
         numElements = 0;
     }
@@ -91,7 +105,12 @@ public:
     void erase(ListIterator & it) throw (const char *);
     void insert(ListIterator & it, const T & data) throw (const char *);
     
+    // stable merge sort that relinks the nodes in place
+    void sort();
+    
 private:
+    static Node<T> *merge(Node<T> *pLeft, Node<T> *pRight);
+    
     Node<T> *pHead;
     Node<T> *pTail;
     int numElements;
@@ -151,10 +170,10 @@ void List<T> :: push_front(const T &data) throw(const char *)
         pNew->pNext = pHead;
         if (pHead != NULL)
             pHead->pPrev = pNew;
-            else
-                pTail = pNew;
-                pHead = pNew;
-                numElements++;
+        else
+            pTail = pNew;
+        pHead = pNew;
+        numElements++;
     }
     catch (...)
     {
@@ -164,57 +183,136 @@ void List<T> :: push_front(const T &data) throw(const char *)
 
 /*************************************************
  * List :: insert
- * Uses ListIterator to position insert of new node
+ * Uses ListIterator to position insert of new node.
+ * The new node goes in front of it, and it is left
+ * pointing at the new node
  ***********************************************/
 template <class T>
 void List<T> :: insert(ListIterator & it, const T & data) throw (const char *)
 {
+    if (it == end())
+    {
+        push_back(data);
+        it = ListIterator(pTail);
+        return;
+    }
+    
     try
     {
         Node <T> * pNew = new Node <T> (data);
-        if(it != NULL)
-        {
-            pNew->pNext = it;
-            pNew->pPrev = it->pPrev;
-            it->pPrev = pNew;
-            if(pNew->pPrev)
-                pNew->pPrev->pNext == pNew;
-                }
-        return pNew;
+        pNew->pNext = it.p;
+        pNew->pPrev = it.p->pPrev;
+        it.p->pPrev = pNew;
+        if (pNew->pPrev)
+            pNew->pPrev->pNext = pNew;
+        else
+            pHead = pNew;
+        numElements++;
+        it = ListIterator(pNew);
     }
     catch (...)
     {
         throw "ERROR: unable to allocate a new node for a List";
     }
-    
 }
 
 /*************************************************
  * List :: erase
- * Uses ListIterator to position insert of new node
+ * Removes the node at it and leaves it pointing
+ * at the node that followed
  ***********************************************/
 template <class T>
 void List<T> :: erase(ListIterator & it) throw (const char *)
 {
-    if (empty())
-        return;
+    if (it == end())
+        throw "ERROR: unable to remove from an invalid location in a List";
+    
+    Node <T> * p = it.p;
+    if (p->pNext)
+        p->pNext->pPrev = p->pPrev;
+    else
+        pTail = p->pPrev;
+    if (p->pPrev)
+        p->pPrev->pNext = p->pNext;
+    else
+        pHead = p->pNext;
+    
+    it = ListIterator(p->pNext);
+    delete p;
+    numElements--;
+}
+
+/*************************************************
+ * List :: merge
+ * Merges two sorted runs linked through pNext.
+ * Ties go to pLeft so that the sort is stable
+ ***********************************************/
+template <class T>
+Node<T> * List<T> :: merge(Node<T> *pLeft, Node<T> *pRight)
+{
+    Node<T> *pHead = NULL;
+    Node<T> **ppTail = &pHead;
     
-    try
+    while (pLeft && pRight)
     {
-        Node <T> * p;
-        p = pHead;
-        if(p->data == *it)
-            delete p;
+        if (pRight->data < pLeft->data)
+        {
+            *ppTail = pRight;
+            pRight = pRight->pNext;
+        }
         else
-            p = p->pNext;
-            
-            numElements--;
+        {
+            *ppTail = pLeft;
+            pLeft = pLeft->pNext;
+        }
+        ppTail = &(*ppTail)->pNext;
     }
-    catch (...)
+    *ppTail = pLeft ? pLeft : pRight;
+    return pHead;
+}
+
+/*************************************************
+ * List :: sort
+ * Bottom-up merge sort on the pNext links, where
+ * bins[i] holds a sorted run of 2^i nodes. The
+ * pPrev links and pTail are rebuilt in one final
+ * pass. O(n log n), stable, allocates nothing
+ ***********************************************/
+template <class T>
+void List<T> :: sort()
+{
+    Node<T> *bins[64] = { NULL };
+    int numBins = 0;
+    
+    while (pHead)
     {
-        throw "ERROR: unable to allocate a new node for a List";
+        Node<T> *pRun = pHead;
+        pHead = pHead->pNext;
+        pRun->pNext = NULL;
+        
+        int i = 0;
+        for (; i < numBins && bins[i]; i++)
+        {
+            pRun = merge(bins[i], pRun);
+            bins[i] = NULL;
+        }
+        if (i == numBins)
+            numBins++;
+        bins[i] = pRun;
     }
     
+    // the higher bins hold the earlier items
+    for (int i = 0; i < numBins; i++)
+        if (bins[i])
+            pHead = merge(bins[i], pHead);
+    
+    // put the back links together again
+    pTail = NULL;
+    for (Node<T> *p = pHead; p; p = p->pNext)
+    {
+        p->pPrev = pTail;
+        pTail = p;
+    }
 }
 
 /**************************************************
@@ -224,6 +322,7 @@ void List<T> :: erase(ListIterator & it) throw (const char *)
 template <class T>
 class List <T> :: ListIterator
 {
+    friend class List <T>;
 public:
     //constructors
     ListIterator() : p(NULL){};
@@ -296,7 +395,7 @@ private:
  * An ListIterator through List backwards
  *************************************************/
 template <class T>
-class reverse_ListIterator
+class List <T> :: reverse_ListIterator
 {
 public:
     // default constructor
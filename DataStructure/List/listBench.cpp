@@ -0,0 +1,500 @@
+/***********************************************************************
+ * Program:
+ *    LIST BENCH
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    The benchmarks behind the numbers quoted for the lists, so they
+ *    can be run again. Each one is a mode:
+ *       listBench pool [n]        calls to operator new and time per
+ *                                 node while building and clearing a
+ *                                 list of n, std::list against List on
+ *                                 the pool, on one thread and with the
+ *                                 clearing done on another
+ *       listBench iterate [n]     time per element to walk lists of 1M
+ *                                 ints up to n, List against
+ *                                 UnrolledList
+ *       listBench intrusive [n]   moving records picked at random to
+ *                                 the back of the two lists each is
+ *                                 on, n records: List of copies, List
+ *                                 of pointers and IntrusiveList
+ *       listBench sort [n]        sorting random, sorted and reverse
+ *                                 lists of 1M ints up to n, List::sort
+ *                                 against std::list::sort, and sorted
+ *                                 again on nodes the pool has reused
+ *       listBench fibonacci [n]   F(1000) up to F(n) by fast doubling,
+ *                                 against adding up the sequence with
+ *                                 BigInt + and with FibonacciSequence,
+ *                                 and the time to print it
+ *    Times depend on the machine; compare modes on one machine only.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for SORT and REVERSE
+#include <atomic>
+#include <chrono>          // for STEADY_CLOCK
+#include <cstdlib>         // for ATOI and MALLOC
+#include <cstring>         // for STRCMP
+#include <iomanip>         // for SETW
+#include <list>
+#include <new>             // for BAD_ALLOC
+#include <random>          // for MT19937
+#include <string>
+#include <thread>
+#include <vector>
+#include "list.h"
+#include "unrolledList.h"
+#include "intrusiveList.h"
+#include "bigInt.h"
+#include "fibonacci.h"
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/**********************************************************************
+ * OPERATOR NEW and OPERATOR DELETE
+ * Every trip to the general heap is counted
+ ***********************************************************************/
+atomic <long> numNews(0);
+
+void * operator new(size_t size)
+{
+   numNews++;
+   void * p = malloc(size ? size : 1);
+   if (p == NULL)
+      throw bad_alloc();
+   return p;
+}
+
+void operator delete(void * p) noexcept
+{
+   free(p);
+}
+
+/**********************************************************************
+ * NANOSECONDS SINCE
+ ***********************************************************************/
+double nanosecondsSince(Clock::time_point start)
+{
+   return chrono::duration <double, nano> (Clock::now() - start).count();
+}
+
+/**********************************************************************
+ * REPORT
+ * One line: operator new calls while building, then the time per
+ * node for each step
+ ***********************************************************************/
+void report(const string & name, long news, double build, double clear)
+{
+   cout << setw(28) << left << name << right
+        << setw(12) << news
+        << setw(10) << fixed << setprecision(1) << build << "ns"
+        << setw(10) << clear << "ns\n";
+}
+
+/**********************************************************************
+ * BUILD AND CLEAR
+ * n push_backs, then one clear, rounds times over on one thread
+ ***********************************************************************/
+template <class L>
+void buildAndClear(const string & name, int n, int rounds)
+{
+   long news = 0;
+   double build = 0.0;
+   double clear = 0.0;
+   for (int round = 0; round < rounds; round++)
+   {
+      L * pList = new L;
+      long before = numNews;
+      Clock::time_point start = Clock::now();
+      for (int i = 0; i < n; i++)
+         pList->push_back(i);
+      build += nanosecondsSince(start);
+      news += numNews - before;
+      start = Clock::now();
+      pList->clear();
+      clear += nanosecondsSince(start);
+      delete pList;
+   }
+   report(name, news, build / rounds / n, clear / rounds / n);
+}
+
+/**********************************************************************
+ * HANDED ACROSS
+ * One thread builds each list and another clears it, so every node
+ * is freed on a thread that did not allocate it
+ ***********************************************************************/
+template <class L>
+void handedAcross(const string & name, int n, int rounds)
+{
+   long news = 0;
+   double build = 0.0;
+   double clear = 0.0;
+   for (int round = 0; round < rounds; round++)
+   {
+      L * pList = new L;
+      long before = numNews;
+      Clock::time_point start = Clock::now();
+      for (int i = 0; i < n; i++)
+         pList->push_back(i);
+      build += nanosecondsSince(start);
+      news += numNews - before;
+      thread consumer([&]()
+      {
+         Clock::time_point start = Clock::now();
+         pList->clear();
+         clear += nanosecondsSince(start);
+      });
+      consumer.join();
+      delete pList;
+   }
+   report(name, news, build / rounds / n, clear / rounds / n);
+}
+
+/**********************************************************************
+ * POOL
+ * How many trips to the heap n nodes take, and what each costs
+ ***********************************************************************/
+void pool(int n)
+{
+   const int ROUNDS = 5;
+   cout << "building and clearing " << n << " ints, " << ROUNDS
+        << " rounds\n"
+        << setw(28) << left << "" << right << setw(12) << "new calls"
+        << setw(12) << "build" << setw(12) << "clear" << endl;
+   buildAndClear <std::list <int> > ("std::list, one thread", n, ROUNDS);
+   buildAndClear <List <int> > ("List on pool, one thread", n, ROUNDS);
+   handedAcross <std::list <int> > ("std::list, two threads", n, ROUNDS);
+   handedAcross <List <int> > ("List on pool, two threads", n, ROUNDS);
+}
+
+/**********************************************************************
+ * SUM
+ * One walk over the list, front to back
+ ***********************************************************************/
+template <class L>
+long long sum(L & list)
+{
+   long long total = 0;
+   for (typename L::ListIterator it = list.begin(); it != list.end(); ++it)
+      total += *it;
+   return total;
+}
+
+/**********************************************************************
+ * TIME WALKS
+ * The best of a few walks over a list of n, in nanoseconds per
+ * element
+ ***********************************************************************/
+template <class L>
+void timeWalks(const string & name, int n)
+{
+   L * pList = new L;
+   for (int i = 0; i < n; i++)
+      pList->push_back(i);
+
+   double best = 0.0;
+   long long total = 0;
+   for (int walk = 0; walk < 3; walk++)
+   {
+      Clock::time_point start = Clock::now();
+      total = sum(*pList);
+      double ns = nanosecondsSince(start) / n;
+      if (walk == 0 || ns < best)
+         best = ns;
+   }
+   delete pList;
+   if (total != (long long)n * (n - 1) / 2)
+      cerr << name << ": wrong sum\n";
+
+   cout << setw(12) << n << setw(16) << name
+        << setw(10) << fixed << setprecision(2) << best << "ns\n";
+}
+
+/**********************************************************************
+ * ITERATE
+ * Walks over lists of 1M ints, then ten times as many, up to n. Both
+ * are built by push_back on a fresh pool, so List's nodes sit in
+ * memory in list order, its best case
+ ***********************************************************************/
+void iterate(int n)
+{
+   cout << "walking a list of ints, best of 3\n"
+        << setw(12) << "elements" << setw(16) << "" << setw(12) << "per item\n";
+   for (long long size = 1000000; size <= n; size *= 10)
+   {
+      timeWalks <List <int> > ("List", size);
+      timeWalks <UnrolledList <int> > ("UnrolledList", size);
+   }
+}
+
+/**********************************************************************
+ * RECORD
+ * Something that sits on a queue and on its owner's list at once
+ ***********************************************************************/
+struct ByQueue {};
+struct ByOwner {};
+
+struct Record : public ListHook <ByQueue>, public ListHook <ByOwner>
+{
+   int id;
+   char payload[60];
+};
+
+/**********************************************************************
+ * PICKS
+ * Which record each move takes, the same for every kind of list
+ ***********************************************************************/
+vector <int> picks(int n, int numMoves)
+{
+   mt19937 random(26);
+   vector <int> picked(numMoves);
+   for (int i = 0; i < numMoves; i++)
+      picked[i] = random() % n;
+   return picked;
+}
+
+/**********************************************************************
+ * MOVE COPIES
+ * Each List holds copies of the records, found again through an
+ * iterator kept per record. A move erases both copies and puts new
+ * ones at the back
+ ***********************************************************************/
+template <class E>
+double moveOnList(vector <Record> & records, const vector <int> & picked,
+                  E (*entry)(Record &))
+{
+   typedef typename List <E> :: ListIterator Iterator;
+   List <E> queue;
+   List <E> owner;
+   vector <Iterator> inQueue(records.size());
+   vector <Iterator> inOwner(records.size());
+   for (int i = 0; i < records.size(); i++)
+   {
+      inQueue[i] = queue.end();
+      queue.insert(inQueue[i], entry(records[i]));
+      inOwner[i] = owner.end();
+      owner.insert(inOwner[i], entry(records[i]));
+   }
+
+   Clock::time_point start = Clock::now();
+   for (int i = 0; i < picked.size(); i++)
+   {
+      int id = picked[i];
+      Iterator it = inQueue[id];
+      queue.erase(it);
+      inQueue[id] = queue.end();
+      queue.insert(inQueue[id], entry(records[id]));
+      it = inOwner[id];
+      owner.erase(it);
+      inOwner[id] = owner.end();
+      owner.insert(inOwner[id], entry(records[id]));
+   }
+   return nanosecondsSince(start) / picked.size();
+}
+
+Record copyOf(Record & record)      { return record;  }
+Record * pointerTo(Record & record) { return &record; }
+
+/**********************************************************************
+ * MOVE INTRUSIVE
+ * The records carry their own links, so a move is an unlink and a
+ * push_back on each list
+ ***********************************************************************/
+double moveIntrusive(vector <Record> & records, const vector <int> & picked)
+{
+   IntrusiveList <Record, ByQueue> queue;
+   IntrusiveList <Record, ByOwner> owner;
+   for (int i = 0; i < records.size(); i++)
+   {
+      queue.push_back(records[i]);
+      owner.push_back(records[i]);
+   }
+
+   Clock::time_point start = Clock::now();
+   for (int i = 0; i < picked.size(); i++)
+   {
+      Record & record = records[picked[i]];
+      IntrusiveList <Record, ByQueue> :: remove(record);
+      queue.push_back(record);
+      IntrusiveList <Record, ByOwner> :: remove(record);
+      owner.push_back(record);
+   }
+   return nanosecondsSince(start) / picked.size();
+}
+
+/**********************************************************************
+ * INTRUSIVE
+ * 10M moves over n records, each on two lists
+ ***********************************************************************/
+void intrusive(int n)
+{
+   const int NUM_MOVES = 10000000;
+   vector <Record> records(n);
+   for (int i = 0; i < n; i++)
+      records[i].id = i;
+   vector <int> picked = picks(n, NUM_MOVES);
+
+   cout << NUM_MOVES << " moves to the back of two lists, " << n
+        << " records of " << sizeof(Record) << " bytes\n";
+   cout << setw(28) << left << "List of copies" << right << fixed
+        << setprecision(1) << setw(10)
+        << moveOnList <Record> (records, picked, copyOf) << "ns\n";
+   cout << setw(28) << left << "List of pointers" << right
+        << setw(10) << moveOnList <Record *> (records, picked, pointerTo)
+        << "ns\n";
+   cout << setw(28) << left << "IntrusiveList" << right
+        << setw(10) << moveIntrusive(records, picked) << "ns\n";
+}
+
+/**********************************************************************
+ * TIME SORT
+ * Seconds for one sort of a list filled with the keys
+ ***********************************************************************/
+template <class L>
+double timeSort(L & list, const vector <int> & keys)
+{
+   for (int i = 0; i < keys.size(); i++)
+      list.push_back(keys[i]);
+   Clock::time_point start = Clock::now();
+   list.sort();
+   return nanosecondsSince(start) / 1e9;
+}
+
+/**********************************************************************
+ * SORT ROW
+ * The same keys sorted on a std::list and on a List. The List is
+ * handed back so the caller decides when its nodes go back to the pool
+ ***********************************************************************/
+List <int> * sortRow(long long size, const char * input,
+                     const vector <int> & keys)
+{
+   double standard;
+   {
+      std::list <int> list;
+      standard = timeSort(list, keys);
+   }
+   List <int> * pList = new List <int>;
+   double ours = timeSort(*pList, keys);
+   cout << setw(12) << size << setw(16) << input << fixed
+        << setprecision(2) << setw(12) << standard << setw(11) << ours
+        << endl;
+   return pList;
+}
+
+/**********************************************************************
+ * SORTS
+ * Lists of 1M ints, then ten times as many, up to n, in random order
+ * from a fixed seed, already sorted and reversed. The pool never gives
+ * memory back, and what it hands out next is in the order the last
+ * list freed it, so every List is kept until the end: each one starts
+ * on fresh nodes laid out in list order, as the std::lists do. The
+ * "reused" row sorts sorted keys again on the nodes a random sort left
+ * scattered, which is what a long-running program will see
+ ***********************************************************************/
+void sorts(int n)
+{
+   cout << "sorting a list of ints, seconds\n"
+        << setw(12) << "elements" << setw(16) << "input"
+        << setw(12) << "std::list" << setw(12) << "List\n";
+   vector <List <int> *> kept;
+   for (long long size = 1000000; size <= n; size *= 10)
+   {
+      mt19937 random(29);
+      vector <int> keys(size);
+      for (int i = 0; i < size; i++)
+         keys[i] = random();
+      List <int> * pRandom = sortRow(size, "random", keys);
+      sort(keys.begin(), keys.end());
+      kept.push_back(sortRow(size, "sorted", keys));
+      reverse(keys.begin(), keys.end());
+      kept.push_back(sortRow(size, "reverse", keys));
+      delete pRandom;
+      reverse(keys.begin(), keys.end());
+      kept.push_back(sortRow(size, "sorted, reused", keys));
+   }
+   for (int i = 0; i < kept.size(); i++)
+      delete kept[i];
+}
+
+/**********************************************************************
+ * FIBONACCIS
+ * F(n) three ways, for n of 1000 and ten times as much up to n.
+ * Adding up the sequence is O(n^2) in the digits, so it stops at 1M
+ ***********************************************************************/
+void fibonaccis(int n)
+{
+   cout << "F(n), seconds\n" << setw(12) << "n" << setw(10) << "digits"
+        << setw(12) << "doubling" << setw(12) << "BigInt +"
+        << setw(12) << "sequence" << setw(12) << "printing\n";
+   for (long long k = 1000; k <= n; k *= 10)
+   {
+      Clock::time_point start = Clock::now();
+      BigInt fast = fibonacciNumber(k);
+      double doubling = nanosecondsSince(start) / 1e9;
+
+      start = Clock::now();
+      string text = fast.toString();
+      double printing = nanosecondsSince(start) / 1e9;
+
+      double added = -1.0;
+      double sequenced = -1.0;
+      if (k <= 1000000)
+      {
+         start = Clock::now();
+         BigInt a(0);
+         BigInt b(1);
+         for (long long i = 0; i < k; i++)
+         {
+            BigInt next = a + b;
+            a = b;
+            b = next;
+         }
+         added = nanosecondsSince(start) / 1e9;
+         if (a != fast)
+            cerr << "F(" << k << ") by BigInt + is wrong\n";
+
+         start = Clock::now();
+         FibonacciSequence sequence;
+         for (long long i = 1; i < k; i++)
+            sequence.next();
+         sequenced = nanosecondsSince(start) / 1e9;
+         if (sequence.value() != fast.getLimbs())
+            cerr << "F(" << k << ") by FibonacciSequence is wrong\n";
+      }
+
+      cout << setw(12) << k << setw(10) << text.size() << fixed
+           << setprecision(4) << setw(12) << doubling;
+      if (added < 0.0)
+         cout << setw(12) << "-" << setw(12) << "-";
+      else
+         cout << setw(12) << added << setw(12) << sequenced;
+      cout << setw(12) << printing << endl;
+   }
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   const char * mode = argc > 1 ? argv[1] : "";
+   int n = argc > 2 ? atoi(argv[2]) : 0;
+
+   if (strcmp(mode, "pool") == 0)
+      pool(n ? n : 10000000);
+   else if (strcmp(mode, "iterate") == 0)
+      iterate(n ? n : 100000000);
+   else if (strcmp(mode, "intrusive") == 0)
+      intrusive(n ? n : 1000000);
+   else if (strcmp(mode, "sort") == 0)
+      sorts(n ? n : 10000000);
+   else if (strcmp(mode, "fibonacci") == 0)
+      fibonaccis(n ? n : 10000000);
+   else
+   {
+      cerr << "Usage: " << argv[0] << " pool|iterate|intrusive|sort|fibonacci [n]\n";
+      return 1;
+   }
+   return 0;
+}
@@ -11,6 +11,7 @@
 #define node_h
 #include <iostream>
 #include <string>
+#include "pool.h"
 
 template <class T>
 class Node {
@@ -21,6 +22,16 @@ public:
     Node() : data(0), pNext(NULL), pPrev(NULL) {};
     Node(T newData) : data(newData), pNext(NULL), pPrev(NULL){};
     
+    // nodes come from the slab pool rather than the general heap
+    static void * operator new(size_t size)
+    {
+        return NodePool <sizeof(Node <T>)> :: allocate();
+    }
+    static void operator delete(void * p)
+    {
+        NodePool <sizeof(Node <T>)> :: release(p);
+    }
+    
     T data;
     Node *pNext;
     Node *pPrev;
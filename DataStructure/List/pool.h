@@ -0,0 +1,311 @@
+/***********************************************************************
+ * Header:
+ *    NODE POOL
+ * Summary:
+ *    A slab allocator for fixed-size blocks such as list nodes. Blocks
+ *    are carved out of large slabs and recycled through a free list
+ *    that is private to each thread, so allocating or releasing a node
+ *    is a couple of pointer moves instead of a trip to new and delete.
+ *
+ *    A node class plugs into the pool by routing its own operator new
+ *    and operator delete through NodePool <sizeof(Node)>.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef pool_h
+#define pool_h
+
+#include <atomic>      // for ATOMIC
+#include <cstddef>     // for SIZE_T and MAX_ALIGN_T
+#include <mutex>       // for MUTEX and LOCK_GUARD
+#include <new>         // for BAD_ALLOC and ::OPERATOR NEW
+
+/*************************************************************************
+ * NODE POOL
+ * All blocks of a given SIZE share one pool per thread. Each thread
+ * keeps a free list of up to BATCH blocks and one spare batch. When
+ * both are full, as on the consumer's side of a queue, a batch goes to
+ * a depot shared by every thread, and a thread that runs dry takes a
+ * batch from there before carving a new slab. A thread that exits
+ * leaves its free blocks in the depot. Only batches move between
+ * threads, so the lock is taken once per BATCH blocks at most. Slabs
+ * are never handed back to the system: memory is recycled, not
+ * returned.
+ ************************************************************************/
+template <std::size_t SIZE>
+class NodePool
+{
+    union Block;
+
+public:
+    // hand out one block of at least SIZE bytes
+    static void * allocate() throw (std::bad_alloc)
+    {
+        if (pFree == NULL)
+            refill();
+        Block * pBlock = pFree;
+        pFree = pBlock->chain.pNext;
+        numFree--;
+        inUse++;
+        return pBlock;
+    }
+
+    // put one block back on the free list
+    static void release(void * p)
+    {
+        if (p == NULL)
+            return;
+        if (numFree >= BATCH || !enrolled)
+            makeRoom();
+        Block * pBlock = static_cast <Block *> (p);
+        pBlock->chain.pNext = pFree;
+        pFree = pBlock;
+        numFree++;
+        inUse--;
+    }
+
+    // blocks given back together, gathered into batches as the caller
+    // walks its nodes: add() each one, then release() them all. Whole
+    // batches go to the depot under one lock, so a thread that takes
+    // one from there never takes more than BATCH blocks, and the few
+    // left over go on this thread's free list
+    class Chain
+    {
+    public:
+        Chain() : pBatches(NULL), pLastBatch(NULL), pBatch(NULL),
+                  pBatchLast(NULL), num(0), total(0) {}
+
+        void add(void * p)
+        {
+            Block * pBlock = static_cast <Block *> (p);
+            if (pBatch == NULL)
+                pBatchLast = pBlock;
+            pBlock->chain.pNext = pBatch;
+            pBatch = pBlock;
+            total++;
+            if (++num == BATCH)
+            {
+                pBatch->chain.count = BATCH;
+                pBatch->chain.pNextBatch = pBatches;
+                if (pBatches == NULL)
+                    pLastBatch = pBatch;
+                pBatches = pBatch;
+                pBatch = NULL;
+                num = 0;
+            }
+        }
+
+        void release()
+        {
+            if (total == 0)
+                return;
+            if (numFree >= BATCH || !enrolled)
+                makeRoom();
+            inUse -= total;
+            if (pBatches != NULL)
+            {
+                numInUse += inUse;
+                inUse = 0;
+                depositBatches(pBatches, pLastBatch);
+            }
+            if (pBatch != NULL)
+            {
+                pBatchLast->chain.pNext = pFree;
+                pFree = pBatch;
+                numFree += num;
+            }
+            pBatches = pLastBatch = pBatch = pBatchLast = NULL;
+            num = total = 0;
+        }
+
+    private:
+        Block * pBatches;    // the whole batches, through pNextBatch
+        Block * pLastBatch;
+        Block * pBatch;      // the batch being filled
+        Block * pBatchLast;
+        long    num;         // blocks in the batch being filled
+        long    total;
+    };
+
+    // statistics, handy when counting allocations. Slabs are counted
+    // across all threads. Blocks in use are exact when one thread uses
+    // the pool; other threads' last few batches may not be in yet
+    static long slabsAllocated() { return numSlabs.load(); }
+    static long blocksInUse()    { return numInUse.load() + inUse; }
+
+private:
+    union Block
+    {
+        struct
+        {
+            Block * pNext;       // the next free block
+            Block * pNextBatch;  // in the depot, the next batch
+            long    count;       // in the depot, blocks in the batch
+        } chain;
+        char    storage[SIZE];
+        std::max_align_t align;
+    };
+
+    // about 64KB per slab, but never fewer than 16 blocks
+    static const std::size_t BLOCKS_PER_SLAB =
+        (65536 / sizeof(Block) > 16) ? 65536 / sizeof(Block) : 16;
+
+    // blocks moved between a thread and the depot at a time
+    static const long BATCH = 256;
+
+    // when this thread exits, its free blocks go to the depot
+    struct ThreadExit
+    {
+        ~ThreadExit()
+        {
+            if (pFree != NULL)
+                deposit(pFree, numFree);
+            if (pSpare != NULL)
+                deposit(pSpare, numSpare);
+            pFree = pSpare = NULL;
+            numFree = numSpare = 0;
+            numInUse += inUse;
+            inUse = 0;
+        }
+    };
+
+    // the free list becomes the spare batch, and the old spare, if
+    // any, goes to the depot. The first time, also arrange for this
+    // thread's blocks to be handed on when it exits
+    static void makeRoom()
+    {
+        if (!enrolled)
+        {
+            enrolled = true;
+            (void)&threadExit;
+            if (numFree < BATCH)
+                return;
+        }
+        if (pSpare != NULL)
+        {
+            numInUse += inUse;
+            inUse = 0;
+            deposit(pSpare, numSpare);
+        }
+        pSpare = pFree;
+        numSpare = numFree;
+        pFree = NULL;
+        numFree = 0;
+    }
+
+    // put a chain of num free blocks in the depot
+    static void deposit(Block * pFirst, long num)
+    {
+        pFirst->chain.count = num;
+        depositBatches(pFirst, pFirst);
+    }
+
+    // put the batches from pFirst to pLast, already counted and
+    // threaded through pNextBatch, in the depot under one lock
+    static void depositBatches(Block * pFirst, Block * pLast)
+    {
+        std::lock_guard <std::mutex> guard(depotLock);
+        pLast->chain.pNextBatch = pDepot;
+        pDepot = pFirst;
+    }
+
+    // take the spare batch, or one from the depot, or carve a new
+    // slab into batches and keep the first
+    static void refill() throw (std::bad_alloc)
+    {
+        if (!enrolled)
+            makeRoom();
+        if (pSpare != NULL)
+        {
+            pFree = pSpare;
+            numFree = numSpare;
+            pSpare = NULL;
+            numSpare = 0;
+            return;
+        }
+
+        numInUse += inUse;
+        inUse = 0;
+        {
+            std::lock_guard <std::mutex> guard(depotLock);
+            if (pDepot != NULL)
+            {
+                pFree = pDepot;
+                numFree = pDepot->chain.count;
+                pDepot = pDepot->chain.pNextBatch;
+                return;
+            }
+        }
+
+        Block * pSlab = static_cast <Block *>
+            (::operator new(BLOCKS_PER_SLAB * sizeof(Block)));
+        numSlabs++;
+        for (std::size_t first = 0; first < BLOCKS_PER_SLAB; first += BATCH)
+        {
+            std::size_t last = first + BATCH < BLOCKS_PER_SLAB ?
+                               first + BATCH : BLOCKS_PER_SLAB;
+            for (std::size_t i = first; i < last - 1; i++)
+                pSlab[i].chain.pNext = pSlab + i + 1;
+            pSlab[last - 1].chain.pNext = NULL;
+            if (first == 0)
+            {
+                pFree = pSlab;
+                numFree = last;
+            }
+            else
+                deposit(pSlab + first, last - first);
+        }
+    }
+
+    // this thread's free list and spare batch, and its allocations
+    // not yet added to numInUse
+    static thread_local Block * pFree;
+    static thread_local long    numFree;
+    static thread_local Block * pSpare;
+    static thread_local long    numSpare;
+    static thread_local long    inUse;
+    static thread_local bool    enrolled;
+    static thread_local ThreadExit threadExit;
+
+    // shared by every thread
+    static std::mutex         depotLock;
+    static Block *            pDepot;
+    static std::atomic <long> numSlabs;
+    static std::atomic <long> numInUse;
+};
+
+template <std::size_t SIZE>
+thread_local typename NodePool <SIZE> :: Block * NodePool <SIZE> :: pFree = NULL;
+
+template <std::size_t SIZE>
+thread_local long NodePool <SIZE> :: numFree = 0;
+
+template <std::size_t SIZE>
+thread_local typename NodePool <SIZE> :: Block * NodePool <SIZE> :: pSpare = NULL;
+
+template <std::size_t SIZE>
+thread_local long NodePool <SIZE> :: numSpare = 0;
+
+template <std::size_t SIZE>
+thread_local long NodePool <SIZE> :: inUse = 0;
+
+template <std::size_t SIZE>
+thread_local bool NodePool <SIZE> :: enrolled = false;
+
+template <std::size_t SIZE>
+thread_local typename NodePool <SIZE> :: ThreadExit NodePool <SIZE> :: threadExit;
+
+template <std::size_t SIZE>
+std::mutex NodePool <SIZE> :: depotLock;
+
+template <std::size_t SIZE>
+typename NodePool <SIZE> :: Block * NodePool <SIZE> :: pDepot = NULL;
+
+template <std::size_t SIZE>
+std::atomic <long> NodePool <SIZE> :: numSlabs(0);
+
+template <std::size_t SIZE>
+std::atomic <long> NodePool <SIZE> :: numInUse(0);
+
+#endif /* pool_h */
@@ -0,0 +1,219 @@
+/***********************************************************************
+ * Program:
+ *    POOL TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks that NodePool keeps its memory bounded when blocks are
+ *    freed on a different thread from the one that allocated them, and
+ *    when threads come and go, that a long chain handed back at once
+ *    is shared out in batches, and that it counts blocks in use right
+ *    once every thread is done. Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <condition_variable>
+#include <cstdlib>         // for EXIT
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "pool.h"
+using namespace std;
+
+typedef NodePool <48> Pool;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * PRODUCER CONSUMER
+ * One thread allocates every block and another frees every one, round
+ * after round. Without the depot the consumer's free list, and the
+ * producer's slabs, would grow by every block passed across
+ ***********************************************************************/
+void producerConsumer()
+{
+   const int ROUNDS = 200;
+   const int PER_ROUND = 10000;
+   mutex lock;
+   condition_variable ready;       // something to free
+   condition_variable drained;     // the consumer took the last round
+   vector <void *> handed;
+   bool done = false;
+
+   thread consumer([&]()
+   {
+      for (;;)
+      {
+         vector <void *> blocks;
+         {
+            unique_lock <mutex> guard(lock);
+            ready.wait(guard, [&]() { return !handed.empty() || done; });
+            if (handed.empty() && done)
+               return;
+            blocks.swap(handed);
+            drained.notify_one();
+         }
+         for (int i = 0; i < blocks.size(); i++)
+            Pool::release(blocks[i]);
+      }
+   });
+
+   for (int round = 0; round < ROUNDS; round++)
+   {
+      vector <void *> blocks;
+      for (int i = 0; i < PER_ROUND; i++)
+         blocks.push_back(Pool::allocate());
+      unique_lock <mutex> guard(lock);
+      drained.wait(guard, [&]() { return handed.empty(); });
+      handed.swap(blocks);
+      ready.notify_one();
+   }
+   {
+      lock_guard <mutex> guard(lock);
+      done = true;
+      ready.notify_one();
+   }
+   consumer.join();
+
+   // 2,000,000 blocks went across, but at most a round is waiting
+   // and another being freed at any time
+   long slabs = Pool::slabsAllocated();
+   cout << "producer/consumer: " << slabs << " slabs for "
+        << ROUNDS * PER_ROUND << " blocks passed across\n";
+   CHECK(slabs * 65536 / 48 < 10 * PER_ROUND);
+   CHECK(Pool::blocksInUse() == 0);
+}
+
+/**********************************************************************
+ * SHORT THREADS
+ * Many threads each take some blocks and exit holding free ones. What
+ * they leave behind has to be found again by the next thread
+ ***********************************************************************/
+void shortThreads()
+{
+   long before = Pool::slabsAllocated();
+   for (int t = 0; t < 200; t++)
+   {
+      thread worker([]()
+      {
+         vector <void *> blocks;
+         for (int i = 0; i < 5000; i++)
+            blocks.push_back(Pool::allocate());
+         for (int i = 0; i < blocks.size(); i++)
+            Pool::release(blocks[i]);
+      });
+      worker.join();
+   }
+   long slabs = Pool::slabsAllocated() - before;
+   cout << "short threads: " << slabs << " new slabs for 200 threads\n";
+   CHECK(slabs * 65536 / 48 < 4 * 5000);
+   CHECK(Pool::blocksInUse() == 0);
+}
+
+/**********************************************************************
+ * SINGLE THREAD
+ * Blocks come back in chains and one at a time, and the count stays
+ * exact on this thread throughout
+ ***********************************************************************/
+void singleThread()
+{
+   vector <void *> blocks;
+   for (int i = 0; i < 3000; i++)
+      blocks.push_back(Pool::allocate());
+   CHECK(Pool::blocksInUse() == 3000);
+
+   Pool::Chain chain;
+   for (int i = 0; i < 1000; i++)
+      chain.add(blocks[i]);
+   chain.release();
+   CHECK(Pool::blocksInUse() == 2000);
+
+   for (int i = 1000; i < 3000; i++)
+      Pool::release(blocks[i]);
+   CHECK(Pool::blocksInUse() == 0);
+}
+
+/**********************************************************************
+ * LONG CHAIN
+ * A million blocks handed back as one chain go to the depot in batches.
+ * One thread that takes a few of them must leave the rest for the
+ * next, rather than carry off the whole chain as one batch
+ ***********************************************************************/
+void longChain()
+{
+   typedef NodePool <64> Other;
+   const int NUM = 1000000;
+   thread releaser([&]()
+   {
+      vector <void *> blocks;
+      for (int i = 0; i < NUM; i++)
+         blocks.push_back(Other::allocate());
+      Other::Chain chain;
+      for (int i = 0; i < NUM; i++)
+         chain.add(blocks[i]);
+      chain.release();
+   });
+   releaser.join();
+   long before = Other::slabsAllocated();
+
+   // the first taker holds on to its free list until the second is done
+   mutex lock;
+   condition_variable changed;
+   bool taken = false;
+   bool finished = false;
+   thread taker([&]()
+   {
+      vector <void *> blocks;
+      for (int i = 0; i < 1000; i++)
+         blocks.push_back(Other::allocate());
+      unique_lock <mutex> guard(lock);
+      taken = true;
+      changed.notify_all();
+      changed.wait(guard, [&]() { return finished; });
+      for (int i = 0; i < blocks.size(); i++)
+         Other::release(blocks[i]);
+   });
+   {
+      unique_lock <mutex> guard(lock);
+      changed.wait(guard, [&]() { return taken; });
+   }
+   thread second([&]()
+   {
+      vector <void *> blocks;
+      for (int i = 0; i < NUM - 10000; i++)
+         blocks.push_back(Other::allocate());
+      for (int i = 0; i < blocks.size(); i++)
+         Other::release(blocks[i]);
+   });
+   second.join();
+   long slabs = Other::slabsAllocated() - before;
+   {
+      lock_guard <mutex> guard(lock);
+      finished = true;
+      changed.notify_all();
+   }
+   taker.join();
+
+   cout << "long chain: " << slabs << " new slabs after a chain of "
+        << NUM << " blocks\n";
+   CHECK(slabs == 0);
+   CHECK(Other::blocksInUse() == 0);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   singleThread();
+   producerConsumer();
+   shortThreads();
+   longChain();
+   cout << "Pool tests passed\n";
+   return 0;
+}
@@ -0,0 +1,136 @@
+/***********************************************************************
+ * Program:
+ *    SORT TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks List::sort against std::stable_sort on empty, one-item,
+ *    short, random, sorted and reverse lists, with many equal keys so
+ *    that stability shows. The back links and the tail must be right
+ *    afterwards too, walked backwards and pushed onto. Exits 1 on the
+ *    first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for STABLE_SORT and REVERSE
+#include <cstdlib>         // for EXIT
+#include <random>          // for MT19937
+#include <vector>
+#include "list.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * ITEM
+ * Sorted by key alone; seq tells equal keys apart
+ ***********************************************************************/
+struct Item
+{
+   int key;
+   int seq;
+   bool operator <  (const Item & rhs) const { return key < rhs.key; }
+   bool operator == (const Item & rhs) const
+   {
+      return key == rhs.key && seq == rhs.seq;
+   }
+};
+
+/**********************************************************************
+ * MATCHES
+ * The list holds exactly the items, forwards through pNext and
+ * backwards through pPrev from the tail
+ ***********************************************************************/
+bool matches(List <Item> & list, const vector <Item> & items)
+{
+   if (list.size() != items.size() || list.empty() != items.empty())
+      return false;
+   int i = 0;
+   for (List <Item> :: ListIterator it = list.begin(); it != list.end(); ++it)
+      if (i >= items.size() || !(*it == items[i++]))
+         return false;
+   if (i != items.size())
+      return false;
+   for (List <Item> :: reverse_ListIterator it = list.rbegin();
+        it != list.rend(); ++it)
+      if (i <= 0 || !(*it == items[--i]))
+         return false;
+   return i == 0;
+}
+
+/**********************************************************************
+ * SORTS LIKE
+ * Sort a List of the keys and compare with std::stable_sort. Then
+ * push onto both ends, which needs the right head and tail
+ ***********************************************************************/
+void sortsLike(const vector <int> & keys)
+{
+   vector <Item> items;
+   List <Item> list;
+   for (int i = 0; i < keys.size(); i++)
+   {
+      Item item = { keys[i], i };
+      items.push_back(item);
+      list.push_back(item);
+   }
+   list.sort();
+   stable_sort(items.begin(), items.end());
+   CHECK(matches(list, items));
+
+   Item first = { -1, -1 };
+   Item last = { 1 << 30, -2 };
+   list.push_front(first);
+   list.push_back(last);
+   items.insert(items.begin(), first);
+   items.push_back(last);
+   CHECK(matches(list, items));
+   CHECK(list.front() == first);
+   CHECK(list.back() == last);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   mt19937 random(29);
+
+   // the edges
+   sortsLike(vector <int> ());
+   sortsLike(vector <int> (1, 5));
+   for (int n = 2; n <= 9; n++)
+      for (int trial = 0; trial < 50; trial++)
+      {
+         vector <int> keys;
+         for (int i = 0; i < n; i++)
+            keys.push_back(random() % 3);
+         sortsLike(keys);
+      }
+
+   // random with few and with many distinct keys, then sorted, reverse
+   // and all equal, around powers of two where the runs meet
+   const int sizes[] = { 255, 256, 257, 1000, 65537 };
+   for (int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+   {
+      vector <int> keys;
+      for (int i = 0; i < sizes[s]; i++)
+         keys.push_back(random() % 10);
+      sortsLike(keys);
+      for (int i = 0; i < sizes[s]; i++)
+         keys[i] = random();
+      sortsLike(keys);
+      sort(keys.begin(), keys.end());
+      sortsLike(keys);
+      reverse(keys.begin(), keys.end());
+      sortsLike(keys);
+      sortsLike(vector <int> (sizes[s], 7));
+   }
+
+   cout << "Sort tests passed\n";
+   return 0;
+}
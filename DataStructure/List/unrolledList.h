@@ -0,0 +1,473 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED LIST
+ * Summary:
+ *    A doubly linked list that keeps up to K elements in every node.
+ *    It behaves like List: push and pop at both ends, plus insert and
+ *    erase through a ListIterator. Packing elements together means far
+ *    less pointer overhead per element and one cache miss per node
+ *    rather than one per element when iterating.
+ *
+ *    Nodes split in half when an insert finds them full and merge with
+ *    their neighbor when an erase leaves them less than half full.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef unrolled_list_h
+#define unrolled_list_h
+
+#include <cassert>
+#include "pool.h"
+
+/*************************************************************************
+ * UNROLLED LIST
+ * K defaults to roughly 256 bytes worth of elements per node.
+ ************************************************************************/
+template <class T, int K = (sizeof(T) * 4 < 256 ? 256 / sizeof(T) : 4)>
+class UnrolledList
+{
+public:
+    // constructors and destructor
+    UnrolledList() : pHead(NULL), pTail(NULL), numElements(0) {}
+    UnrolledList(const UnrolledList <T, K> & rhs) throw (const char *) :
+        pHead(NULL), pTail(NULL), numElements(0)
+    {
+        *this = rhs;
+    }
+    ~UnrolledList() { clear(); }
+
+    // assignment operator
+    UnrolledList <T, K> & operator = (const UnrolledList <T, K> & rhs)
+        throw (const char *);
+
+    // standard container interfaces
+    int  size()  const { return numElements;  }
+    bool empty() const { return pHead == NULL; }
+    void clear();
+
+    // the ListIterator interfaces
+    class ListIterator;
+    class const_ListIterator;
+    ListIterator begin() { return ListIterator(pHead, 0); }
+    ListIterator end()   { return ListIterator(NULL, 0);  }
+    const_ListIterator cbegin() const { return const_ListIterator(pHead, 0); }
+    const_ListIterator cend()   const { return const_ListIterator(NULL, 0);  }
+
+    // pushes and pops
+    void push_back(const T & data)  throw (const char *);
+    void push_front(const T & data) throw (const char *);
+    void pop_back()
+    {
+        ListIterator it(pTail, pTail ? pTail->num - 1 : 0);
+        erase(it);
+    }
+    void pop_front()
+    {
+        ListIterator it(pHead, 0);
+        erase(it);
+    }
+
+    // data reference to the first and last element
+    T & front() throw (const char *)
+    {
+        if (empty())
+            throw "ERROR: unable to access data from an empty List";
+        return pHead->data[0];
+    }
+    T & back() throw (const char *)
+    {
+        if (empty())
+            throw "ERROR: unable to access data from an empty List";
+        return pTail->data[pTail->num - 1];
+    }
+
+    // insert in front of it, or remove the element at it. Either way
+    // it is left on the new element or on the one that followed
+    void insert(ListIterator & it, const T & data) throw (const char *);
+    void erase(ListIterator & it) throw (const char *);
+
+private:
+    /**********************************************
+     * CHUNK
+     * One node of the list, holding up to K items
+     **********************************************/
+    struct Chunk
+    {
+        Chunk() : num(0), pNext(NULL), pPrev(NULL) {}
+
+        static void * operator new(size_t size)
+        {
+            return NodePool <sizeof(Chunk)> :: allocate();
+        }
+        static void operator delete(void * p)
+        {
+            NodePool <sizeof(Chunk)> :: release(p);
+        }
+
+        T data[K];
+        int num;
+        Chunk * pNext;
+        Chunk * pPrev;
+    };
+
+    Chunk * newChunkAfter(Chunk * pChunk) throw (const char *);
+    void    unlink(Chunk * pChunk);
+
+    Chunk * pHead;
+    Chunk * pTail;
+    int numElements;
+};
+
+/***************************************
+ * UnrolledList <T> :: assigment operator
+ * Copies the rhs a whole chunk at a time
+ **************************************/
+template <class T, int K>
+UnrolledList <T, K> & UnrolledList <T, K> :: operator =
+    (const UnrolledList <T, K> & rhs) throw (const char *)
+{
+    if (&rhs == this)
+        return *this;
+
+    clear();
+    for (const Chunk * p = rhs.pHead; p; p = p->pNext)
+    {
+        Chunk * pNew = newChunkAfter(pTail);
+        for (int i = 0; i < p->num; i++)
+            pNew->data[i] = p->data[i];
+        pNew->num = p->num;
+    }
+    numElements = rhs.numElements;
+    return *this;
+}
+
+/*************************************************
+ * UnrolledList :: clear
+ * Deletes every chunk
+ ***********************************************/
+template <class T, int K>
+void UnrolledList <T, K> :: clear()
+{
+    while (pHead)
+    {
+        Chunk * pNext = pHead->pNext;
+        delete pHead;
+        pHead = pNext;
+    }
+    pTail = NULL;
+    numElements = 0;
+}
+
+/*************************************************
+ * UnrolledList :: newChunkAfter
+ * Links a fresh, empty chunk after pChunk. A NULL
+ * pChunk puts it at the head of the list
+ ***********************************************/
+template <class T, int K>
+typename UnrolledList <T, K> :: Chunk *
+UnrolledList <T, K> :: newChunkAfter(Chunk * pChunk) throw (const char *)
+{
+    Chunk * pNew;
+    try
+    {
+        pNew = new Chunk;
+    }
+    catch (...)
+    {
+        throw "ERROR: unable to allocate a new node for a List";
+    }
+
+    pNew->pPrev = pChunk;
+    pNew->pNext = pChunk ? pChunk->pNext : pHead;
+    if (pNew->pNext)
+        pNew->pNext->pPrev = pNew;
+    else
+        pTail = pNew;
+    if (pChunk)
+        pChunk->pNext = pNew;
+    else
+        pHead = pNew;
+    return pNew;
+}
+
+/*************************************************
+ * UnrolledList :: unlink
+ * Removes a chunk from the list and deletes it
+ ***********************************************/
+template <class T, int K>
+void UnrolledList <T, K> :: unlink(Chunk * pChunk)
+{
+    if (pChunk->pNext)
+        pChunk->pNext->pPrev = pChunk->pPrev;
+    else
+        pTail = pChunk->pPrev;
+    if (pChunk->pPrev)
+        pChunk->pPrev->pNext = pChunk->pNext;
+    else
+        pHead = pChunk->pNext;
+    delete pChunk;
+}
+
+/*************************************************
+ * UnrolledList :: push_back
+ * Adds an element to the back, starting a new
+ * chunk only when the last one is full
+ ***********************************************/
+template <class T, int K>
+void UnrolledList <T, K> :: push_back(const T & data) throw (const char *)
+{
+    if (pTail == NULL || pTail->num == K)
+        newChunkAfter(pTail);
+    pTail->data[pTail->num++] = data;
+    numElements++;
+}
+
+/*************************************************
+ * UnrolledList :: push_front
+ * Adds an element to the front of the list
+ ***********************************************/
+template <class T, int K>
+void UnrolledList <T, K> :: push_front(const T & data) throw (const char *)
+{
+    ListIterator it = begin();
+    insert(it, data);
+}
+
+/*************************************************
+ * UnrolledList :: insert
+ * Puts data in front of it. A full chunk is split
+ * in half first so both halves have room to grow
+ ***********************************************/
+template <class T, int K>
+void UnrolledList <T, K> :: insert(ListIterator & it, const T & data)
+    throw (const char *)
+{
+    if (it == end())
+    {
+        push_back(data);
+        it = ListIterator(pTail, pTail->num - 1);
+        return;
+    }
+
+    Chunk * pChunk = it.p;
+    int index = it.i;
+
+    // split a full chunk, moving the upper half into a new one
+    if (pChunk->num == K)
+    {
+        Chunk * pNew = newChunkAfter(pChunk);
+        int half = K / 2;
+        for (int i = half; i < K; i++)
+        {
+            pNew->data[i - half] = pChunk->data[i];
+            pChunk->data[i] = T();
+        }
+        pNew->num = K - half;
+        pChunk->num = half;
+        if (index > half)
+        {
+            pChunk = pNew;
+            index -= half;
+        }
+    }
+
+    // open a gap and drop the new element into it
+    for (int i = pChunk->num; i > index; i--)
+        pChunk->data[i] = pChunk->data[i - 1];
+    pChunk->data[index] = data;
+    pChunk->num++;
+    numElements++;
+    it = ListIterator(pChunk, index);
+}
+
+/*************************************************
+ * UnrolledList :: erase
+ * Removes the element at it. A chunk that drops
+ * below half full absorbs its successor when the
+ * two fit together in one chunk
+ ***********************************************/
+template <class T, int K>
+void UnrolledList <T, K> :: erase(ListIterator & it) throw (const char *)
+{
+    if (it == end())
+        throw "ERROR: unable to remove from an invalid location in a List";
+
+    Chunk * pChunk = it.p;
+    int index = it.i;
+    assert(index < pChunk->num);
+
+    // close the gap left by the element
+    for (int i = index; i < pChunk->num - 1; i++)
+        pChunk->data[i] = pChunk->data[i + 1];
+    pChunk->data[--pChunk->num] = T();
+    numElements--;
+
+    if (pChunk->num == 0)
+    {
+        Chunk * pNext = pChunk->pNext;
+        unlink(pChunk);
+        it = ListIterator(pNext, 0);
+        return;
+    }
+
+    // merge with the next chunk when we get too sparse
+    Chunk * pNext = pChunk->pNext;
+    if (pChunk->num < K / 2 && pNext && pChunk->num + pNext->num <= K)
+    {
+        for (int i = 0; i < pNext->num; i++)
+            pChunk->data[pChunk->num + i] = pNext->data[i];
+        pChunk->num += pNext->num;
+        unlink(pNext);
+    }
+
+    if (index < pChunk->num)
+        it = ListIterator(pChunk, index);
+    else
+        it = ListIterator(pChunk->pNext, 0);
+}
+
+/**************************************************
+ * UnrolledList ListIterator
+ * An iterator through the list: a chunk plus the
+ * index of the element within that chunk
+ *************************************************/
+template <class T, int K>
+class UnrolledList <T, K> :: ListIterator
+{
+    friend class UnrolledList <T, K>;
+public:
+    // constructors
+    ListIterator() : p(NULL), i(0) {}
+    ListIterator(Chunk * p, int i) : p(p), i(i) {}
+
+    // equals, not equals operator
+    bool operator == (const ListIterator & it) const
+    {
+        return it.p == p && it.i == i;
+    }
+    bool operator != (const ListIterator & it) const
+    {
+        return !(*this == it);
+    }
+
+    // prefix increment
+    ListIterator & operator ++ ()
+    {
+        if (++i == p->num)
+        {
+            p = p->pNext;
+            i = 0;
+        }
+        return *this;
+    }
+
+    // prefix decrement
+    ListIterator & operator -- ()
+    {
+        if (i-- == 0)
+        {
+            p = p->pPrev;
+            i = p ? p->num - 1 : 0;
+        }
+        return *this;
+    }
+
+    // postfix increment and decrement
+    ListIterator operator ++ (int postfix)
+    {
+        ListIterator tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+    ListIterator operator -- (int postfix)
+    {
+        ListIterator tmp(*this);
+        --(*this);
+        return tmp;
+    }
+
+    // dereference operator
+    T & operator * () throw (const char *)
+    {
+        if (p)
+            return p->data[i];
+        else
+            throw "ERROR: Trying to dereference a NULL pointer";
+    }
+
+private:
+    Chunk * p;
+    int i;
+};
+
+/**************************************************
+ * UnrolledList CONST ListIterator
+ * An iterator through the list that cannot change it
+ *************************************************/
+template <class T, int K>
+class UnrolledList <T, K> :: const_ListIterator
+{
+public:
+    // constructors
+    const_ListIterator() : p(NULL), i(0) {}
+    const_ListIterator(const Chunk * p, int i) : p(p), i(i) {}
+
+    // equals, not equals operator
+    bool operator == (const const_ListIterator & it) const
+    {
+        return it.p == p && it.i == i;
+    }
+    bool operator != (const const_ListIterator & it) const
+    {
+        return !(*this == it);
+    }
+
+    // prefix increment
+    const_ListIterator & operator ++ ()
+    {
+        if (++i == p->num)
+        {
+            p = p->pNext;
+            i = 0;
+        }
+        return *this;
+    }
+
+    // prefix decrement
+    const_ListIterator & operator -- ()
+    {
+        if (i-- == 0)
+        {
+            p = p->pPrev;
+            i = p ? p->num - 1 : 0;
+        }
+        return *this;
+    }
+
+    // postfix increment and decrement
+    const_ListIterator operator ++ (int postfix)
+    {
+        const_ListIterator tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+    const_ListIterator operator -- (int postfix)
+    {
+        const_ListIterator tmp(*this);
+        --(*this);
+        return tmp;
+    }
+
+    // dereference operator
+    T operator * () const
+    {
+        return p->data[i];
+    }
+
+private:
+    const Chunk * p;
+    int i;
+};
+
+#endif /* unrolled_list_h */
@@ -0,0 +1,182 @@
+/***********************************************************************
+ * Program:
+ *    UNROLLED LIST TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Runs UnrolledList through random inserts, erases, pushes and pops
+ *    next to a std::list, with chunks small enough that nearly every
+ *    step splits or merges one, and checks the two agree after each
+ *    step, walking forwards and backwards. Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT
+#include <list>
+#include <random>          // for MT19937
+#include <string>
+#include "unrolledList.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * SAME
+ * Both lists hold the same items in the same order, read either way
+ ***********************************************************************/
+template <class T, int K>
+void same(UnrolledList <T, K> & unrolled, const list <T> & expected)
+{
+   CHECK(unrolled.size() == expected.size());
+   CHECK(unrolled.empty() == expected.empty());
+
+   typename list <T> :: const_iterator e = expected.begin();
+   typename UnrolledList <T, K> :: ListIterator it;
+   for (it = unrolled.begin(); it != unrolled.end(); ++it, ++e)
+      CHECK(*it == *e);
+   CHECK(e == expected.end());
+
+   typename UnrolledList <T, K> :: const_ListIterator c = unrolled.cbegin();
+   for (e = expected.begin(); e != expected.end(); ++e, ++c)
+      CHECK(*c == *e);
+   CHECK(c == unrolled.cend());
+
+   if (!expected.empty())
+   {
+      CHECK(unrolled.front() == expected.front());
+      CHECK(unrolled.back() == expected.back());
+
+      // backwards from the last item
+      typename list <T> :: const_reverse_iterator r = expected.rbegin();
+      it = unrolled.begin();
+      for (int i = 1; i < unrolled.size(); i++)
+         ++it;
+      for (int i = 0; i < unrolled.size(); i++, --it, ++r)
+         CHECK(*it == *r);
+   }
+}
+
+/**********************************************************************
+ * FUZZ
+ * Random steps, with the position of each insert and erase chosen at
+ * random too. Runs of inserts in one place split chunks over and over;
+ * runs of erases empty them and merge their neighbours
+ ***********************************************************************/
+template <class T, int K>
+void fuzz(T (*make)(int), int steps, unsigned seed)
+{
+   mt19937 random(seed);
+   UnrolledList <T, K> unrolled;
+   list <T> expected;
+
+   for (int step = 0; step < steps; step++)
+   {
+      int choice = random() % 10;
+      T item = make(random() % 1000);
+      if (choice < 4 || expected.empty())
+      {
+         // insert, sometimes at end()
+         int at = random() % (expected.size() + 1);
+         typename UnrolledList <T, K> :: ListIterator it = unrolled.begin();
+         typename list <T> :: iterator e = expected.begin();
+         for (int i = 0; i < at; i++, ++it, ++e)
+            ;
+         unrolled.insert(it, item);
+         e = expected.insert(e, item);
+         CHECK(*it == *e);
+      }
+      else if (choice < 7)
+      {
+         int at = random() % expected.size();
+         typename UnrolledList <T, K> :: ListIterator it = unrolled.begin();
+         typename list <T> :: iterator e = expected.begin();
+         for (int i = 0; i < at; i++, ++it, ++e)
+            ;
+         unrolled.erase(it);
+         e = expected.erase(e);
+         CHECK((it == unrolled.end()) == (e == expected.end()));
+         if (e != expected.end())
+            CHECK(*it == *e);
+      }
+      else if (choice == 7)
+      {
+         unrolled.push_front(item);
+         expected.push_front(item);
+      }
+      else if (choice == 8)
+      {
+         unrolled.push_back(item);
+         expected.push_back(item);
+      }
+      else if (random() % 2)
+      {
+         unrolled.pop_front();
+         expected.pop_front();
+      }
+      else
+      {
+         unrolled.pop_back();
+         expected.pop_back();
+      }
+      same(unrolled, expected);
+
+      // now and then, a copy and an assignment have to match too
+      if (step % 500 == 0)
+      {
+         UnrolledList <T, K> copy(unrolled);
+         same(copy, expected);
+         UnrolledList <T, K> assigned;
+         assigned.push_back(item);
+         assigned = unrolled;
+         same(assigned, expected);
+      }
+   }
+
+   unrolled.clear();
+   expected.clear();
+   same(unrolled, expected);
+}
+
+int    makeInt(int n)    { return n; }
+string makeString(int n) { return string(n % 40, 'a' + n % 26); }
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   fuzz <int, 2> (makeInt, 5000, 1);
+   fuzz <int, 4> (makeInt, 5000, 2);
+   fuzz <int, 7> (makeInt, 5000, 3);
+   fuzz <int, 64> (makeInt, 5000, 4);
+   fuzz <string, 3> (makeString, 5000, 5);
+   fuzz <string, 8> (makeString, 5000, 6);
+
+   // pops alone, all the way down from both ends
+   UnrolledList <int, 4> unrolled;
+   list <int> expected;
+   for (int i = 0; i < 1000; i++)
+   {
+      unrolled.push_back(i);
+      expected.push_back(i);
+   }
+   while (!expected.empty())
+   {
+      unrolled.pop_back();
+      expected.pop_back();
+      if (!expected.empty())
+      {
+         unrolled.pop_front();
+         expected.pop_front();
+      }
+      same(unrolled, expected);
+   }
+
+   cout << "UnrolledList tests passed\n";
+   return 0;
+}
@@ -10,12 +10,17 @@
 *    prompt the user for the filename. The array indexes will be the 
 *    palabras and the value of each element of the array will be a count 
 *    of the number of occurrences of that palabra.
+*
+*    The counting is done in a HashMap instead: one hash and one probe
+*    per palabra, where the map took O(log n) string compares, twice.
 ***************************************************************************/
 #include <iostream> // For STL Library
 #include <fstream> // For Input and output files
-#include <map>  // STL Map
 #include <string> // For strings
 #include <iomanip> // For setw(23)
+#include <vector> // For the most common palabras
+#include <algorithm> // For partial_sort
+#include "hashMap.h" // For HashMap
 using namespace std;
 
 /***************************************************************************
@@ -75,40 +80,36 @@ int main(int argc, char* argv[])
     * will be a count of the number of occurrences of that palabra. 
     *********************************************************************************/
 
-   map < string, int, less < string > > i;
+   HashMap < string, int > i;
    
    string palabra;
    int npalabra = 0;
    while (fin >> palabra)
    {
       remove(palabra);
-
-      if (i[palabra])
-         i[palabra]++;
-      else
-         i[palabra] = 1;
-         npalabra++;
+      i.upsert(palabra, [](int & count) { count++; });
+      npalabra++;
    }
 
    cout << endl << "Number of words processed: " << npalabra << endl;
    cout << "100 most common words found and their frequencies:" << endl;
 
-   // CREATE A MAP ...
+   // Only the top 100 need to be in order: most common first, and
+   // palabras with the same count alphabetically
    
-   multimap < int, string, less < int > > contar;
-   map < string, int > ::reverse_iterator iter;
-
-   for (iter = i.rbegin(); iter != i.rend(); iter++)
+   vector < pair < int, string > > contar;
+   contar.reserve(i.size());
+   for (HashMap < string, int > ::iterator iter = i.begin(); iter != i.end(); iter++)
    {
-      contar.insert(pair < int, string > (iter->second,iter->first));
+      contar.push_back(pair < int, string > (-iter->second, iter->first));
    }
 
-   multimap < int, string > ::reverse_iterator it = contar.rbegin();
+   int ncontar = contar.size() < 100 ? contar.size() : 100;
+   partial_sort(contar.begin(), contar.begin() + ncontar, contar.end());
    
-   for (int j = 0;j < 100; j++)
+   for (int j = 0;j < ncontar; j++)
    {
-      cout << setw(23) << it->second << " - " << it->first << endl;
-      it++;
+      cout << setw(23) << contar[j].second << " - " << -contar[j].first << endl;
    }
    
    return 0;
@@ -10,6 +10,7 @@
 #define node_h
 #include <cassert>
 #include <iostream>
+#include "pool.h"
 using namespace std;
 /*************************************************************************
  *  NODE: A node can be use as a linked list
@@ -21,6 +22,16 @@ public:
     Node(): data(0), pNext(NULL) {}
     Node(T newData):data(newData), pNext(NULL) {}
     
+    // nodes come from the slab pool rather than the general heap
+    static void * operator new(size_t size)
+    {
+        return NodePool <sizeof(Node <T>)> :: allocate();
+    }
+    static void operator delete(void * p)
+    {
+        NodePool <sizeof(Node <T>)> :: release(p);
+    }
+    
     T data;
     Node * pNext;
     
@@ -121,15 +132,86 @@ ostream &operator << ( ostream &out, Node<T> * & rhs)
  *  Release all the memory contained in a given linked-list. The one
  *  parameter is a pass-by-reference pointer to the head of the list.
  *  Once the memory is freed this function should set the parameter
- *  to NULL. This should be a non-member function.
+ *  to NULL. The nodes go back to the pool in batches.
  ************************************************************************/
 template<class T>
 void freeData(Node<T> * &  pHead)
 {
-    if(pHead == NULL)
-        return;
-    freeData(pHead->pNext);
-    delete pHead;
+    typename NodePool <sizeof(Node <T>)> :: Chain chain;
+    for (Node<T> * p = pHead; p; )
+    {
+        Node<T> * pNext = p->pNext;
+        p->~Node();
+        chain.add(p);
+        p = pNext;
+    }
+    chain.release();
     pHead = NULL;
 }
+/*************************************************************************
+ * MERGE LISTS:
+ * Merge two sorted linked-lists into one by relinking their nodes.
+ * When two items compare equal the one from pLeft goes first, which
+ * keeps the sort below stable.
+ ************************************************************************/
+template<class T>
+Node<T> * mergeLists(Node<T> * pLeft, Node<T> * pRight)
+{
+    Node<T> * pHead = NULL;
+    Node<T> ** ppTail = &pHead;
+    
+    while (pLeft != NULL && pRight != NULL)
+    {
+        if (pRight->data < pLeft->data)
+        {
+            *ppTail = pRight;
+            pRight = pRight->pNext;
+        }
+        else
+        {
+            *ppTail = pLeft;
+            pLeft = pLeft->pNext;
+        }
+        ppTail = &(*ppTail)->pNext;
+    }
+    *ppTail = (pLeft != NULL) ? pLeft : pRight;
+    return pHead;
+}
+/*************************************************************************
+ * SORT LIST:
+ * Sort a linked-list in place with a bottom-up merge sort. Nodes are
+ * only relinked, never copied or allocated. bins[i] holds a sorted run
+ * of 2^i nodes, so 64 of them cover any list we could ever build.
+ * O(n log n) and stable.
+ ************************************************************************/
+template<class T>
+void sortList(Node<T> * & pHead)
+{
+    Node<T> * bins[64] = { NULL };
+    int numBins = 0;
+    
+    while (pHead != NULL)
+    {
+        // detach the next node as a run of one
+        Node<T> * pRun = pHead;
+        pHead = pHead->pNext;
+        pRun->pNext = NULL;
+        
+        // carry it up through the bins like adding one to a counter
+        int i = 0;
+        for (; i < numBins && bins[i] != NULL; i++)
+        {
+            pRun = mergeLists(bins[i], pRun);
+            bins[i] = NULL;
+        }
+        if (i == numBins)
+            numBins++;
+        bins[i] = pRun;
+    }
+    
+    // the higher bins hold the earlier items
+    for (int i = 0; i < numBins; i++)
+        if (bins[i] != NULL)
+            pHead = mergeLists(bins[i], pHead);
+}
 #endif /* node_h */
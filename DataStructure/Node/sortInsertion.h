@@ -15,47 +15,29 @@
 
 /***********************************************
  * INSERTION SORT
- * Sort the items in the array
+ * Sort the items in the array. The items are
+ * put on a linked list in array order, which is
+ * then merge sorted in place and copied back.
+ * O(n log n) and stable.
  **********************************************/
 template <class T>
 void sortInsertion(T array[], int num)
 {
+    if (num <= 0)
+        return;
     
-  
-    Node <T> *pCurrent = NULL;
-    Node <T> *pTemp = NULL;
-    Node <T> *pTemp2 = NULL;
-    pCurrent = insert(array[0], pCurrent);
-    int index = 0;
+    Node <T> *pHead = NULL;
+    Node <T> *pTail = insert(array[0], pHead);
+    for (int index = 1; index < num; index++)
+        pTail = insert(array[index], pTail);
     
-    for(int index = 1; index < num; index++)
-    {
-        
-        insert(array[index],pCurrent);
-        
-       // exit = false;
-        T temp;
-        
-        for (pTemp = pCurrent; pTemp!=NULL; pTemp = pTemp->pNext)
-        {
-            for (pTemp2 = pTemp->pNext; pTemp2!=NULL; pTemp2 = pTemp2->pNext)
-            {
-                
-            if(pTemp->data > pTemp2->data)
-            {
-               // pCurrent = pCurrent->pNext;
-                temp = pTemp->data;
-                pTemp->data = pTemp2->data;
-                pTemp2->data = temp;
-            }
-        }
-    }
-
-    }
-    for (Node<T> * p = pCurrent; p; p = p->pNext)
+    sortList(pHead);
+    
+    int index = 0;
+    for (Node<T> * p = pHead; p; p = p->pNext)
         array[index++] = p->data;
     
+    freeData(pHead);
 }
 
 #endif // INSERTION_SORT_H
-
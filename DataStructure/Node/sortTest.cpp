@@ -0,0 +1,120 @@
+/***********************************************************************
+ * Program:
+ *    SORT TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks sortList() and sortInsertion() against std::stable_sort on
+ *    empty, one-item, short, random, sorted and reverse input, with
+ *    many equal keys so that stability shows. Exits 1 on the first
+ *    failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for STABLE_SORT and REVERSE
+#include <cstdlib>         // for EXIT
+#include <random>          // for MT19937
+#include <vector>
+#include "node.h"
+#include "sortInsertion.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * ITEM
+ * Sorted by key alone; seq tells equal keys apart
+ ***********************************************************************/
+struct Item
+{
+   int key;
+   int seq;
+   bool operator <  (const Item & rhs) const { return key < rhs.key; }
+   bool operator == (const Item & rhs) const
+   {
+      return key == rhs.key && seq == rhs.seq;
+   }
+};
+
+/**********************************************************************
+ * SORTS LIKE
+ * Sort a linked list of the keys, and an array of them, and compare
+ * each with std::stable_sort
+ ***********************************************************************/
+void sortsLike(const vector <int> & keys)
+{
+   vector <Item> items;
+   Node <Item> * pHead = NULL;
+   Node <Item> * pTail = NULL;
+   for (int i = 0; i < keys.size(); i++)
+   {
+      Item item = { keys[i], i };
+      items.push_back(item);
+      pTail = insert(item, pTail == NULL ? pHead : pTail);
+   }
+   vector <Item> array(items);
+   sortList(pHead);
+   stable_sort(items.begin(), items.end());
+
+   int i = 0;
+   for (Node <Item> * p = pHead; p != NULL; p = p->pNext)
+   {
+      CHECK(i < items.size());
+      CHECK(p->data == items[i]);
+      i++;
+   }
+   CHECK(i == items.size());
+   freeData(pHead);
+   CHECK(pHead == NULL);
+
+   if (!array.empty())
+      sortInsertion(&array[0], array.size());
+   CHECK(array == items);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   mt19937 random(29);
+
+   // the edges
+   sortsLike(vector <int> ());
+   sortsLike(vector <int> (1, 5));
+   for (int n = 2; n <= 9; n++)
+      for (int trial = 0; trial < 50; trial++)
+      {
+         vector <int> keys;
+         for (int i = 0; i < n; i++)
+            keys.push_back(random() % 3);
+         sortsLike(keys);
+      }
+
+   // random with few and with many distinct keys, then sorted, reverse
+   // and all equal, around powers of two where the runs meet
+   const int sizes[] = { 255, 256, 257, 1000, 65537 };
+   for (int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+   {
+      vector <int> keys;
+      for (int i = 0; i < sizes[s]; i++)
+         keys.push_back(random() % 10);
+      sortsLike(keys);
+      for (int i = 0; i < sizes[s]; i++)
+         keys[i] = random();
+      sortsLike(keys);
+      sort(keys.begin(), keys.end());
+      sortsLike(keys);
+      reverse(keys.begin(), keys.end());
+      sortsLike(keys);
+      sortsLike(vector <int> (sizes[s], 7));
+   }
+
+   cout << "Sort tests passed\n";
+   return 0;
+}
@@ -0,0 +1,122 @@
+//
+//  bitSet.h
+//  W5_Set
+//
+//  Created by Daniel Guzman.
+//
+
+#ifndef bit_set_h
+#define bit_set_h
+
+#include <cassert>
+
+/*****************************************
+ * BIT SET
+ * Membership of the numbers 0 .. N-1 as one bit each, packed into
+ * 64-bit words. Adding, removing and testing a number is a single
+ * bit operation; union, intersection and difference are one word
+ * operation per 64 numbers, and size is a popcount per word.
+ ****************************************/
+template <int N>
+class BitSet
+{
+public:
+    static const int NUM_WORDS = (N + 63) / 64;
+
+    BitSet() { clear(); }
+
+    // one number at a time
+    bool test(int i)  const { assert(0 <= i && i < N); return (words[i >> 6] >> (i & 63)) & 1; }
+    void set(int i)         { assert(0 <= i && i < N); words[i >> 6] |=   1ULL << (i & 63);  }
+    void reset(int i)       { assert(0 <= i && i < N); words[i >> 6] &= ~(1ULL << (i & 63)); }
+
+    // the whole set
+    void clear()
+    {
+        for (int w = 0; w < NUM_WORDS; w++)
+            words[w] = 0;
+    }
+    int count() const
+    {
+        int num = 0;
+        for (int w = 0; w < NUM_WORDS; w++)
+            num += __builtin_popcountll(words[w]);
+        return num;
+    }
+    bool none() const
+    {
+        for (int w = 0; w < NUM_WORDS; w++)
+            if (words[w])
+                return false;
+        return true;
+    }
+
+    // the first member at or after i, or N if there is none
+    int next(int i) const
+    {
+        if (i >= N)
+            return N;
+        int w = i >> 6;
+        unsigned long long bits = words[w] & (~0ULL << (i & 63));
+        while (bits == 0)
+        {
+            if (++w == NUM_WORDS)
+                return N;
+            bits = words[w];
+        }
+        return (w << 6) + __builtin_ctzll(bits);
+    }
+
+    // the last member at or before i, or -1 if there is none
+    int previous(int i) const
+    {
+        if (i < 0)
+            return -1;
+        int w = i >> 6;
+        unsigned long long bits = words[w] & (~0ULL >> (63 - (i & 63)));
+        while (bits == 0)
+        {
+            if (--w < 0)
+                return -1;
+            bits = words[w];
+        }
+        return (w << 6) + 63 - __builtin_clzll(bits);
+    }
+
+    // union, intersection and difference
+    BitSet <N> operator | (const BitSet <N> & rhs) const
+    {
+        BitSet <N> result;
+        for (int w = 0; w < NUM_WORDS; w++)
+            result.words[w] = words[w] | rhs.words[w];
+        return result;
+    }
+    BitSet <N> operator & (const BitSet <N> & rhs) const
+    {
+        BitSet <N> result;
+        for (int w = 0; w < NUM_WORDS; w++)
+            result.words[w] = words[w] & rhs.words[w];
+        return result;
+    }
+    BitSet <N> operator - (const BitSet <N> & rhs) const
+    {
+        BitSet <N> result;
+        for (int w = 0; w < NUM_WORDS; w++)
+            result.words[w] = words[w] & ~rhs.words[w];
+        return result;
+    }
+
+    bool operator == (const BitSet <N> & rhs) const
+    {
+        for (int w = 0; w < NUM_WORDS; w++)
+            if (words[w] != rhs.words[w])
+                return false;
+        return true;
+    }
+    bool operator != (const BitSet <N> & rhs) const { return !(*this == rhs); }
+
+private:
+    unsigned long long words[NUM_WORDS];
+};
+
+#endif /* bit_set_h */
@@ -30,9 +30,14 @@ class Card
    Card()                  : value(INVALID)   { assert(validate()); }
    Card(const Card & rhs)  : value(rhs.value) { assert(validate()); }
    Card(const char * rhs)  : value(INVALID)   { *this = rhs;        }
+   explicit Card(int index) : value(index)    { assert(validate()); }
 
    bool isInvalid() const { return value == INVALID; }
 
+   // the internal value, 0 .. NUM_INDICES - 1, so sets of cards can be bits
+   enum { NUM_INDICES = 256 };
+   int getIndex() const { return value; }
+
    // insertion and extraction operators
    friend std::ostream & operator << (std::ostream & out, const Card & card);
    friend std::istream & operator >> (std::istream & in,        Card & card);
@@ -58,4 +63,8 @@ class Card
    bool validate() const;              // are we in a valid state?
 };
 
+// Set <Card> is specialized as a bit set. Every file that can see Card
+// must see that too, or it would build the general Set <Card> instead
+#include "cardSet.h"
+
 #endif // CARD_H
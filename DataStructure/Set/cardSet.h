@@ -0,0 +1,195 @@
+//
+//  cardSet.h
+//  W5_Set
+//
+//  Created by Daniel Guzman.
+//
+
+#ifndef card_set_h
+#define card_set_h
+
+#include "set.h"
+#include "bitSet.h"
+#include "card.h"          // which includes this once Card is complete
+
+/*****************************************
+ * SET <CARD>
+ * A Card is a single byte, so a Set of them needs only 256 bits:
+ * one per possible card. This has the same interface as Set <T>, but
+ * insert, find and erase are O(1) bit operations, union, intersection
+ * and difference are four word operations, and size is a popcount.
+ * Iteration still visits the cards in order.
+ ****************************************/
+template <>
+class Set <Card>
+{
+public:
+    // constructors and destructors. There is never anything to allocate
+    Set() {}
+    Set(int numCapacity) {}
+    template <class Iterator>
+    Set(Iterator first, Iterator last) { insert(first, last); }
+
+    //union, intersection, and difference, each a new Set
+    Set <Card> operator || (const Set <Card> & rhs) const { return Set <Card> (bits | rhs.bits); }
+    Set <Card> operator && (const Set <Card> & rhs) const { return Set <Card> (bits & rhs.bits); }
+    Set <Card> operator -  (const Set <Card> & rhs) const { return Set <Card> (bits - rhs.bits); }
+
+    // standard container interfaces
+    int  size() const  { return bits.count(); }
+    bool empty() const { return bits.none();  }
+    void clear()       { bits.clear();        }
+
+    // the various iterator interfaces
+    class iterator;
+    class const_iterator;
+    iterator begin();
+    iterator end();
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    iterator find(const Card & t);
+
+    //typical Set methods
+    void insert(const Card & t) { bits.set(t.getIndex()); }
+    void erase(iterator & it);
+
+    // batch methods
+    template <class Iterator>
+    void insert(Iterator first, Iterator last)
+    {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+    template <class Predicate>
+    int eraseIf(Predicate pred)
+    {
+        int numErased = 0;
+        for (int i = bits.next(0); i < Card::NUM_INDICES; i = bits.next(i + 1))
+            if (pred(Card(i)))
+            {
+                bits.reset(i);
+                numErased++;
+            }
+        return numErased;
+    }
+
+    Set <Card> unions(const Set <Card> & rhs) const       { return *this || rhs; }
+    Set <Card> intersection(const Set <Card> & rhs) const { return *this && rhs; }
+    Set <Card> difference(const Set <Card> & rhs) const   { return *this - rhs;  }
+    int capacity() const { return Card::NUM_INDICES; }
+
+private:
+    typedef BitSet <Card::NUM_INDICES> Bits;
+    explicit Set(const Bits & bits) : bits(bits) {}
+
+    Bits bits;
+};
+
+/**************************************************
+ * SET <CARD> ITERATOR
+ * Walks the set bits. There is no Card stored to
+ * refer to, so dereferencing gives a copy
+ *************************************************/
+class Set <Card> :: iterator
+{
+public:
+    // constructors, destructors, and assignment operator
+    iterator() : pBits(NULL), i(Card::NUM_INDICES) {}
+    iterator(const Bits * pBits, int i) : pBits(pBits), i(i) {}
+
+    // equals, not equals operator
+    bool operator != (const iterator & rhs) const { return rhs.i != this->i; }
+    bool operator == (const iterator & rhs) const { return rhs.i == this->i; }
+
+    // dereference operator
+    Card operator * () const
+    {
+        if (pBits)
+            return Card(i);
+        else
+            throw "ERROR: Trying to dereference a NULL pointer";
+    }
+
+    // prefix and postfix increment
+    iterator & operator ++ ()
+    {
+        i = pBits->next(i + 1);
+        return *this;
+    }
+    iterator operator ++ (int postfix)
+    {
+        iterator tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+
+    // prefix and postfix decrement
+    iterator & operator -- ()
+    {
+        i = pBits->previous(i - 1);
+        return *this;
+    }
+    iterator operator -- (int postfix)
+    {
+        iterator tmp(*this);
+        --(*this);
+        return tmp;
+    }
+
+private:
+    friend class Set <Card>;
+    const Bits * pBits;
+    int i;
+};
+
+/**************************************************
+ * SET <CARD> CONSTANT ITERATOR
+ * Since the iterator already hands out copies, the
+ * two only differ in name
+ *************************************************/
+class Set <Card> :: const_iterator : public Set <Card> :: iterator
+{
+public:
+    const_iterator() {}
+    const_iterator(const iterator & rhs) : iterator(rhs) {}
+};
+
+/***************************************
+ * SET <CARD> :: begin, end, find
+ **************************************/
+inline Set <Card> :: iterator Set <Card> :: begin()
+{
+    return iterator(&bits, bits.next(0));
+}
+
+inline Set <Card> :: iterator Set <Card> :: end()
+{
+    return iterator(&bits, Card::NUM_INDICES);
+}
+
+inline Set <Card> :: const_iterator Set <Card> :: cbegin() const
+{
+    return iterator(&bits, bits.next(0));
+}
+
+inline Set <Card> :: const_iterator Set <Card> :: cend() const
+{
+    return iterator(&bits, Card::NUM_INDICES);
+}
+
+inline Set <Card> :: iterator Set <Card> :: find(const Card & t)
+{
+    return bits.test(t.getIndex()) ? iterator(&bits, t.getIndex()) : end();
+}
+
+/***************************************
+ * SET <CARD> :: erase
+ * Remove the card the iterator refers to
+ **************************************/
+inline void Set <Card> :: erase(iterator & it)
+{
+    if (it.i < Card::NUM_INDICES)
+        bits.reset(it.i);
+}
+
+#endif /* card_set_h */
@@ -0,0 +1,272 @@
+/***********************************************************************
+ * Program:
+ *    CARD SET TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks BitSet at sizes either side of a 64-bit word, and Set <Card>
+ *    built on it, against std::set after every step of a long run of
+ *    random changes. Only card.h is included, as goFish.cpp would, to
+ *    check that it brings the Set <Card> specialization with it. Exits
+ *    1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT
+#include <random>          // for MT19937
+#include <set>
+#include <vector>
+#include "card.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+// the cards with a name; the asserts in Card refuse the rest
+const int NUM_CARDS = INDEX_LAST + 1;
+
+/**********************************************************************
+ * BITS MATCH
+ * The BitSet holds exactly the numbers in expected, by test(), count(),
+ * none(), and next() and previous() from every place
+ ***********************************************************************/
+template <int N>
+bool bitsMatch(const BitSet <N> & bits, const std::set <int> & expected)
+{
+   if (bits.count() != (int)expected.size() || bits.none() != expected.empty())
+      return false;
+   for (int i = 0; i < N; i++)
+      if (bits.test(i) != (expected.count(i) == 1))
+         return false;
+   for (int i = -1; i <= N; i++)
+   {
+      std::set <int> :: const_iterator after = expected.lower_bound(i);
+      if (bits.next(i < 0 ? 0 : i) != (after == expected.end() ? N : *after))
+         return false;
+      std::set <int> :: const_iterator upTo = expected.upper_bound(i);
+      int before = (upTo == expected.begin()) ? -1 : *--upTo;
+      if (bits.previous(i >= N ? N - 1 : i) != before)
+         return false;
+   }
+   return true;
+}
+
+/**********************************************************************
+ * BIT SETS
+ * Random sets and resets, checked after each, then the set algebra
+ * against std::set_* on what is left
+ ***********************************************************************/
+template <int N>
+void bitSets(mt19937 & random)
+{
+   for (int trial = 0; trial < 20; trial++)
+   {
+      BitSet <N> a;
+      BitSet <N> b;
+      std::set <int> expectedA;
+      std::set <int> expectedB;
+      CHECK(bitsMatch(a, expectedA));
+      for (int step = 0; step < 3 * N; step++)
+      {
+         int i = random() % N;
+         if (random() % 3)
+         {
+            a.set(i);
+            expectedA.insert(i);
+         }
+         else
+         {
+            a.reset(i);
+            expectedA.erase(i);
+         }
+         i = random() % N;
+         b.set(i);
+         expectedB.insert(i);
+      }
+      CHECK(bitsMatch(a, expectedA));
+      CHECK(bitsMatch(b, expectedB));
+
+      std::set <int> both;
+      std::set <int> either(expectedA);
+      std::set <int> onlyA;
+      either.insert(expectedB.begin(), expectedB.end());
+      for (std::set <int> :: iterator it = expectedA.begin();
+           it != expectedA.end(); ++it)
+         if (expectedB.count(*it))
+            both.insert(*it);
+         else
+            onlyA.insert(*it);
+      CHECK(bitsMatch(a | b, either));
+      CHECK(bitsMatch(a & b, both));
+      CHECK(bitsMatch(a - b, onlyA));
+      CHECK(bitsMatch(b - b, std::set <int> ()));
+
+      BitSet <N> copy(a);
+      CHECK(copy == a);
+      CHECK(!(copy != a));
+      copy.set(N - 1);
+      CHECK((copy == a) == a.test(N - 1));
+      copy.reset(N - 1);
+      CHECK((copy != a) == a.test(N - 1));
+      a.clear();
+      CHECK(bitsMatch(a, std::set <int> ()));
+   }
+}
+
+/**********************************************************************
+ * CARDS MATCH
+ * The Set <Card> holds exactly the cards in expected, in order both
+ * ways, through both iterators and find()
+ ***********************************************************************/
+bool cardsMatch(Set <Card> & hand, const std::set <int> & expected)
+{
+   if (hand.size() != (int)expected.size() || hand.empty() != expected.empty())
+      return false;
+
+   std::set <int> :: const_iterator itExpected = expected.begin();
+   for (Set <Card> :: iterator it = hand.begin(); it != hand.end(); it++)
+      if ((*it).getIndex() != *itExpected++)
+         return false;
+   itExpected = expected.begin();
+   for (Set <Card> :: const_iterator it = hand.cbegin(); it != hand.cend(); ++it)
+      if ((*it).getIndex() != *itExpected++)
+         return false;
+
+   // backwards from the end
+   Set <Card> :: iterator it = hand.end();
+   for (std::set <int> :: const_reverse_iterator rit = expected.rbegin();
+        rit != expected.rend(); ++rit)
+      if ((*--it).getIndex() != *rit)
+         return false;
+
+   for (int i = 0; i < NUM_CARDS; i++)
+   {
+      Set <Card> :: iterator found = hand.find(Card(i));
+      if ((found != hand.end()) != (expected.count(i) == 1))
+         return false;
+      if (found != hand.end() && (*found).getIndex() != i)
+         return false;
+   }
+   return true;
+}
+
+/**********************************************************************
+ * IS SHARK
+ * A predicate for eraseIf
+ ***********************************************************************/
+bool isShark(const Card & card) { return card.getIndex() == INDEX_LAST; }
+
+/**********************************************************************
+ * CARD SETS
+ * A game's worth of inserts and erases, then each batch method and
+ * the set algebra
+ ***********************************************************************/
+void cardSets(mt19937 & random)
+{
+   // the specialization, not the general Set: nothing allocated
+   Set <Card> hand;
+   CHECK(hand.capacity() == Card::NUM_INDICES);
+   CHECK(sizeof(Set <Card>) == Card::NUM_INDICES / 8);
+
+   std::set <int> expected;
+   CHECK(cardsMatch(hand, expected));
+   for (int step = 0; step < 10000; step++)
+   {
+      int i = random() % NUM_CARDS;
+      if (random() % 2)
+      {
+         hand.insert(Card(i));
+         expected.insert(i);
+      }
+      else
+      {
+         Set <Card> :: iterator it = hand.find(Card(i));
+         if (it != hand.end())
+            hand.erase(it);
+         expected.erase(i);
+      }
+      CHECK(cardsMatch(hand, expected));
+   }
+
+   // a range of cards, with repeats, into a new Set and an old one
+   vector <Card> deal;
+   for (int i = 0; i < 20; i++)
+      deal.push_back(Card((int)(random() % NUM_CARDS)));
+   Set <Card> dealt(deal.begin(), deal.end());
+   std::set <int> expectedDealt;
+   for (int i = 0; i < deal.size(); i++)
+      expectedDealt.insert(deal[i].getIndex());
+   CHECK(cardsMatch(dealt, expectedDealt));
+   hand.insert(deal.begin(), deal.end());
+   expected.insert(expectedDealt.begin(), expectedDealt.end());
+   CHECK(cardsMatch(hand, expected));
+
+   // the algebra, on every pair of hands of the first four cards
+   for (int maskA = 0; maskA < 16; maskA++)
+      for (int maskB = 0; maskB < 16; maskB++)
+      {
+         Set <Card> a;
+         Set <Card> b;
+         std::set <int> either;
+         std::set <int> both;
+         std::set <int> onlyA;
+         for (int i = 0; i < 4; i++)
+         {
+            bool inA = (maskA >> i) & 1;
+            bool inB = (maskB >> i) & 1;
+            if (inA)
+               a.insert(Card(i + 1));
+            if (inB)
+               b.insert(Card(i + 1));
+            if (inA || inB)
+               either.insert(i + 1);
+            if (inA && inB)
+               both.insert(i + 1);
+            if (inA && !inB)
+               onlyA.insert(i + 1);
+         }
+         Set <Card> result = a || b;
+         CHECK(cardsMatch(result, either));
+         result = a.unions(b);
+         CHECK(cardsMatch(result, either));
+         result = a && b;
+         CHECK(cardsMatch(result, both));
+         result = a.intersection(b);
+         CHECK(cardsMatch(result, both));
+         result = a - b;
+         CHECK(cardsMatch(result, onlyA));
+         result = a.difference(b);
+         CHECK(cardsMatch(result, onlyA));
+      }
+
+   // eraseIf counts what it takes, and clear takes the rest
+   hand.insert(Card(INDEX_LAST));
+   expected.insert(INDEX_LAST);
+   CHECK(hand.eraseIf(isShark) == 1);
+   expected.erase(INDEX_LAST);
+   CHECK(cardsMatch(hand, expected));
+   CHECK(hand.eraseIf(isShark) == 0);
+   hand.clear();
+   CHECK(cardsMatch(hand, std::set <int> ()));
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   mt19937 random(39);
+   bitSets <1> (random);
+   bitSets <63> (random);
+   bitSets <64> (random);
+   bitSets <65> (random);
+   bitSets <130> (random);
+   bitSets <256> (random);
+   cardSets(random);
+   cout << "Card set tests passed\n";
+   return 0;
+}
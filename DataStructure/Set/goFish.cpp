@@ -13,16 +13,75 @@
 ************************************************************************/
 
 #include <iostream>
+#include <fstream>
 #include "set.h"
 #include "card.h"
+#include "cardSet.h"
 #include "goFish.h"
 using namespace std;
 
+#define HAND_FILE "/home/cs235e/week05/hand.txt"
+#define NUM_ROUNDS 5
+
+/**********************************************************************
+ * READ HAND
+ * Fill the hand with the cards listed in the file
+ ***********************************************************************/
+bool readHand(Set <Card> & hand)
+{
+   ifstream fin(HAND_FILE);
+   if (fin.fail())
+      return false;
+
+   Card card;
+   while (fin >> card)
+      hand.insert(card);
+   fin.close();
+   return true;
+}
+
 /**********************************************************************
  * GO FISH
- * The function which starts it all
+ * The function which starts it all. The hand is a Set <Card>, so
+ * every guess is a single bit test
  ***********************************************************************/
 void goFish()
 {
-   return ;
+   Set <Card> hand;
+   if (!readHand(hand))
+   {
+      cout << "Unable to open file " << HAND_FILE << endl;
+      return;
+   }
+
+   cout << "We will play " << NUM_ROUNDS << " rounds of Go Fish.  "
+        << "Guess the card in the hand\n";
+
+   int numMatches = 0;
+   for (int round = 1; round <= NUM_ROUNDS; round++)
+   {
+      Card guess;
+      cout << "round " << round << ": ";
+      cin  >> guess;
+
+      Set <Card> :: iterator it = hand.find(guess);
+      if (it != hand.end())
+      {
+         cout << "\tYou got a match!\n";
+         hand.erase(it);
+         numMatches++;
+      }
+      else
+         cout << "\tGo Fish!\n";
+   }
+
+   cout << "You have " << numMatches << " matches!\n";
+   cout << "The remaining cards: ";
+   for (Set <Card> :: iterator it = hand.begin(); it != hand.end(); ++it)
+   {
+      if (it != hand.begin())
+         cout << ", ";
+      cout << *it;
+   }
+   cout << endl;
 }
@@ -9,6 +9,10 @@
 #ifndef set_h
 #define set_h
 #include <cassert>
+#include <algorithm>   // for SORT
+#include <string>
+#include <vector>      // for VECTOR
+#include "setAlgebra.h"
 /*****************************************
  * Set
  * Just like the std :: Set <T> class
@@ -21,15 +25,17 @@ public:
     Set() : data(NULL), numElements(0), numCapacity(0){}
     Set(int numCapacity) throw (const char *);
     Set(const Set <T> & rhs) throw (const char *);
+    template <class Iterator>
+    Set(Iterator first, Iterator last) throw (const char *);
     ~Set();
     
     //assignment operator
     Set <T> & operator = (const Set <T> & rhs) throw (const char *);
     
-    //union, difference, and intersection
-    Set <T> & operator || (const Set <T> & rhs) throw (const char *);
-    Set <T> & operator &&(const Set <T> & rhs) throw (const char *);
-    Set <T> & operator -(const Set <T> & rhs) throw (const char *);
+    //union, intersection, and difference, each a new Set
+    Set <T> operator || (const Set <T> & rhs) const throw (const char *);
+    Set <T> operator && (const Set <T> & rhs) const throw (const char *);
+    Set <T> operator -  (const Set <T> & rhs) const throw (const char *);
     
     // standard container interfaces
     int  size() const { return numElements;}
@@ -48,11 +54,25 @@ public:
     //typical Set methods
     void insert(const T & t) throw (const char *);
     void erase(iterator & it) throw (const char *);
-    Set <T> & unions(const Set <T> & rhs);
-    Set <T> & intersection(const Set <T> & rhs);
-    Set <T> & difference(const Set <T> & rhs);
+    
+    // batch methods: one sort of the batch and one pass over the Set
+    template <class Iterator>
+    void insert(Iterator first, Iterator last) throw (const char *);
+    template <class Predicate>
+    int eraseIf(Predicate pred);
+    Set <T> unions(const Set <T> & rhs) const       { return *this || rhs; }
+    Set <T> intersection(const Set <T> & rhs) const { return *this && rhs; }
+    Set <T> difference(const Set <T> & rhs) const   { return *this - rhs;  }
     int capacity() { return numCapacity; }
     
+    // snapshots need POSIX, so they are in setSnapshot.h
+    template <class U>
+    friend void snapshot(const Set <U> & s, const std::string & fileName)
+        throw (const char *);
+    template <class U>
+    friend void restore(Set <U> & s, const std::string & fileName)
+        throw (const char *);
+    
 private:
     T *  data;                 // user data, a dynamically-allocated array
     int  numCapacity;          // the capacity of the array
@@ -107,13 +127,25 @@ Set <T> :: Set (const Set <T> & rhs) throw (const char *) : data(NULL), numEleme
         *this = rhs; // call the assignment operator
 }
 
+/*****************************************
+ * RANGE CONSTRUCTOR
+ * Build the Set from the items in [first, last),
+ * which need not be sorted or distinct
+ ****************************************/
+template <class T>
+template <class Iterator>
+Set <T> :: Set (Iterator first, Iterator last) throw (const char *) : data(NULL), numElements(0), numCapacity(0)
+{
+    insert(first, last);
+}
+
 /*****************************************
  * DESTRUCTOR
  ****************************************/
 template <class T>
 Set <T> :: ~Set()
 {
-    if (size() != 0)
+    if (NULL != data)
         delete [] data;
 }
 
@@ -395,17 +427,107 @@ void Set <T> :: insert(const T &t) throw(const char *)
                 }
     
     int iInsert = findIndex(t);
-    if(data[iInsert] != t)
+    if(iInsert == numElements || data[iInsert] != t)
     {
-        for(int i = numElements; i >= iInsert; i--)
+        for(int i = numElements; i > iInsert; i--)
         {
-            data[i + 1] = data[i];
+            data[i] = data[i - 1];
         }
         data[iInsert] = t;
         numElements++;
     }
 }
 
+/***************************************
+ * Set :: insert (batch)
+ * Insert every item in [first, last). Inserting
+ * them one at a time shifts the tail each time,
+ * O(n) per item. Instead the batch is sorted and
+ * its duplicates dropped, then merged with the
+ * Set into a new buffer in a single pass:
+ * O(m log m + n) for m items into a Set of n
+ **************************************/
+template <class T>
+template <class Iterator>
+void Set <T> :: insert(Iterator first, Iterator last) throw (const char *)
+{
+    std::vector <T> batch(first, last);
+    if (batch.empty())
+        return;
+    
+    // sort and dedup the batch
+    std::sort(batch.begin(), batch.end());
+    int numBatch = 1;
+    for (int i = 1; i < (int)batch.size(); i++)
+        if (batch[numBatch - 1] < batch[i])
+            batch[numBatch++] = batch[i];
+    
+    int newCapacity = numElements + numBatch;
+    if (newCapacity < numCapacity)
+        newCapacity = numCapacity;
+    T * pNew;
+    try
+    {
+        pNew = new T[newCapacity];
+    }
+    catch (std::bad_alloc)
+    {
+        throw "ERROR: Unable to allocate a new buffer for Set";
+    }
+    
+    // merge, keeping one copy of anything in both
+    int iSet = 0;
+    int iBatch = 0;
+    int iNew = 0;
+    while (iSet < numElements && iBatch < numBatch)
+    {
+        if (data[iSet] < batch[iBatch])
+            pNew[iNew++] = data[iSet++];
+        else if (batch[iBatch] < data[iSet])
+            pNew[iNew++] = batch[iBatch++];
+        else
+        {
+            pNew[iNew++] = data[iSet++];
+            iBatch++;
+        }
+    }
+    while (iSet < numElements)
+        pNew[iNew++] = data[iSet++];
+    while (iBatch < numBatch)
+        pNew[iNew++] = batch[iBatch++];
+    
+    if (NULL != data)
+        delete [] data;
+    data = pNew;
+    numElements = iNew;
+    numCapacity = newCapacity;
+}
+
+/***************************************
+ * Set :: eraseIf
+ * Erase every item for which pred(item) is true
+ * and return how many went. The survivors slide
+ * down in one pass, so the cost is O(n) however
+ * many are erased
+ **************************************/
+template <class T>
+template <class Predicate>
+int Set <T> :: eraseIf(Predicate pred)
+{
+    int iKeep = 0;
+    for (int i = 0; i < numElements; i++)
+        if (!pred(data[i]))
+        {
+            if (iKeep != i)
+                data[iKeep] = data[i];
+            iKeep++;
+        }
+    
+    int numErased = numElements - iKeep;
+    numElements = iKeep;
+    return numErased;
+}
+
 /***************************************
  * Set :: erase
  * Erase an item on the end of the Set.
@@ -425,129 +547,42 @@ void Set <T> :: erase(iterator &it) throw (const char *)
 
 /***************************************
  * Set :: union
+ * Everything in either Set. See setAlgebra.h
+ * for how the two are merged
  **************************************/
 template <class T>
-Set <T> & Set <T> :: operator || (const Set <T> & rhs) throw (const char *)
+Set <T> Set <T> :: operator || (const Set <T> & rhs) const throw (const char *)
 {
-    int iSet1 = 0;
-    int iSet2 = 0;
-    
-    T *pNew;
-    try
-    {
-        pNew = new T[numCapacity + rhs.numCapacity];
-    }
-    catch (std::bad_alloc)
-    {
-        throw "ERROR: Unable to allocate a new buffer for vector";
-    }
-    
-    
-    while(iSet1 < numElements || iSet2 < rhs.numElements)
-    {
-        if(iSet1 == numElements)
-            pNew[iSet1] = rhs.data[iSet2++];
-            else if(iSet2 == rhs.numElements)
-                pNew[iSet2] = data[iSet1++];
-                else if(data[iSet1] == rhs.data[iSet2])
-                {
-                    pNew[iSet1] = data[iSet1];
-                    iSet1++;
-                    iSet2++;
-                }
-                else if(data[iSet1] < data[iSet2])
-                    pNew[iSet1] = data[iSet1++];
-                    else
-                        pNew[iSet2] = rhs.data[iSet2++];
-                        
-                        data = pNew;
-                        //return *this;
-                        }
-    return *this;
+    Set <T> result(numElements + rhs.numElements);
+    result.numElements = setUnion(data, numElements,
+                                  rhs.data, rhs.numElements, result.data);
+    return result;
 }
 
 /***************************************
  * Set :: intersection
+ * Everything in both Sets
  **************************************/
 template <class T>
-Set <T> & Set <T> :: operator &&(const Set <T> & rhs) throw (const char *)
+Set <T> Set <T> :: operator && (const Set <T> & rhs) const throw (const char *)
 {
-    int iSet1 = 0;
-    int iSet2 = 0;
-    
-    T *pNew;
-    try
-    {
-        pNew = new T[numCapacity + rhs.numCapacity];
-    }
-    catch (std::bad_alloc)
-    {
-        throw "ERROR: Unable to allocate a new buffer for vector";
-    }
-    
-    while(iSet1 < numElements || iSet2 < rhs.numElements)
-    {
-        if(iSet1 == numElements)
-            return *this;
-        else if(iSet2 == rhs.numElements)
-            return *this;
-        else if(data[iSet1] == rhs.data[iSet2])
-        {
-            pNew[iSet1] = data[iSet1];
-            iSet1++;
-            iSet2++;
-        }
-        else if(data[iSet1] < data[iSet2])
-            iSet1++;
-        else
-            iSet2++;
-        
-        data = pNew;
-        //return *this;
-    }
-    return *this;
+    Set <T> result(numElements < rhs.numElements ? numElements : rhs.numElements);
+    result.numElements = setIntersection(data, numElements,
+                                         rhs.data, rhs.numElements, result.data);
+    return result;
 }
 
 /*************************************
  * Set :: difference
+ * Everything in this Set but not in rhs
  **************************************/
 template <class T>
-Set <T> & Set <T> :: operator -(const Set <T> & rhs) throw (const char *)
+Set <T> Set <T> :: operator - (const Set <T> & rhs) const throw (const char *)
 {
-    int iSet1 = 0;
-    int iSet2 = 0;
-    
-    T *pNew;
-    try
-    {
-        pNew = new T[numCapacity + rhs.numCapacity];
-    }
-    catch (std::bad_alloc)
-    {
-        throw "ERROR: Unable to allocate a new buffer for vector";
-    }
-    
-    while(iSet1 < numElements || iSet2 < rhs.numElements)
-    {
-        if(iSet1 != numElements)
-            return *this;
-        else if(iSet2 != rhs.numElements)
-            return *this;
-        else if(data[iSet1] != rhs.data[iSet2])
-        {
-            pNew[iSet1] = data[iSet1];
-            iSet1++;
-            iSet2++;
-        }
-        else if(data[iSet1] < data[iSet2])
-            iSet1++;
-        else
-            iSet2++;
-        
-        data = pNew;
-        // return *this;
-    }
-    return *this;
+    Set <T> result(numElements);
+    result.numElements = setDifference(data, numElements,
+                                       rhs.data, rhs.numElements, result.data);
+    return result;
 }
 
 
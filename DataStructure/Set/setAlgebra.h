@@ -0,0 +1,306 @@
+//
+//  setAlgebra.h
+//  W5_Set
+//
+//  Created by Daniel Guzman.
+//
+
+#ifndef set_algebra_h
+#define set_algebra_h
+
+#if defined(__SSE2__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/*****************************************
+ * SET ALGEBRA
+ * Union, intersection and difference of two sorted arrays of distinct
+ * items, written into out in sorted order. Each returns the number of
+ * items written; out needs room for na + nb, min(na, nb) and na items
+ * respectively.
+ *
+ * Arrays of about the same size are merged in one linear pass. When one
+ * is more than GALLOP_RATIO times the size of the other, each item of
+ * the small one is found in the big one by galloping: doubling steps
+ * from the last place found, then a binary search. That costs
+ * O(m log(n / m)) comparisons instead of O(n + m). Intersections of
+ * ints compare whole blocks at a time with SSE2, or AVX2 if the compiler
+ * is allowed to use it.
+ ****************************************/
+
+const int GALLOP_RATIO = 32;
+
+/***************************************
+ * MUCH BIGGER
+ * Is n more than GALLOP_RATIO times m? By
+ * division, since GALLOP_RATIO * m would
+ * overflow an int once m passes 2^26
+ **************************************/
+inline bool muchBigger(int n, int m)
+{
+    return n / GALLOP_RATIO > m;
+}
+
+/***************************************
+ * GALLOP
+ * The first index i in [lo, n) with
+ * !(a[i] < key), or n if there is none
+ **************************************/
+template <class T>
+int gallop(const T * a, int lo, int n, const T & key)
+{
+    if (lo >= n || !(a[lo] < key))
+        return lo;
+
+    // a[lo] < key: double the step until we pass key. The step is
+    // checked against what is left, as lo + step could overflow
+    int step = 1;
+    while (step < n - lo && a[lo + step] < key)
+    {
+        lo += step;
+        step = (step <= (n - lo) / 2) ? step * 2 : n - lo;
+    }
+
+    // a[lo] < key <= a[hi]
+    int hi = (step < n - lo) ? lo + step : n;
+    while (hi - lo > 1)
+    {
+        int mid = lo + (hi - lo) / 2;
+        if (a[mid] < key)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return hi;
+}
+
+/***************************************
+ * SET COPY
+ **************************************/
+template <class T>
+inline int setCopy(const T * a, int na, T * out)
+{
+    for (int i = 0; i < na; i++)
+        out[i] = a[i];
+    return na;
+}
+
+/***************************************
+ * SET UNION
+ **************************************/
+template <class T>
+int setUnion(const T * a, int na, const T * b, int nb, T * out)
+{
+    // gallop through the big one, copying what lies between
+    if (muchBigger(na, nb) || muchBigger(nb, na))
+    {
+        const T * small = (na < nb) ? a : b;
+        const T * big   = (na < nb) ? b : a;
+        int nSmall = (na < nb) ? na : nb;
+        int nBig   = (na < nb) ? nb : na;
+
+        int k = 0;
+        int iBig = 0;
+        for (int i = 0; i < nSmall; i++)
+        {
+            int next = gallop(big, iBig, nBig, small[i]);
+            k += setCopy(big + iBig, next - iBig, out + k);
+            if (next < nBig && !(small[i] < big[next]))
+                next++;
+            out[k++] = small[i];
+            iBig = next;
+        }
+        return k + setCopy(big + iBig, nBig - iBig, out + k);
+    }
+
+    int i = 0;
+    int j = 0;
+    int k = 0;
+    while (i < na && j < nb)
+    {
+        if (a[i] < b[j])
+            out[k++] = a[i++];
+        else if (b[j] < a[i])
+            out[k++] = b[j++];
+        else
+        {
+            out[k++] = a[i++];
+            j++;
+        }
+    }
+    k += setCopy(a + i, na - i, out + k);
+    return k + setCopy(b + j, nb - j, out + k);
+}
+
+/***************************************
+ * SET INTERSECTION
+ **************************************/
+template <class T>
+int setIntersection(const T * a, int na, const T * b, int nb, T * out)
+{
+    // look up each item of the small one in the big one
+    if (muchBigger(na, nb) || muchBigger(nb, na))
+    {
+        const T * small = (na < nb) ? a : b;
+        const T * big   = (na < nb) ? b : a;
+        int nSmall = (na < nb) ? na : nb;
+        int nBig   = (na < nb) ? nb : na;
+
+        int k = 0;
+        int iBig = 0;
+        for (int i = 0; i < nSmall && iBig < nBig; i++)
+        {
+            iBig = gallop(big, iBig, nBig, small[i]);
+            if (iBig < nBig && !(small[i] < big[iBig]))
+            {
+                out[k++] = small[i];
+                iBig++;
+            }
+        }
+        return k;
+    }
+
+    int i = 0;
+    int j = 0;
+    int k = 0;
+    while (i < na && j < nb)
+    {
+        if (a[i] < b[j])
+            i++;
+        else if (b[j] < a[i])
+            j++;
+        else
+        {
+            out[k++] = a[i++];
+            j++;
+        }
+    }
+    return k;
+}
+
+/***************************************
+ * SET INTERSECTION : INT
+ * Compare a block of a against a block of b,
+ * every item against every item, by rotating
+ * b's block through all its positions. The
+ * block whose last item is smaller is used up;
+ * both are when the last items match
+ **************************************/
+inline int setIntersection(const int * a, int na, const int * b, int nb,
+                           int * out)
+{
+    if (muchBigger(na, nb) || muchBigger(nb, na))
+        return setIntersection <int> (a, na, b, nb, out);
+
+    int i = 0;
+    int j = 0;
+    int k = 0;
+
+#ifdef __AVX2__
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    while (i + 8 <= na && j + 8 <= nb)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + j));
+        __m256i match = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; r++)
+        {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            match = _mm256_or_si256(match, _mm256_cmpeq_epi32(va, vb));
+        }
+
+        for (int mask = _mm256_movemask_ps(_mm256_castsi256_ps(match));
+             mask; mask &= mask - 1)
+            out[k++] = a[i + __builtin_ctz(mask)];
+
+        int lastA = a[i + 7];
+        int lastB = b[j + 7];
+        if (lastA <= lastB)
+            i += 8;
+        if (lastB <= lastA)
+            j += 8;
+    }
+#endif // __AVX2__
+
+#ifdef __SSE2__
+    while (i + 4 <= na && j + 4 <= nb)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+        __m128i match = _mm_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 4; r++)
+        {
+            vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+            match = _mm_or_si128(match, _mm_cmpeq_epi32(va, vb));
+        }
+
+        for (int mask = _mm_movemask_ps(_mm_castsi128_ps(match));
+             mask; mask &= mask - 1)
+            out[k++] = a[i + __builtin_ctz(mask)];
+
+        int lastA = a[i + 3];
+        int lastB = b[j + 3];
+        if (lastA <= lastB)
+            i += 4;
+        if (lastB <= lastA)
+            j += 4;
+    }
+#endif // __SSE2__
+
+    // whatever is left over, a pair at a time
+    return k + setIntersection <int> (a + i, na - i, b + j, nb - j, out + k);
+}
+
+/***************************************
+ * SET DIFFERENCE
+ * Everything in a that is not in b
+ **************************************/
+template <class T>
+int setDifference(const T * a, int na, const T * b, int nb, T * out)
+{
+    int i = 0;
+    int j = 0;
+    int k = 0;
+
+    // few items to take away: copy the stretches between them
+    if (muchBigger(na, nb))
+    {
+        for (; j < nb; j++)
+        {
+            int next = gallop(a, i, na, b[j]);
+            k += setCopy(a + i, next - i, out + k);
+            if (next < na && !(b[j] < a[next]))
+                next++;
+            i = next;
+        }
+        return k + setCopy(a + i, na - i, out + k);
+    }
+
+    // few items to keep: look each one up
+    if (muchBigger(nb, na))
+    {
+        for (; i < na; i++)
+        {
+            j = gallop(b, j, nb, a[i]);
+            if (j == nb || a[i] < b[j])
+                out[k++] = a[i];
+        }
+        return k;
+    }
+
+    while (i < na && j < nb)
+    {
+        if (a[i] < b[j])
+            out[k++] = a[i++];
+        else if (b[j] < a[i])
+            j++;
+        else
+        {
+            i++;
+            j++;
+        }
+    }
+    return k + setCopy(a + i, na - i, out + k);
+}
+
+#endif /* set_algebra_h */
@@ -0,0 +1,259 @@
+/***********************************************************************
+ * Program:
+ *    SET ALGEBRA TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks setUnion, setIntersection and setDifference against
+ *    std::set_union, std::set_intersection and std::set_difference on
+ *    sorted arrays whose sizes run from equal to 10,000 to 1, either
+ *    side of GALLOP_RATIO, so the merges, the galloping and the blocks
+ *    of ints compared at once are all used. Also gallop() on its own.
+ *    Built once as it is and once with -mavx2 for the AVX2 blocks.
+ *    Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for SET_UNION, SET_INTERSECTION, ...
+#include <cstdlib>         // for EXIT
+#include <iterator>        // for BACK_INSERTER
+#include <random>          // for MT19937
+#include <string>
+#include <vector>
+#include "setAlgebra.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * SORTED
+ * n distinct numbers from [0, range), sorted
+ ***********************************************************************/
+template <class T>
+vector <T> sorted(int n, int range, mt19937 & random)
+{
+   vector <T> items;
+   while ((int)items.size() < n)
+   {
+      while ((int)items.size() < n)
+         items.push_back(random() % range);
+      sort(items.begin(), items.end());
+      items.erase(unique(items.begin(), items.end()), items.end());
+   }
+   return items;
+}
+
+/**********************************************************************
+ * AGREE ONE WAY
+ * setX(a, b) gives what std::set_x(a, b) does, for each of the three
+ ***********************************************************************/
+template <class T>
+void agreeOneWay(const vector <T> & a, const vector <T> & b)
+{
+   const T * pA = a.empty() ? NULL : &a[0];
+   const T * pB = b.empty() ? NULL : &b[0];
+   vector <T> out(a.size() + b.size() + 1);
+   vector <T> expected;
+
+   set_union(a.begin(), a.end(), b.begin(), b.end(),
+             back_inserter(expected));
+   int k = setUnion(pA, (int)a.size(), pB, (int)b.size(), &out[0]);
+   CHECK(vector <T> (out.begin(), out.begin() + k) == expected);
+
+   expected.clear();
+   set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                    back_inserter(expected));
+   k = setIntersection(pA, (int)a.size(), pB, (int)b.size(), &out[0]);
+   CHECK(vector <T> (out.begin(), out.begin() + k) == expected);
+
+   expected.clear();
+   set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                  back_inserter(expected));
+   k = setDifference(pA, (int)a.size(), pB, (int)b.size(), &out[0]);
+   CHECK(vector <T> (out.begin(), out.begin() + k) == expected);
+}
+
+/**********************************************************************
+ * AGREE
+ * Both ways round, as ints, which have their own intersection, and
+ * as long longs, which take the template
+ ***********************************************************************/
+void agree(const vector <int> & a, const vector <int> & b)
+{
+   agreeOneWay(a, b);
+   agreeOneWay(b, a);
+   vector <long long> longA(a.begin(), a.end());
+   vector <long long> longB(b.begin(), b.end());
+   agreeOneWay(longA, longB);
+   agreeOneWay(longB, longA);
+}
+
+/**********************************************************************
+ * RATIOS
+ * A big array against a small one at ratios either side of
+ * GALLOP_RATIO, the small one drawn from the same numbers, from
+ * numbers the big one mostly holds, from a subset of it and from
+ * numbers it cannot hold
+ ***********************************************************************/
+void ratios()
+{
+   mt19937 random(38);
+   const int ratios[] = { 1, 2, 3, 8, 16, 31, 32, 33, 34, 64, 100, 1000,
+                          10000 };
+   const int smalls[] = { 1, 2, 5, 17, 100 };
+   for (int r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++)
+      for (int s = 0; s < sizeof(smalls) / sizeof(smalls[0]); s++)
+      {
+         int m = smalls[s];
+         int n = m * ratios[r];
+         if (n > 200000)
+            continue;
+         vector <int> big = sorted <int> (n, 2 * n, random);
+
+         agree(big, sorted <int> (m, 2 * n, random));
+         agree(big, sorted <int> (m, n / 2 + m, random));
+
+         // every r-th, counting back so the last is in, and the last two
+         vector <int> subset;
+         for (int i = (n - 1) % ratios[r]; i < n; i += ratios[r])
+            subset.push_back(big[i]);
+         agree(big, subset);
+         agree(big, vector <int> (big.end() - min(n, 2), big.end()));
+
+         vector <int> below = sorted <int> (m, 2 * n, random);
+         vector <int> above(below);
+         for (int i = 0; i < m; i++)
+         {
+            below[i] -= 2 * n;
+            above[i] += 2 * n;
+         }
+         agree(big, below);
+         agree(big, above);
+      }
+
+   // exactly at the cutoff, where n / GALLOP_RATIO == m and m + 1
+   for (int m = 1; m < 40; m++)
+      for (int n = GALLOP_RATIO * m; n < GALLOP_RATIO * (m + 2); n += 7)
+         agree(sorted <int> (n, 3 * n, random), sorted <int> (m, 3 * n, random));
+}
+
+/**********************************************************************
+ * EDGES
+ * Empty arrays, identical and disjoint ones, and every pair of small
+ * sizes, which leaves every number of items over after the blocks
+ ***********************************************************************/
+void edges()
+{
+   mt19937 random(38);
+   vector <int> none;
+   vector <int> some = sorted <int> (50, 100, random);
+   agree(none, none);
+   agree(none, some);
+   agree(some, some);
+
+   vector <int> evens;
+   vector <int> odds;
+   for (int i = 0; i < 1000; i++)
+   {
+      evens.push_back(2 * i);
+      odds.push_back(2 * i + 1);
+   }
+   agree(evens, odds);
+   vector <int> low(evens.begin(), evens.begin() + 500);
+   vector <int> high(evens.begin() + 500, evens.end());
+   agree(low, high);
+
+   for (int na = 0; na <= 40; na++)
+      for (int nb = 0; nb <= 40; nb++)
+         for (int trial = 0; trial < 5; trial++)
+         {
+            int range = (na + nb) * (trial + 1) / 2 + 1;
+            if (range < na || range < nb)
+               range = max(na, nb);
+            agree(sorted <int> (na, range, random),
+                  sorted <int> (nb, range, random));
+         }
+
+   // blocks whose last items match, and one block against many
+   vector <int> a;
+   vector <int> b;
+   for (int i = 0; i < 64; i++)
+   {
+      a.push_back(3 * i);
+      b.push_back(i % 8 == 7 ? 3 * i : 3 * i + 1);
+   }
+   agree(a, b);
+   agree(vector <int> (a.begin(), a.begin() + 8), b);
+
+   // negative numbers and the ends of the range of int
+   vector <int> extremes;
+   extremes.push_back(-2147483647 - 1);
+   extremes.push_back(-5);
+   extremes.push_back(0);
+   extremes.push_back(2147483647);
+   agree(extremes, some);
+   agree(extremes, extremes);
+}
+
+/**********************************************************************
+ * GALLOPING
+ * gallop() finds what std::lower_bound does from every start
+ ***********************************************************************/
+void galloping()
+{
+   for (int n = 0; n <= 70; n++)
+   {
+      vector <int> a;
+      for (int i = 0; i < n; i++)
+         a.push_back(2 * i);
+      const int * pA = a.empty() ? NULL : &a[0];
+      for (int lo = 0; lo <= n; lo++)
+         for (int key = -1; key <= 2 * n; key++)
+            CHECK(gallop(pA, lo, n, key) ==
+                  lower_bound(a.begin() + lo, a.end(), key) - a.begin());
+   }
+}
+
+/**********************************************************************
+ * STRINGS
+ * The template on something that is not a number
+ ***********************************************************************/
+void strings()
+{
+   mt19937 random(38);
+   vector <int> big = sorted <int> (20000, 40000, random);
+   vector <int> small = sorted <int> (50, 40000, random);
+   vector <string> bigWords;
+   vector <string> smallWords;
+   for (int i = 0; i < big.size(); i++)
+      bigWords.push_back(to_string(big[i]));
+   for (int i = 0; i < small.size(); i++)
+      smallWords.push_back(to_string(small[i]));
+   sort(bigWords.begin(), bigWords.end());
+   sort(smallWords.begin(), smallWords.end());
+   agreeOneWay(bigWords, smallWords);
+   agreeOneWay(smallWords, bigWords);
+   agreeOneWay(bigWords, bigWords);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   ratios();
+   edges();
+   galloping();
+   strings();
+#ifdef __AVX2__
+   cout << "Set algebra tests passed, with AVX2\n";
+#else
+   cout << "Set algebra tests passed\n";
+#endif
+   return 0;
+}
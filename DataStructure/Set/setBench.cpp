@@ -0,0 +1,523 @@
+/***********************************************************************
+ * Program:
+ *    SET BENCH
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    The benchmarks behind the numbers quoted for the sets, so they
+ *    can be run again. Each one is a mode:
+ *       setBench skipList [n]     millions of inserts and of finds a
+ *                                 second as 1 to 8 threads share n
+ *                                 keys, SkipList against Set and BST
+ *                                 each behind one mutex
+ *       setBench bulk [n]         seconds to build Sets of up to n
+ *                                 random ints with one range insert
+ *                                 and one insert at a time, and a
+ *                                 std::set for scale
+ *       setBench algebra [n]      microseconds for union, intersection
+ *                                 and difference of n ints with n / r,
+ *                                 r from 1 to 10,000, against std::set_*
+ *       setBench card [n]         nanoseconds for n steps of a Go Fish
+ *                                 hand, Set <Card> against Set <int>
+ *                                 and std::set, and for the algebra of
+ *                                 256-wide sets as bits and as arrays
+ *    Inputs are generated from fixed seeds, so runs are comparable.
+ *    Times depend on the machine; compare modes on one machine only.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <algorithm>       // for SORT, SHUFFLE and SET_UNION
+#include <iterator>        // for BACK_INSERTER
+#include <chrono>          // for STEADY_CLOCK
+#include <cstdlib>         // for ATOI
+#include <cstring>         // for STRCMP
+#include <iomanip>         // for SETW
+#include <set>
+#include <mutex>           // for MUTEX and LOCK_GUARD
+#include <random>          // for MT19937
+#include <string>
+#include <thread>
+#include <vector>
+#include "set.h"
+#include "setAlgebra.h"
+#include "card.h"
+#include "skipList.h"
+#include "bst.h"
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/**********************************************************************
+ * SECONDS SINCE
+ ***********************************************************************/
+double secondsSince(Clock::time_point start)
+{
+   return chrono::duration <double> (Clock::now() - start).count();
+}
+
+/**********************************************************************
+ * RANDOM KEYS
+ * n distinct random numbers, none of them negative, in random order
+ ***********************************************************************/
+vector <int> randomKeys(int n, unsigned seed)
+{
+   mt19937 random(seed);
+   vector <int> keys;
+   while ((int)keys.size() < n)
+   {
+      while ((int)keys.size() < n)
+         keys.push_back(random() >> 1);
+      sort(keys.begin(), keys.end());
+      keys.erase(unique(keys.begin(), keys.end()), keys.end());
+   }
+   shuffle(keys.begin(), keys.end(), random);
+   return keys;
+}
+
+/**********************************************************************
+ * LOCKED SET and LOCKED BST
+ * A single-threaded container behind one mutex
+ ***********************************************************************/
+class LockedSet
+{
+public:
+   void insert(int key)
+   {
+      lock_guard <mutex> guard(lock);
+      set.insert(key);
+   }
+   bool find(int key)
+   {
+      lock_guard <mutex> guard(lock);
+      return set.find(key) != set.end();
+   }
+private:
+   mutex lock;
+   Set <int> set;
+};
+
+class LockedBST
+{
+public:
+   void insert(int key)
+   {
+      lock_guard <mutex> guard(lock);
+      tree.insert(key);
+   }
+   bool find(int key)
+   {
+      lock_guard <mutex> guard(lock);
+      return tree.find(key) != tree.end();
+   }
+private:
+   mutex lock;
+   BST <int> tree;
+};
+
+/**********************************************************************
+ * RUN THREADS
+ * Seconds for numThreads threads to each call work(t) once
+ ***********************************************************************/
+template <class Work>
+double runThreads(int numThreads, Work work)
+{
+   vector <thread> threads;
+   Clock::time_point start = Clock::now();
+   for (int t = 0; t < numThreads; t++)
+      threads.push_back(thread(work, t));
+   for (int t = 0; t < numThreads; t++)
+      threads[t].join();
+   return secondsSince(start);
+}
+
+/**********************************************************************
+ * SHARE
+ * numThreads threads insert the keys between them, every thread
+ * taking every numThreads-th one, then each looks up all of them and
+ * as many that are not there. Millions of each a second, overall
+ ***********************************************************************/
+template <class Container>
+void share(const char * name, int numThreads, const vector <int> & keys,
+           const vector <int> & missing)
+{
+   Container container;
+   int n = keys.size();
+   double inserting = runThreads(numThreads, [&](int t)
+   {
+      for (int i = t; i < n; i += numThreads)
+         container.insert(keys[i]);
+   });
+
+   vector <int> found(numThreads, 0);
+   double finding = runThreads(numThreads, [&](int t)
+   {
+      int numFound = 0;
+      for (int i = 0; i < n; i++)
+      {
+         int at = (i + t * n / numThreads) % n;
+         numFound += container.find(keys[at]);
+         numFound += container.find(missing[at]);
+      }
+      found[t] = numFound;
+   });
+   for (int t = 0; t < numThreads; t++)
+      if (found[t] != n)
+         cerr << name << ": found " << found[t] << " of " << n << endl;
+
+   cout << setw(20) << left << name << right << setw(8) << numThreads
+        << fixed << setprecision(2)
+        << setw(12) << n / inserting / 1e6
+        << setw(12) << 2.0 * n * numThreads / finding / 1e6 << endl;
+}
+
+/**********************************************************************
+ * SKIP LIST
+ * SkipList against a locked Set and a locked BST at 1 to 8 threads
+ ***********************************************************************/
+void skipList(int n)
+{
+   vector <int> keys = randomKeys(2 * n, 33);
+   vector <int> missing(keys.begin() + n, keys.end());
+   keys.resize(n);
+
+   cout << n << " keys, " << thread::hardware_concurrency()
+        << " hardware threads, millions a second\n"
+        << setw(20) << "" << setw(8) << "threads"
+        << setw(12) << "insert" << setw(12) << "find" << endl;
+   for (int numThreads = 1; numThreads <= 8; numThreads *= 2)
+   {
+      share <SkipList <int> > ("SkipList", numThreads, keys, missing);
+      share <LockedSet> ("Set and a mutex", numThreads, keys, missing);
+      share <LockedBST> ("BST and a mutex", numThreads, keys, missing);
+   }
+}
+
+/**********************************************************************
+ * TIME BUILD
+ * Seconds to build a container of the keys with build(keys)
+ ***********************************************************************/
+template <class Build>
+double timeBuild(const vector <int> & keys, Build build)
+{
+   Clock::time_point start = Clock::now();
+   build(keys);
+   return secondsSince(start);
+}
+
+/**********************************************************************
+ * BULK
+ * A Set built from random keys with the range constructor, with
+ * single inserts, and a std::set built one at a time, at sizes from
+ * 10,000 up to n. Single inserts into a Set shift the tail each time,
+ * so that row stops once a size takes more than ten seconds; the next
+ * would take about a hundred times as long
+ ***********************************************************************/
+void bulk(int n)
+{
+   cout << "seconds to build from random ints\n"
+        << setw(12) << "size" << setw(12) << "range" << setw(12) << "one by one"
+        << setw(12) << "std::set" << endl;
+   bool oneByOne = true;
+   for (int size = 10000; size <= n; size *= 10)
+   {
+      vector <int> keys = randomKeys(size, 37);
+      cout << setw(12) << size << fixed << setprecision(3);
+
+      cout << setw(12) << timeBuild(keys, [](const vector <int> & keys)
+      {
+         Set <int> set(keys.begin(), keys.end());
+         if (set.size() != (int)keys.size())
+            cerr << "The range insert lost keys\n";
+      });
+
+      if (oneByOne)
+      {
+         double seconds = timeBuild(keys, [](const vector <int> & keys)
+         {
+            Set <int> set;
+            for (size_t i = 0; i < keys.size(); i++)
+               set.insert(keys[i]);
+            if (set.size() != (int)keys.size())
+               cerr << "Single inserts lost keys\n";
+         });
+         cout << setw(12) << seconds;
+         oneByOne = seconds < 10.0;
+      }
+      else
+         cout << setw(12) << "-";
+
+      cout << setw(12) << timeBuild(keys, [](const vector <int> & keys)
+      {
+         std::set <int> set;
+         for (size_t i = 0; i < keys.size(); i++)
+            set.insert(keys[i]);
+      }) << endl;
+   }
+}
+
+/**********************************************************************
+ * SORTED KEYS
+ * n distinct random keys, sorted
+ ***********************************************************************/
+vector <int> sortedKeys(int n, unsigned seed)
+{
+   vector <int> keys = randomKeys(n, seed);
+   sort(keys.begin(), keys.end());
+   return keys;
+}
+
+/**********************************************************************
+ * MICROSECONDS
+ * Average time of a call of work(), repeated for a tenth of a second
+ ***********************************************************************/
+template <class Work>
+double microseconds(Work work)
+{
+   int numCalls = 0;
+   Clock::time_point start = Clock::now();
+   double seconds;
+   do
+   {
+      work();
+      numCalls++;
+   }
+   while ((seconds = secondsSince(start)) < 0.1);
+   return seconds / numCalls * 1e6;
+}
+
+/**********************************************************************
+ * ALGEBRA
+ * n sorted ints against n / r of them, half drawn from the big array
+ * so there is something to find. The merges run while r is at most
+ * GALLOP_RATIO and the galloping after
+ ***********************************************************************/
+void algebra(int n)
+{
+   vector <int> big = sortedKeys(n, 38);
+   vector <int> out(2 * n);
+   vector <int> expected;
+   expected.reserve(2 * n);
+
+   cout << n << " ints against n / r, microseconds a call\n"
+        << setw(8) << "r" << setw(11) << "union" << setw(11) << "std::"
+        << setw(11) << "inter" << setw(11) << "std::"
+        << setw(11) << "diff" << setw(11) << "std::" << endl;
+   const int ratios[] = { 1, 2, 10, 32, 33, 100, 1000, 10000 };
+   for (int r = 0; r < sizeof(ratios) / sizeof(ratios[0]); r++)
+   {
+      int m = n / ratios[r];
+      if (m == 0)
+         break;
+      vector <int> small = sortedKeys(m, 380 + r);
+      for (int i = 0; i < m; i += 2)
+         small[i] = big[(long long)i * n / m];
+      sort(small.begin(), small.end());
+      small.erase(unique(small.begin(), small.end()), small.end());
+      m = small.size();
+
+      const int * a = &big[0];
+      const int * b = &small[0];
+      int * pOut = &out[0];
+      cout << setw(8) << ratios[r] << fixed << setprecision(1)
+           << setw(11) << microseconds([&]() { setUnion(a, n, b, m, pOut); })
+           << setw(11) << microseconds([&]()
+              {
+                 expected.clear();
+                 set_union(big.begin(), big.end(), small.begin(), small.end(),
+                           back_inserter(expected));
+              })
+           << setw(11) << microseconds([&]()
+              {
+                 setIntersection(a, n, b, m, pOut);
+              })
+           << setw(11) << microseconds([&]()
+              {
+                 expected.clear();
+                 set_intersection(big.begin(), big.end(),
+                                  small.begin(), small.end(),
+                                  back_inserter(expected));
+              })
+           << setw(11) << microseconds([&]()
+              {
+                 setDifference(a, n, b, m, pOut);
+              })
+           << setw(11) << microseconds([&]()
+              {
+                 expected.clear();
+                 set_difference(big.begin(), big.end(),
+                                small.begin(), small.end(),
+                                back_inserter(expected));
+              }) << endl;
+   }
+}
+
+/**********************************************************************
+ * PLAY
+ * A Go Fish hand: each step adds a card, asks for one, and every
+ * fourth step takes the cards of another hand, keeps those two share,
+ * or gives them up. Returns the cards found, so nothing is optimized
+ * away and the containers can be checked against each other
+ ***********************************************************************/
+template <class Hand, class Item>
+long long play(const vector <int> & picks, Item (*make)(int))
+{
+   Hand hand;
+   Hand other;
+   long long numFound = 0;
+   for (size_t i = 0; i + 2 < picks.size(); i += 3)
+   {
+      hand.insert(make(picks[i]));
+      other.insert(make(picks[i + 1]));
+      numFound += hand.find(make(picks[i + 2])) != hand.end();
+      switch (i / 3 % 12)
+      {
+         case 3:  hand = hand || other; break;
+         case 7:  hand = hand && other; break;
+         case 11: hand = hand - other;  break;
+      }
+      numFound += hand.size();
+   }
+   return numFound;
+}
+
+Card makeCard(int i)     { return Card(i); }
+int  makeInt(int i)      { return i;       }
+
+/**********************************************************************
+ * STD HAND
+ * std::set with the operators the Sets have
+ ***********************************************************************/
+class StdHand : public std::set <int>
+{
+public:
+   int size() const { return (int)std::set <int> :: size(); }
+   StdHand operator || (const StdHand & rhs) const
+   {
+      StdHand result(*this);
+      result.insert(rhs.begin(), rhs.end());
+      return result;
+   }
+   StdHand operator && (const StdHand & rhs) const
+   {
+      StdHand result;
+      set_intersection(begin(), end(), rhs.begin(), rhs.end(),
+                       inserter(result, result.end()));
+      return result;
+   }
+   StdHand operator - (const StdHand & rhs) const
+   {
+      StdHand result;
+      set_difference(begin(), end(), rhs.begin(), rhs.end(),
+                     inserter(result, result.end()));
+      return result;
+   }
+};
+
+/**********************************************************************
+ * CARD
+ * Set <Card> is 256 bits; Set <int> is a sorted array. First the
+ * hands of Go Fish, where only six cards exist, then sets of half of
+ * 256 numbers, where the bits win on the algebra
+ ***********************************************************************/
+void card(int n)
+{
+   mt19937 random(39);
+   vector <int> picks;
+   for (int i = 0; i < 3 * n; i++)
+      picks.push_back(INDEX_FIRST + random() % (INDEX_LAST - INDEX_FIRST + 1));
+
+   cout << n << " steps of a hand, nanoseconds a step\n";
+   long long found[3];
+   const char * names[3] = { "Set <Card>", "Set <int>", "std::set <int>" };
+   double seconds[3];
+   Clock::time_point start = Clock::now();
+   found[0] = play <Set <Card> > (picks, makeCard);
+   seconds[0] = secondsSince(start);
+   start = Clock::now();
+   found[1] = play <Set <int> > (picks, makeInt);
+   seconds[1] = secondsSince(start);
+   start = Clock::now();
+   found[2] = play <StdHand> (picks, makeInt);
+   seconds[2] = secondsSince(start);
+   for (int i = 0; i < 3; i++)
+   {
+      cout << setw(20) << left << names[i] << right << fixed
+           << setprecision(1) << setw(10) << seconds[i] / n * 1e9 << endl;
+      if (found[i] != found[0])
+         cerr << names[i] << " disagrees with " << names[0] << endl;
+   }
+
+   // 128 of 256 numbers each, as bits and as sorted arrays
+   const int NUM_PAIRS = 1000;
+   vector <BitSet <256> > bits(2 * NUM_PAIRS);
+   vector <vector <int> > arrays(2 * NUM_PAIRS);
+   for (int i = 0; i < 2 * NUM_PAIRS; i++)
+   {
+      arrays[i] = sortedKeys(128, 3900 + i);
+      for (int j = 0; j < 128; j++)
+      {
+         arrays[i][j] %= 256;
+         bits[i].set(arrays[i][j]);
+      }
+      sort(arrays[i].begin(), arrays[i].end());
+      arrays[i].erase(unique(arrays[i].begin(), arrays[i].end()),
+                      arrays[i].end());
+   }
+
+   long long bitCount = 0;
+   long long arrayCount = 0;
+   int out[512];
+   int rounds = n / NUM_PAIRS + 1;
+   start = Clock::now();
+   for (int round = 0; round < rounds; round++)
+      for (int i = 0; i < NUM_PAIRS; i++)
+         bitCount += (bits[2 * i] | bits[2 * i + 1]).count() +
+                     (bits[2 * i] & bits[2 * i + 1]).count() +
+                     (bits[2 * i] - bits[2 * i + 1]).count();
+   double bitSeconds = secondsSince(start);
+   start = Clock::now();
+   for (int round = 0; round < rounds; round++)
+      for (int i = 0; i < NUM_PAIRS; i++)
+      {
+         const vector <int> & a = arrays[2 * i];
+         const vector <int> & b = arrays[2 * i + 1];
+         arrayCount += setUnion(&a[0], a.size(), &b[0], b.size(), out) +
+                       setIntersection(&a[0], a.size(), &b[0], b.size(), out) +
+                       setDifference(&a[0], a.size(), &b[0], b.size(), out);
+      }
+   double arraySeconds = secondsSince(start);
+   if (bitCount != arrayCount)
+      cerr << "The bits and the arrays disagree\n";
+
+   double numOps = 3.0 * rounds * NUM_PAIRS;
+   cout << "union, intersection and difference of about 100 of 256, "
+        << "nanoseconds each\n"
+        << setw(20) << left << "BitSet <256>" << right
+        << setw(10) << bitSeconds / numOps * 1e9 << endl
+        << setw(20) << left << "sorted arrays" << right
+        << setw(10) << arraySeconds / numOps * 1e9 << endl;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   const char * mode = argc > 1 ? argv[1] : "";
+   int n = argc > 2 ? atoi(argv[2]) : 0;
+
+   if (strcmp(mode, "skipList") == 0)
+      skipList(n ? n : 200000);
+   else if (strcmp(mode, "bulk") == 0)
+      bulk(n ? n : 10000000);
+   else if (strcmp(mode, "algebra") == 0)
+      algebra(n ? n : 1000000);
+   else if (strcmp(mode, "card") == 0)
+      card(n ? n : 10000000);
+   else
+   {
+      cerr << "Usage: " << argv[0] << " skipList|bulk|algebra|card [n]\n";
+      return 1;
+   }
+   return 0;
+}
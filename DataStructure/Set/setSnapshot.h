@@ -0,0 +1,72 @@
+//
+//  setSnapshot.h
+//  W5_Set
+//
+//  Saving a Set to a snapshot and loading it back, kept out of set.h
+//  because snapshot.h needs POSIX. The items come back in the order
+//  saved, already sorted.
+//
+
+#ifndef setSnapshot_h
+#define setSnapshot_h
+#include <new>         // for BAD_ALLOC
+#include "set.h"
+#include "snapshot.h"
+
+/***************************************
+ * SNAPSHOT
+ * The sorted array as it is
+ **************************************/
+template <class T>
+void snapshot(const Set <T> & s, const std::string & fileName)
+    throw (const char *)
+{
+    SnapshotWriter out(fileName, SNAPSHOT_SET,
+                       SnapshotElements <T> :: KIND, SnapshotElements <T> :: SIZE);
+    SnapshotElements <T> :: writeArray(out, s.data, s.numElements);
+    out.finish(s.numElements, 0);
+}
+
+/***************************************
+ * RESTORE
+ * Checked in full and copied into a new
+ * buffer before anything in s changes, so
+ * a bad file or a failed allocation leaves
+ * s as it was; nothing is sorted
+ **************************************/
+template <class T>
+void restore(Set <T> & s, const std::string & fileName)
+    throw (const char *)
+{
+    SnapshotReader in(fileName, SNAPSHOT_SET,
+                      SnapshotElements <T> :: KIND, SnapshotElements <T> :: SIZE);
+    const SnapshotHeader & header = in.header();
+    if (header.count > INT_MAX ||
+        SnapshotElements <T> :: check(in.payload(), header.payloadSize, header.count)
+            != header.payloadSize)
+        throw "ERROR: the snapshot is corrupt";
+
+    T * pNew = NULL;
+    if (header.count > 0)
+    {
+        try
+        {
+            pNew = new T[header.count];
+            SnapshotElements <T> :: readArray(in.payload(), pNew, header.count);
+        }
+        catch (std::bad_alloc)
+        {
+            delete [] pNew;
+            throw "ERROR: Unable to allocate a new buffer for Set";
+        }
+    }
+
+    // swap in the new and delete the old
+    if (NULL != s.data)
+        delete [] s.data;
+    s.data = pNew;
+    s.numCapacity = header.count;
+    s.numElements = header.count;
+}
+
+#endif /* setSnapshot_h */
@@ -0,0 +1,247 @@
+/***********************************************************************
+ * Program:
+ *    SET TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks the batch methods of Set against std::set: inserting a
+ *    range, unsorted and full of duplicates, into empty and full Sets,
+ *    building a Set from a range, and eraseIf with what it returns.
+ *    Single inserts are checked the same way, as the batch must agree
+ *    with them. Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdlib>         // for EXIT
+#include <list>
+#include <random>          // for MT19937
+#include <set>
+#include <string>
+#include <vector>
+#include "set.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * MATCHES
+ * The Set holds exactly what the std::set does, in the same order,
+ * through both kinds of iterator and through find()
+ ***********************************************************************/
+template <class T>
+bool matches(Set <T> & set, const std::set <T> & expected)
+{
+   if (set.size() != (int)expected.size() || set.empty() != expected.empty())
+      return false;
+   typename std::set <T> :: const_iterator itExpected = expected.begin();
+   for (typename Set <T> :: iterator it = set.begin(); it != set.end(); ++it)
+      if (!(*it == *itExpected++))
+         return false;
+   itExpected = expected.begin();
+   for (typename Set <T> :: const_iterator it = set.cbegin();
+        it != set.cend(); ++it)
+      if (!(*it == *itExpected++))
+         return false;
+   for (itExpected = expected.begin(); itExpected != expected.end();
+        ++itExpected)
+      if (set.find(*itExpected) == set.end())
+         return false;
+   return true;
+}
+
+/**********************************************************************
+ * INSERT RANGE
+ * Batches of every size into Sets of every size, with keys from a
+ * small range so batches repeat themselves and overlap the Set
+ ***********************************************************************/
+void insertRange()
+{
+   mt19937 random(37);
+   const int sizes[] = { 0, 1, 2, 10, 100, 1000 };
+   const int numSizes = sizeof(sizes) / sizeof(sizes[0]);
+   for (int i = 0; i < numSizes; i++)
+      for (int j = 0; j < numSizes; j++)
+      {
+         Set <int> set;
+         std::set <int> expected;
+         int range = 2 * (sizes[i] + sizes[j]) + 1;
+         for (int k = 0; k < sizes[i]; k++)
+         {
+            int key = random() % range;
+            set.insert(key);
+            expected.insert(key);
+         }
+         CHECK(matches(set, expected));
+
+         vector <int> batch;
+         for (int k = 0; k < sizes[j]; k++)
+            batch.push_back(random() % range);
+         int capacity = set.capacity();
+         set.insert(batch.begin(), batch.end());
+         expected.insert(batch.begin(), batch.end());
+         CHECK(matches(set, expected));
+         CHECK(set.capacity() >= capacity);
+         CHECK(set.capacity() >= set.size());
+
+         // the same batch again changes nothing, and single inserts
+         // still work afterwards
+         set.insert(batch.begin(), batch.end());
+         CHECK(matches(set, expected));
+         set.insert(-1);
+         set.insert(range);
+         expected.insert(-1);
+         expected.insert(range);
+         CHECK(matches(set, expected));
+      }
+
+   // all one item, already sorted, and reversed
+   Set <int> set;
+   std::set <int> expected;
+   vector <int> same(500, 4);
+   set.insert(same.begin(), same.end());
+   expected.insert(4);
+   CHECK(matches(set, expected));
+   vector <int> sorted;
+   for (int i = 0; i < 1000; i++)
+      sorted.push_back(i * 3);
+   set.insert(sorted.begin(), sorted.end());
+   set.insert(sorted.rbegin(), sorted.rend());
+   expected.insert(sorted.begin(), sorted.end());
+   CHECK(matches(set, expected));
+
+   // an empty range into an empty Set allocates nothing
+   Set <int> empty;
+   empty.insert(sorted.end(), sorted.end());
+   CHECK(empty.empty());
+   CHECK(empty.capacity() == 0);
+}
+
+/**********************************************************************
+ * CONSTRUCT FROM RANGE
+ * From a vector, a list, a plain array and an empty range, of ints
+ * and of strings
+ ***********************************************************************/
+void constructFromRange()
+{
+   mt19937 random(37);
+   vector <int> numbers;
+   for (int i = 0; i < 5000; i++)
+      numbers.push_back(random() % 3000 - 1500);
+   Set <int> fromVector(numbers.begin(), numbers.end());
+   CHECK(matches(fromVector, std::set <int> (numbers.begin(), numbers.end())));
+
+   list <int> linked(numbers.begin(), numbers.end());
+   Set <int> fromList(linked.begin(), linked.end());
+   CHECK(matches(fromList, std::set <int> (numbers.begin(), numbers.end())));
+
+   int array[] = { 5, 3, 5, 1, 3, 9 };
+   Set <int> fromArray(array, array + 6);
+   CHECK(matches(fromArray, std::set <int> (array, array + 6)));
+
+   Set <int> fromNothing(array, array);
+   CHECK(fromNothing.empty());
+
+   vector <string> words;
+   for (int i = 0; i < 2000; i++)
+      words.push_back("word" + to_string(random() % 700));
+   Set <string> fromWords(words.begin(), words.end());
+   CHECK(matches(fromWords, std::set <string> (words.begin(), words.end())));
+}
+
+/**********************************************************************
+ * ODD, BELOW and ALWAYS
+ * Predicates for eraseIf
+ ***********************************************************************/
+bool odd(int value) { return value % 2 != 0; }
+
+struct Below
+{
+   int limit;
+   bool operator () (int value) const { return value < limit; }
+};
+
+template <class T>
+bool always(const T &) { return true; }
+
+/**********************************************************************
+ * ERASE IF
+ * None, some, all, and on an empty Set, counting what goes. The Set
+ * must still work once some are gone
+ ***********************************************************************/
+void eraseIf()
+{
+   mt19937 random(37);
+   vector <int> numbers;
+   for (int i = 0; i < 10000; i++)
+      numbers.push_back(random() % 20000);
+   Set <int> set(numbers.begin(), numbers.end());
+   std::set <int> expected(numbers.begin(), numbers.end());
+
+   Below none = { -1 };
+   CHECK(set.eraseIf(none) == 0);
+   CHECK(matches(set, expected));
+
+   int numOdd = 0;
+   for (std::set <int> :: iterator it = expected.begin(); it != expected.end(); )
+      if (odd(*it))
+      {
+         expected.erase(it++);
+         numOdd++;
+      }
+      else
+         ++it;
+   CHECK(numOdd > 0);
+   CHECK(set.eraseIf(odd) == numOdd);
+   CHECK(matches(set, expected));
+
+   // the survivors are still sorted, so inserts land in the right place
+   for (int i = 1; i < 100; i += 2)
+   {
+      set.insert(i);
+      expected.insert(i);
+   }
+   set.insert(numbers.begin(), numbers.begin() + 10);
+   expected.insert(numbers.begin(), numbers.begin() + 10);
+   CHECK(matches(set, expected));
+
+   Below half = { 10000 };
+   int numBelow = 0;
+   for (std::set <int> :: iterator it = expected.begin();
+        it != expected.end() && *it < 10000; ++it)
+      numBelow++;
+   CHECK(set.eraseIf(half) == numBelow);
+   expected.erase(expected.begin(), expected.lower_bound(10000));
+   CHECK(matches(set, expected));
+
+   int numLeft = set.size();
+   CHECK(set.eraseIf(always <int>) == numLeft);
+   CHECK(set.empty());
+   CHECK(set.eraseIf(always <int>) == 0);
+   set.insert(7);
+   CHECK(set.size() == 1);
+   CHECK(set.find(7) != set.end());
+
+   Set <string> words;
+   words.insert("apple");
+   words.insert("banana");
+   words.insert("cherry");
+   CHECK(words.eraseIf(always <string>) == 3);
+   CHECK(words.empty());
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   insertRange();
+   constructFromRange();
+   eraseIf();
+   cout << "Set tests passed\n";
+   return 0;
+}
@@ -0,0 +1,284 @@
+//
+//  skipList.h
+//  W5_Set
+//
+//  Created by Daniel Guzman.
+//
+
+#ifndef skip_list_h
+#define skip_list_h
+
+#include <atomic>
+#include <cstddef>
+
+/*****************************************
+ * SKIP LIST
+ * An ordered set that many threads can fill at once. Every element is
+ * on the bottom list; each list above skips over roughly half of the
+ * one below, so finding a place takes O(log n) steps on average.
+ *
+ * Elements are only ever added, never removed, which keeps it simple:
+ *   - insert() is lock-free. A new node is published on the bottom list
+ *     with a single compare-and-swap, then linked into the upper lists.
+ *     A thread that loses a race just searches again from the top.
+ *   - find() takes no locks and never retries, so it is wait-free.
+ *   - iteration walks the bottom list in sorted order. Items inserted
+ *     while iterating may or may not be seen.
+ ****************************************/
+template <class T>
+class SkipList
+{
+public:
+    // constructors and destructors
+    SkipList();
+    ~SkipList();
+
+    // standard container interfaces
+    int  size()  const { return numElements.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+
+    // typical Set methods. insert() returns false for a duplicate
+    bool insert(const T & t);
+    bool find(const T & t) const;
+
+    // iterate through the items in order
+    class iterator;
+    iterator begin() const;
+    iterator end()   const;
+
+private:
+    static const int MAX_LEVEL = 32;
+
+    struct SkipNode
+    {
+        SkipNode(const T & data, int height) :
+            data(data), height(height), pNext(new std::atomic <SkipNode *> [height])
+        {
+            for (int i = 0; i < height; i++)
+                pNext[i].store(NULL, std::memory_order_relaxed);
+        }
+        ~SkipNode() { delete [] pNext; }
+
+        T data;
+        int height;
+        std::atomic <SkipNode *> * pNext;
+    };
+
+    // a skip list is not copyable while other threads may be using it
+    SkipList(const SkipList <T> & rhs);
+    SkipList <T> & operator = (const SkipList <T> & rhs);
+
+    static int randomHeight();
+    bool findPlace(const T & t, SkipNode ** preds, SkipNode ** succs) const;
+
+    SkipNode * pHead;                   // sentinel in front of everything
+    std::atomic <int> topLevel;         // highest level in use
+    std::atomic <int> numElements;
+};
+
+/*****************************************
+ * DEFAULT CONSTRUCTOR and DESTRUCTOR
+ ****************************************/
+template <class T>
+SkipList <T> :: SkipList() :
+    pHead(new SkipNode(T(), MAX_LEVEL)), topLevel(1), numElements(0)
+{
+}
+
+template <class T>
+SkipList <T> :: ~SkipList()
+{
+    SkipNode * p = pHead;
+    while (p)
+    {
+        SkipNode * pNext = p->pNext[0].load(std::memory_order_relaxed);
+        delete p;
+        p = pNext;
+    }
+}
+
+/***************************************
+ * SkipList :: randomHeight
+ * Each extra level with probability 1/2,
+ * from a per-thread xorshift generator
+ **************************************/
+template <class T>
+int SkipList <T> :: randomHeight()
+{
+    static thread_local unsigned int seed = 0;
+    if (seed == 0)
+        seed = (unsigned int)(size_t)&seed | 1;
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+
+    int height = 1;
+    for (unsigned int bits = seed; (bits & 1) && height < MAX_LEVEL; bits >>= 1)
+        height++;
+    return height;
+}
+
+/***************************************
+ * SkipList :: findPlace
+ * For every level, find the last node before
+ * t and the first node at or after it. Returns
+ * true if t itself is already in the list
+ **************************************/
+template <class T>
+bool SkipList <T> :: findPlace(const T & t, SkipNode ** preds,
+                               SkipNode ** succs) const
+{
+    SkipNode * pPred = pHead;
+    for (int level = MAX_LEVEL - 1; level >= 0; level--)
+    {
+        SkipNode * pCurr = pPred->pNext[level].load(std::memory_order_acquire);
+        while (pCurr && pCurr->data < t)
+        {
+            pPred = pCurr;
+            pCurr = pCurr->pNext[level].load(std::memory_order_acquire);
+        }
+        preds[level] = pPred;
+        succs[level] = pCurr;
+    }
+    return succs[0] && succs[0]->data == t;
+}
+
+/***************************************
+ * SkipList :: insert
+ * Publish on the bottom level first; once a node
+ * is there it is in the set. Then splice it into
+ * each level above, searching again whenever
+ * another thread got in first
+ **************************************/
+template <class T>
+bool SkipList <T> :: insert(const T & t)
+{
+    SkipNode * preds[MAX_LEVEL];
+    SkipNode * succs[MAX_LEVEL];
+    SkipNode * pNew = NULL;
+
+    do
+    {
+        if (findPlace(t, preds, succs))
+        {
+            delete pNew;
+            return false;
+        }
+        if (pNew == NULL)
+            pNew = new SkipNode(t, randomHeight());
+        for (int level = 0; level < pNew->height; level++)
+            pNew->pNext[level].store(succs[level], std::memory_order_relaxed);
+    }
+    while (!preds[0]->pNext[0].compare_exchange_strong(succs[0], pNew,
+                                                       std::memory_order_release,
+                                                       std::memory_order_relaxed));
+
+    for (int level = 1; level < pNew->height; level++)
+    {
+        while (true)
+        {
+            pNew->pNext[level].store(succs[level], std::memory_order_relaxed);
+            if (preds[level]->pNext[level].compare_exchange_strong(
+                    succs[level], pNew,
+                    std::memory_order_release, std::memory_order_relaxed))
+                break;
+            findPlace(t, preds, succs);
+        }
+    }
+
+    // let searches start from the new top level
+    int top = topLevel.load(std::memory_order_relaxed);
+    while (top < pNew->height &&
+           !topLevel.compare_exchange_weak(top, pNew->height,
+                                           std::memory_order_relaxed))
+        ;
+
+    numElements.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+/***************************************
+ * SkipList :: find
+ * Drop down a level each time the next node
+ * would overshoot t. No locks, no retries
+ **************************************/
+template <class T>
+bool SkipList <T> :: find(const T & t) const
+{
+    SkipNode * pPred = pHead;
+    SkipNode * pCurr = NULL;
+    for (int level = topLevel.load(std::memory_order_relaxed) - 1;
+         level >= 0; level--)
+    {
+        pCurr = pPred->pNext[level].load(std::memory_order_acquire);
+        while (pCurr && pCurr->data < t)
+        {
+            pPred = pCurr;
+            pCurr = pCurr->pNext[level].load(std::memory_order_acquire);
+        }
+    }
+    return pCurr && pCurr->data == t;
+}
+
+/**************************************************
+ * SkipList ITERATOR
+ * Walks the bottom level, which is in sorted order.
+ * The items cannot be changed through the iterator
+ * since that could break the order
+ *************************************************/
+template <class T>
+class SkipList <T> :: iterator
+{
+public:
+    // constructors, destructors, and assignment operator
+    iterator() : p(NULL) {}
+    iterator(SkipNode * p) : p(p) {}
+
+    // equals, not equals operator
+    bool operator != (const iterator & rhs) const { return rhs.p != this->p; }
+    bool operator == (const iterator & rhs) const { return rhs.p == this->p; }
+
+    // dereference operator
+    const T & operator * () const throw (const char *)
+    {
+        if (p)
+            return p->data;
+        else
+            throw "ERROR: Trying to dereference a NULL pointer";
+    }
+
+    // prefix increment
+    iterator & operator ++ ()
+    {
+        p = p->pNext[0].load(std::memory_order_acquire);
+        return *this;
+    }
+
+    // postfix increment
+    iterator operator ++ (int postfix)
+    {
+        iterator tmp(*this);
+        ++(*this);
+        return tmp;
+    }
+
+private:
+    SkipNode * p;
+};
+
+/***************************************
+ * SkipList :: begin and end
+ **************************************/
+template <class T>
+typename SkipList <T> :: iterator SkipList <T> :: begin() const
+{
+    return iterator(pHead->pNext[0].load(std::memory_order_acquire));
+}
+
+template <class T>
+typename SkipList <T> :: iterator SkipList <T> :: end() const
+{
+    return iterator(NULL);
+}
+
+#endif /* skip_list_h */
@@ -0,0 +1,134 @@
+/***********************************************************************
+ * Program:
+ *    SKIP LIST TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Has several threads insert overlapping ranges into one SkipList at
+ *    the same time, while other threads look items up, and checks that
+ *    every item went in exactly once, that an item a thread inserted is
+ *    found right away, and that the list walks in order afterwards.
+ *    Build it with -fsanitize=thread ("make tsan") to have the races
+ *    checked too. Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <atomic>
+#include <cstdlib>         // for EXIT
+#include <string>
+#include <thread>
+#include <vector>
+#include "skipList.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+/**********************************************************************
+ * KEY
+ * Item number n, as an int or as a string that sorts the same way
+ ***********************************************************************/
+template <class T> T key(int n);
+template <> int key <int> (int n) { return n; }
+template <> string key <string> (int n)
+{
+   string s = to_string(n);
+   return string(8 - s.size(), '0') + s;
+}
+
+/**********************************************************************
+ * RACE
+ * Each inserter takes a range that overlaps both its neighbours' by
+ * half, stepping through it in its own order, so most items are raced
+ * for by two threads. Finders meanwhile look up items that may or may
+ * not be there yet: whatever they see must be a real item
+ ***********************************************************************/
+template <class T>
+void race(int numInserters, int numFinders, int perThread)
+{
+   SkipList <T> skip;
+   const int NUM = numInserters * perThread / 2 + perThread / 2;
+   atomic <int> numInserted(0);
+   atomic <bool> done(false);
+   vector <thread> threads;
+
+   for (int t = 0; t < numInserters; t++)
+      threads.push_back(thread([&, t]()
+      {
+         int first = t * perThread / 2;
+         int inserted = 0;
+         for (int i = 0; i < perThread; i++)
+         {
+            // odd threads go backwards, to meet the others head on
+            int n = first + (t % 2 ? perThread - 1 - i : i);
+            if (skip.insert(key <T> (n)))
+               inserted++;
+            CHECK(skip.find(key <T> (n)));
+            CHECK(!skip.insert(key <T> (n)));
+         }
+         numInserted += inserted;
+      }));
+
+   for (int t = 0; t < numFinders; t++)
+      threads.push_back(thread([&, t]()
+      {
+         unsigned int seed = t + 1;
+         while (!done.load())
+         {
+            seed = seed * 1103515245 + 12345;
+            int n = (int)(seed >> 8) % (NUM + 100);
+            bool found = skip.find(key <T> (n));
+            CHECK(!found || n < NUM);
+
+            // a short walk must be in order
+            typename SkipList <T> :: iterator it = skip.begin();
+            if (it != skip.end())
+            {
+               T previous = *it;
+               for (int i = 0; i < 20 && ++it != skip.end(); i++)
+               {
+                  CHECK(previous < *it);
+                  previous = *it;
+               }
+            }
+         }
+      }));
+
+   for (int t = 0; t < numInserters; t++)
+      threads[t].join();
+   done = true;
+   for (int t = numInserters; t < threads.size(); t++)
+      threads[t].join();
+
+   // every item exactly once, and nothing else
+   CHECK(numInserted == NUM);
+   CHECK(skip.size() == NUM);
+   int n = 0;
+   for (typename SkipList <T> :: iterator it = skip.begin();
+        it != skip.end(); ++it, n++)
+      CHECK(*it == key <T> (n));
+   CHECK(n == NUM);
+   for (int i = 0; i < NUM; i++)
+      CHECK(skip.find(key <T> (i)));
+   CHECK(!skip.find(key <T> (-1)));
+   CHECK(!skip.find(key <T> (NUM)));
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+   // a smaller run is plenty under the thread sanitizer, which is slow
+   int perThread = argc > 1 ? atoi(argv[1]) : 100000;
+
+   race <int> (8, 2, perThread);
+   race <string> (4, 4, perThread / 4);
+   race <int> (2, 0, perThread);
+   cout << "SkipList tests passed\n";
+   return 0;
+}
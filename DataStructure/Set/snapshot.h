@@ -0,0 +1,501 @@
+/***********************************************************************
+* Header:
+*    Snapshot
+* Author: Daniel Guzman
+* Summary:
+*    Save a container to a binary file and load it back without parsing
+*    anything. A snapshot is a header and then the payload, exactly as
+*    the container wrote it:
+*       SnapshotHeader   magic, format version, which container, how
+*                        elements are stored, counts, and a checksum of
+*                        the payload
+*       payload          raw elements one after another, or for strings
+*                        count + 1 offsets and then one pool of all the
+*                        characters; Hash puts its bucket sizes first
+*    Writes go out a few megabytes at a time to a temporary file that is
+*    synced to disk and only then renamed over the old snapshot, and the
+*    rename is synced too, so after a crash the name holds the old
+*    snapshot or the new one, whole. Loading maps the file, checks
+*    everything, and copies straight out of the mapping.
+*
+*    This header needs POSIX (mmap, fsync), so the containers leave it
+*    out: include vectorSnapshot.h, setSnapshot.h or hashSnapshot.h to
+*    take snapshots.
+*
+*    Only elements that can be copied byte for byte (int, double, plain
+*    structs) and std::string can be saved, and a snapshot is only good
+*    on a machine with the same byte order and type sizes.
+************************************************************************/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstdio>        // for FOPEN, FWRITE and RENAME
+#include <climits>       // for INT_MAX
+#include <cstring>       // for MEMCPY and MEMCMP
+#include <new>           // for BAD_ALLOC
+#include <string>
+#include <type_traits>   // for IS_TRIVIALLY_COPYABLE
+#include <fcntl.h>       // for OPEN
+#include <sys/mman.h>    // for MMAP
+#include <sys/stat.h>    // for FSTAT
+#include <unistd.h>      // for CLOSE and FSYNC
+
+#define SNAPSHOT_VERSION 1
+
+// which container wrote the snapshot
+const unsigned int SNAPSHOT_VECTOR = 'V';
+const unsigned int SNAPSHOT_SET    = 'S';
+const unsigned int SNAPSHOT_HASH   = 'H';
+
+// how its elements are stored
+const unsigned int SNAPSHOT_RAW    = 1;
+const unsigned int SNAPSHOT_STRING = 2;
+
+/**************************************************
+ * SNAPSHOT HEADER
+ * 56 bytes, so the payload after it starts on an
+ * eight byte boundary
+ *************************************************/
+struct SnapshotHeader
+{
+   char magic[8];                  // "SNAPSHOT"
+   unsigned int version;
+   unsigned int container;
+   unsigned int elementKind;
+   unsigned int elementSize;       // sizeof(T) for raw elements, else 0
+   unsigned long long count;       // elements
+   unsigned long long extra;       // the container's own: buckets for Hash
+   unsigned long long payloadSize; // bytes
+   unsigned long long checksum;    // of the payload
+};
+
+/**************************************************
+ * SNAPSHOT CHECKSUM
+ * Four lanes of xxHash64's round, 32 bytes at a
+ * time, so it keeps up with the disk. Bytes can be
+ * added in pieces of any size
+ *************************************************/
+class SnapshotChecksum
+{
+public:
+   SnapshotChecksum() : held(0), length(0)
+   {
+      lane[0] = P1 + P2;
+      lane[1] = P2;
+      lane[2] = 0;
+      lane[3] = 0 - P1;
+   }
+
+   void update(const void * data, size_t size)
+   {
+      const char * p = (const char *)data;
+      length += size;
+      if (held)
+      {
+         size_t more = (size < 32 - held) ? size : 32 - held;
+         memcpy(pending + held, p, more);
+         held += more;
+         p += more;
+         size -= more;
+         if (held < 32)
+            return;
+         stripe(pending);
+         held = 0;
+      }
+      for (; size >= 32; p += 32, size -= 32)
+         stripe(p);
+      memcpy(pending, p, size);
+      held = size;
+   }
+
+   unsigned long long value() const
+   {
+      unsigned long long h = rotate(lane[0], 1) + rotate(lane[1], 7) +
+                             rotate(lane[2], 12) + rotate(lane[3], 18);
+      h ^= length;
+      for (int i = 0; i < held; i++)
+         h = rotate(h ^ ((unsigned char)pending[i] * P1), 11) * P2;
+      h ^= h >> 33;
+      h *= P2;
+      h ^= h >> 29;
+      h *= P3;
+      return h ^ (h >> 32);
+   }
+
+private:
+   static const unsigned long long P1 = 0x9e3779b185ebca87ULL;
+   static const unsigned long long P2 = 0xc2b2ae3d27d4eb4fULL;
+   static const unsigned long long P3 = 0x165667b19e3779f9ULL;
+
+   static unsigned long long rotate(unsigned long long x, int bits)
+   {
+      return (x << bits) | (x >> (64 - bits));
+   }
+   void stripe(const char * p)
+   {
+      for (int i = 0; i < 4; i++)
+      {
+         unsigned long long word;
+         memcpy(&word, p + 8 * i, 8);
+         lane[i] = rotate(lane[i] + word * P2, 31) * P1;
+      }
+   }
+
+   unsigned long long lane[4];
+   char pending[32];
+   int held;
+   unsigned long long length;
+};
+
+/**************************************************
+ * SNAPSHOT WRITER
+ * Everything written goes through a buffer of
+ * BUFFER bytes; anything that big or bigger is
+ * written straight from where it is
+ *************************************************/
+class SnapshotWriter
+{
+public:
+   SnapshotWriter(const std::string & fileName, unsigned int container,
+                  unsigned int elementKind, unsigned int elementSize) throw (const char *) :
+      fileName(fileName), tempName(fileName + ".tmp"), used(0)
+   {
+      memset(&header, 0, sizeof(header));
+      memcpy(header.magic, "SNAPSHOT", 8);
+      header.version = SNAPSHOT_VERSION;
+      header.container = container;
+      header.elementKind = elementKind;
+      header.elementSize = elementSize;
+
+      try
+      {
+         buffer = new char[BUFFER];
+      }
+      catch (std::bad_alloc)
+      {
+         throw "ERROR: unable to allocate memory for the snapshot";
+      }
+      file = fopen(tempName.c_str(), "wb");
+      if (file != NULL)
+      {
+         setvbuf(file, NULL, _IONBF, 0);
+         if (fwrite(&header, sizeof(header), 1, file) != 1)
+         {
+            fclose(file);
+            remove(tempName.c_str());
+            file = NULL;
+         }
+      }
+      if (file == NULL)
+      {
+         delete [] buffer;
+         throw "ERROR: unable to create the snapshot";
+      }
+   }
+
+   // a writer not finished leaves the old snapshot as it was
+   ~SnapshotWriter()
+   {
+      if (file != NULL)
+      {
+         fclose(file);
+         remove(tempName.c_str());
+      }
+      delete [] buffer;
+   }
+
+   void write(const void * data, size_t size) throw (const char *)
+   {
+      if (size == 0)
+         return;
+      header.payloadSize += size;
+      if (used + size > BUFFER)
+         flush();
+      if (size >= BUFFER)
+      {
+         checksum.update(data, size);
+         put(data, size);
+      }
+      else
+      {
+         memcpy(buffer + used, data, size);
+         used += size;
+      }
+   }
+
+   // fill in the header and put the snapshot in place. The data must
+   // be on disk before the rename, or a crash could leave the name on
+   // a file that was never written, and the directory must be synced
+   // for the rename itself to last
+   void finish(unsigned long long count, unsigned long long extra) throw (const char *)
+   {
+      flush();
+      header.count = count;
+      header.extra = extra;
+      header.checksum = checksum.value();
+      if (fseek(file, 0, SEEK_SET) != 0)
+         throw "ERROR: unable to write the snapshot";
+      put(&header, sizeof(header));
+      bool synced = fflush(file) == 0 && fsync(fileno(file)) == 0;
+      int closed = fclose(file);
+      file = NULL;
+      if (!synced || closed != 0 || rename(tempName.c_str(), fileName.c_str()) != 0)
+      {
+         remove(tempName.c_str());
+         throw "ERROR: unable to write the snapshot";
+      }
+
+      size_t slash = fileName.rfind('/');
+      std::string directory = (slash == std::string::npos) ? "." :
+                              (slash == 0) ? "/" : fileName.substr(0, slash);
+      int fd = ::open(directory.c_str(), O_RDONLY);
+      bool dirSynced = fd >= 0 && fsync(fd) == 0;
+      if (fd >= 0)
+         ::close(fd);
+      if (!dirSynced)
+         throw "ERROR: unable to sync the snapshot's directory";
+   }
+
+private:
+   static const size_t BUFFER = 4 << 20;
+
+   // no copying: the file belongs to one writer
+   SnapshotWriter(const SnapshotWriter &);
+   SnapshotWriter & operator = (const SnapshotWriter &);
+
+   void put(const void * data, size_t size) throw (const char *)
+   {
+      if (fwrite(data, 1, size, file) != size)
+         throw "ERROR: unable to write the snapshot";
+   }
+   void flush() throw (const char *)
+   {
+      checksum.update(buffer, used);
+      put(buffer, used);
+      used = 0;
+   }
+
+   std::string fileName;
+   std::string tempName;
+   FILE * file;
+   char * buffer;
+   size_t used;
+   SnapshotHeader header;
+   SnapshotChecksum checksum;
+};
+
+/**************************************************
+ * SNAPSHOT READER
+ * Maps a snapshot and checks it is whole and of
+ * the kind expected before handing out a pointer
+ * to the payload. The pointer lasts as long as
+ * the reader
+ *************************************************/
+class SnapshotReader
+{
+public:
+   SnapshotReader(const std::string & fileName, unsigned int container,
+                  unsigned int elementKind, unsigned int elementSize) throw (const char *) :
+      image(NULL), size(0)
+   {
+      int fd = ::open(fileName.c_str(), O_RDONLY);
+      if (fd < 0)
+         throw "ERROR: unable to open the snapshot";
+      struct stat status;
+      if (fstat(fd, &status) != 0 || status.st_size < (off_t)sizeof(SnapshotHeader))
+      {
+         ::close(fd);
+         throw "ERROR: not a snapshot";
+      }
+      size = status.st_size;
+      void * mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if (mapped == MAP_FAILED)
+         throw "ERROR: unable to map the snapshot";
+      image = (const char *)mapped;
+      madvise(mapped, size, MADV_SEQUENTIAL);
+
+      const char * error = check(container, elementKind, elementSize);
+      if (error != NULL)
+      {
+         munmap(mapped, size);
+         throw error;
+      }
+   }
+
+   ~SnapshotReader()
+   {
+      munmap((void *)image, size);
+   }
+
+   const SnapshotHeader & header() const { return *(const SnapshotHeader *)image; }
+   const char * payload() const { return image + sizeof(SnapshotHeader); }
+
+private:
+   // no copying: the mapping belongs to one reader
+   SnapshotReader(const SnapshotReader &);
+   SnapshotReader & operator = (const SnapshotReader &);
+
+   const char * check(unsigned int container, unsigned int elementKind,
+                      unsigned int elementSize) const
+   {
+      const SnapshotHeader & h = header();
+      if (memcmp(h.magic, "SNAPSHOT", 8) != 0)
+         return "ERROR: not a snapshot";
+      if (h.version != SNAPSHOT_VERSION)
+         return "ERROR: unsupported snapshot version";
+      if (h.container != container || h.elementKind != elementKind ||
+          h.elementSize != elementSize)
+         return "ERROR: the snapshot holds a different type";
+      if (h.payloadSize != size - sizeof(SnapshotHeader))
+         return "ERROR: the snapshot is truncated";
+
+      SnapshotChecksum checksum;
+      checksum.update(payload(), h.payloadSize);
+      if (checksum.value() != h.checksum)
+         return "ERROR: the snapshot is corrupt";
+      return NULL;
+   }
+
+   const char * image;
+   size_t size;
+};
+
+/**************************************************
+ * SNAPSHOT ELEMENTS
+ * How a run of num elements is laid out. Each kind
+ * gives:
+ *    writeArray  num of them from an array
+ *    write       num of them from an iterator
+ *    check       the bytes the run takes at p, after
+ *                making sure it fits in size
+ *    readArray   num of them into an array
+ *    get         just the i-th
+ *************************************************/
+template <class T, bool RAW = std::is_trivially_copyable <T>::value>
+struct SnapshotElements;
+
+/**************************************************
+ * SNAPSHOT ELEMENTS : RAW
+ * The bytes of each element. An array goes out in
+ * one write and comes back in one copy
+ *************************************************/
+template <class T>
+struct SnapshotElements <T, true>
+{
+   static const unsigned int KIND = SNAPSHOT_RAW;
+   static const unsigned int SIZE = sizeof(T);
+
+   static void writeArray(SnapshotWriter & out, const T * items, int num) throw (const char *)
+   {
+      out.write(items, sizeof(T) * (size_t)num);
+   }
+
+   template <class Iterator>
+   static void write(SnapshotWriter & out, Iterator it, int num) throw (const char *)
+   {
+      for (int i = 0; i < num; i++, ++it)
+      {
+         const T & item = *it;
+         out.write(&item, sizeof(T));
+      }
+   }
+
+   static size_t check(const char * p, size_t size, unsigned long long num) throw (const char *)
+   {
+      if (num > size / sizeof(T))
+         throw "ERROR: the snapshot is truncated";
+      return num * sizeof(T);
+   }
+
+   static void readArray(const char * p, T * items, int num)
+   {
+      if (num > 0)
+         memcpy((void *)items, p, sizeof(T) * (size_t)num);
+   }
+
+   static void get(const char * p, unsigned long long num, unsigned long long i, T & item)
+   {
+      memcpy((void *)&item, p + i * sizeof(T), sizeof(T));
+   }
+};
+
+/**************************************************
+ * SNAPSHOT ELEMENTS : STRING
+ * num + 1 offsets, starting at 0, then the pool:
+ * string i is pool[offsets[i] .. offsets[i + 1])
+ *************************************************/
+template <>
+struct SnapshotElements <std::string, false>
+{
+   static const unsigned int KIND = SNAPSHOT_STRING;
+   static const unsigned int SIZE = 0;
+
+   static void writeArray(SnapshotWriter & out, const std::string * items, int num) throw (const char *)
+   {
+      write(out, items, num);
+   }
+
+   template <class Iterator>
+   static void write(SnapshotWriter & out, Iterator it, int num) throw (const char *)
+   {
+      Iterator first = it;
+      unsigned long long offset = 0;
+      out.write(&offset, sizeof(offset));
+      for (int i = 0; i < num; i++, ++it)
+      {
+         offset += (*it).size();
+         out.write(&offset, sizeof(offset));
+      }
+      it = first;
+      for (int i = 0; i < num; i++, ++it)
+      {
+         const std::string & item = *it;
+         out.write(item.data(), item.size());
+      }
+   }
+
+   static size_t check(const char * p, size_t size, unsigned long long num) throw (const char *)
+   {
+      if (num >= size / 8)
+         throw "ERROR: the snapshot is truncated";
+      size_t poolStart = (num + 1) * 8;
+      unsigned long long previous = offset(p, 0);
+      if (previous != 0)
+         throw "ERROR: the snapshot is corrupt";
+      for (unsigned long long i = 1; i <= num; i++)
+      {
+         unsigned long long next = offset(p, i);
+         if (next < previous)
+            throw "ERROR: the snapshot is corrupt";
+         previous = next;
+      }
+      if (previous > size - poolStart)
+         throw "ERROR: the snapshot is truncated";
+      return poolStart + previous;
+   }
+
+   static void readArray(const char * p, std::string * items, int num)
+   {
+      for (int i = 0; i < num; i++)
+         get(p, num, i, items[i]);
+   }
+
+   static void get(const char * p, unsigned long long num, unsigned long long i,
+                   std::string & item)
+   {
+      unsigned long long first = offset(p, i);
+      item.assign(p + (num + 1) * 8 + first, offset(p, i + 1) - first);
+   }
+
+private:
+   static unsigned long long offset(const char * p, unsigned long long i)
+   {
+      unsigned long long value;
+      memcpy(&value, p + i * 8, 8);
+      return value;
+   }
+};
+
+#endif // SNAPSHOT_H
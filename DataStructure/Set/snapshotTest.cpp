@@ -0,0 +1,156 @@
+/***********************************************************************
+ * Program:
+ *    SNAPSHOT TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks that a Set comes back from a snapshot with the same items
+ *    in the same order, of ints and of strings, and that neither a
+ *    damaged snapshot nor running out of memory part way through a
+ *    restore changes the Set it was restoring into. Exits 1 on the
+ *    first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdio>          // for REMOVE
+#include <cstdlib>         // for EXIT
+#include <fstream>         // for IFSTREAM and OFSTREAM
+#include <new>             // for BAD_ALLOC
+#include <string>
+#include <unistd.h>        // for GETPID
+#include "setSnapshot.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+string fileName = "/tmp/snapshotTest-" + to_string(getpid()) + ".snap";
+
+/**********************************************************************
+ * SCARCE
+ * A plain number whose arrays can be made to fail to allocate
+ ***********************************************************************/
+struct Scarce
+{
+   int value;
+   bool operator <  (const Scarce & rhs) const { return value <  rhs.value; }
+   bool operator == (const Scarce & rhs) const { return value == rhs.value; }
+   bool operator != (const Scarce & rhs) const { return value != rhs.value; }
+   bool operator >  (const Scarce & rhs) const { return value >  rhs.value; }
+   bool operator <= (const Scarce & rhs) const { return value <= rhs.value; }
+   bool operator >= (const Scarce & rhs) const { return value >= rhs.value; }
+
+   static bool outOfMemory;
+   static void * operator new [] (size_t size)
+   {
+      if (outOfMemory)
+         throw bad_alloc();
+      return ::operator new [] (size);
+   }
+   static void operator delete [] (void * p) { ::operator delete [] (p); }
+};
+bool Scarce::outOfMemory = false;
+
+Scarce scarce(int value) { Scarce item = { value }; return item; }
+
+/**********************************************************************
+ * ROUND TRIP
+ * Out and back in, over a Set that held something else
+ ***********************************************************************/
+void roundTrip()
+{
+   Set <int> numbers;
+   for (int i = 0; i < 10000; i++)
+      numbers.insert(i * 7 % 10007);
+   snapshot(numbers, fileName);
+   Set <int> restored;
+   restored.insert(-1);
+   restore(restored, fileName);
+   CHECK(restored.size() == numbers.size());
+   for (int i = 0; i < 10000; i++)
+      CHECK(restored.find(i * 7 % 10007) != restored.end());
+   CHECK(restored.find(-1) == restored.end());
+
+   Set <string> words;
+   for (int i = 0; i < 1000; i++)
+      words.insert("word" + to_string(i));
+   snapshot(words, fileName);
+   Set <string> restoredWords;
+   restore(restoredWords, fileName);
+   CHECK(restoredWords.size() == 1000);
+   for (int i = 0; i < 1000; i++)
+      CHECK(restoredWords.find("word" + to_string(i)) != restoredWords.end());
+
+   Set <int> empty;
+   snapshot(empty, fileName);
+   restore(restored, fileName);
+   CHECK(restored.empty());
+}
+
+/**********************************************************************
+ * LEFT AS IT WAS
+ * A damaged snapshot, and a restore that runs out of memory, both
+ * throw and leave the Set holding what it did
+ ***********************************************************************/
+void leftAsItWas()
+{
+   Set <Scarce> big;
+   for (int i = 0; i < 1000; i++)
+      big.insert(scarce(i));
+   snapshot(big, fileName);
+
+   Set <Scarce> small;
+   for (int i = 0; i < 10; i++)
+      small.insert(scarce(i * 100));
+
+   Scarce::outOfMemory = true;
+   const char * error = NULL;
+   try
+   {
+      restore(small, fileName);
+   }
+   catch (const char * thrown)
+   {
+      error = thrown;
+   }
+   Scarce::outOfMemory = false;
+   CHECK(error != NULL);
+   CHECK(small.size() == 10);
+   for (int i = 0; i < 10; i++)
+      CHECK(small.find(scarce(i * 100)) != small.end());
+
+   ifstream fin(fileName.c_str(), ios::binary);
+   string image((istreambuf_iterator <char> (fin)), istreambuf_iterator <char> ());
+   fin.close();
+   image[image.size() - 1] ^= 1;
+   ofstream fout(fileName.c_str(), ios::binary);
+   fout.write(image.data(), image.size());
+   fout.close();
+   error = NULL;
+   try
+   {
+      restore(small, fileName);
+   }
+   catch (const char * thrown)
+   {
+      error = thrown;
+   }
+   CHECK(error != NULL);
+   CHECK(small.size() == 10);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   roundTrip();
+   leftAsItWas();
+   remove(fileName.c_str());
+   cout << "Snapshot tests passed\n";
+   return 0;
+}
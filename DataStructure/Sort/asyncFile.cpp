@@ -0,0 +1,366 @@
+/***********************************************************************
+ * Implementation:
+ *    ASYNC FILE
+ * Summary:
+ *    The reader and writer threads behind AsyncReader and AsyncWriter,
+ *    and the line splitting of LineReader. See asyncFile.h.
+ * Author
+ *    Daniel Guzman
+ **********************************************************************/
+
+#include <cstring>     // for MEMCHR and MEMCPY
+#include <new>         // for BAD_ALLOC
+#include <system_error> // for SYSTEM_ERROR
+#include "asyncFile.h"
+using namespace std;
+
+/************************************************
+ * ASYNC READER : CONSTRUCTOR
+ * Open the file and start reading ahead
+ ***********************************************/
+AsyncReader :: AsyncReader(const string & fileName, size_t bufferSize)
+    throw (const char *) :
+    current(0), held(-1), atEnd(false), failed(false), stop(false)
+{
+    file = fopen(fileName.c_str(), "rb");
+    if (file == NULL)
+        throw "ERROR: Unable to open file for reading";
+
+    // the destructor will not run if this fails, so close up here
+    try
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            buffers[i].resize(bufferSize);
+            sizes[i] = 0;
+            full[i] = false;
+        }
+        thread = std::thread(&AsyncReader::run, this);
+    }
+    catch (const bad_alloc &)
+    {
+        fclose(file);
+        throw "ERROR: Not enough memory for the file buffers";
+    }
+    catch (const system_error &)
+    {
+        fclose(file);
+        throw "ERROR: Unable to start a thread to read the file";
+    }
+}
+
+/************************************************
+ * ASYNC READER : DESTRUCTOR
+ ***********************************************/
+AsyncReader :: ~AsyncReader()
+{
+    {
+        lock_guard <std::mutex> lock(mutex);
+        stop = true;
+    }
+    ready.notify_all();
+    thread.join();
+    fclose(file);
+}
+
+/************************************************
+ * ASYNC READER : RUN
+ * The background thread: fill each buffer in
+ * turn as soon as the caller gives it back. An
+ * empty block marks the end of the file
+ ***********************************************/
+void AsyncReader :: run()
+{
+    for (int i = 0; ; i ^= 1)
+    {
+        {
+            unique_lock <std::mutex> lock(mutex);
+            while (full[i] && !stop)
+                ready.wait(lock);
+            if (stop)
+                return;
+        }
+
+        size_t num = fread(buffers[i].data(), 1, buffers[i].size(), file);
+        bool error = num == 0 && ferror(file);
+
+        {
+            lock_guard <std::mutex> lock(mutex);
+            sizes[i] = num;
+            full[i] = true;
+            failed = error;
+        }
+        ready.notify_all();
+        if (num == 0)
+            return;
+    }
+}
+
+/************************************************
+ * ASYNC READER : NEXT
+ * Give back the block the caller had and wait
+ * for the one after it
+ ***********************************************/
+size_t AsyncReader :: next(const char *& pBlock) throw (const char *)
+{
+    if (atEnd)
+        return 0;
+
+    unique_lock <std::mutex> lock(mutex);
+    if (held != -1)
+    {
+        full[held] = false;
+        ready.notify_all();
+    }
+    while (!full[current])
+        ready.wait(lock);
+    if (failed)
+        throw "ERROR: Unable to read from file";
+
+    pBlock = buffers[current].data();
+    size_t num = sizes[current];
+    held = current;
+    current ^= 1;
+    atEnd = (num == 0);
+    return num;
+}
+
+/************************************************
+ * ASYNC WRITER : CONSTRUCTOR
+ ***********************************************/
+AsyncWriter :: AsyncWriter(const string & fileName, size_t bufferSize)
+    throw (const char *) :
+    current(0), used(0), failed(false), stop(false)
+{
+    file = fopen(fileName.c_str(), "wb");
+    if (file == NULL)
+        throw "ERROR: Unable to open file for writing";
+
+    // the destructor will not run if this fails, so close up here
+    try
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            buffers[i].resize(bufferSize);
+            sizes[i] = 0;
+            pending[i] = false;
+        }
+        thread = std::thread(&AsyncWriter::run, this);
+    }
+    catch (const bad_alloc &)
+    {
+        fclose(file);
+        throw "ERROR: Not enough memory for the file buffers";
+    }
+    catch (const system_error &)
+    {
+        fclose(file);
+        throw "ERROR: Unable to start a thread to write the file";
+    }
+}
+
+/************************************************
+ * ASYNC WRITER : DESTRUCTOR
+ * A writer that was never closed is abandoned:
+ * whatever was buffered is still written, but
+ * errors can no longer be reported
+ ***********************************************/
+AsyncWriter :: ~AsyncWriter()
+{
+    try
+    {
+        close();
+    }
+    catch (const char *)
+    {
+    }
+}
+
+/************************************************
+ * ASYNC WRITER : RUN
+ * The background thread: write out each buffer
+ * the caller hands over, in order
+ ***********************************************/
+void AsyncWriter :: run()
+{
+    for (int i = 0; ; i ^= 1)
+    {
+        {
+            unique_lock <std::mutex> lock(mutex);
+            while (!pending[i] && !stop)
+                ready.wait(lock);
+            if (!pending[i])
+                return;
+        }
+
+        bool error = fwrite(buffers[i].data(), 1, sizes[i], file) != sizes[i];
+
+        {
+            lock_guard <std::mutex> lock(mutex);
+            pending[i] = false;
+            if (error)
+                failed = true;
+        }
+        ready.notify_all();
+    }
+}
+
+/************************************************
+ * ASYNC WRITER : SUBMIT
+ * Hand the current buffer to the thread and
+ * carry on in the other one once it is free
+ ***********************************************/
+void AsyncWriter :: submit() throw (const char *)
+{
+    unique_lock <std::mutex> lock(mutex);
+    if (failed)
+        throw "ERROR: Unable to write to file";
+    sizes[current] = used;
+    pending[current] = true;
+    ready.notify_all();
+
+    current ^= 1;
+    used = 0;
+    while (pending[current])
+        ready.wait(lock);
+}
+
+/************************************************
+ * ASYNC WRITER : WRITE
+ ***********************************************/
+void AsyncWriter :: write(const char * p, size_t num) throw (const char *)
+{
+    while (num > 0)
+    {
+        if (used == buffers[current].size())
+            submit();
+        size_t room = buffers[current].size() - used;
+        size_t chunk = num < room ? num : room;
+        memcpy(buffers[current].data() + used, p, chunk);
+        used += chunk;
+        p += chunk;
+        num -= chunk;
+    }
+}
+
+/************************************************
+ * ASYNC WRITER : CLOSE
+ * Hand over whatever is left and wait for the
+ * thread to finish. The file is closed even if
+ * a write failed
+ ***********************************************/
+void AsyncWriter :: close() throw (const char *)
+{
+    if (file == NULL)
+        return;
+    {
+        lock_guard <std::mutex> lock(mutex);
+        if (used > 0 && !failed)
+        {
+            sizes[current] = used;
+            pending[current] = true;
+            used = 0;
+        }
+        stop = true;
+    }
+    ready.notify_all();
+    thread.join();
+
+    bool error = fclose(file) != 0;
+    file = NULL;
+    if (failed || error)
+        throw "ERROR: Unable to write to file";
+}
+
+/************************************************
+ * LINE READER : NEXT
+ * Most lines are found whole inside a block. One
+ * that runs off the end is gathered elsewhere
+ ***********************************************/
+bool LineReader :: next(const char *& pLine, size_t & length)
+    throw (const char *)
+{
+    if (pos < size)
+    {
+        const char * pStart = pBlock + pos;
+        const char * pEnd = (const char *)memchr(pStart, '\n', size - pos);
+        if (pEnd)
+        {
+            pLine = pStart;
+            length = pEnd - pStart;
+            pos += length + 1;
+            return true;
+        }
+    }
+
+    try
+    {
+        return gather(pLine, length);
+    }
+    catch (const bad_alloc &)
+    {
+        throw "ERROR: A line is too long to fit in memory";
+    }
+}
+
+/************************************************
+ * LINE READER : GATHER
+ * The line that runs off the end of the block is
+ * gathered into carry, block by block, until its
+ * '\n' turns up
+ ***********************************************/
+bool LineReader :: gather(const char *& pLine, size_t & length)
+{
+    carry.clear();
+    if (pos < size)
+        add(pBlock + pos, size - pos);
+
+    while (true)
+    {
+        pos = 0;
+        size = reader.next(pBlock);
+        if (size == 0)
+        {
+            // a last line with no '\n'
+            pLine = carry.data();
+            length = carry.size();
+            return !carry.empty();
+        }
+
+        const char * pEnd = (const char *)memchr(pBlock, '\n', size);
+        if (pEnd == NULL)
+        {
+            add(pBlock, size);
+            continue;
+        }
+
+        if (carry.empty())
+        {
+            pLine = pBlock;
+            length = pEnd - pBlock;
+        }
+        else
+        {
+            add(pBlock, pEnd - pBlock);
+            pLine = carry.data();
+            length = carry.size();
+        }
+        pos = pEnd - pBlock + 1;
+        return true;
+    }
+}
+
+/************************************************
+ * LINE READER : ADD
+ * Append to carry, which is given room for the
+ * longest line allowed once, rather than left to
+ * double its way past it
+ ***********************************************/
+void LineReader :: add(const char * p, size_t num)
+{
+    if (num > maxLength - carry.size())
+        throw "ERROR: A line is longer than the memory limit allows";
+    if (maxLength != string::npos && carry.capacity() < maxLength)
+        carry.reserve(maxLength);
+    carry.append(p, num);
+}
@@ -0,0 +1,134 @@
+/***********************************************************************
+ * Header:
+ *    ASYNC FILE
+ * Summary:
+ *    Double-buffered file reading and writing. Each file gets a
+ *    background thread and two buffers: while the caller works on one
+ *    buffer the thread fills (or drains) the other, so disk time hides
+ *    behind computation instead of adding to it.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef ASYNC_FILE_H
+#define ASYNC_FILE_H
+
+#include <cstdio>                // for FILE
+#include <string>                // for STRING
+#include <vector>                // for VECTOR
+#include <thread>                // for THREAD
+#include <mutex>                 // for MUTEX
+#include <condition_variable>    // for CONDITION_VARIABLE
+
+/*************************************************************************
+ * ASYNC READER
+ * Hands out a file one block at a time, the next block already being
+ * read while the caller looks at the current one.
+ ************************************************************************/
+class AsyncReader
+{
+public:
+    AsyncReader(const std::string & fileName, size_t bufferSize)
+        throw (const char *);
+    ~AsyncReader();
+
+    // point pBlock at the next block of the file and return its size,
+    // or 0 at the end. The block is good until the following call
+    size_t next(const char *& pBlock) throw (const char *);
+
+private:
+    AsyncReader(const AsyncReader & rhs);
+    AsyncReader & operator = (const AsyncReader & rhs);
+
+    void run();
+
+    FILE * file;
+    std::vector <char> buffers[2];
+    size_t sizes[2];
+    bool full[2];              // holds data the caller has not finished with
+    int  current;              // the buffer the caller gets next
+    int  held;                 // the buffer the caller has now, or -1
+    bool atEnd;
+    bool failed;
+    bool stop;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::thread thread;
+};
+
+/*************************************************************************
+ * ASYNC WRITER
+ * Collects output in one buffer while the other is being written.
+ * close() must be called to find out whether everything made it to disk.
+ ************************************************************************/
+class AsyncWriter
+{
+public:
+    AsyncWriter(const std::string & fileName, size_t bufferSize)
+        throw (const char *);
+    ~AsyncWriter();
+
+    void write(const char * p, size_t num) throw (const char *);
+    void put(char c) throw (const char *)
+    {
+        if (used == buffers[current].size())
+            submit();
+        buffers[current][used++] = c;
+    }
+
+    // flush everything and close the file
+    void close() throw (const char *);
+
+private:
+    AsyncWriter(const AsyncWriter & rhs);
+    AsyncWriter & operator = (const AsyncWriter & rhs);
+
+    void run();
+    void submit() throw (const char *);
+
+    FILE * file;
+    std::vector <char> buffers[2];
+    size_t sizes[2];
+    bool pending[2];           // waiting to be written
+    int  current;              // the buffer being filled
+    size_t used;
+    bool failed;
+    bool stop;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::thread thread;
+};
+
+/*************************************************************************
+ * LINE READER
+ * Splits an AsyncReader's blocks into lines. A line is returned without
+ * its '\n' and normally points straight into the block; only a line that
+ * straddles two blocks is copied. Lines longer than maxLength are an
+ * error, so that copy never takes more than maxLength bytes.
+ ************************************************************************/
+class LineReader
+{
+public:
+    LineReader(const std::string & fileName, size_t bufferSize,
+               size_t maxLength = std::string::npos) throw (const char *) :
+        reader(fileName, bufferSize), pBlock(NULL), pos(0), size(0),
+        maxLength(maxLength) {}
+
+    // the next line, good until the following call. False at the end
+    bool next(const char *& pLine, size_t & length) throw (const char *);
+
+private:
+    // the slow part of next(), for a line that spans blocks, and adding
+    // to it. Both may also throw bad_alloc, which next() reports
+    bool gather(const char *& pLine, size_t & length);
+    void add(const char * p, size_t num);
+
+    AsyncReader reader;
+    const char * pBlock;
+    size_t pos;
+    size_t size;
+    size_t maxLength;
+    std::string carry;          // a line that spans blocks
+};
+
+#endif // ASYNC_FILE_H
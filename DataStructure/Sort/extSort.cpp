@@ -0,0 +1,50 @@
+/***********************************************************************
+ * Program:
+ *    EXTSORT
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Sorts the lines of a file too big to fit in memory, such as a
+ *    sorted.dat from a very large GEDCOM file. Usage:
+ *       extsort <input> <output> [memory limit in MB] [temp directory]
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <chrono>          // for STEADY_CLOCK
+#include <cstdlib>         // for ATOL
+#include "externalSort.h"
+using namespace std;
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+    if (argc < 3 || argc > 5)
+    {
+        cerr << "Usage: " << argv[0]
+             << " <input> <output> [memory limit in MB] [temp directory]\n";
+        return 1;
+    }
+    size_t megabytes = (argc > 3) ? atol(argv[3]) : 1024;
+    string tempDirectory = (argc > 4) ? argv[4] : ".";
+
+    try
+    {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        ExternalSort sorter(megabytes << 20, tempDirectory);
+        sorter.sort(argv[1], argv[2]);
+        chrono::duration <double> elapsed = chrono::steady_clock::now() - start;
+
+        cout << "Sorted " << sorter.numLines() << " lines in "
+             << sorter.numRuns() << " runs and "
+             << sorter.numPasses() << " merge passes, "
+             << elapsed.count() << " seconds\n";
+    }
+    catch (const char * error)
+    {
+        cerr << error << endl;
+        return 1;
+    }
+    return 0;
+}
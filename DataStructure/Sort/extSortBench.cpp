@@ -0,0 +1,164 @@
+/***********************************************************************
+ * Program:
+ *    EXTSORT BENCH
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Writes a file of random lines far bigger than the memory limit,
+ *    sorts it with ExternalSort, and reports the time, the throughput
+ *    and the peak resident memory, which should be no more than the
+ *    limit plus what the program held before the sort began.
+ *    The output is then checked to be in order with every line there.
+ *    The files are removed afterwards. Usage:
+ *       extSortBench [gigabytes] [memory limit in MB] [directory]
+ *    The defaults are 20GB under a 1024MB limit in this directory,
+ *    which needs about 60GB of free disk.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <chrono>          // for STEADY_CLOCK
+#include <cstdio>          // for REMOVE
+#include <cstdlib>         // for ATOL
+#include <string>          // for STRING
+#include <sys/resource.h>  // for GETRUSAGE
+#include "asyncFile.h"
+#include "externalSort.h"
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+/**********************************************************************
+ * SECONDS SINCE
+ ***********************************************************************/
+double secondsSince(Clock::time_point start)
+{
+    return chrono::duration <double> (Clock::now() - start).count();
+}
+
+/**********************************************************************
+ * PEAK MEGABYTES
+ * The most this process has had resident at once
+ ***********************************************************************/
+double peakMegabytes()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.0;
+}
+
+/**********************************************************************
+ * XORSHIFT
+ * A library generator would be the slow part of writing 20GB
+ ***********************************************************************/
+unsigned long long xorshift(unsigned long long & state)
+{
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+/**********************************************************************
+ * GENERATE
+ * Lines of 8 to 120 random letters until the file holds the given
+ * number of bytes. Returns the number of lines
+ ***********************************************************************/
+long long generate(const string & fileName, long long numBytes)
+{
+    AsyncWriter out(fileName, 1 << 20);
+    unsigned long long state = 36;
+    long long numLines = 0;
+    char line[120];
+    for (long long written = 0; written < numBytes; numLines++)
+    {
+        int length = 8 + (int)(xorshift(state) % 113);
+        for (int i = 0; i < length; i++)
+            line[i] = 'a' + (int)(xorshift(state) % 26);
+        out.write(line, length);
+        out.put('\n');
+        written += length + 1;
+    }
+    out.close();
+    return numLines;
+}
+
+/**********************************************************************
+ * CHECK SORTED
+ * Every line no smaller than the one before, and the expected count
+ ***********************************************************************/
+bool checkSorted(const string & fileName, long long numLines)
+{
+    LineReader in(fileName, 8 << 20);
+    string previous;
+    const char * pLine;
+    size_t length;
+    long long num = 0;
+    for (; in.next(pLine, length); num++)
+    {
+        string line(pLine, length);
+        if (line < previous)
+        {
+            cerr << "Line " << num + 1 << " is out of order\n";
+            return false;
+        }
+        previous.swap(line);
+    }
+    if (num != numLines)
+    {
+        cerr << num << " lines came out of " << numLines << endl;
+        return false;
+    }
+    return true;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+    if (argc > 4)
+    {
+        cerr << "Usage: " << argv[0]
+             << " [gigabytes] [memory limit in MB] [directory]\n";
+        return 1;
+    }
+    long long gigabytes = (argc > 1) ? atol(argv[1]) : 20;
+    size_t megabytes = (argc > 2) ? atol(argv[2]) : 1024;
+    string directory = (argc > 3) ? argv[3] : ".";
+    string inFileName = directory + "/extSortBench.in";
+    string outFileName = directory + "/extSortBench.out";
+
+    bool sorted = false;
+    try
+    {
+        Clock::time_point start = Clock::now();
+        long long numLines = generate(inFileName, gigabytes << 30);
+        cout << "Wrote " << gigabytes << "GB, " << numLines << " lines, in "
+             << secondsSince(start) << " seconds\n";
+
+        double before = peakMegabytes();
+        start = Clock::now();
+        ExternalSort sorter(megabytes << 20, directory);
+        sorter.sort(inFileName, outFileName);
+        double seconds = secondsSince(start);
+        cout << "Sorted under a " << megabytes << "MB limit in "
+             << sorter.numRuns() << " runs and " << sorter.numPasses()
+             << " merge passes, " << seconds << " seconds, "
+             << (gigabytes << 10) / seconds << "MB/s\n"
+             << "Peak resident memory " << peakMegabytes() << "MB, "
+             << before << "MB of it before the sort began\n";
+
+        sorted = checkSorted(outFileName, numLines);
+    }
+    catch (const char * error)
+    {
+        cerr << error << endl;
+    }
+
+    remove(inFileName.c_str());
+    remove(outFileName.c_str());
+    if (!sorted)
+        return 1;
+    cout << "The output is in order\n";
+    return 0;
+}
@@ -0,0 +1,349 @@
+/***********************************************************************
+ * Implementation:
+ *    EXTERNAL SORT
+ * Summary:
+ *    Run formation, spilling and the k-way loser tree merge behind
+ *    ExternalSort. See externalSort.h.
+ * Author
+ *    Daniel Guzman
+ **********************************************************************/
+
+#include <cstdio>          // for REMOVE
+#include <cstring>         // for MEMCMP and MEMCPY
+#include <memory>          // for UNIQUE_PTR
+#include <new>             // for BAD_ALLOC
+#include <system_error>    // for SYSTEM_ERROR
+#include <unistd.h>        // for GETPID
+#include "asyncFile.h"
+#include "externalSort.h"
+#include "sortPdq.h"
+using namespace std;
+
+// bounds on the size of each half of a double buffer
+const size_t MIN_BUFFER = 64 * 1024;
+const size_t MAX_BUFFER = 8 * 1024 * 1024;
+
+// runs merged at once. Every run has its own reader thread
+const int MAX_FAN_IN = 64;
+
+/************************************************
+ * COMPARE LINES
+ * Byte by byte, a prefix before a longer line
+ ***********************************************/
+static int compareLines(const char * lhs, size_t numLhs,
+                        const char * rhs, size_t numRhs)
+{
+    int result = memcmp(lhs, rhs, numLhs < numRhs ? numLhs : numRhs);
+    if (result != 0)
+        return result;
+    return numLhs < numRhs ? -1 : (numLhs > numRhs ? 1 : 0);
+}
+
+/*************************************************************************
+ * LINE REF
+ * A line of the run being sorted. The first eight bytes are kept as a
+ * big-endian number so most comparisons never touch the text itself.
+ ************************************************************************/
+struct LineRef
+{
+    unsigned long long prefix;
+    const char * p;
+    size_t length;
+
+    void set(const char * pLine, size_t numLine)
+    {
+        p = pLine;
+        length = numLine;
+        prefix = 0;
+        for (size_t i = 0; i < 8; i++)
+            prefix = (prefix << 8) | (i < numLine ? (unsigned char)pLine[i] : 0);
+    }
+
+    bool operator < (const LineRef & rhs) const
+    {
+        if (prefix != rhs.prefix)
+            return prefix < rhs.prefix;
+        return compareLines(p, length, rhs.p, rhs.length) < 0;
+    }
+};
+
+/*************************************************************************
+ * LOSER TREE
+ * A tournament among k sorted runs. Each inner node remembers the run
+ * that lost the match played there, and tree[0] the overall winner, so
+ * replacing the winner's line costs one match per level: log k
+ * comparisons, against 2 log k for a binary heap.
+ ************************************************************************/
+class LoserTree
+{
+public:
+    LoserTree(const vector <string> & runNames, size_t bufferSize,
+              size_t maxLength) :
+        k((int)runNames.size()), lines(k), lengths(k), live(k), tree(k, k)
+    {
+        for (int i = 0; i < k; i++)
+        {
+            sources.push_back(unique_ptr <LineReader>
+                              (new LineReader(runNames[i], bufferSize,
+                                              maxLength)));
+            live[i] = sources[i]->next(lines[i], lengths[i]);
+        }
+
+        // every node starts out holding k, which beats everybody
+        for (int i = k - 1; i >= 0; i--)
+            replay(i);
+    }
+
+    // the smallest line left, or false once every run is used up
+    bool top(const char *& pLine, size_t & length) const
+    {
+        int winner = tree[0];
+        pLine = lines[winner];
+        length = lengths[winner];
+        return live[winner];
+    }
+
+    // move the winning run on to its next line
+    void pop() throw (const char *)
+    {
+        int winner = tree[0];
+        live[winner] = sources[winner]->next(lines[winner], lengths[winner]);
+        replay(winner);
+    }
+
+private:
+    // does run a come out ahead of run b? Ties go to the earlier run
+    bool beats(int a, int b) const
+    {
+        if (a == k || b == k)
+            return a == k;
+        if (!live[a] || !live[b])
+            return live[a];
+        int result = compareLines(lines[a], lengths[a], lines[b], lengths[b]);
+        return result != 0 ? result < 0 : a < b;
+    }
+
+    // play run s up the tree from its leaf to the root
+    void replay(int s)
+    {
+        for (int node = (s + k) / 2; node > 0; node /= 2)
+            if (beats(tree[node], s))
+                swap(s, tree[node]);
+        tree[0] = s;
+    }
+
+    int k;
+    vector <unique_ptr <LineReader> > sources;
+    vector <const char *> lines;
+    vector <size_t> lengths;
+    vector <bool> live;
+    vector <int> tree;
+};
+
+/************************************************
+ * EXTERNAL SORT : CONSTRUCTOR
+ * Each double buffer gets about 1/64th of the
+ * memory, within reason. A merge gives each of
+ * its readers a share of what the output leaves,
+ * a third for each buffer and a third for a line
+ * that spans them, which sets the longest line
+ ***********************************************/
+ExternalSort :: ExternalSort(size_t memoryLimit, const string & tempDirectory)
+    throw (const char *) :
+    memoryLimit(memoryLimit), tempDirectory(tempDirectory),
+    numTempFiles(0), lines(0), runs(0), passes(0)
+{
+    if (memoryLimit < 16 * MIN_BUFFER)
+        throw "ERROR: The memory limit must be at least 1MB";
+
+    bufferSize = memoryLimit / 64;
+    if (bufferSize < MIN_BUFFER)
+        bufferSize = MIN_BUFFER;
+    if (bufferSize > MAX_BUFFER)
+        bufferSize = MAX_BUFFER;
+
+    size_t readBytes = memoryLimit - 2 * bufferSize;
+    fanIn = (int)(readBytes / (3 * MIN_BUFFER));
+    if (fanIn > MAX_FAN_IN)
+        fanIn = MAX_FAN_IN;
+    maxLine = readBytes / (3 * fanIn);
+    if (maxLine > bufferSize)
+        maxLine = bufferSize;
+}
+
+/************************************************
+ * EXTERNAL SORT : TEMP NAME
+ ***********************************************/
+string ExternalSort :: tempName()
+{
+    return tempDirectory + "/extsort." + to_string(getpid()) + "." +
+           to_string(numTempFiles++) + ".run";
+}
+
+/************************************************
+ * EXTERNAL SORT : SORT
+ * Temporary files are removed whether or not
+ * the sort succeeds. Running out of memory, or
+ * of threads, is reported like any other error
+ ***********************************************/
+void ExternalSort :: sort(const string & inFileName, const string & outFileName)
+    throw (const char *)
+{
+    lines = 0;
+    runs = 0;
+    passes = 0;
+    numTempFiles = 0;
+
+    vector <string> runNames;
+    try
+    {
+        makeRuns(inFileName, outFileName, runNames);
+        if (runs > 1)
+            merge(runNames, outFileName);
+    }
+    catch (const char *)
+    {
+        removeTempFiles();
+        throw;
+    }
+    catch (const bad_alloc &)
+    {
+        removeTempFiles();
+        throw "ERROR: Not enough memory for the external sort";
+    }
+    catch (const system_error &)
+    {
+        removeTempFiles();
+        throw "ERROR: Unable to start a thread for the external sort";
+    }
+    catch (...)
+    {
+        removeTempFiles();
+        throw "ERROR: The external sort failed";
+    }
+}
+
+/************************************************
+ * EXTERNAL SORT : REMOVE TEMP FILES
+ * Every name handed out so far, whether or not
+ * the file is still there
+ ***********************************************/
+void ExternalSort :: removeTempFiles()
+{
+    int numCreated = numTempFiles;
+    numTempFiles = 0;
+    for (int i = 0; i < numCreated; i++)
+        remove(tempName().c_str());
+    numTempFiles = numCreated;
+}
+
+/************************************************
+ * EXTERNAL SORT : MAKE RUNS
+ * Fill one block of memory with lines, the text
+ * growing up from the bottom and a LineRef for
+ * each line growing down from the top, until the
+ * two meet. Sort the LineRefs and write the run.
+ * A file that fits in one run goes straight to
+ * the output
+ ***********************************************/
+void ExternalSort :: makeRuns(const string & inFileName,
+                              const string & outFileName,
+                              vector <string> & runNames)
+{
+    // what is left after the input and run double buffers, and the
+    // input's longest line
+    size_t runBytes = memoryLimit - 4 * bufferSize - maxLine;
+    unique_ptr <char []> arena(new char[runBytes]);
+    LineRef * pRefsEnd = (LineRef *)(arena.get() +
+                                     runBytes / sizeof(LineRef) * sizeof(LineRef));
+
+    LineReader input(inFileName, bufferSize, maxLine);
+    const char * pLine;
+    size_t length;
+    bool haveLine = input.next(pLine, length);
+
+    do
+    {
+        size_t used = 0;
+        LineRef * pRefs = pRefsEnd;
+        for (; haveLine; haveLine = input.next(pLine, length))
+        {
+            if ((char *)(pRefs - 1) < arena.get() + used + length)
+            {
+                if (pRefs == pRefsEnd)
+                    throw "ERROR: A line is longer than the memory limit allows";
+                break;
+            }
+            memcpy(arena.get() + used, pLine, length);
+            (--pRefs)->set(arena.get() + used, length);
+            used += length;
+        }
+
+        int num = (int)(pRefsEnd - pRefs);
+        sortPdq(pRefs, num);
+
+        runNames.push_back(runs == 0 && !haveLine ? outFileName : tempName());
+        AsyncWriter run(runNames.back(), bufferSize);
+        for (int i = 0; i < num; i++)
+        {
+            run.write(pRefs[i].p, pRefs[i].length);
+            run.put('\n');
+        }
+        run.close();
+
+        lines += num;
+        runs++;
+    }
+    while (haveLine);
+}
+
+/************************************************
+ * EXTERNAL SORT : MERGE
+ * Merge up to fanIn runs at a time, as many as
+ * leave each reader a sensible buffer, until a
+ * single merge can produce the output
+ ***********************************************/
+void ExternalSort :: merge(const vector <string> & runNames,
+                           const string & outFileName)
+{
+    size_t readBytes = memoryLimit - 2 * bufferSize;
+
+    vector <string> pending(runNames);
+    while (true)
+    {
+        bool last = (int)pending.size() <= fanIn;
+        vector <string> merged;
+        for (size_t first = 0; first < pending.size(); first += fanIn)
+        {
+            vector <string> group(pending.begin() + first,
+                                  pending.begin() + min(first + fanIn,
+                                                        pending.size()));
+            if (group.size() == 1)
+            {
+                merged.push_back(group[0]);
+                continue;
+            }
+
+            merged.push_back(last ? outFileName : tempName());
+            LoserTree tree(group, readBytes / (3 * group.size()), maxLine);
+            AsyncWriter out(merged.back(), bufferSize);
+            const char * pLine;
+            size_t length;
+            while (tree.top(pLine, length))
+            {
+                out.write(pLine, length);
+                out.put('\n');
+                tree.pop();
+            }
+            out.close();
+
+            for (size_t i = 0; i < group.size(); i++)
+                remove(group[i].c_str());
+        }
+        passes++;
+
+        if (last)
+            return;
+        pending.swap(merged);
+    }
+}
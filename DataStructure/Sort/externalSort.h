@@ -0,0 +1,68 @@
+/***********************************************************************
+ * Header:
+ *    EXTERNAL SORT
+ * Summary:
+ *    Sorts the lines of a text file that may be far bigger than memory.
+ *    The file is read in runs that fit in the memory allowance, each
+ *    run is sorted in memory and spilled to a temporary file, and then
+ *    the runs are merged with a loser tree. All file access is double
+ *    buffered in the background (see asyncFile.h).
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <string>
+#include <vector>
+
+/*************************************************************************
+ * EXTERNAL SORT
+ * Lines are compared byte by byte, the order of std::string's operator <.
+ * Every output line ends in '\n', even if the last input line did not.
+ * A line longer than maxLineLength() is an error rather than a reason to
+ * go over the memory limit.
+ ************************************************************************/
+class ExternalSort
+{
+public:
+    // memoryLimit covers the run being sorted and every I/O buffer.
+    // Temporary files go in tempDirectory
+    ExternalSort(size_t memoryLimit, const std::string & tempDirectory = ".")
+        throw (const char *);
+
+    void sort(const std::string & inFileName, const std::string & outFileName)
+        throw (const char *);
+
+    // what the last sort did
+    long long numLines()  const { return lines;  }
+    int       numRuns()   const { return runs;   }
+    int       numPasses() const { return passes; }
+
+    size_t maxLineLength() const { return maxLine; }
+
+private:
+    // these may also throw bad_alloc or system_error, which sort()
+    // turns into a message once the temporary files are gone
+    std::string tempName();
+    void removeTempFiles();
+    void makeRuns(const std::string & inFileName,
+                  const std::string & outFileName,
+                  std::vector <std::string> & runNames);
+    void merge(const std::vector <std::string> & runNames,
+               const std::string & outFileName);
+
+    size_t memoryLimit;
+    size_t bufferSize;          // each half of a double buffer
+    int fanIn;                  // runs merged at once
+    size_t maxLine;
+    std::string tempDirectory;
+    int numTempFiles;
+
+    long long lines;
+    int runs;
+    int passes;
+};
+
+#endif // EXTERNAL_SORT_H
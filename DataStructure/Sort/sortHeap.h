@@ -0,0 +1,56 @@
+/***********************************************************************
+ * Header:
+ *    HEAP SORT
+ * Summary:
+ *    An in-place O(n log n) sort with no bad cases. Too slow to be the
+ *    first choice, but it is the safety net that keeps introsort and
+ *    pdqsort from ever going quadratic.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef SORT_HEAP_H
+#define SORT_HEAP_H
+
+/***********************************************
+ * SIFT DOWN
+ * Move array[i] down the max-heap array[0..num)
+ * until both of its children are no bigger
+ **********************************************/
+template <class T>
+void siftDown(T array[], int i, int num)
+{
+    T item = array[i];
+    int child;
+    while ((child = 2 * i + 1) < num)
+    {
+        if (child + 1 < num && array[child] < array[child + 1])
+            child++;
+        if (!(item < array[child]))
+            break;
+        array[i] = array[child];
+        i = child;
+    }
+    array[i] = item;
+}
+
+/***********************************************
+ * HEAP SORT
+ * Build a max-heap, then repeatedly swap the top
+ * to the end of the shrinking heap
+ **********************************************/
+template <class T>
+void sortHeap(T array[], int num)
+{
+    for (int i = num / 2 - 1; i >= 0; i--)
+        siftDown(array, i, num);
+    for (int last = num - 1; last > 0; last--)
+    {
+        T tmp = array[0];
+        array[0] = array[last];
+        array[last] = tmp;
+        siftDown(array, 0, last);
+    }
+}
+
+#endif // SORT_HEAP_H
@@ -0,0 +1,127 @@
+/***********************************************************************
+ * Header:
+ *    INTRO SORT
+ * Summary:
+ *    Quicksort with a median-of-three pivot, insertion sort for short
+ *    ranges, and a fallback to heap sort once the recursion gets deeper
+ *    than 2 log n. That keeps quicksort's speed on ordinary input while
+ *    guaranteeing O(n log n) on inputs built to defeat it.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef SORT_INTRO_H
+#define SORT_INTRO_H
+
+#include "sortHeap.h"
+
+// ranges this short are left for insertion sort
+const int INTRO_THRESHOLD = 16;
+
+/***********************************************
+ * INTRO INSERTION
+ * Straight insertion sort of array[0..num)
+ **********************************************/
+template <class T>
+void introInsertion(T array[], int num)
+{
+    for (int i = 1; i < num; i++)
+    {
+        T item = array[i];
+        int j = i;
+        for (; j > 0 && item < array[j - 1]; j--)
+            array[j] = array[j - 1];
+        array[j] = item;
+    }
+}
+
+/***********************************************
+ * INTRO SWAP
+ **********************************************/
+template <class T>
+inline void introSwap(T & lhs, T & rhs)
+{
+    T tmp = lhs;
+    lhs = rhs;
+    rhs = tmp;
+}
+
+/***********************************************
+ * INTRO LOOP
+ * Partition around the median of the first,
+ * middle and last items, recurse on the smaller
+ * side and loop on the larger one. Short ranges
+ * are left unsorted for one final insertion pass
+ **********************************************/
+template <class T>
+void introLoop(T array[], int num, int depthLimit)
+{
+    while (num > INTRO_THRESHOLD)
+    {
+        if (depthLimit-- == 0)
+        {
+            sortHeap(array, num);
+            return;
+        }
+
+        // order first, middle and last; the middle becomes the pivot
+        int mid = num / 2;
+        if (array[mid] < array[0])
+            introSwap(array[mid], array[0]);
+        if (array[num - 1] < array[mid])
+        {
+            introSwap(array[num - 1], array[mid]);
+            if (array[mid] < array[0])
+                introSwap(array[mid], array[0]);
+        }
+        T pivot = array[mid];
+
+        // Hoare partition. The sorted ends act as sentinels
+        int i = 0;
+        int j = num - 1;
+        while (true)
+        {
+            while (array[++i] < pivot)
+                ;
+            while (pivot < array[--j])
+                ;
+            if (i >= j)
+                break;
+            introSwap(array[i], array[j]);
+        }
+
+        // array[0..j] <= pivot <= array[j+1..num)
+        int numLeft = j + 1;
+        if (numLeft < num - numLeft)
+        {
+            introLoop(array, numLeft, depthLimit);
+            array += numLeft;
+            num -= numLeft;
+        }
+        else
+        {
+            introLoop(array + numLeft, num - numLeft, depthLimit);
+            num = numLeft;
+        }
+    }
+}
+
+/*****************************************************
+ * SORT INTRO
+ * Sort the items in the array. Not stable
+ ****************************************************/
+template <class T>
+void sortIntro(T array[], int num)
+{
+    if (num < 2)
+        return;
+
+    int depthLimit = 0;
+    for (int n = num; n > 1; n >>= 1)
+        depthLimit += 2;
+
+    introLoop(array, num, depthLimit);
+    introInsertion(array, num);
+}
+
+#endif // SORT_INTRO_H
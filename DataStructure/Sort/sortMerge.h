@@ -0,0 +1,254 @@
+/***********************************************************************
+ * Header:
+ *    NATURAL MERGE SORT
+ * Summary:
+ *    A stable merge sort that takes advantage of order already in the
+ *    input, along the lines of TimSort. The array is cut into runs that
+ *    are already ascending (descending runs are reversed in place);
+ *    short runs are grown to a minimum length with binary insertion
+ *    sort. Runs are merged while keeping their lengths on a stack
+ *    roughly balanced, so sorted input costs one pass and random input
+ *    costs O(n log n).
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef SORT_MERGE_H
+#define SORT_MERGE_H
+
+#include <vector>
+
+/***********************************************
+ * MERGE MIN RUN
+ * A run length between 32 and 64 such that
+ * num / minRun is a power of two or just under
+ * one, which keeps the final merges balanced
+ **********************************************/
+inline int mergeMinRun(int num)
+{
+    int extra = 0;
+    while (num >= 64)
+    {
+        extra |= num & 1;
+        num >>= 1;
+    }
+    return num + extra;
+}
+
+/***********************************************
+ * MERGE UPPER BOUND / LOWER BOUND
+ * First place in array[0..num) whose item is
+ * bigger than (or not smaller than) item
+ **********************************************/
+template <class T>
+int mergeUpperBound(const T array[], int num, const T & item)
+{
+    int lo = 0;
+    while (lo < num)
+    {
+        int mid = lo + (num - lo) / 2;
+        if (item < array[mid])
+            num = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+template <class T>
+int mergeLowerBound(const T array[], int num, const T & item)
+{
+    int lo = 0;
+    while (lo < num)
+    {
+        int mid = lo + (num - lo) / 2;
+        if (array[mid] < item)
+            lo = mid + 1;
+        else
+            num = mid;
+    }
+    return lo;
+}
+
+/***********************************************
+ * MERGE BINARY INSERTION
+ * array[0..sorted) is in order; insert the rest
+ * one at a time, each after any equal items
+ **********************************************/
+template <class T>
+void mergeBinaryInsertion(T array[], int sorted, int num)
+{
+    for (int i = sorted; i < num; i++)
+    {
+        T item = array[i];
+        int place = mergeUpperBound(array, i, item);
+        for (int j = i; j > place; j--)
+            array[j] = array[j - 1];
+        array[place] = item;
+    }
+}
+
+/***********************************************
+ * MERGE COUNT RUN
+ * Length of the run at the start of the array.
+ * A strictly descending run is reversed so that
+ * equal items never trade places
+ **********************************************/
+template <class T>
+int mergeCountRun(T array[], int num)
+{
+    if (num < 2)
+        return num;
+
+    int end = 2;
+    if (array[1] < array[0])
+    {
+        while (end < num && array[end] < array[end - 1])
+            end++;
+        for (int lo = 0, hi = end - 1; lo < hi; lo++, hi--)
+        {
+            T tmp = array[lo];
+            array[lo] = array[hi];
+            array[hi] = tmp;
+        }
+    }
+    else
+    {
+        while (end < num && !(array[end] < array[end - 1]))
+            end++;
+    }
+    return end;
+}
+
+/***********************************************
+ * MERGE RUNS
+ * Merge the neighbouring runs array[0..numA) and
+ * array[numA..numA+numB). Items of A already no
+ * bigger than B's first, and items of B already
+ * no smaller than A's last, stay where they are.
+ * Whichever remaining side is shorter is copied
+ * out to the buffer
+ **********************************************/
+template <class T>
+void mergeRuns(T array[], int numA, int numB, T buffer[])
+{
+    T * a = array;
+    T * b = array + numA;
+
+    int skip = mergeUpperBound(a, numA, b[0]);
+    a += skip;
+    numA -= skip;
+    if (numA == 0)
+        return;
+    numB = mergeLowerBound(b, numB, a[numA - 1]);
+
+    if (numA <= numB)
+    {
+        // merge forward from the front, A in the buffer
+        for (int i = 0; i < numA; i++)
+            buffer[i] = a[i];
+        T * pDest = a;
+        T * pA = buffer;
+        T * pAEnd = buffer + numA;
+        T * pB = b;
+        T * pBEnd = b + numB;
+        while (pA != pAEnd && pB != pBEnd)
+            *pDest++ = (*pB < *pA) ? *pB++ : *pA++;
+        while (pA != pAEnd)
+            *pDest++ = *pA++;
+    }
+    else
+    {
+        // merge backward from the end, B in the buffer
+        for (int i = 0; i < numB; i++)
+            buffer[i] = b[i];
+        T * pDest = b + numB;
+        T * pA = a + numA;
+        T * pB = buffer + numB;
+        while (pA != a && pB != buffer)
+            *--pDest = (*(pB - 1) < *(pA - 1)) ? *--pA : *--pB;
+        while (pB != buffer)
+            *--pDest = *--pB;
+    }
+}
+
+/*****************************************************
+ * SORT MERGE
+ * Sort the items in the array, keeping equal items in
+ * their original order. Uses a buffer of num / 2 items.
+ * The run stack keeps, for the top three runs X Y Z
+ * (Z on top), X > Y + Z and Y > Z; a run breaking
+ * that is merged with the smaller of its neighbours
+ ****************************************************/
+template <class T>
+void sortMerge(T array[], int num)
+{
+    if (num < 2)
+        return;
+
+    int minRun = mergeMinRun(num);
+    std::vector <T> buffer(num / 2 + 1);
+
+    // run stack; lengths grow at least like Fibonacci so 64 is plenty
+    int runStart[64];
+    int runLength[64];
+    int numRuns = 0;
+
+    for (int start = 0; start < num; )
+    {
+        int length = mergeCountRun(array + start, num - start);
+        if (length < minRun)
+        {
+            int grown = (num - start < minRun) ? num - start : minRun;
+            mergeBinaryInsertion(array + start, length, grown);
+            length = grown;
+        }
+        runStart[numRuns] = start;
+        runLength[numRuns] = length;
+        numRuns++;
+        start += length;
+
+        // restore the stack invariants
+        while (numRuns > 1)
+        {
+            int n = numRuns - 2;
+            if ((n > 0 && runLength[n - 1] <= runLength[n] + runLength[n + 1]) ||
+                (n > 1 && runLength[n - 2] <= runLength[n - 1] + runLength[n]))
+            {
+                if (runLength[n - 1] < runLength[n + 1])
+                    n--;
+            }
+            else if (runLength[n] > runLength[n + 1])
+                break;
+
+            mergeRuns(array + runStart[n], runLength[n], runLength[n + 1],
+                      buffer.data());
+            runLength[n] += runLength[n + 1];
+            for (int i = n + 1; i < numRuns - 1; i++)
+            {
+                runStart[i] = runStart[i + 1];
+                runLength[i] = runLength[i + 1];
+            }
+            numRuns--;
+        }
+    }
+
+    // merge whatever is left, top down
+    while (numRuns > 1)
+    {
+        int n = numRuns - 2;
+        if (n > 0 && runLength[n - 1] < runLength[n + 1])
+            n--;
+        mergeRuns(array + runStart[n], runLength[n], runLength[n + 1],
+                  buffer.data());
+        runLength[n] += runLength[n + 1];
+        for (int i = n + 1; i < numRuns - 1; i++)
+        {
+            runStart[i] = runStart[i + 1];
+            runLength[i] = runLength[i + 1];
+        }
+        numRuns--;
+    }
+}
+
+#endif // SORT_MERGE_H
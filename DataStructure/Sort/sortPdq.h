@@ -0,0 +1,465 @@
+/***********************************************************************
+ * Header:
+ *    PATTERN-DEFEATING QUICKSORT
+ * Summary:
+ *    A quicksort that notices the shape of its input, after Orson
+ *    Peters' pdqsort:
+ *      - a partition that swapped nothing suggests the range is nearly
+ *        sorted, so a bounded insertion sort is tried first;
+ *      - a pivot equal to the item before the range means the range is
+ *        full of duplicates, which are swept aside in one pass;
+ *      - a lopsided partition scrambles a few items to break up the
+ *        pattern, and too many of them switch over to heap sort.
+ *    For numbers the partition is branchless: items are compared a
+ *    block at a time and the offsets of misplaced ones are recorded
+ *    without a conditional jump, so the CPU has nothing to mispredict.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef SORT_PDQ_H
+#define SORT_PDQ_H
+
+#include <cstddef>        // for SIZE_T
+#include <type_traits>    // for IS_ARITHMETIC
+#include "sortHeap.h"
+
+// ranges this short are insertion sorted
+const int PDQ_INSERTION = 24;
+
+// ranges longer than this take their pivot from a ninther
+const int PDQ_NINTHER = 128;
+
+// the nearly-sorted check gives up after moving this many items
+const int PDQ_PARTIAL_LIMIT = 8;
+
+// items compared per block by the branchless partition
+const int PDQ_BLOCK = 64;
+
+/***********************************************
+ * PDQ SWAP
+ **********************************************/
+template <class T>
+inline void pdqSwap(T * lhs, T * rhs)
+{
+    T tmp = *lhs;
+    *lhs = *rhs;
+    *rhs = tmp;
+}
+
+/***********************************************
+ * PDQ SORT 3
+ * Order three items in place
+ **********************************************/
+template <class T>
+inline void pdqSort3(T * a, T * b, T * c)
+{
+    if (*b < *a) pdqSwap(a, b);
+    if (*c < *b) pdqSwap(b, c);
+    if (*b < *a) pdqSwap(a, b);
+}
+
+/***********************************************
+ * PDQ INSERTION
+ * Insertion sort of [begin, end). The unguarded
+ * version may only be used when something no
+ * bigger than any item sits just before begin
+ **********************************************/
+template <class T>
+void pdqInsertion(T * begin, T * end)
+{
+    if (begin == end)
+        return;
+    for (T * pCur = begin + 1; pCur != end; ++pCur)
+    {
+        T * pSift = pCur;
+        T * pSift1 = pCur - 1;
+        if (*pSift < *pSift1)
+        {
+            T item = *pSift;
+            do
+                *pSift-- = *pSift1;
+            while (pSift != begin && item < *--pSift1);
+            *pSift = item;
+        }
+    }
+}
+
+template <class T>
+void pdqUnguardedInsertion(T * begin, T * end)
+{
+    if (begin == end)
+        return;
+    for (T * pCur = begin + 1; pCur != end; ++pCur)
+    {
+        T * pSift = pCur;
+        T * pSift1 = pCur - 1;
+        if (*pSift < *pSift1)
+        {
+            T item = *pSift;
+            do
+                *pSift-- = *pSift1;
+            while (item < *--pSift1);
+            *pSift = item;
+        }
+    }
+}
+
+/***********************************************
+ * PDQ PARTIAL INSERTION
+ * Insertion sort that gives up once it has had
+ * to move too many items. Returns true if the
+ * range ended up sorted
+ **********************************************/
+template <class T>
+bool pdqPartialInsertion(T * begin, T * end)
+{
+    if (begin == end)
+        return true;
+    long moved = 0;
+    for (T * pCur = begin + 1; pCur != end; ++pCur)
+    {
+        T * pSift = pCur;
+        T * pSift1 = pCur - 1;
+        if (*pSift < *pSift1)
+        {
+            T item = *pSift;
+            do
+                *pSift-- = *pSift1;
+            while (pSift != begin && item < *--pSift1);
+            *pSift = item;
+            moved += pCur - pSift;
+        }
+        if (moved > PDQ_PARTIAL_LIMIT)
+            return false;
+    }
+    return true;
+}
+
+/***********************************************
+ * PDQ PARTITION LEFT
+ * Put everything equal to the pivot *begin on the
+ * left. Used when the pivot equals the item just
+ * before the range, so nothing here is smaller
+ **********************************************/
+template <class T>
+T * pdqPartitionLeft(T * begin, T * end)
+{
+    T pivot = *begin;
+    T * first = begin;
+    T * last = end;
+
+    while (pivot < *--last)
+        ;
+    if (last + 1 == end)
+        while (first < last && !(pivot < *++first))
+            ;
+    else
+        while (!(pivot < *++first))
+            ;
+
+    while (first < last)
+    {
+        pdqSwap(first, last);
+        while (pivot < *--last)
+            ;
+        while (!(pivot < *++first))
+            ;
+    }
+
+    *begin = *last;
+    *last = pivot;
+    return last;
+}
+
+/***********************************************
+ * PDQ PARTITION RIGHT
+ * Partition around the pivot *begin with items
+ * equal to it going right. Returns where the
+ * pivot ended up; alreadyPartitioned is set when
+ * no item had to move
+ **********************************************/
+template <class T>
+T * pdqPartitionRight(T * begin, T * end, bool & alreadyPartitioned)
+{
+    T pivot = *begin;
+    T * first = begin;
+    T * last = end;
+
+    // find the first item on each side that is out of place
+    while (*++first < pivot)
+        ;
+    if (first - 1 == begin)
+        while (first < last && !(*--last < pivot))
+            ;
+    else
+        while (!(*--last < pivot))
+            ;
+
+    alreadyPartitioned = first >= last;
+
+    while (first < last)
+    {
+        pdqSwap(first, last);
+        while (*++first < pivot)
+            ;
+        while (!(*--last < pivot))
+            ;
+    }
+
+    T * pPivot = first - 1;
+    *begin = *pPivot;
+    *pPivot = pivot;
+    return pPivot;
+}
+
+/***********************************************
+ * PDQ SWAP OFFSETS
+ * Exchange num misplaced pairs found by the
+ * block partition. When the counts differ a
+ * cyclic rotation does it in fewer moves
+ **********************************************/
+template <class T>
+inline void pdqSwapOffsets(T * first, T * last,
+                           unsigned char * offsetsL, unsigned char * offsetsR,
+                           size_t num, bool useSwaps)
+{
+    if (useSwaps)
+    {
+        for (size_t i = 0; i < num; i++)
+            pdqSwap(first + offsetsL[i], last - offsetsR[i]);
+    }
+    else if (num > 0)
+    {
+        T * l = first + offsetsL[0];
+        T * r = last - offsetsR[0];
+        T tmp = *l;
+        *l = *r;
+        for (size_t i = 1; i < num; i++)
+        {
+            l = first + offsetsL[i];
+            *r = *l;
+            r = last - offsetsR[i];
+            *l = *r;
+        }
+        *r = tmp;
+    }
+}
+
+/***********************************************
+ * PDQ PARTITION RIGHT BRANCHLESS
+ * Same contract as pdqPartitionRight. Blocks of
+ * items from each end are scanned and the offset
+ * of every misplaced item is written down with
+ * no branch on the comparison; the two lists of
+ * offsets are then swapped pairwise
+ **********************************************/
+template <class T>
+T * pdqPartitionRightBranchless(T * begin, T * end, bool & alreadyPartitioned)
+{
+    T pivot = *begin;
+    T * first = begin;
+    T * last = end;
+
+    while (*++first < pivot)
+        ;
+    if (first - 1 == begin)
+        while (first < last && !(*--last < pivot))
+            ;
+    else
+        while (!(*--last < pivot))
+            ;
+
+    alreadyPartitioned = first >= last;
+    if (!alreadyPartitioned)
+    {
+        pdqSwap(first, last);
+        ++first;
+
+        unsigned char offsetsL[PDQ_BLOCK];
+        unsigned char offsetsR[PDQ_BLOCK];
+        T * baseL = first;
+        T * baseR = last;
+        size_t numL = 0, numR = 0, startL = 0, startR = 0;
+
+        while (first < last)
+        {
+            // refill whichever side has run out of misplaced items
+            size_t numUnknown = last - first;
+            size_t splitL = numL == 0 ? (numR == 0 ? numUnknown / 2 : numUnknown) : 0;
+            size_t splitR = numR == 0 ? (numUnknown - splitL) : 0;
+            if (splitL > (size_t)PDQ_BLOCK)
+                splitL = PDQ_BLOCK;
+            if (splitR > (size_t)PDQ_BLOCK)
+                splitR = PDQ_BLOCK;
+
+            for (size_t i = 0; i < splitL; i++)
+            {
+                offsetsL[numL] = (unsigned char)i;
+                numL += !(*first < pivot);
+                ++first;
+            }
+            for (size_t i = 0; i < splitR; )
+            {
+                offsetsR[numR] = (unsigned char)++i;
+                numR += (*--last < pivot);
+            }
+
+            size_t num = numL < numR ? numL : numR;
+            pdqSwapOffsets(baseL, baseR, offsetsL + startL, offsetsR + startR,
+                           num, numL == numR);
+            numL -= num;
+            numR -= num;
+            startL += num;
+            startR += num;
+            if (numL == 0)
+            {
+                startL = 0;
+                baseL = first;
+            }
+            if (numR == 0)
+            {
+                startR = 0;
+                baseR = last;
+            }
+        }
+
+        // one side may still hold misplaced items; move them to the middle
+        if (numL)
+        {
+            while (numL--)
+                pdqSwap(baseL + offsetsL[startL + numL], --last);
+            first = last;
+        }
+        if (numR)
+        {
+            while (numR--)
+            {
+                pdqSwap(baseR - offsetsR[startR + numR], first);
+                ++first;
+            }
+            last = first;
+        }
+    }
+
+    T * pPivot = first - 1;
+    *begin = *pPivot;
+    *pPivot = pivot;
+    return pPivot;
+}
+
+/***********************************************
+ * PDQ LOOP
+ * Sort [begin, end). leftmost is false when the
+ * item before begin is no bigger than anything
+ * in the range, which lets insertion sort skip
+ * its bounds check. badAllowed counts down the
+ * lopsided partitions we put up with
+ **********************************************/
+template <class T, bool BRANCHLESS>
+void pdqLoop(T * begin, T * end, int badAllowed, bool leftmost)
+{
+    while (true)
+    {
+        long size = end - begin;
+        if (size < PDQ_INSERTION)
+        {
+            if (leftmost)
+                pdqInsertion(begin, end);
+            else
+                pdqUnguardedInsertion(begin, end);
+            return;
+        }
+
+        // pivot: median of three, or the median of three medians
+        long half = size / 2;
+        if (size > PDQ_NINTHER)
+        {
+            pdqSort3(begin, begin + half, end - 1);
+            pdqSort3(begin + 1, begin + (half - 1), end - 2);
+            pdqSort3(begin + 2, begin + (half + 1), end - 3);
+            pdqSort3(begin + (half - 1), begin + half, begin + (half + 1));
+            pdqSwap(begin, begin + half);
+        }
+        else
+            pdqSort3(begin + half, begin, end - 1);
+
+        // a pivot equal to its predecessor: sweep its duplicates aside
+        if (!leftmost && !(*(begin - 1) < *begin))
+        {
+            begin = pdqPartitionLeft(begin, end) + 1;
+            continue;
+        }
+
+        bool alreadyPartitioned;
+        T * pPivot = BRANCHLESS ?
+            pdqPartitionRightBranchless(begin, end, alreadyPartitioned) :
+            pdqPartitionRight(begin, end, alreadyPartitioned);
+
+        long sizeL = pPivot - begin;
+        long sizeR = end - (pPivot + 1);
+        if (sizeL < size / 8 || sizeR < size / 8)
+        {
+            // too lopsided: give up on quicksort or shake things up
+            if (--badAllowed == 0)
+            {
+                sortHeap(begin, (int)size);
+                return;
+            }
+            if (sizeL >= PDQ_INSERTION)
+            {
+                pdqSwap(begin, begin + sizeL / 4);
+                pdqSwap(pPivot - 1, pPivot - sizeL / 4);
+                if (sizeL > PDQ_NINTHER)
+                {
+                    pdqSwap(begin + 1, begin + (sizeL / 4 + 1));
+                    pdqSwap(begin + 2, begin + (sizeL / 4 + 2));
+                    pdqSwap(pPivot - 2, pPivot - (sizeL / 4 + 1));
+                    pdqSwap(pPivot - 3, pPivot - (sizeL / 4 + 2));
+                }
+            }
+            if (sizeR >= PDQ_INSERTION)
+            {
+                pdqSwap(pPivot + 1, pPivot + (1 + sizeR / 4));
+                pdqSwap(end - 1, end - sizeR / 4);
+                if (sizeR > PDQ_NINTHER)
+                {
+                    pdqSwap(pPivot + 2, pPivot + (2 + sizeR / 4));
+                    pdqSwap(pPivot + 3, pPivot + (3 + sizeR / 4));
+                    pdqSwap(end - 2, end - (1 + sizeR / 4));
+                    pdqSwap(end - 3, end - (2 + sizeR / 4));
+                }
+            }
+        }
+        else if (alreadyPartitioned &&
+                 pdqPartialInsertion(begin, pPivot) &&
+                 pdqPartialInsertion(pPivot + 1, end))
+            return;
+
+        pdqLoop <T, BRANCHLESS> (begin, pPivot, badAllowed, leftmost);
+        begin = pPivot + 1;
+        leftmost = false;
+    }
+}
+
+/*****************************************************
+ * SORT PDQ
+ * Sort the items in the array. Not stable. Numbers
+ * use the branchless partition; anything else, where
+ * a comparison may be expensive, uses the plain one
+ ****************************************************/
+template <class T>
+void sortPdq(T array[], int num)
+{
+    if (num < 2)
+        return;
+
+    int badAllowed = 0;
+    for (int n = num; n > 1; n >>= 1)
+        badAllowed++;
+
+    pdqLoop <T, std::is_arithmetic <T> :: value> (array, array + num,
+                                                  badAllowed, true);
+}
+
+#endif // SORT_PDQ_H
@@ -0,0 +1,219 @@
+/***********************************************************************
+ * Header:
+ *    RADIX SORT
+ * Summary:
+ *    Sorts that never compare two items, only look at their keys a
+ *    piece at a time:
+ *      - LSD radix sort for 32 and 64-bit integers, and for records
+ *        sorted by an integer key such as an id number or a packed
+ *        date. One byte per pass, least significant first; each pass
+ *        is stable, so the result is too. Passes where every key has
+ *        the same byte are skipped.
+ *      - MSD radix sort for strings. Items are bucketed on one
+ *        character and each bucket sorted on the next, dropping to
+ *        insertion sort once a bucket gets small.
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+
+#ifndef SORT_RADIX_H
+#define SORT_RADIX_H
+
+#include <string>         // for STRING
+#include <vector>         // for VECTOR
+#include <utility>        // for MOVE
+#include <type_traits>    // for MAKE_UNSIGNED and DECAY
+
+// buckets this small are insertion sorted by the string sort
+const int RADIX_STRING_CUTOFF = 32;
+
+/***********************************************
+ * RADIX BITS
+ * The key as an unsigned number that sorts the
+ * same way. Signed keys get their sign bit
+ * flipped so negatives come first
+ **********************************************/
+template <class K>
+inline typename std::make_unsigned <K> :: type radixBits(K key)
+{
+    typedef typename std::make_unsigned <K> :: type U;
+    U bits = (U)key;
+    if (std::is_signed <K> :: value)
+        bits ^= (U)1 << (sizeof(U) * 8 - 1);
+    return bits;
+}
+
+/*****************************************************
+ * SORT RADIX : BY KEY
+ * Sort records by key(record), which must return a
+ * built-in integer type. Stable. Uses a second array
+ * of num records
+ ****************************************************/
+template <class T, class KeyFunction>
+void sortRadix(T array[], int num, KeyFunction key)
+{
+    typedef typename std::decay <decltype(key(array[0]))> :: type K;
+    const int BYTES = sizeof(K);
+    if (num < 2)
+        return;
+
+    // one pass over the data counts every byte of every key
+    std::vector <int> counts(BYTES * 256, 0);
+    for (int i = 0; i < num; i++)
+    {
+        auto bits = radixBits <K> (key(array[i]));
+        for (int b = 0; b < BYTES; b++)
+            counts[b * 256 + ((bits >> (8 * b)) & 0xff)]++;
+    }
+
+    std::vector <T> buffer(num);
+    T * pFrom = array;
+    T * pTo = buffer.data();
+    for (int b = 0; b < BYTES; b++)
+    {
+        int * count = &counts[b * 256];
+
+        // every key has the same byte here: the pass would change nothing
+        auto first = (radixBits <K> (key(array[0])) >> (8 * b)) & 0xff;
+        if (count[first] == num)
+            continue;
+
+        // turn counts into starting offsets
+        int offset[256];
+        for (int d = 0, total = 0; d < 256; d++)
+        {
+            offset[d] = total;
+            total += count[d];
+        }
+
+        for (int i = 0; i < num; i++)
+        {
+            auto digit = (radixBits <K> (key(pFrom[i])) >> (8 * b)) & 0xff;
+            pTo[offset[digit]++] = std::move(pFrom[i]);
+        }
+        std::swap(pFrom, pTo);
+    }
+
+    if (pFrom != array)
+        for (int i = 0; i < num; i++)
+            array[i] = std::move(pFrom[i]);
+}
+
+/*****************************************************
+ * SORT RADIX : INTEGERS
+ * Sort an array of built-in integers
+ ****************************************************/
+template <class T>
+struct RadixIdentity
+{
+    T operator () (const T & t) const { return t; }
+};
+
+template <class T>
+void sortRadix(T array[], int num)
+{
+    static_assert(std::is_integral <T> :: value,
+                  "sortRadix needs integers, strings or a key function");
+    sortRadix(array, num, RadixIdentity <T> ());
+}
+
+/***********************************************
+ * RADIX CHAR
+ * The character at depth as 1..256, or 0 once
+ * the string has ended, so shorter strings
+ * come first
+ **********************************************/
+inline int radixChar(const std::string & s, size_t depth)
+{
+    return depth < s.size() ? (unsigned char)s[depth] + 1 : 0;
+}
+
+/***********************************************
+ * RADIX STRING INSERTION
+ * Insertion sort of strings known to agree on
+ * their first depth characters
+ **********************************************/
+inline void radixStringInsertion(std::string array[], int num, size_t depth)
+{
+    for (int i = 1; i < num; i++)
+    {
+        int j = i;
+        for (; j > 0 &&
+                 array[j].compare(depth, std::string::npos,
+                                  array[j - 1], depth, std::string::npos) < 0;
+             j--)
+            array[j].swap(array[j - 1]);
+    }
+}
+
+/***********************************************
+ * RADIX STRING LOOP
+ * Bucket array[0..num) on the character at
+ * depth, then sort each bucket on the next one.
+ * Strings that have ended are all equal. Each
+ * character is read once into digits, and a
+ * depth where every string has the same
+ * character is stepped over without moving any
+ **********************************************/
+inline void radixStringLoop(std::string array[], int num, size_t depth,
+                            std::string buffer[], unsigned short digits[])
+{
+    int count[258];
+    while (true)
+    {
+        if (num < RADIX_STRING_CUTOFF)
+        {
+            radixStringInsertion(array, num, depth);
+            return;
+        }
+
+        for (int d = 0; d < 258; d++)
+            count[d] = 0;
+        for (int i = 0; i < num; i++)
+        {
+            digits[i] = (unsigned short)radixChar(array[i], depth);
+            count[digits[i] + 1]++;
+        }
+        if (count[digits[0] + 1] != num)
+            break;
+        if (digits[0] == 0)
+            return;
+        depth++;
+    }
+
+    for (int d = 1; d < 258; d++)
+        count[d] += count[d - 1];
+
+    // count[d] is now where bucket d starts
+    int start[257];
+    for (int d = 0; d < 257; d++)
+        start[d] = count[d];
+
+    for (int i = 0; i < num; i++)
+        buffer[count[digits[i]]++].swap(array[i]);
+    for (int i = 0; i < num; i++)
+        array[i].swap(buffer[i]);
+
+    for (int d = 1; d < 257; d++)
+    {
+        int size = count[d] - start[d];
+        if (size > 1)
+            radixStringLoop(array + start[d], size, depth + 1, buffer, digits);
+    }
+}
+
+/*****************************************************
+ * SORT RADIX : STRINGS
+ * Sort strings by their bytes, the same order as
+ * std::string's operator <
+ ****************************************************/
+inline void sortRadix(std::string array[], int num)
+{
+    if (num < 2)
+        return;
+    std::vector <std::string> buffer(num);
+    std::vector <unsigned short> digits(num);
+    radixStringLoop(array, num, 0, buffer.data(), digits.data());
+}
+
+#endif // SORT_RADIX_H
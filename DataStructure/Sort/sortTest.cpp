@@ -0,0 +1,219 @@
+/***********************************************************************
+ * Program:
+ *    SORT TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Times each sort in this folder, next to std::sort and
+ *    std::stable_sort, on several shapes of input and several kinds of
+ *    item. Every result is checked against std::sort, so a wrong answer
+ *    is reported rather than timed. Usage:  a.out [number of items]
+ ************************************************************************/
+
+#include <iostream>        // for COUT
+#include <iomanip>         // for SETW
+#include <string>          // for STRING
+#include <vector>          // for VECTOR
+#include <algorithm>       // for SORT and STABLE_SORT
+#include <chrono>          // for STEADY_CLOCK
+#include <random>          // for MT19937
+#include <cstdlib>         // for ATOI
+#include "sortHeap.h"
+#include "sortIntro.h"
+#include "sortPdq.h"
+#include "sortMerge.h"
+#include "sortRadix.h"
+using namespace std;
+
+/**********************************************************************
+ * RECORD
+ * Stands in for something like a Person: sorted by an integer id,
+ * with a payload that has to travel along with it
+ ***********************************************************************/
+struct Record
+{
+    int id;
+    string name;
+    bool operator <  (const Record & rhs) const { return id < rhs.id;  }
+    bool operator == (const Record & rhs) const { return id == rhs.id; }
+};
+
+int recordId(const Record & record) { return record.id; }
+
+template <class T>
+void stdSort(T array[], int num)       { sort(array, array + num);        }
+template <class T>
+void stdStableSort(T array[], int num) { stable_sort(array, array + num); }
+
+void radixRecords(Record array[], int num) { sortRadix(array, num, recordId); }
+
+template <class T>
+struct Contestant
+{
+    const char * name;
+    void (*sort)(T array[], int num);
+};
+
+/**********************************************************************
+ * MAKE ITEM
+ * Turn a generated number into each kind of item
+ ***********************************************************************/
+void makeItem(int & item, long long value)       { item = (int)value;    }
+void makeItem(long long & item, long long value) { item = value << 20;   }
+void makeItem(string & item, long long value)
+{
+    // a shared prefix, as in real keys, followed by the digits
+    item = "item-" + to_string(value);
+}
+void makeItem(Record & item, long long value)
+{
+    item.id = (int)value;
+    item.name = "somebody";
+}
+
+/**********************************************************************
+ * MAKE INPUT
+ * Fill data with num items of the given shape
+ ***********************************************************************/
+enum Shape { RANDOM, SORTED, REVERSED, FEW_UNIQUE, ORGAN_PIPE, NUM_SHAPES };
+const char * SHAPE_NAMES[NUM_SHAPES] =
+{
+    "random", "sorted", "reversed", "few unique", "organ pipe"
+};
+
+template <class T>
+void makeInput(vector <T> & data, int num, Shape shape)
+{
+    mt19937 generator(235);
+    data.resize(num);
+    for (int i = 0; i < num; i++)
+    {
+        long long value = 0;
+        switch (shape)
+        {
+            case RANDOM:
+                value = (int)generator();
+                break;
+            case SORTED:
+                value = i;
+                break;
+            case REVERSED:
+                value = num - i;
+                break;
+            case FEW_UNIQUE:
+                value = generator() % 16;
+                break;
+            case ORGAN_PIPE:
+                value = (i < num / 2) ? i : num - i;
+                break;
+            default:
+                break;
+        }
+        makeItem(data[i], value);
+    }
+}
+
+/**********************************************************************
+ * RACE
+ * One row per input shape, one column per sort, times in milliseconds.
+ * Returns false if any sort got the wrong answer
+ ***********************************************************************/
+template <class T>
+bool race(const char * title, const vector <Contestant <T> > & contestants,
+          int num)
+{
+    cout << "\nSorting " << num << ' ' << title
+         << ", times in milliseconds\n";
+    cout << setw(12) << "";
+    for (size_t c = 0; c < contestants.size(); c++)
+        cout << setw(18) << contestants[c].name;
+    cout << endl;
+
+    bool allCorrect = true;
+    vector <T> input;
+    vector <T> expected;
+    vector <T> work;
+    for (int s = 0; s < NUM_SHAPES; s++)
+    {
+        makeInput(input, num, (Shape)s);
+        expected = input;
+        sort(expected.begin(), expected.end());
+
+        cout << setw(12) << SHAPE_NAMES[s];
+        for (size_t c = 0; c < contestants.size(); c++)
+        {
+            work = input;
+            chrono::steady_clock::time_point start = chrono::steady_clock::now();
+            contestants[c].sort(work.data(), num);
+            chrono::duration <double, milli> elapsed =
+                chrono::steady_clock::now() - start;
+
+            if (work == expected)
+                cout << setw(18) << fixed << setprecision(1) << elapsed.count();
+            else
+            {
+                cout << setw(18) << "WRONG";
+                allCorrect = false;
+            }
+        }
+        cout << endl;
+    }
+    return allCorrect;
+}
+
+/**********************************************************************
+ * COMPARISON SORTS
+ * The contestants that work on any item with operator <
+ ***********************************************************************/
+template <class T>
+vector <Contestant <T> > comparisonSorts()
+{
+    vector <Contestant <T> > contestants;
+    Contestant <T> list[] =
+    {
+        { "std::sort",        stdSort <T>       },
+        { "std::stable_sort", stdStableSort <T> },
+        { "sortIntro",        sortIntro <T>     },
+        { "sortPdq",          sortPdq <T>       },
+        { "sortMerge",        sortMerge <T>     },
+        { "sortHeap",         sortHeap <T>      }
+    };
+    contestants.assign(list, list + sizeof(list) / sizeof(list[0]));
+    return contestants;
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main(int argc, char ** argv)
+{
+    int num = (argc > 1) ? atoi(argv[1]) : 1000000;
+    if (num < 1)
+    {
+        cout << "Usage: " << argv[0] << " [number of items]\n";
+        return 1;
+    }
+
+    vector <Contestant <int> > ints = comparisonSorts <int> ();
+    Contestant <int> radixInt = { "sortRadix", sortRadix <int> };
+    ints.push_back(radixInt);
+
+    vector <Contestant <long long> > longs = comparisonSorts <long long> ();
+    Contestant <long long> radixLong = { "sortRadix", sortRadix <long long> };
+    longs.push_back(radixLong);
+
+    vector <Contestant <string> > strings = comparisonSorts <string> ();
+    Contestant <string> radixString = { "sortRadix", sortRadix };
+    strings.push_back(radixString);
+
+    vector <Contestant <Record> > records = comparisonSorts <Record> ();
+    Contestant <Record> radixRecord = { "sortRadix", radixRecords };
+    records.push_back(radixRecord);
+
+    bool allCorrect = true;
+    allCorrect &= race("32-bit integers", ints, num);
+    allCorrect &= race("64-bit integers", longs, num);
+    allCorrect &= race("strings", strings, num);
+    allCorrect &= race("records by id", records, num);
+    return allCorrect ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+/***********************************************************************
+ * Program:
+ *    SNAPSHOT TEST
+ * Author:
+ *    Daniel Guzman
+ * Summary:
+ *    Checks that a Vector comes back from a snapshot with the same
+ *    elements in the same order, of ints, doubles and strings, that it
+ *    still grows afterwards, and that a snapshot of the wrong kind, a
+ *    damaged or cut short one, a missing file, or running out of
+ *    memory part way through a restore all throw and leave the Vector
+ *    it was restoring into as it was. Exits 1 on the first failure.
+ ************************************************************************/
+
+#include <iostream>        // for COUT and CERR
+#include <cstdio>          // for REMOVE
+#include <cstdlib>         // for EXIT
+#include <fstream>         // for IFSTREAM and OFSTREAM
+#include <new>             // for BAD_ALLOC
+#include <string>
+#include <unistd.h>        // for GETPID
+#include "vectorSnapshot.h"
+using namespace std;
+
+#define CHECK(condition)                                               \
+   if (!(condition))                                                   \
+   {                                                                   \
+      cerr << __FILE__ << ':' << __LINE__ << ": " << #condition << endl; \
+      exit(1);                                                         \
+   }
+
+string fileName = "/tmp/vectorSnapshotTest-" + to_string(getpid()) + ".snap";
+
+/**********************************************************************
+ * SCARCE
+ * A plain number whose arrays can be made to fail to allocate
+ ***********************************************************************/
+struct Scarce
+{
+   int value;
+
+   static bool outOfMemory;
+   static void * operator new [] (size_t size)
+   {
+      if (outOfMemory)
+         throw bad_alloc();
+      return ::operator new [] (size);
+   }
+   static void operator delete [] (void * p) { ::operator delete [] (p); }
+};
+bool Scarce::outOfMemory = false;
+
+Scarce scarce(int value) { Scarce item = { value }; return item; }
+
+/**********************************************************************
+ * SAME
+ * Two Vectors hold equal elements in the same order
+ ***********************************************************************/
+template <class T>
+bool same(const Vector <T> & a, const Vector <T> & b)
+{
+   if (a.size() != b.size())
+      return false;
+   for (int i = 0; i < a.size(); i++)
+      if (!(a[i] == b[i]))
+         return false;
+   return true;
+}
+
+/**********************************************************************
+ * FAILS
+ * restore(v, fileName) throws
+ ***********************************************************************/
+template <class T>
+bool fails(Vector <T> & v)
+{
+   try
+   {
+      restore(v, fileName);
+   }
+   catch (const char * error)
+   {
+      return true;
+   }
+   return false;
+}
+
+/**********************************************************************
+ * ROUND TRIP
+ * Out and back in, over Vectors that held more and less, and then
+ * grown, which a Vector restored exactly to capacity has to do first
+ ***********************************************************************/
+void roundTrip()
+{
+   Vector <int> numbers;
+   for (int i = 0; i < 10000; i++)
+      numbers.push_back(i * 7 % 10007 - 5000);
+   snapshot(numbers, fileName);
+   Vector <int> restored;
+   restored.push_back(-1);
+   restore(restored, fileName);
+   CHECK(same(restored, numbers));
+   restored.push_back(123);
+   CHECK(restored.size() == 10001);
+   CHECK(restored[10000] == 123);
+   CHECK(restored[9999] == numbers[9999]);
+
+   Vector <int> few;
+   for (int i = 0; i < 3; i++)
+      few.push_back(i);
+   snapshot(few, fileName);
+   restore(restored, fileName);
+   CHECK(same(restored, few));
+
+   Vector <double> fractions;
+   for (int i = 0; i < 1000; i++)
+      fractions.push_back(i / 7.0);
+   snapshot(fractions, fileName);
+   Vector <double> restoredFractions;
+   restore(restoredFractions, fileName);
+   CHECK(same(restoredFractions, fractions));
+
+   // strings of every length, the empty one and one with a NUL inside
+   Vector <string> words;
+   for (int i = 0; i < 1000; i++)
+      words.push_back(string(i % 50, 'a' + i % 26) + to_string(i));
+   words.push_back("");
+   words.push_back(string("nul\0inside", 10));
+   snapshot(words, fileName);
+   Vector <string> restoredWords;
+   restoredWords.push_back("old");
+   restore(restoredWords, fileName);
+   CHECK(same(restoredWords, words));
+   CHECK(restoredWords[1001].size() == 10);
+   restoredWords.push_back("new");
+   CHECK(restoredWords[1002] == "new");
+
+   // nothing at all, and growing from there
+   Vector <string> empty;
+   snapshot(empty, fileName);
+   restore(restoredWords, fileName);
+   CHECK(restoredWords.empty());
+   restoredWords.push_back("again");
+   CHECK(restoredWords.size() == 1);
+   CHECK(restoredWords[0] == "again");
+}
+
+/**********************************************************************
+ * LEFT AS IT WAS
+ * Every way a restore can fail leaves the Vector holding what it did
+ ***********************************************************************/
+void leftAsItWas()
+{
+   Vector <Scarce> big;
+   for (int i = 0; i < 1000; i++)
+      big.push_back(scarce(i));
+   snapshot(big, fileName);
+
+   Vector <Scarce> small;
+   for (int i = 0; i < 10; i++)
+      small.push_back(scarce(i * 100));
+
+   // out of memory for the new buffer
+   Scarce::outOfMemory = true;
+   bool failed = fails(small);
+   Scarce::outOfMemory = false;
+   CHECK(failed);
+   CHECK(small.size() == 10);
+   for (int i = 0; i < 10; i++)
+      CHECK(small[i].value == i * 100);
+
+   // a snapshot of some other kind of element
+   Vector <int> numbers;
+   for (int i = 0; i < 100; i++)
+      numbers.push_back(i);
+   snapshot(numbers, fileName);
+   Vector <double> fractions;
+   fractions.push_back(0.5);
+   CHECK(fails(fractions));
+   Vector <string> words;
+   words.push_back("kept");
+   CHECK(fails(words));
+   CHECK(fractions.size() == 1 && fractions[0] == 0.5);
+   CHECK(words.size() == 1 && words[0] == "kept");
+
+   // a flipped bit, and the file cut short
+   Vector <int> kept;
+   kept.push_back(42);
+   ifstream fin(fileName.c_str(), ios::binary);
+   string image((istreambuf_iterator <char> (fin)), istreambuf_iterator <char> ());
+   fin.close();
+   image[image.size() - 1] ^= 1;
+   ofstream fout(fileName.c_str(), ios::binary);
+   fout.write(image.data(), image.size());
+   fout.close();
+   CHECK(fails(kept));
+   fout.open(fileName.c_str(), ios::binary | ios::trunc);
+   fout.write(image.data(), image.size() / 2);
+   fout.close();
+   CHECK(fails(kept));
+   CHECK(kept.size() == 1 && kept[0] == 42);
+
+   // no file at all
+   remove(fileName.c_str());
+   CHECK(fails(kept));
+   CHECK(kept.size() == 1 && kept[0] == 42);
+}
+
+/**********************************************************************
+ * MAIN
+ ***********************************************************************/
+int main()
+{
+   roundTrip();
+   leftAsItWas();
+   remove(fileName.c_str());
+   cout << "Snapshot tests passed\n";
+   return 0;
+}
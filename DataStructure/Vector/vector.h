@@ -52,6 +52,14 @@ public:
     T & operator [] (int index)       throw (const char *);
     T   operator [] (int index) const throw (const char *);
     
+    // snapshots need POSIX, so they are in vectorSnapshot.h
+    template <class U>
+    friend void snapshot(const Vector <U> & v, const std::string & fileName)
+        throw (const char *);
+    template <class U>
+    friend void restore(Vector <U> & v, const std::string & fileName)
+        throw (const char *);
+    
     // the various iterator interfaces
     class iterator;
     class const_iterator;
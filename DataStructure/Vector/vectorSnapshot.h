@@ -0,0 +1,76 @@
+/***********************************************************************
+ * Header:
+ *    Vector Snapshot
+ * Summary:
+ *    Saving a Vector to a snapshot and loading it back, kept out of
+ *    vector.h because snapshot.h needs POSIX:
+ *        snapshot(v, fileName)  : write v to fileName
+ *        restore(v, fileName)   : replace what is in v with fileName's
+ * Author
+ *    Daniel Guzman
+ ************************************************************************/
+#ifndef vectorSnapshot_h
+#define vectorSnapshot_h
+
+#include <new>         // for BAD_ALLOC
+#include "vector.h"
+#include "snapshot.h"
+
+/***************************************
+ * SNAPSHOT
+ * The elements in one write, or for strings
+ * their offsets and then their characters
+ **************************************/
+template <class T>
+void snapshot(const Vector <T> & v, const std::string & fileName)
+    throw (const char *)
+{
+    SnapshotWriter out(fileName, SNAPSHOT_VECTOR,
+                       SnapshotElements <T> :: KIND, SnapshotElements <T> :: SIZE);
+    SnapshotElements <T> :: writeArray(out, v.data, v.numElements);
+    out.finish(v.numElements, 0);
+}
+
+/***************************************
+ * RESTORE
+ * Checked in full and copied into a new
+ * buffer before anything in v changes, so
+ * a bad file or a failed allocation leaves
+ * v as it was
+ **************************************/
+template <class T>
+void restore(Vector <T> & v, const std::string & fileName)
+    throw (const char *)
+{
+    SnapshotReader in(fileName, SNAPSHOT_VECTOR,
+                      SnapshotElements <T> :: KIND, SnapshotElements <T> :: SIZE);
+    const SnapshotHeader & header = in.header();
+    if (header.count > INT_MAX ||
+        SnapshotElements <T> :: check(in.payload(), header.payloadSize, header.count)
+            != header.payloadSize)
+        throw "ERROR: the snapshot is corrupt";
+
+    T * pNew = NULL;
+    if (header.count > 0)
+    {
+        try
+        {
+            pNew = new T[header.count];
+            SnapshotElements <T> :: readArray(in.payload(), pNew, header.count);
+        }
+        catch (std::bad_alloc)
+        {
+            delete [] pNew;
+            throw "ERROR: Unable to allocate a new buffer for Vector";
+        }
+    }
+
+    // swap in the new and delete the old
+    if (v.numCapacity != 0)
+        delete [] v.data;
+    v.data = pNew;
+    v.numCapacity = header.count;
+    v.numElements = header.count;
+}
+
+#endif /* vectorSnapshot_h */